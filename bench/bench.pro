@@ -0,0 +1,10 @@
+# bench/bench.pro
+
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    codegen \
+    expression_vm \
+    interpreter \
+    protocol \
+    timers
@@ -0,0 +1,158 @@
+/**
+ * @file bench_codegen.cpp
+ * @brief Measures code generation on synthetic machines of growing size.
+ * @details Every synthetic state has an action writing an output and a variable, one
+ *          event-triggered guarded transition and one eventless transition (delayed or guarded),
+ *          so a machine of N states has 2N transitions. If the time per state stays flat as
+ *          the machine grows, rendering is linear in the size of the machine.
+ *
+ *          The same generator writes the stress model used to measure split builds:
+ *          `ifa_bench_codegen --write-model 3000 Stress3000.json` saves a 3000-state machine that
+ *          the editor can open, `ifa_bench_codegen --write-units 3000 <dir>` writes the files of its
+ *          split build (header, core and one source file per state).
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "codegen/CodeGenerator.h"
+#include "core/Input.h"
+#include "core/Machine.h"
+#include "core/Output.h"
+#include "core/State.h"
+#include "core/Transition.h"
+#include "core/Variable.h"
+#include "nlohmann/json.hpp"
+#include "persistence/JsonPersistance.h"
+#include "persistence/json_conversions.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace {
+
+/** @brief Inputs of the synthetic machines. */
+constexpr int kInputs = 8;
+/** @brief Outputs of the synthetic machines. */
+constexpr int kOutputs = 4;
+/** @brief Machine sizes (states) that are measured. */
+constexpr int kSizes[] = {300, 1000, 3000};
+
+std::string stateName(int index) {
+    return "S" + std::to_string(index);
+}
+
+/**
+ * @brief Builds a synthetic machine the way the editor does.
+ * @param states Number of states.
+ * @return std::unique_ptr<Machine> The machine with 2 * states transitions.
+ */
+std::unique_ptr<Machine> buildMachine(int states) {
+    auto machine = std::make_unique<Machine>("Synthetic" + std::to_string(states));
+    for (int i = 0; i < kInputs; ++i) {
+        machine->addInput(std::make_unique<Input>("in" + std::to_string(i)));
+    }
+    for (int i = 0; i < kOutputs; ++i) {
+        machine->addOutput(std::make_unique<Output>("out" + std::to_string(i)));
+    }
+    machine->addVariable(std::make_unique<Variable>("count", "0", "int"));
+    machine->addVariable(std::make_unique<Variable>("period", "250", "int"));
+
+    std::vector<State*> created;
+    for (int i = 0; i < states; ++i) {
+        const std::string action = "count = count + 1;\noutput(\"out" + std::to_string(i % kOutputs) + "\", count);";
+        auto state = std::make_unique<State>(stateName(i), action, i);
+        created.push_back(state.get());
+        machine->addState(std::move(state));
+    }
+    machine->setInitialState(stateName(0));
+
+    int transitionId = 0;
+    for (int i = 0; i < states; ++i) {
+        const std::string input = "in" + std::to_string(i % kInputs);
+        const std::string onEvent = input + " [valueof(\"" + input + "\") == \"1\" && count > " + std::to_string(i % 10) + "]";
+        machine->addTransition(std::make_unique<Transition>(created[i], created[(i + 1) % states], transitionId++, onEvent));
+        // Alternate delayed transitions (constant or variable delay) and guarded immediate ones.
+        const std::string eventless = i % 3 == 0 ? "@ 1000" : i % 3 == 1 ? "@ period" : "[count > 100]";
+        machine->addTransition(std::make_unique<Transition>(created[i], created[(i + 7) % states], transitionId++, eventless));
+    }
+    return machine;
+}
+
+/**
+ * @brief Writes the split build of a synthetic machine into a directory.
+ * @param generator The code generator.
+ * @param states Number of states.
+ * @param directory The output directory (created if missing).
+ * @return int Exit code.
+ */
+int writeUnits(CodeGenerator& generator, int states, const std::string& directory) {
+    std::unique_ptr<Machine> machine = buildMachine(states);
+    json model = *machine;
+    std::vector<CodeGenerator::Unit> units = generator.generateUnits(model, machine->getName());
+    std::filesystem::create_directories(directory);
+    for (const CodeGenerator::Unit& unit : units) {
+        std::ofstream(std::filesystem::path(directory) / unit.fileName) << unit.code;
+    }
+    std::printf("wrote %zu files to %s\n", units.size(), directory.c_str());
+    return 0;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--write-model" && argc == 4) {
+        return JsonPersistence::saveToFile(*buildMachine(std::atoi(argv[2])), argv[3]) ? 0 : 1;
+    }
+    const std::string templatePath = IFA_TEMPLATE_DIR "/automation_template.tpl";
+    CodeGenerator generator(templatePath);
+    if (mode == "--write-units" && argc == 4) {
+        return writeUnits(generator, std::atoi(argv[2]), argv[3]);
+    }
+    if (!mode.empty()) {
+        std::fprintf(stderr, "usage: %s [--write-model <states> <file> | --write-units <states> <directory>]\n", argv[0]);
+        return 2;
+    }
+
+    // Parse the templates once, the GUI keeps them cached between builds too.
+    json warmUp = *buildMachine(2);
+    generator.generate(warmUp);
+    generator.generateUnits(warmUp, "WarmUp");
+
+    std::printf("%8s %12s %12s %12s %12s %10s %12s\n", "states", "to_json ms", "codegen ms", "render ms", "us/state",
+                "code KiB", "split ms");
+    for (int states : kSizes) {
+        std::unique_ptr<Machine> machine = buildMachine(states);
+
+        auto start = std::chrono::steady_clock::now();
+        json model = *machine;
+        double toJsonMs = millisecondsSince(start);
+
+        json codegenData = model;
+        start = std::chrono::steady_clock::now();
+        add_codegen_data(codegenData);
+        double codegenMs = millisecondsSince(start);
+
+        // generate() derives the codegen data itself, so the render share is the difference.
+        start = std::chrono::steady_clock::now();
+        std::string code = generator.generate(model);
+        double generateMs = millisecondsSince(start);
+
+        // The split build renders the same machine into a header, a core and one file per state.
+        start = std::chrono::steady_clock::now();
+        std::vector<CodeGenerator::Unit> units = generator.generateUnits(model, machine->getName());
+        double splitMs = millisecondsSince(start);
+
+        std::printf("%8d %12.1f %12.1f %12.1f %12.1f %10zu %12.1f\n", states, toJsonMs, codegenMs, generateMs - codegenMs,
+                    (toJsonMs + generateMs) * 1000.0 / states, code.size() / 1024, splitMs);
+    }
+    return 0;
+}
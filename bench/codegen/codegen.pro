@@ -0,0 +1,34 @@
+# bench/codegen/codegen.pro
+
+TEMPLATE = app
+QT += core gui widgets
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = ifa_bench_codegen
+
+DEFINES += IFA_TEMPLATE_DIR=\\\"$$PWD/../../templates\\\"
+
+INCLUDEPATH += \
+    $$PWD/../../src \
+    $$PWD/../../third_party
+
+SOURCES += \
+    bench_codegen.cpp \
+    ../../src/core/Machine.cpp \
+    ../../src/core/State.cpp \
+    ../../src/core/Transition.cpp \
+    ../../src/core/Variable.cpp \
+    ../../src/core/Input.cpp \
+    ../../src/core/Output.cpp \
+    ../../src/core/MachineElement.cpp \
+    ../../src/core/Expression.cpp \
+    ../../src/core/ExpressionBytecode.cpp \
+    ../../src/codegen/CodeGenerator.cpp \
+    ../../src/persistence/JsonPersistance.cpp \
+    ../../src/persistence/json_conversions.cpp \
+    ../../src/persistence/io_call_rewriter.cpp
+
+QMAKE_CXXFLAGS += -O2 -w
+
+unix:LIBS += -lstdc++fs
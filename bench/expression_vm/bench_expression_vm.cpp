@@ -0,0 +1,134 @@
+/**
+ * @file bench_expression_vm.cpp
+ * @brief Compares the bytecode virtual machine of the interpreter with the same code compiled natively.
+ * @details Each case is a guard or action of the kind the interpreter runs on every step, evaluated
+ *          through Expression/ActionProgram and as the C++ the code generator would emit for it.
+ *          The native loops read their operands through volatile variables, so the compiler cannot
+ *          fold them away; they give the cost of the generated automaton.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "core/Expression.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+/** @brief Evaluations per case. */
+constexpr long kIterations = 5000000;
+
+/**
+ * @brief An environment with an integer and a floating point variable.
+ */
+struct BenchEnvironment : ExpressionEnvironment {
+    std::vector<Value> variables{0LL, 2.5};
+    long long outputs = 0;
+
+    Value& variable(int slot) override { return variables[slot]; }
+    const std::string* inputValue(int, const std::string&) const override { return nullptr; }
+    long long elapsedMs() const override { return 0; }
+    void output(int, const std::string&, const Value&) override { ++outputs; }
+};
+
+ExpressionSymbols symbols() {
+    ExpressionSymbols result;
+    result.variables = {{"i", 0}, {"d", 1}};
+    result.outputs = {{"out", 0}};
+    return result;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* name, double vmSeconds, double nativeSeconds) {
+    double vm = vmSeconds * 1e9 / kIterations;
+    double native = nativeSeconds * 1e9 / kIterations;
+    std::printf("%-44s %8.1f %8.1f %8.0fx\n", name, vm, native, native > 0 ? vm / native : 0.0);
+}
+
+// Guard with short-circuit operators and constant operands.
+long long guardCase() {
+    BenchEnvironment environment;
+    Expression guard = Expression::parse("i % 2 == 1 && i + 1 > 3 || d > 2", symbols());
+    long long hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long k = 0; k < kIterations; ++k) {
+        environment.variables[0] = static_cast<long long>(k);
+        hits += valueToBool(guard.evaluate(environment));
+    }
+    double vmSeconds = secondsSince(start);
+
+    volatile long long i = 0;
+    volatile double d = 2.5;
+    start = std::chrono::steady_clock::now();
+    for (long k = 0; k < kIterations; ++k) {
+        i = k;
+        hits -= (i % 2 == 1 && i + 1 > 3) || d > 2;
+    }
+    report("i % 2 == 1 && i + 1 > 3 || d > 2", vmSeconds, secondsSince(start));
+    return hits;
+}
+
+// Guard with ?: and variable operands.
+long long conditionalCase() {
+    BenchEnvironment environment;
+    Expression guard = Expression::parse("(i > 100 ? i - 100 : i * d) < d * 40", symbols());
+    long long hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long k = 0; k < kIterations; ++k) {
+        environment.variables[0] = static_cast<long long>(k % 200);
+        hits += valueToBool(guard.evaluate(environment));
+    }
+    double vmSeconds = secondsSince(start);
+
+    volatile long long i = 0;
+    volatile double d = 2.5;
+    start = std::chrono::steady_clock::now();
+    for (long k = 0; k < kIterations; ++k) {
+        i = k % 200;
+        hits -= (i > 100 ? i - 100 : i * d) < d * 40;
+    }
+    report("(i > 100 ? i - 100 : i * d) < d * 40", vmSeconds, secondsSince(start));
+    return hits;
+}
+
+// Action updating a variable and sending it to an output.
+long long actionCase() {
+    BenchEnvironment environment;
+    ActionProgram action = ActionProgram::parse("i = i + 1; if (i >= 1000) i = 0; output(\"out\", i);", symbols());
+    auto start = std::chrono::steady_clock::now();
+    for (long k = 0; k < kIterations; ++k) {
+        action.execute(environment);
+    }
+    double vmSeconds = secondsSince(start);
+
+    volatile long long i = 0;
+    volatile long long sent = 0;
+    start = std::chrono::steady_clock::now();
+    for (long k = 0; k < kIterations; ++k) {
+        i = i + 1;
+        if (i >= 1000) i = 0;
+        sent = i;
+    }
+    report("i = i + 1; if (i >= 1000) i = 0; output(..)", vmSeconds, secondsSince(start));
+    return environment.outputs - kIterations + (sent >= 0 ? 0 : 1);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%-44s %8s %8s %9s\n", "ns per evaluation", "vm", "native", "vm/native");
+    long long mismatches = 0;
+    mismatches += guardCase() != 0;
+    mismatches += conditionalCase() != 0;
+    mismatches += actionCase() != 0;
+    // The VM and the native code must agree, or the comparison is meaningless.
+    if (mismatches != 0) {
+        std::printf("%lld cases gave different results\n", mismatches);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+# bench/expression_vm/expression_vm.pro
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+TARGET = ifa_bench_expression_vm
+
+INCLUDEPATH += \
+    $$PWD/../../src
+
+SOURCES += \
+    bench_expression_vm.cpp \
+    ../../src/core/Expression.cpp \
+    ../../src/core/ExpressionBytecode.cpp
+
+QMAKE_CXXFLAGS += -O2 -w
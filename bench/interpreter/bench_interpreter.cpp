@@ -0,0 +1,166 @@
+/**
+ * @file bench_interpreter.cpp
+ * @brief Compares the in-process interpreter (Machine::start/step) with the compiled automaton.
+ * @details Both run the Counter example through the same input sequence (increments up to the
+ *          limit, then a reset). The interpreter is timed from start() (parsing the code of the
+ *          machine) to the last step. The compiled path is timed from code generation through the
+ *          g++ build of the automaton as a fleet simulator (-DIFA_AUTOMATON_FLEET) with one
+ *          instance, whose own report gives the time it spent executing the inputs.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "codegen/CodeGenerator.h"
+#include "core/Machine.h"
+#include "persistence/JsonPersistance.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/** @brief Inputs fed to both paths. */
+constexpr int kInputs = 200000;
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** @brief Input i of the sequence: six increments (past the limit of 5), then a reset. */
+const char* inputName(int i) {
+    return i % 7 == 6 ? "reset" : "increment";
+}
+
+/**
+ * @brief Runs the inputs through the interpreter.
+ * @param machine The machine.
+ * @param startMs Receives the time of start().
+ * @param steps Receives the number of states entered.
+ * @return double Milliseconds spent in step().
+ */
+double runInterpreter(Machine& machine, double& startMs, long long& steps) {
+    steps = 0;
+    machine.setInterpreterHandlers(
+        [&steps](const std::string&) { ++steps; },
+        [](const std::string&, const std::string&) {},
+        [](const std::string&, const std::string&) {},
+        [](const std::string& message) { std::fprintf(stderr, "interpreter error: %s\n", message.c_str()); });
+
+    auto start = std::chrono::steady_clock::now();
+    machine.start();
+    startMs = millisecondsSince(start);
+
+    const std::string value = "1";
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kInputs; ++i) {
+        machine.step(std::make_pair(std::string(inputName(i)), value));
+    }
+    return millisecondsSince(start);
+}
+
+/**
+ * @brief Runs a command and returns its standard output.
+ */
+std::string capture(const std::string& command) {
+    std::string output;
+    if (FILE* pipe = popen(command.c_str(), "r")) {
+        char buffer[512];
+        while (std::fgets(buffer, sizeof(buffer), pipe)) {
+            output += buffer;
+        }
+        pclose(pipe);
+    }
+    return output;
+}
+
+/**
+ * @brief Generates and builds the compiled automaton and runs the inputs through it.
+ * @param machine The machine.
+ * @param buildMs Receives the time of code generation and compilation.
+ * @param steps Receives the steps the fleet simulator reports.
+ * @return double Milliseconds the automaton spent on the inputs, negative on failure.
+ */
+double runCompiled(const Machine& machine, double& buildMs, long long& steps) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "ifa_bench_interpreter";
+    fs::create_directories(dir);
+    const fs::path source = dir / "Counter.cpp";
+    const fs::path executable = dir / "Counter";
+    const fs::path inputs = dir / "inputs.txt";
+
+    {
+        // One input per 1 ms tick, all addressed to instance 0.
+        std::ofstream file(inputs);
+        for (int i = 0; i < kInputs; ++i) {
+            file << i << " 0 " << inputName(i) << " 1\n";
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    CodeGenerator generator(IFA_SOURCE_DIR "/templates/automation_template.tpl");
+    std::ofstream(source) << generator.generate(machine);
+    const std::string compile = "g++ -std=c++17 -O2 -DIFA_AUTOMATON_FLEET -I" IFA_SOURCE_DIR "/src/runtime " +
+                                source.string() + " -o " + executable.string() +
+                                " -L" IFA_RUNTIME_LIB_DIR " -lifa_runtime -lpthread";
+    if (std::system(compile.c_str()) != 0) {
+        return -1.0;
+    }
+    buildMs = millisecondsSince(start);
+
+    // Fleet report: "Inputs: D delivered, P processed, timers: T fired" and "Wall time: W ms, ..."
+    const std::string report = capture(executable.string() + " --instances 1 --ticks " + std::to_string(kInputs) +
+                                       " " + inputs.string());
+    unsigned long long delivered = 0;
+    unsigned long long processed = 0;
+    unsigned long long timers = 0;
+    double wallMs = -1.0;
+    std::size_t inputsLine = report.find("Inputs: ");
+    std::size_t wallLine = report.find("Wall time: ");
+    if (inputsLine == std::string::npos || wallLine == std::string::npos ||
+        std::sscanf(report.c_str() + inputsLine, "Inputs: %llu delivered, %llu processed, timers: %llu", &delivered, &processed, &timers) != 3 ||
+        std::sscanf(report.c_str() + wallLine, "Wall time: %lf ms", &wallMs) != 1) {
+        std::fprintf(stderr, "unexpected fleet report:\n%s", report.c_str());
+        return -1.0;
+    }
+    steps = static_cast<long long>(processed + timers);
+    return wallMs;
+}
+
+} // namespace
+
+int main() {
+    std::unique_ptr<Machine> machine = JsonPersistence::loadFromFile(IFA_SOURCE_DIR "/examples/Counter.json");
+    if (!machine) {
+        std::fprintf(stderr, "cannot load the Counter example\n");
+        return 1;
+    }
+
+    double startMs = 0.0;
+    long long interpreterStates = 0;
+    double interpreterMs = runInterpreter(*machine, startMs, interpreterStates);
+
+    double buildMs = 0.0;
+    long long compiledSteps = 0;
+    double compiledMs = runCompiled(*machine, buildMs, compiledSteps);
+    if (compiledMs < 0) {
+        return 1;
+    }
+
+    std::printf("%-12s %14s %14s %12s\n", "", "ready after ms", "inputs ms", "ns/input");
+    std::printf("%-12s %14.2f %14.2f %12.1f\n", "interpreter", startMs, interpreterMs, interpreterMs * 1e6 / kInputs);
+    std::printf("%-12s %14.2f %14.2f %12.1f\n", "compiled", buildMs, compiledMs, compiledMs * 1e6 / kInputs);
+    if (interpreterMs > compiledMs) {
+        std::printf("break-even after %.0f inputs\n", (buildMs - startMs) / ((interpreterMs - compiledMs) / kInputs));
+    } else {
+        std::printf("no break-even: the interpreter is faster per input\n");
+    }
+    std::printf("states entered: interpreter %lld, compiled steps %lld\n", interpreterStates, compiledSteps);
+    return 0;
+}
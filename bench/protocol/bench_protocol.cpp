@@ -0,0 +1,232 @@
+/**
+ * @file bench_protocol.cpp
+ * @brief Compares the throughput of the text and the binary wire protocol (encode and decode).
+ * @details Encodes the updates the engine sends on every step (STATE, OUTPUT, VAR), one update
+ *          per datagram as the engine does without batching, and decodes them the way the GUI
+ *          does. The GUI decodes into QString, which is not available here; the text decoder
+ *          below performs the same steps as MainWindow::processMessage (prefix dispatch, split at
+ *          '=', trim, strip quotes, name lookup) on std::string_view, the binary decoder the same
+ *          steps as MainWindow::processBinaryDatagram (RecordReader, id lookup).
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "runtime/ifa_runtime_protocol.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace ifa_runtime::protocol;
+
+namespace {
+
+/** @brief Number of simulated steps, each sending one update of every kind. */
+constexpr int kSteps = 1000000;
+/** @brief Updates sent per step. */
+constexpr int kUpdatesPerStep = 3;
+
+/** @brief Names of the symbols the updates refer to (ids are the indices). */
+const std::vector<std::string> kStates{"IDLE", "RED_LIGHT", "RED_YELLOW", "GREEN_LIGHT", "YELLOW_LIGHT"};
+const std::vector<std::string> kOutputs{"lamp_red", "lamp_yellow", "lamp_green", "pedestrian_signal"};
+const std::vector<std::string> kVariables{"cycle_count", "green_time_ms", "last_button_press"};
+
+/**
+ * @brief What the GUI keeps from the decoded updates.
+ */
+struct DecodedView {
+    std::vector<std::size_t> outputWrites;
+    std::vector<std::size_t> variableWrites;
+    std::size_t stateChanges = 0;
+    std::size_t valueBytes = 0;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* name, double seconds, std::size_t bytes) {
+    const double messages = static_cast<double>(kSteps) * kUpdatesPerStep;
+    std::printf("%-24s %8.1f ns/msg %8.2f Mmsg/s %6.1f B/msg\n", name, seconds * 1e9 / messages,
+                messages / seconds / 1e6, static_cast<double>(bytes) / messages);
+}
+
+std::string_view trimmed(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\n')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+std::unordered_map<std::string_view, std::size_t> indexOf(const std::vector<std::string>& names) {
+    std::unordered_map<std::string_view, std::size_t> index;
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        index.emplace(names[i], i);
+    }
+    return index;
+}
+
+/**
+ * @brief Decodes one text datagram (text protocol of MainWindow::processMessage).
+ */
+class TextDecoder {
+public:
+    explicit TextDecoder(DecodedView& view)
+        : view_(view), states_(indexOf(kStates)), outputs_(indexOf(kOutputs)), variables_(indexOf(kVariables)) {}
+
+    void decode(std::string_view message) {
+        if (message.substr(0, 6) == "STATE ") {
+            if (states_.count(trimmed(message.substr(6))) != 0) {
+                ++view_.stateChanges;
+            }
+        } else if (message.substr(0, 7) == "OUTPUT ") {
+            assign(message.substr(7), outputs_, view_.outputWrites);
+        } else if (message.substr(0, 4) == "VAR ") {
+            assign(message.substr(4), variables_, view_.variableWrites);
+        }
+    }
+
+private:
+    // Parses name="value".
+    void assign(std::string_view dataPart, const std::unordered_map<std::string_view, std::size_t>& names,
+                std::vector<std::size_t>& writes) {
+        std::size_t assignmentPos = dataPart.find('=');
+        if (assignmentPos == std::string_view::npos) {
+            return;
+        }
+        std::string_view name = trimmed(dataPart.substr(0, assignmentPos));
+        std::string_view value = trimmed(dataPart.substr(assignmentPos + 1));
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+        auto it = names.find(name);
+        if (it != names.end()) {
+            ++writes[it->second];
+            view_.valueBytes += value.size();
+        }
+    }
+
+    DecodedView& view_;
+    std::unordered_map<std::string_view, std::size_t> states_;
+    std::unordered_map<std::string_view, std::size_t> outputs_;
+    std::unordered_map<std::string_view, std::size_t> variables_;
+};
+
+/**
+ * @brief Decodes one binary datagram (binary protocol of MainWindow::processBinaryDatagram).
+ */
+void decodeBinary(std::string_view datagram, DecodedView& view) {
+    RecordReader reader(datagram.data(), datagram.size());
+    Record record;
+    while (reader.next(record)) {
+        std::uint16_t id = 0;
+        std::string_view value;
+        if (!splitIdPayload(record.payload, id, value)) {
+            return;
+        }
+        switch (record.type) {
+        case RecordType::State:
+            view.stateChanges += id < kStates.size() ? 1 : 0;
+            break;
+        case RecordType::Output:
+            if (id < kOutputs.size()) {
+                ++view.outputWrites[id];
+                view.valueBytes += value.size();
+            }
+            break;
+        case RecordType::Variable:
+            if (id < kVariables.size()) {
+                ++view.variableWrites[id];
+                view.valueBytes += value.size();
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+DecodedView emptyView() {
+    DecodedView view;
+    view.outputWrites.assign(kOutputs.size(), 0);
+    view.variableWrites.assign(kVariables.size(), 0);
+    return view;
+}
+
+/** @brief Value of an update in the given step, as the generated code would format it. */
+const std::string& valueOf(int step) {
+    static const std::vector<std::string> values{"0", "1", "4500", "true", "false", "12.5"};
+    return values[static_cast<std::size_t>(step) % values.size()];
+}
+
+// Encodes and decodes the updates with the text protocol (message built like sendOutputUpdate()).
+double runText(DecodedView& view, std::size_t& bytes) {
+    TextDecoder decoder(view);
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < kSteps; ++step) {
+        const std::string& value = valueOf(step);
+        std::string message = "STATE " + kStates[static_cast<std::size_t>(step) % kStates.size()];
+        bytes += message.size();
+        decoder.decode(message);
+        message = "OUTPUT " + kOutputs[static_cast<std::size_t>(step) % kOutputs.size()] + "=\"" + value + "\"";
+        bytes += message.size();
+        decoder.decode(message);
+        message = "VAR " + kVariables[static_cast<std::size_t>(step) % kVariables.size()] + "=\"" + value + "\"";
+        bytes += message.size();
+        decoder.decode(message);
+    }
+    return secondsSince(start);
+}
+
+// Encodes and decodes the updates with the binary protocol (record and datagram buffers reused
+// like in sendOutputById() and dispatchRecord()).
+double runBinary(DecodedView& view, std::size_t& bytes) {
+    std::string record;
+    std::string datagram;
+    auto send = [&]() {
+        datagram.clear();
+        appendHeader(datagram);
+        datagram += record;
+        bytes += datagram.size();
+        decodeBinary(datagram, view);
+    };
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < kSteps; ++step) {
+        const std::string& value = valueOf(step);
+        record.clear();
+        appendIdRecord(record, RecordType::State, static_cast<std::uint16_t>(static_cast<std::size_t>(step) % kStates.size()));
+        send();
+        record.clear();
+        appendIdRecord(record, RecordType::Output, static_cast<std::uint16_t>(static_cast<std::size_t>(step) % kOutputs.size()), value);
+        send();
+        record.clear();
+        appendIdRecord(record, RecordType::Variable, static_cast<std::uint16_t>(static_cast<std::size_t>(step) % kVariables.size()), value);
+        send();
+    }
+    return secondsSince(start);
+}
+
+} // namespace
+
+int main() {
+    DecodedView text = emptyView();
+    DecodedView binary = emptyView();
+    std::size_t textBytes = 0;
+    std::size_t binaryBytes = 0;
+    double textSeconds = runText(text, textBytes);
+    report("text: encode + decode", textSeconds, textBytes);
+    double binarySeconds = runBinary(binary, binaryBytes);
+    report("binary: encode + decode", binarySeconds, binaryBytes);
+
+    // Both protocols must have delivered the same updates to the view.
+    bool same = text.stateChanges == binary.stateChanges && text.outputWrites == binary.outputWrites &&
+                text.variableWrites == binary.variableWrites && text.valueBytes == binary.valueBytes &&
+                text.stateChanges == static_cast<std::size_t>(kSteps);
+    std::printf("decoded views %s\n", same ? "match" : "DIFFER");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file bench_timers.cpp
+ * @brief Compares the timing wheel of TimerManager with the former map of Asio timers.
+ * @details The map-based manager below is the TimerManager the runtime used before the timing
+ *          wheel (one heap-allocated asio::steady_timer per scheduled timer, kept in a std::map).
+ *          Both are measured on the patterns of the generated automata: every state entry
+ *          schedules the delayed transitions of the state and every state exit cancels them all,
+ *          and a burst of timers that all run to expiry.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "runtime/ifa_runtime_timers.h"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace {
+
+/**
+ * @brief The map-of-timers TimerManager the timing wheel replaced, kept as the baseline.
+ */
+class MapTimerManager {
+public:
+    using Handler = std::function<void(const std::string&)>;
+
+    MapTimerManager(asio::io_context& io_ctx, Handler handler)
+        : io_context_(io_ctx), timeoutHandler_(std::move(handler)) {}
+
+    ~MapTimerManager() { cancelAllTimers(); }
+
+    int scheduleTimer(long long delayMs, const std::string& targetStateName) {
+        int timerId = nextTimerId_++;
+        auto timer = std::make_unique<asio::steady_timer>(io_context_);
+        timer->expires_after(std::chrono::milliseconds(delayMs));
+        timer->async_wait([this, timerId](const asio::error_code& error) {
+            handleWait(error, timerId);
+        });
+        activeTimers_[timerId] = ActiveTimer{std::move(timer), targetStateName};
+        return timerId;
+    }
+
+    void cancelAllTimers() {
+        for (auto& [id, active] : activeTimers_) {
+            active.timer->cancel();
+        }
+        activeTimers_.clear();
+    }
+
+private:
+    struct ActiveTimer {
+        std::unique_ptr<asio::steady_timer> timer;
+        std::string targetStateName;
+    };
+
+    void handleWait(const asio::error_code& error, int timerId) {
+        if (!error) {
+            auto it = activeTimers_.find(timerId);
+            if (it != activeTimers_.end()) {
+                timeoutHandler_(it->second.targetStateName);
+                activeTimers_.erase(it);
+            }
+        }
+    }
+
+    std::map<int, ActiveTimer> activeTimers_;
+    int nextTimerId_ = 0;
+    asio::io_context& io_context_;
+    Handler timeoutHandler_;
+};
+
+/** @brief Number of simulated state changes in the schedule/cancel benchmark. */
+constexpr int kTransitions = 200000;
+/** @brief Delayed transitions scheduled on every state entry. */
+constexpr int kTimersPerState = 3;
+/** @brief Timers of the expiry burst. */
+constexpr int kBurst = 20000;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* name, const char* unit, long long operations, double seconds) {
+    std::printf("%-34s %10.1f ns/%s\n", name, seconds * 1e9 / static_cast<double>(operations), unit);
+}
+
+// State entry schedules kTimersPerState timers, state exit cancels them all; the cancelled waits
+// are drained like the engine's io_context would.
+template <typename Manager>
+double scheduleCancel(asio::io_context& io, Manager& timers) {
+    const std::string target = "NEXT_STATE";
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTransitions; ++i) {
+        for (int t = 0; t < kTimersPerState; ++t) {
+            timers.scheduleTimer(1000 + 250 * t, target);
+        }
+        timers.cancelAllTimers();
+        io.poll();
+    }
+    return secondsSince(start);
+}
+
+// kBurst timers due at once, run until all of them have fired.
+template <typename Manager>
+double expiryBurst(asio::io_context& io, Manager& timers) {
+    const std::string target = "NEXT_STATE";
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kBurst; ++i) {
+        timers.scheduleTimer(0, target);
+    }
+    io.restart();
+    io.run();
+    return secondsSince(start);
+}
+
+} // namespace
+
+int main() {
+    using namespace ifa_runtime;
+    long long fired = 0;
+
+    {
+        asio::io_context io;
+        MapTimerManager timers(io, [&](const std::string&) { ++fired; });
+        report("map: schedule x3 + cancelAll", "state", kTransitions, scheduleCancel(io, timers));
+        report("map: burst to expiry", "timer", kBurst, expiryBurst(io, timers));
+    }
+    {
+        asio::io_context io;
+        HandlerTracker tracker;
+        SteadyClock clock;
+        TimerManager timers(io.get_executor(), tracker, clock, [&](std::uint32_t, const std::string&) { ++fired; });
+        report("wheel: schedule x3 + cancelAll", "state", kTransitions, scheduleCancel(io, timers));
+        report("wheel: burst to expiry", "timer", kBurst, expiryBurst(io, timers));
+    }
+
+    std::printf("fired %lld of %d timers\n", fired, 2 * kBurst);
+    return fired == 2 * kBurst ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+# bench/timers/timers.pro
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+TARGET = ifa_bench_timers
+
+DEFINES += ASIO_STANDALONE
+DEFINES += ASIO_SEPARATE_COMPILATION
+
+INCLUDEPATH += \
+    $$PWD/../../src \
+    $$PWD/../../third_party/asio/include
+
+SOURCES += \
+    bench_timers.cpp
+
+QMAKE_CXXFLAGS += -O2 -w
+
+unix {
+    LIBS += -L$$OUT_PWD/../../src/runtime -lifa_runtime -lpthread
+    PRE_TARGETDEPS += $$OUT_PWD/../../src/runtime/libifa_runtime.a
+}
@@ -2,6 +2,14 @@ TEMPLATE = subdirs
 
 SUBDIRS = \
     src/runtime  \
-    src/gui_app
+    src/gui_app  \
+    src/host  \
+    src/flightrec  \
+    tests  \
+    bench
 
-src/gui_app.depends = src/runtime
\ No newline at end of file
+src/gui_app.depends = src/runtime
+src/host.depends = src/runtime
+src/flightrec.depends = src/runtime
+tests.depends = src/runtime
+bench.depends = src/runtime
@@ -12,10 +12,143 @@
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <sstream>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <algorithm>
+#include <cctype>
 #include "persistence/json_conversions.h"
 
 using json = nlohmann::json;
 
+namespace {
+
+// Parts of the automaton template, in the directory of the main template (see automation_template.tpl).
+const char* const kDeclarationsTemplate = "automaton_declarations.tpl";
+const char* const kCoreTemplate = "automaton_core.tpl";
+const char* const kStateTemplate = "automaton_state.tpl";
+
+/**
+ * @brief A parsed template with the environment holding its included templates.
+ */
+struct CachedTemplate {
+    std::filesystem::file_time_type modified;
+    std::shared_ptr<inja::Environment> env;
+    std::shared_ptr<const inja::Template> parsed;
+};
+
+/**
+ * @brief Returns the latest modification time of the templates in the directory of a template.
+ * @details Templates include each other, so a change to any of them invalidates the parsed template.
+ * @param templatePath Path of the template file.
+ * @return std::filesystem::file_time_type The latest modification time.
+ */
+std::filesystem::file_time_type latestTemplateChange(const std::string& templatePath) {
+    std::filesystem::file_time_type latest = std::filesystem::last_write_time(templatePath);
+    std::error_code ec;
+    std::filesystem::path dir = std::filesystem::path(templatePath).parent_path();
+    for (const auto& entry : std::filesystem::directory_iterator(dir.empty() ? "." : dir, ec)) {
+        if (entry.path().extension() == ".tpl") {
+            latest = std::max(latest, entry.last_write_time(ec));
+        }
+    }
+    return latest;
+}
+
+/**
+ * @brief Returns the parsed template for a file, parsing it only on first use or after a template changed.
+ * @details The cache is shared by all CodeGenerator instances and guarded by a mutex, so background
+ *          builds reuse the template parsed by earlier builds. Rendering only reads the template
+ *          and its environment.
+ * @param templatePath Path of the template file.
+ * @return CachedTemplate The parsed template and its environment.
+ * @throws std::exception If a file cannot be read or parsed.
+ */
+CachedTemplate loadTemplate(const std::string& templatePath) {
+    static std::mutex cacheMutex;
+    static std::unordered_map<std::string, CachedTemplate> cache;
+
+    std::filesystem::file_time_type modified = latestTemplateChange(templatePath);
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto cached = cache.find(templatePath);
+    if (cached != cache.end() && cached->second.modified == modified) {
+        return cached->second;
+    }
+
+    // Included templates are resolved relative to the including template and stored in the environment
+    auto env = std::make_shared<inja::Environment>();
+    auto parsed = std::make_shared<const inja::Template>(env->parse_template(templatePath));
+    CachedTemplate entry{modified, env, parsed};
+    cache[templatePath] = entry;
+    std::cout << "[CodeGen] Parsed template: " << templatePath << std::endl;
+    return entry;
+}
+
+/**
+ * @brief Renders a template file, using the template cache.
+ * @param templatePath Path of the template file.
+ * @param data Data for the template.
+ * @param out The stream receiving the rendered text.
+ * @throws std::exception If loading or rendering the template fails.
+ */
+void renderTemplate(const std::string& templatePath, const json& data, std::ostream& out) {
+    CachedTemplate cached = loadTemplate(templatePath);
+    cached.env->render_to(out, *cached.parsed, data);
+}
+
+/**
+ * @brief Renders the main template for an automaton.
+ * @param templatePath Path of the main template file.
+ * @param data The automaton's definition extended by add_codegen_data().
+ * @param out The stream receiving the generated code.
+ * @throws CodeGenerator::GenerationError If loading or rendering the template fails.
+ */
+void renderAutomaton(const std::string& templatePath, const json& data, std::ostream& out) {
+    try {
+        renderTemplate(templatePath, data, out);
+        if (!out) {
+            throw CodeGenerator::GenerationError("Failed to write the generated code.");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[CodeGen] Error processing template '" << templatePath << "': " << e.what() << std::endl;
+        throw CodeGenerator::GenerationError(std::string("Template processing failed: ") + e.what());
+    }
+}
+
+/**
+ * @brief Copies a saved automaton definition and adds the data the templates need (see add_codegen_data()).
+ * @param machineData The automaton's definition in the format written by JsonPersistence.
+ * @return json The extended copy.
+ * @throws CodeGenerator::GenerationError If the definition is malformed.
+ */
+json codegenData(const json& machineData) {
+    try {
+        json data = machineData;
+        add_codegen_data(data);
+        return data;
+    } catch (const std::exception& e) {
+        std::cerr << "[CodeGen] Error preparing the automaton definition: " << e.what() << std::endl;
+        throw CodeGenerator::GenerationError(std::string("Invalid automaton definition: ") + e.what());
+    }
+}
+
+/**
+ * @brief Builds the include guard of the shared header of a split build.
+ * @param baseName Base name of the generated files.
+ * @return std::string A valid preprocessor identifier.
+ */
+std::string includeGuard(const std::string& baseName) {
+    std::string guard = "AUTOMATON_";
+    for (char c : baseName) {
+        guard += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : '_';
+    }
+    return guard + "_H";
+}
+
+} // namespace
+
 /**
  * @brief Constructs a CodeGenerator instance.
  * @param templatePath The file path to the Inja template used for code generation.
@@ -61,21 +194,106 @@ std::string CodeGenerator::generate(const Machine& machine, const std::string& j
         throw GenerationError(std::string("JSON file reading failed: ") + e.what());
     }
 
-    //Load Template and Render using Inja
+    return generate(machine_data);
+}
+
+/**
+ * @brief Generates C++ source code for the automaton interpreter directly from the Machine.
+ * @param machine The Machine object to generate code for.
+ * @return std::string A string containing the generated C++ source code.
+ * @throws CodeGenerator::GenerationError If serializing the machine, loading or rendering the template fails.
+ */
+std::string CodeGenerator::generate(const Machine& machine) {
+    std::ostringstream out;
+    generate(machine, out);
+    return out.str();
+}
+
+/**
+ * @brief Generates C++ source code for the automaton interpreter directly from the Machine into a stream.
+ * @param machine The Machine object to generate code for.
+ * @param out The stream receiving the generated code.
+ * @throws CodeGenerator::GenerationError If serializing the machine, loading or rendering the template fails.
+ */
+void CodeGenerator::generate(const Machine& machine, std::ostream& out) {
+    std::cout << "[CodeGen] Starting code generation for machine: " << machine.getName() << std::endl;
+    json machine_data;
     try {
-        inja::Environment env; // Create an Inja environment
-        // Load and parse the template file
-        inja::Template code_template = env.parse_template(templateFilePath);
+        machine_data = machine; // to_json(json&, const Machine&)
+        add_codegen_data(machine_data);
+    } catch (const std::exception& e) {
+        std::cerr << "[CodeGen] Error serializing machine '" << machine.getName() << "': " << e.what() << std::endl;
+        throw GenerationError(std::string("Machine serialization failed: ") + e.what());
+    }
+    renderAutomaton(templateFilePath, machine_data, out);
+}
 
-        // Render the template using the parsed JSON data
-        std::cout << "[CodeGen] Rendering template..." << std::endl;
-        std::string generated_code = env.render(code_template, machine_data);
-        std::cout << "[CodeGen] Template rendered successfully." << std::endl;
+/**
+ * @brief Generates C++ source code for the automaton interpreter from an in-memory JSON definition.
+ * @param machine_data The automaton's definition in the format written by JsonPersistence.
+ * @return std::string A string containing the generated C++ source code.
+ * @throws CodeGenerator::GenerationError If loading or rendering the template fails.
+ */
+std::string CodeGenerator::generate(const json& machine_data) {
+    std::ostringstream out;
+    generate(machine_data, out);
+    return out.str();
+}
 
-        return generated_code; // Return the generated C++ code as a string
+/**
+ * @brief Renders the template with an in-memory JSON definition into a stream.
+ * @details Uses the process-wide template cache and only reads the template file when it changed,
+ *          so it is safe to call from a worker thread on a snapshot of the model.
+ * @param machine_data The automaton's definition in the format written by JsonPersistence.
+ * @param out The stream receiving the generated code.
+ * @throws CodeGenerator::GenerationError If loading or rendering the template fails.
+ */
+void CodeGenerator::generate(const json& machine_data, std::ostream& out) {
+    //Load Template and Render using Inja
+    renderAutomaton(templateFilePath, codegenData(machine_data), out);
+}
 
+/**
+ * @brief Generates the automaton as separate translation units.
+ * @details Renders the parts of the template separately: the declarations as a header with an
+ *          include guard, the core logic as one source file and the functions of every state as
+ *          one source file each. Every source file includes the header.
+ * @param machine_data The automaton's definition in the format written by JsonPersistence.
+ * @param baseName Base name of the generated files.
+ * @return std::vector<CodeGenerator::Unit> The header first, then the core, then one unit per state.
+ * @throws CodeGenerator::GenerationError If loading or rendering a template fails.
+ */
+std::vector<CodeGenerator::Unit> CodeGenerator::generateUnits(const json& machine_data, const std::string& baseName) {
+    const json data = codegenData(machine_data);
+    std::filesystem::path templateDir = std::filesystem::path(templateFilePath).parent_path();
+    auto partPath = [&templateDir](const char* name) { return (templateDir / name).string(); };
+    std::string headerName = baseName + ".h";
+    std::string includeLine = "#include \"" + headerName + "\"\n\n";
+
+    std::vector<Unit> units;
+    try {
+        std::ostringstream header;
+        std::string guard = includeGuard(baseName);
+        header << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+        renderTemplate(partPath(kDeclarationsTemplate), data, header);
+        header << "\n#endif // " << guard << "\n";
+        units.push_back(Unit{headerName, header.str()});
+
+        std::ostringstream core;
+        core << includeLine;
+        renderTemplate(partPath(kCoreTemplate), data, core);
+        units.push_back(Unit{baseName + "_core.cpp", core.str()});
+
+        for (const auto& state : data.at("states")) {
+            std::ostringstream unit;
+            unit << includeLine;
+            renderTemplate(partPath(kStateTemplate), json{{"state", state}}, unit);
+            units.push_back(Unit{baseName + "_" + state.at("func_id").get<std::string>() + ".cpp", unit.str()});
+        }
     } catch (const std::exception& e) {
-        std::cerr << "[CodeGen] Error processing template '" << templateFilePath << "': " << e.what() << std::endl;
+        std::cerr << "[CodeGen] Error generating translation units from '" << templateDir.string() << "': " << e.what() << std::endl;
         throw GenerationError(std::string("Template processing failed: ") + e.what());
     }
-}
\ No newline at end of file
+    std::cout << "[CodeGen] Generated " << units.size() << " files for " << baseName << std::endl;
+    return units;
+}
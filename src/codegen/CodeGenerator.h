@@ -10,6 +10,9 @@
 
 #include <string>
 #include <stdexcept>
+#include <iosfwd>
+#include <vector>
+#include "nlohmann/json_fwd.hpp"
 
 
 class Machine;
@@ -17,8 +20,10 @@ class Machine;
 /**
  * @brief Responsible for generating C++ interpreter code for a given automaton
  *        using the Inja templating engine.
- * @details Loads a template file, receives the automaton's definition via a JSON file path,
- *          and renders the final code by combining the template and the JSON data.
+ * @details Loads a template file, receives the automaton's definition (a Machine, its JSON
+ *          definition, or a JSON file path) and renders the final code by combining the template
+ *          and the JSON data. Parsed templates are cached process-wide and re-parsed only when the
+ *          template file changes.
  */
 class CodeGenerator {
 public:
@@ -49,9 +54,68 @@ public:
      * @throws GenerationError If an error occurs during template loading, JSON file reading/parsing,
      *         or template rendering.
      * @throws nlohmann::json::exception If JSON parsing fails (propagated from the nlohmann library).
+     * @note Prefer generate(const Machine&), which skips writing and re-parsing the JSON file.
      */
     std::string generate(const Machine& machine, const std::string& jsonDefinitionPath);
 
+    /**
+     * @brief Generates the C++ code for the specified automaton directly from the in-memory model.
+     * @param machine A constant reference to the Machine object, serialized with to_json().
+     * @return std::string The generated C++ code as a string.
+     * @throws GenerationError If an error occurs during serialization, template loading or rendering.
+     */
+    std::string generate(const Machine& machine);
+
+    /**
+     * @brief Generates the C++ code for the specified automaton and writes it to a stream.
+     * @param machine A constant reference to the Machine object, serialized with to_json().
+     * @param out The stream receiving the generated code.
+     * @throws GenerationError If an error occurs during serialization, template loading or rendering.
+     */
+    void generate(const Machine& machine, std::ostream& out);
+
+    /**
+     * @brief Generates the C++ code from an automaton definition already held in memory.
+     * @details Does not touch the Machine object or the file system (apart from the template),
+     *          so it can run on a worker thread against a snapshot of the model. The data only
+     *          the templates need is derived from a copy of the definition (add_codegen_data()).
+     * @param machineData The automaton's definition, as produced by to_json(json&, const Machine&).
+     * @return std::string The generated C++ code as a string.
+     * @throws GenerationError If an error occurs during template loading or rendering.
+     */
+    std::string generate(const nlohmann::json& machineData);
+
+    /**
+     * @brief Generates the C++ code from an automaton definition and writes it to a stream.
+     * @param machineData The automaton's definition, as produced by to_json(json&, const Machine&).
+     * @param out The stream receiving the generated code.
+     * @throws GenerationError If an error occurs during template loading or rendering.
+     */
+    void generate(const nlohmann::json& machineData, std::ostream& out);
+
+    /**
+     * @brief One generated file of a split build.
+     */
+    struct Unit {
+        /** @brief File name, without a directory. */
+        std::string fileName;
+        /** @brief Contents of the file. */
+        std::string code;
+    };
+
+    /**
+     * @brief Generates the automaton as a shared header, a core source file and one source file per state.
+     * @details Editing the action of a state or the guards of its transitions only changes that
+     *          state's source file, so a build system can recompile just that file and relink.
+     *          Uses the templates automaton_declarations.tpl, automaton_core.tpl and
+     *          automaton_state.tpl from the directory of the main template.
+     * @param machineData The automaton's definition, as produced by to_json(json&, const Machine&).
+     * @param baseName Base name of the files ("<base>.h", "<base>_core.cpp", "<base>_<action function>.cpp").
+     * @return std::vector<Unit> The header first, then the core, then one unit per state.
+     * @throws GenerationError If an error occurs during template loading or rendering.
+     */
+    std::vector<Unit> generateUnits(const nlohmann::json& machineData, const std::string& baseName);
+
     CodeGenerator(const CodeGenerator&) = delete;
     CodeGenerator& operator=(const CodeGenerator&) = delete;
     CodeGenerator(CodeGenerator&&) = delete;
@@ -0,0 +1,556 @@
+/**
+ * @file Expression.cpp
+ * @brief Implements the parser of the interpreter's expression language.
+ * @details The code is tokenized and parsed by recursive descent (following the precedence of
+ * the C++ operators) into a syntax tree, which is compiled to bytecode (see ExpressionBytecode.h).
+ * Names of variables, inputs and outputs are resolved to slots while parsing, so evaluation does
+ * no name lookups.
+ * @authors xsimonl00, xsiaket00
+ * @date Last modified: 2025-05-05
+ */
+
+#include "Expression.h"
+#include "ExpressionBytecode.h"
+#include <stdexcept>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+// --- Tokenizer ---
+
+enum class TokenKind { Number, String, Identifier, Punct, End };
+
+struct Token {
+    TokenKind kind;
+    std::string text;   // Identifier (with a "std::" prefix removed), punctuator, decoded string or number
+    std::size_t offset; // Position in the source, for error messages
+};
+
+std::vector<Token> tokenize(const std::string& source) {
+    static const char* const kPunctuators[] = {
+        "&&", "||", "==", "!=", "<=", ">=", "++", "--", "+=", "-=", "*=", "/=", "%=",
+        "+", "-", "*", "/", "%", "<", ">", "=", "!", "(", ")", "{", "}", ";", ",", "?", ":"
+    };
+    std::vector<Token> tokens;
+    std::size_t i = 0;
+    const std::size_t n = source.size();
+    auto fail = [&](const std::string& message) {
+        throw std::runtime_error(message + " at offset " + std::to_string(i) + ".");
+    };
+
+    while (i < n) {
+        unsigned char c = static_cast<unsigned char>(source[i]);
+        if (std::isspace(c)) {
+            ++i;
+        } else if (source.compare(i, 2, "//") == 0) {
+            i = source.find('\n', i);
+            if (i == std::string::npos) i = n;
+        } else if (source.compare(i, 2, "/*") == 0) {
+            std::size_t end = source.find("*/", i + 2);
+            if (end == std::string::npos) fail("Unterminated comment");
+            i = end + 2;
+        } else if (std::isdigit(c) || (c == '.' && i + 1 < n && std::isdigit(static_cast<unsigned char>(source[i + 1])))) {
+            std::size_t start = i;
+            if (source.compare(i, 2, "0x") == 0 || source.compare(i, 2, "0X") == 0) {
+                i += 2;
+                while (i < n && std::isxdigit(static_cast<unsigned char>(source[i]))) ++i;
+            } else {
+                while (i < n && (std::isdigit(static_cast<unsigned char>(source[i])) || source[i] == '.')) ++i;
+                if (i < n && (source[i] == 'e' || source[i] == 'E')) {
+                    ++i;
+                    if (i < n && (source[i] == '+' || source[i] == '-')) ++i;
+                    while (i < n && std::isdigit(static_cast<unsigned char>(source[i]))) ++i;
+                }
+            }
+            std::string text = source.substr(start, i - start);
+            // Suffixes: f makes a float, u/l do not change the value
+            while (i < n && source[i] != '\0' && std::strchr("fFuUlL", source[i])) {
+                if (source[i] == 'f' || source[i] == 'F') text += 'f';
+                ++i;
+            }
+            tokens.push_back({TokenKind::Number, text, start});
+        } else if (std::isalpha(c) || c == '_') {
+            std::size_t start = i;
+            std::string text;
+            for (;;) {
+                std::size_t wordStart = i;
+                while (i < n && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_')) ++i;
+                text += source.substr(wordStart, i - wordStart);
+                // Qualified name (std::stoi)
+                if (source.compare(i, 2, "::") == 0 && i + 2 < n &&
+                    (std::isalpha(static_cast<unsigned char>(source[i + 2])) || source[i + 2] == '_')) {
+                    text += "::";
+                    i += 2;
+                } else {
+                    break;
+                }
+            }
+            if (text.rfind("std::", 0) == 0) {
+                text.erase(0, 5);
+            }
+            tokens.push_back({TokenKind::Identifier, text, start});
+        } else if (c == '"') {
+            std::size_t start = i++;
+            std::string text;
+            while (i < n && source[i] != '"') {
+                char ch = source[i++];
+                if (ch == '\\' && i < n) {
+                    char escaped = source[i++];
+                    switch (escaped) {
+                        case 'n': ch = '\n'; break;
+                        case 't': ch = '\t'; break;
+                        case 'r': ch = '\r'; break;
+                        case '0': ch = '\0'; break;
+                        default: ch = escaped; break; // \" \\ \'
+                    }
+                }
+                text += ch;
+            }
+            if (i >= n) fail("Unterminated string literal");
+            ++i;
+            tokens.push_back({TokenKind::String, text, start});
+        } else {
+            const char* match = nullptr;
+            for (const char* punct : kPunctuators) {
+                if (source.compare(i, std::char_traits<char>::length(punct), punct) == 0) {
+                    match = punct;
+                    break;
+                }
+            }
+            if (!match) fail(std::string("Unsupported character '") + source[i] + "'");
+            tokens.push_back({TokenKind::Punct, match, i});
+            i += std::char_traits<char>::length(match);
+        }
+    }
+    tokens.push_back({TokenKind::End, "", n});
+    return tokens;
+}
+
+// --- Parser ---
+
+using NodePtr = std::unique_ptr<ExpressionNode>;
+
+class Parser {
+public:
+    Parser(const std::string& source, const ExpressionSymbols& symbols)
+        : tokens(tokenize(source)), symbols(symbols) {}
+
+    NodePtr parseExpressionOnly() {
+        NodePtr node = parseExpression();
+        if (peek().kind != TokenKind::End) fail("Unexpected '" + peek().text + "'");
+        return node;
+    }
+
+    std::vector<ExpressionStatement> parseStatements() {
+        std::vector<ExpressionStatement> statements;
+        while (peek().kind != TokenKind::End) {
+            statements.push_back(parseStatement());
+        }
+        return statements;
+    }
+
+private:
+    std::vector<Token> tokens;
+    const ExpressionSymbols& symbols;
+    std::size_t pos = 0;
+
+    const Token& peek() const { return tokens[pos]; }
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error(message + " at offset " + std::to_string(peek().offset) + ".");
+    }
+
+    bool accept(const char* punct) {
+        if (peek().kind == TokenKind::Punct && peek().text == punct) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool acceptKeyword(const char* keyword) {
+        if (peek().kind == TokenKind::Identifier && peek().text == keyword) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const char* punct) {
+        if (!accept(punct)) {
+            fail(std::string("Expected '") + punct + "'" +
+                 (peek().kind == TokenKind::End ? " at the end" : ", found '" + peek().text + "'"));
+        }
+    }
+
+    static NodePtr makeNode(ExpressionNodeKind kind, ExpressionOp op = ExpressionOp::None) {
+        NodePtr node = std::make_unique<ExpressionNode>();
+        node->kind = kind;
+        node->op = op;
+        return node;
+    }
+
+    static NodePtr makeBinary(ExpressionNodeKind kind, ExpressionOp op, NodePtr left, NodePtr right) {
+        NodePtr node = makeNode(kind, op);
+        node->operands.push_back(std::move(left));
+        node->operands.push_back(std::move(right));
+        return node;
+    }
+
+    ExpressionStatement parseStatement() {
+        ExpressionStatement statement;
+        if (accept(";")) {
+            return statement; // Empty statement
+        }
+        if (accept("{")) {
+            statement.kind = ExpressionStatement::Kind::Block;
+            while (!accept("}")) {
+                if (peek().kind == TokenKind::End) fail("Expected '}'");
+                statement.body.push_back(parseStatement());
+            }
+            return statement;
+        }
+        if (acceptKeyword("if")) {
+            statement.kind = ExpressionStatement::Kind::If;
+            expect("(");
+            statement.expression = parseExpression();
+            expect(")");
+            statement.body.push_back(parseStatement());
+            if (acceptKeyword("else")) {
+                statement.elseBody.push_back(parseStatement());
+            }
+            return statement;
+        }
+        statement.expression = parseExpression();
+        expect(";");
+        return statement;
+    }
+
+    // expression: assignment
+    NodePtr parseExpression() {
+        return parseAssignment();
+    }
+
+    // assignment: variable (= | += | -= | *= | /= | %=) assignment | conditional
+    NodePtr parseAssignment() {
+        NodePtr left = parseConditional();
+        static const std::pair<const char*, ExpressionOp> kAssignments[] = {
+            {"=", ExpressionOp::None}, {"+=", ExpressionOp::Add}, {"-=", ExpressionOp::Sub}, {"*=", ExpressionOp::Mul}, {"/=", ExpressionOp::Div}, {"%=", ExpressionOp::Mod}
+        };
+        for (const auto& [punct, op] : kAssignments) {
+            if (accept(punct)) {
+                if (left->kind != ExpressionNodeKind::Variable) fail("Only a variable can be assigned to");
+                NodePtr node = makeNode(ExpressionNodeKind::Assign, op);
+                node->slot = left->slot;
+                node->name = left->name;
+                node->operands.push_back(parseAssignment());
+                return node;
+            }
+        }
+        return left;
+    }
+
+    // conditional: logical-or (? expression : conditional)
+    NodePtr parseConditional() {
+        NodePtr condition = parseLogicalOr();
+        if (!accept("?")) {
+            return condition;
+        }
+        NodePtr node = makeNode(ExpressionNodeKind::Conditional);
+        node->operands.push_back(std::move(condition));
+        node->operands.push_back(parseExpression());
+        expect(":");
+        node->operands.push_back(parseConditional());
+        return node;
+    }
+
+    NodePtr parseLogicalOr() {
+        NodePtr left = parseLogicalAnd();
+        while (accept("||")) {
+            left = makeBinary(ExpressionNodeKind::Logical, ExpressionOp::Or, std::move(left), parseLogicalAnd());
+        }
+        return left;
+    }
+
+    NodePtr parseLogicalAnd() {
+        NodePtr left = parseEquality();
+        while (accept("&&")) {
+            left = makeBinary(ExpressionNodeKind::Logical, ExpressionOp::And, std::move(left), parseEquality());
+        }
+        return left;
+    }
+
+    NodePtr parseEquality() {
+        NodePtr left = parseRelational();
+        for (;;) {
+            if (accept("==")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::Equal, std::move(left), parseRelational());
+            else if (accept("!=")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::NotEqual, std::move(left), parseRelational());
+            else return left;
+        }
+    }
+
+    NodePtr parseRelational() {
+        NodePtr left = parseAdditive();
+        for (;;) {
+            if (accept("<=")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::LessEqual, std::move(left), parseAdditive());
+            else if (accept(">=")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::GreaterEqual, std::move(left), parseAdditive());
+            else if (accept("<")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::Less, std::move(left), parseAdditive());
+            else if (accept(">")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::Greater, std::move(left), parseAdditive());
+            else return left;
+        }
+    }
+
+    NodePtr parseAdditive() {
+        NodePtr left = parseMultiplicative();
+        for (;;) {
+            if (accept("+")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::Add, std::move(left), parseMultiplicative());
+            else if (accept("-")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::Sub, std::move(left), parseMultiplicative());
+            else return left;
+        }
+    }
+
+    NodePtr parseMultiplicative() {
+        NodePtr left = parseUnary();
+        for (;;) {
+            if (accept("*")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::Mul, std::move(left), parseUnary());
+            else if (accept("/")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::Div, std::move(left), parseUnary());
+            else if (accept("%")) left = makeBinary(ExpressionNodeKind::Binary, ExpressionOp::Mod, std::move(left), parseUnary());
+            else return left;
+        }
+    }
+
+    // unary: (! | - | +) unary | (++ | --) variable | postfix
+    NodePtr parseUnary() {
+        ExpressionOp op = ExpressionOp::None;
+        if (accept("!")) op = ExpressionOp::Not;
+        else if (accept("-")) op = ExpressionOp::Negate;
+        else if (accept("+")) op = ExpressionOp::Plus;
+        if (op != ExpressionOp::None) {
+            NodePtr node = makeNode(ExpressionNodeKind::Unary, op);
+            node->operands.push_back(parseUnary());
+            return node;
+        }
+        if (peek().kind == TokenKind::Punct && (peek().text == "++" || peek().text == "--")) {
+            ExpressionOp step = peek().text == "++" ? ExpressionOp::Add : ExpressionOp::Sub;
+            ++pos;
+            NodePtr target = parseUnary();
+            return makeIncrement(std::move(target), step, true);
+        }
+        return parsePostfix();
+    }
+
+    // postfix: primary (++ | --)?
+    NodePtr parsePostfix() {
+        NodePtr node = parsePrimary();
+        if (accept("++")) return makeIncrement(std::move(node), ExpressionOp::Add, false);
+        if (accept("--")) return makeIncrement(std::move(node), ExpressionOp::Sub, false);
+        return node;
+    }
+
+    NodePtr makeIncrement(NodePtr target, ExpressionOp step, bool prefix) {
+        if (target->kind != ExpressionNodeKind::Variable) fail("Only a variable can be incremented or decremented");
+        NodePtr node = makeNode(ExpressionNodeKind::Increment, step);
+        node->slot = target->slot;
+        node->name = target->name;
+        node->prefix = prefix;
+        return node;
+    }
+
+    NodePtr parsePrimary() {
+        const Token token = peek();
+        if (token.kind == TokenKind::Number) {
+            ++pos;
+            NodePtr node = makeNode(ExpressionNodeKind::Literal);
+            bool isFloat = token.text.find_first_of(".eEf") != std::string::npos &&
+                           token.text.rfind("0x", 0) != 0 && token.text.rfind("0X", 0) != 0;
+            try {
+                if (isFloat) node->literal = std::stod(token.text);
+                else node->literal = static_cast<long long>(std::stoull(token.text, nullptr, 0));
+            } catch (const std::exception&) {
+                fail("Invalid number '" + token.text + "'");
+            }
+            return node;
+        }
+        if (token.kind == TokenKind::String) {
+            ++pos;
+            NodePtr node = makeNode(ExpressionNodeKind::Literal);
+            node->literal = token.text;
+            return node;
+        }
+        if (accept("(")) {
+            NodePtr node = parseExpression();
+            expect(")");
+            return node;
+        }
+        if (token.kind == TokenKind::Identifier) {
+            ++pos;
+            if (token.text == "true" || token.text == "false") {
+                NodePtr node = makeNode(ExpressionNodeKind::Literal);
+                node->literal = token.text == "true";
+                return node;
+            }
+            if (accept("(")) {
+                return parseCall(token.text);
+            }
+            auto it = symbols.variables.find(token.text);
+            if (it == symbols.variables.end()) {
+                --pos;
+                fail("Unknown variable '" + token.text + "'");
+            }
+            NodePtr node = makeNode(ExpressionNodeKind::Variable);
+            node->slot = it->second;
+            node->name = token.text;
+            return node;
+        }
+        if (token.kind == TokenKind::End) fail("Unexpected end of the code");
+        fail("Unexpected '" + token.text + "'");
+    }
+
+    // Call of a supported function; the opening parenthesis has been consumed.
+    NodePtr parseCall(const std::string& name) {
+        static const std::map<std::string, std::pair<ExpressionFunction, std::size_t>> kFunctions = {
+            {"valueof", {ExpressionFunction::Valueof, 1}}, {"defined", {ExpressionFunction::Defined, 1}},
+            {"elapsed", {ExpressionFunction::Elapsed, 0}}, {"output", {ExpressionFunction::Output, 2}},
+            {"stoi", {ExpressionFunction::Stoll, 1}}, {"stol", {ExpressionFunction::Stoll, 1}}, {"stoll", {ExpressionFunction::Stoll, 1}},
+            {"atoi", {ExpressionFunction::Atoll, 1}}, {"atol", {ExpressionFunction::Atoll, 1}}, {"atoll", {ExpressionFunction::Atoll, 1}},
+            {"stof", {ExpressionFunction::Stod, 1}}, {"stod", {ExpressionFunction::Stod, 1}}, {"stold", {ExpressionFunction::Stod, 1}},
+            {"atof", {ExpressionFunction::Atof, 1}}, {"to_string", {ExpressionFunction::ToString, 1}}
+        };
+        auto function = kFunctions.find(name);
+        if (function == kFunctions.end()) {
+            pos -= 2;
+            fail("Unsupported function '" + name + "'");
+        }
+        NodePtr node = makeNode(ExpressionNodeKind::Call);
+        node->function = function->second.first;
+        std::size_t arity = function->second.second;
+
+        std::vector<NodePtr> arguments;
+        if (!accept(")")) {
+            do {
+                arguments.push_back(parseAssignment());
+            } while (accept(","));
+            expect(")");
+        }
+        if (arguments.size() != arity) {
+            fail("Function '" + name + "' takes " + std::to_string(arity) + " argument(s)");
+        }
+
+        // valueof/defined/output name an input or output; a literal name is resolved now.
+        bool namesInput = node->function == ExpressionFunction::Valueof || node->function == ExpressionFunction::Defined;
+        if ((namesInput || node->function == ExpressionFunction::Output) &&
+            arguments[0]->kind == ExpressionNodeKind::Literal && std::holds_alternative<std::string>(arguments[0]->literal)) {
+            node->name = std::get<std::string>(arguments[0]->literal);
+            const auto& slots = namesInput ? symbols.inputs : symbols.outputs;
+            auto slot = slots.find(node->name);
+            node->slot = slot != slots.end() ? slot->second : -1;
+            arguments.erase(arguments.begin());
+        }
+        node->operands = std::move(arguments);
+        return node;
+    }
+};
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+} // namespace
+
+// --- Values ---
+
+std::string valueToString(const Value& value) {
+    if (const std::string* text = std::get_if<std::string>(&value)) return *text;
+    if (const long long* i = std::get_if<long long>(&value)) return std::to_string(*i);
+    if (const bool* b = std::get_if<bool>(&value)) return *b ? "1" : "0";
+    std::ostringstream stream;
+    stream << std::get<double>(value);
+    return stream.str();
+}
+
+bool valueToBool(const Value& value) {
+    if (const bool* b = std::get_if<bool>(&value)) return *b;
+    if (const long long* i = std::get_if<long long>(&value)) return *i != 0;
+    if (const double* d = std::get_if<double>(&value)) return *d != 0.0;
+    return !std::get<std::string>(value).empty();
+}
+
+Value parseVariableValue(const std::string& text, const std::string& typeHint) {
+    std::string type = lowercase(typeHint);
+    std::string trimmed = text;
+    trimmed.erase(0, trimmed.find_first_not_of(" \t\r\n"));
+    trimmed.erase(trimmed.find_last_not_of(" \t\r\n") + 1);
+
+    if (type.find("string") != std::string::npos) {
+        return text;
+    }
+    if (type.find("bool") != std::string::npos) {
+        std::string lower = lowercase(trimmed);
+        if (lower == "true" || lower == "1") return true;
+        if (lower == "false" || lower == "0" || lower.empty()) return false;
+        throw std::runtime_error("Invalid bool value '" + text + "'");
+    }
+    bool isFloatType = type.find("float") != std::string::npos || type.find("double") != std::string::npos;
+    bool isIntegerType = !isFloatType && (type.find("int") != std::string::npos || type.find("long") != std::string::npos ||
+                                          type.find("short") != std::string::npos || type.find("unsigned") != std::string::npos ||
+                                          type.find("size_t") != std::string::npos);
+    if (trimmed.empty() && (isFloatType || isIntegerType)) {
+        return isFloatType ? Value(0.0) : Value(0LL);
+    }
+    // A number in full, as the generated code would read it
+    std::size_t processed = 0;
+    try {
+        if (isIntegerType || (!isFloatType && trimmed.find_first_of(".eE") == std::string::npos)) {
+            long long integer = std::stoll(trimmed, &processed, 0);
+            if (processed == trimmed.size()) return integer;
+        } else {
+            double number = std::stod(trimmed, &processed);
+            if (processed == trimmed.size()) return number;
+        }
+    } catch (const std::exception&) {
+        // Falls through
+    }
+    if (isFloatType || isIntegerType) {
+        throw std::runtime_error("Invalid " + typeHint + " value '" + text + "'");
+    }
+    return text;
+}
+
+// --- Expression ---
+
+Expression Expression::parse(const std::string& source, const ExpressionSymbols& symbols) {
+    Expression expression;
+    expression.code = std::make_shared<const ExpressionBytecode>(compileExpression(*Parser(source, symbols).parseExpressionOnly()));
+    return expression;
+}
+
+Value Expression::evaluate(ExpressionEnvironment& environment) const {
+    if (!code) {
+        return true; // No guard
+    }
+    return runBytecode(*code, environment);
+}
+
+bool Expression::empty() const {
+    return !code;
+}
+
+// --- ActionProgram ---
+
+ActionProgram ActionProgram::parse(const std::string& source, const ExpressionSymbols& symbols) {
+    ActionProgram program;
+    program.code = std::make_shared<const ExpressionBytecode>(compileStatements(Parser(source, symbols).parseStatements()));
+    return program;
+}
+
+void ActionProgram::execute(ExpressionEnvironment& environment) const {
+    if (code) {
+        runBytecode(*code, environment);
+    }
+}
@@ -0,0 +1,181 @@
+/**
+ * @file Expression.h
+ * @brief Declares the expression language used by the in-process interpreter of the automaton.
+ * @details The actions, guards and delays of a machine are C++ snippets which the code generator
+ * pastes into the generated program. The interpreter (Machine::start(), Machine::step()) understands
+ * the subset of C++ these snippets are normally written in: integer, floating point, boolean and
+ * string values, the variables of the machine, arithmetic, comparison and logical operators,
+ * assignments, increments, if/else, blocks and the functions valueof(), defined(), elapsed(),
+ * output(), the std::sto* / ato* conversions and std::to_string(). Anything else is reported
+ * as an error when the machine is started, and the machine has to be compiled to run.
+ * Parsed code is compiled to bytecode for a small register-based virtual machine, so that guards
+ * and actions evaluated on every event do not walk a syntax tree.
+ * @authors xsimonl00, xsiaket00
+ * @date Last modified: 2025-05-05
+ */
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <variant>
+
+/**
+ * @brief Value of a variable or of an evaluated expression.
+ * @details Integers are kept as long long and floating point numbers as double, following the
+ * usual arithmetic conversions of C++ (integer operations stay integral).
+ */
+using Value = std::variant<long long, double, bool, std::string>;
+
+/**
+ * @brief Converts a value to the text the generated code would print for it (as with std::ostream).
+ * @param value The value to convert.
+ * @return std::string The text of the value; a boolean is printed as 1 or 0.
+ */
+std::string valueToString(const Value& value);
+
+/**
+ * @brief Converts a value to a boolean (a number is true when not zero, a string when not empty).
+ * @param value The value to convert.
+ * @return bool The truth value.
+ */
+bool valueToBool(const Value& value);
+
+/**
+ * @brief Parses the initial value of a variable according to its type hint.
+ * @details int/long/short/unsigned give an integer, float/double a floating point number, bool a boolean
+ * and string a string. Without a known type hint the text is read as an integer, a floating point
+ * number or (if it is neither) a string.
+ * @param text The value as stored in the model.
+ * @param typeHint The type hint of the variable.
+ * @return Value The parsed value.
+ * @throws std::runtime_error if the text is not a valid value of a numeric type.
+ */
+Value parseVariableValue(const std::string& text, const std::string& typeHint);
+
+/**
+ * @brief Names the expressions can refer to, resolved to slots when an expression is parsed.
+ * @details The slot of a name is its position in the container of the environment (see ExpressionEnvironment).
+ */
+struct ExpressionSymbols {
+    /** @brief Variables by name. */
+    std::map<std::string, int> variables;
+    /** @brief Inputs by name. */
+    std::map<std::string, int> inputs;
+    /** @brief Outputs by name. */
+    std::map<std::string, int> outputs;
+};
+
+/**
+ * @brief The state an expression is evaluated against.
+ * @details Implemented by the interpreter. A slot of -1 stands for a name that is not declared in the
+ * machine (or is not a literal), the environment then looks it up by name.
+ */
+class ExpressionEnvironment {
+public:
+    virtual ~ExpressionEnvironment() = default;
+
+    /**
+     * @brief Accesses the value of a variable.
+     * @param slot The slot of the variable in ExpressionSymbols::variables.
+     * @return Value& The value, which assignments overwrite.
+     */
+    virtual Value& variable(int slot) = 0;
+
+    /**
+     * @brief Gets the last value received on an input.
+     * @param slot The slot of the input, or -1.
+     * @param name The name of the input.
+     * @return const std::string* The value, or nullptr if no value has been received yet.
+     */
+    virtual const std::string* inputValue(int slot, const std::string& name) const = 0;
+
+    /**
+     * @brief Gets the time spent in the current state.
+     * @return long long Milliseconds since the current state was entered.
+     */
+    virtual long long elapsedMs() const = 0;
+
+    /**
+     * @brief Sends a value to an output.
+     * @param slot The slot of the output, or -1.
+     * @param name The name of the output.
+     * @param value The value to send.
+     */
+    virtual void output(int slot, const std::string& name, const Value& value) = 0;
+};
+
+struct ExpressionBytecode;
+
+/**
+ * @brief A parsed guard or delay expression.
+ */
+class Expression {
+public:
+    /**
+     * @brief Constructs an empty expression (a transition without a guard).
+     */
+    Expression() = default;
+
+    /**
+     * @brief Parses an expression.
+     * @param source The text of the expression.
+     * @param symbols The names the expression can refer to.
+     * @return Expression The parsed expression.
+     * @throws std::runtime_error if the text is not a valid expression of the supported subset.
+     */
+    static Expression parse(const std::string& source, const ExpressionSymbols& symbols);
+
+    /**
+     * @brief Evaluates the expression.
+     * @param environment The state the expression is evaluated against.
+     * @return Value The result.
+     * @throws std::runtime_error on an invalid operation (e.g. division by zero, string arithmetic).
+     */
+    Value evaluate(ExpressionEnvironment& environment) const;
+
+    /**
+     * @brief Checks whether the expression is empty.
+     * @return bool True if nothing has been parsed into it.
+     */
+    bool empty() const;
+
+private:
+    /**
+     * @brief The compiled expression, shared by the copies of the expression.
+     */
+    std::shared_ptr<const ExpressionBytecode> code;
+};
+
+/**
+ * @brief A parsed state action (a sequence of statements).
+ */
+class ActionProgram {
+public:
+    /**
+     * @brief Parses the statements of an action.
+     * @param source The code of the action.
+     * @param symbols The names the action can refer to.
+     * @return ActionProgram The parsed action.
+     * @throws std::runtime_error if the code is not valid in the supported subset.
+     */
+    static ActionProgram parse(const std::string& source, const ExpressionSymbols& symbols);
+
+    /**
+     * @brief Executes the action.
+     * @param environment The state the action works on.
+     * @throws std::runtime_error on an invalid operation; the statements before it keep their effect.
+     */
+    void execute(ExpressionEnvironment& environment) const;
+
+private:
+    /**
+     * @brief The compiled statements of the action, shared by the copies of the program.
+     */
+    std::shared_ptr<const ExpressionBytecode> code;
+};
+
+#endif // EXPRESSION_H
@@ -0,0 +1,642 @@
+/**
+ * @file ExpressionBytecode.cpp
+ * @brief Implements the bytecode compiler and the virtual machine of the interpreter's expression language.
+ * @details Every node of the syntax tree is compiled to instructions which leave its value in a
+ * register: a node evaluated into register r keeps its operands in r and r + 1, so the number of
+ * registers is the depth of the tree. A literal right operand is read from the constants by the
+ * operation itself. Short-circuit operators, ?: and if/else become jumps.
+ * The virtual machine is a loop over the instructions with a switch, taking a fast path for
+ * the integer operands of arithmetic and comparisons.
+ * @authors xsimonl00, xsiaket00
+ * @date Last modified: 2025-05-05
+ */
+
+#include "ExpressionBytecode.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// --- Operations on values ---
+
+[[noreturn]] void evaluationError(const std::string& message) {
+    throw std::runtime_error(message);
+}
+
+bool isNumeric(const Value& value) {
+    return !std::holds_alternative<std::string>(value);
+}
+
+bool isFloat(const Value& value) {
+    return std::holds_alternative<double>(value);
+}
+
+long long toInteger(const Value& value) {
+    if (const long long* i = std::get_if<long long>(&value)) return *i;
+    if (const bool* b = std::get_if<bool>(&value)) return *b ? 1 : 0;
+    if (const double* d = std::get_if<double>(&value)) return static_cast<long long>(*d);
+    evaluationError("A string is used as a number");
+}
+
+double toDouble(const Value& value) {
+    if (const double* d = std::get_if<double>(&value)) return *d;
+    return static_cast<double>(toInteger(value));
+}
+
+// Reads two integer operands, for the fast path of the virtual machine.
+inline bool integerOperands(const Value& left, const Value& right, long long& a, long long& b) {
+    const long long* x = std::get_if<long long>(&left);
+    const long long* y = std::get_if<long long>(&right);
+    if (!x || !y) {
+        return false;
+    }
+    a = *x;
+    b = *y;
+    return true;
+}
+
+Value arithmetic(ExpressionOp op, const Value& left, const Value& right) {
+    if (!isNumeric(left) || !isNumeric(right)) {
+        if (op == ExpressionOp::Add && !isNumeric(left) && !isNumeric(right)) {
+            return std::get<std::string>(left) + std::get<std::string>(right);
+        }
+        evaluationError("Invalid operands of an arithmetic operator (string and number)");
+    }
+    if (isFloat(left) || isFloat(right)) {
+        double a = toDouble(left), b = toDouble(right);
+        switch (op) {
+            case ExpressionOp::Add: return a + b;
+            case ExpressionOp::Sub: return a - b;
+            case ExpressionOp::Mul: return a * b;
+            case ExpressionOp::Div: return a / b;
+            default: evaluationError("Operator % needs integer operands");
+        }
+    }
+    long long a = toInteger(left), b = toInteger(right);
+    switch (op) {
+        case ExpressionOp::Add: return a + b;
+        case ExpressionOp::Sub: return a - b;
+        case ExpressionOp::Mul: return a * b;
+        case ExpressionOp::Div:
+            if (b == 0) evaluationError("Division by zero");
+            return a / b;
+        case ExpressionOp::Mod:
+            if (b == 0) evaluationError("Division by zero");
+            return a % b;
+        default: evaluationError("Invalid arithmetic operator");
+    }
+}
+
+bool compare(ExpressionOp op, const Value& left, const Value& right) {
+    int order;
+    if (!isNumeric(left) && !isNumeric(right)) {
+        order = std::get<std::string>(left).compare(std::get<std::string>(right));
+    } else if (isNumeric(left) && isNumeric(right)) {
+        if (isFloat(left) || isFloat(right)) {
+            double a = toDouble(left), b = toDouble(right);
+            order = a < b ? -1 : (a > b ? 1 : 0);
+        } else {
+            long long a = toInteger(left), b = toInteger(right);
+            order = a < b ? -1 : (a > b ? 1 : 0);
+        }
+    } else {
+        evaluationError("Invalid operands of a comparison (string and number)");
+    }
+    switch (op) {
+        case ExpressionOp::Less: return order < 0;
+        case ExpressionOp::LessEqual: return order <= 0;
+        case ExpressionOp::Greater: return order > 0;
+        case ExpressionOp::GreaterEqual: return order >= 0;
+        case ExpressionOp::Equal: return order == 0;
+        default: return order != 0;
+    }
+}
+
+// The operator of a binary operation (the register or the constant form).
+ExpressionOp binaryOperator(OpCode op) {
+    static const ExpressionOp kOperators[] = {
+        ExpressionOp::Add, ExpressionOp::Sub, ExpressionOp::Mul, ExpressionOp::Div, ExpressionOp::Mod,
+        ExpressionOp::Less, ExpressionOp::LessEqual, ExpressionOp::Greater,
+        ExpressionOp::GreaterEqual, ExpressionOp::Equal, ExpressionOp::NotEqual
+    };
+    constexpr int kCount = sizeof(kOperators) / sizeof(kOperators[0]);
+    return kOperators[(static_cast<int>(op) - static_cast<int>(OpCode::Add)) % kCount];
+}
+
+// Arithmetic of the virtual machine, with a fast path for integer operands.
+inline Value arithmeticFast(ExpressionOp op, const Value& left, const Value& right) {
+    long long a, b;
+    if (integerOperands(left, right, a, b)) {
+        switch (op) {
+            case ExpressionOp::Add: return a + b;
+            case ExpressionOp::Sub: return a - b;
+            case ExpressionOp::Mul: return a * b;
+            case ExpressionOp::Div: if (b != 0) return a / b; break;
+            case ExpressionOp::Mod: if (b != 0) return a % b; break;
+            default: break;
+        }
+    }
+    return arithmetic(op, left, right);
+}
+
+// Comparison of the virtual machine, with a fast path for integer operands.
+inline bool compareFast(ExpressionOp op, const Value& left, const Value& right) {
+    long long a, b;
+    if (!integerOperands(left, right, a, b)) {
+        return compare(op, left, right);
+    }
+    switch (op) {
+        case ExpressionOp::Less: return a < b;
+        case ExpressionOp::LessEqual: return a <= b;
+        case ExpressionOp::Greater: return a > b;
+        case ExpressionOp::GreaterEqual: return a >= b;
+        case ExpressionOp::Equal: return a == b;
+        default: return a != b;
+    }
+}
+
+// Converts the result of an assignment to the type of the variable, as C++ does.
+Value convertForAssignment(const Value& current, Value value, const std::string& name) {
+    if (current.index() == value.index()) {
+        return value;
+    }
+    if (std::holds_alternative<std::string>(current) || std::holds_alternative<std::string>(value)) {
+        evaluationError("Cannot assign between a string and a number (variable '" + name + "')");
+    }
+    if (std::holds_alternative<long long>(current)) return toInteger(value);
+    if (std::holds_alternative<double>(current)) return toDouble(value);
+    return valueToBool(value);
+}
+
+std::string stringArgument(const Value& value, const char* function) {
+    if (const std::string* text = std::get_if<std::string>(&value)) return *text;
+    evaluationError(std::string(function) + " needs a string argument");
+}
+
+// Converts text to a number as the std::sto* / ato* function of the operation does.
+Value convertText(OpCode op, const Value& argument) {
+    if (isNumeric(argument)) {
+        return op == OpCode::Stoll || op == OpCode::Atoll ? Value(toInteger(argument)) : Value(toDouble(argument));
+    }
+    const std::string& text = std::get<std::string>(argument);
+    switch (op) {
+        case OpCode::Stoll:
+            try {
+                return std::stoll(text);
+            } catch (const std::exception&) {
+                evaluationError("stoi: invalid number '" + text + "'");
+            }
+        case OpCode::Stod:
+            try {
+                return std::stod(text);
+            } catch (const std::exception&) {
+                evaluationError("stod: invalid number '" + text + "'");
+            }
+        case OpCode::Atoll:
+            return std::atoll(text.c_str());
+        default:
+            return std::atof(text.c_str());
+    }
+}
+
+// --- Compiler ---
+
+class Compiler {
+public:
+    ExpressionBytecode compileExpression(const ExpressionNode& root) {
+        compileNode(root, 0);
+        emit(OpCode::Return, 0);
+        return std::move(program);
+    }
+
+    ExpressionBytecode compileStatements(const std::vector<ExpressionStatement>& statements) {
+        useRegister(0);
+        compileBlock(statements);
+        emit(OpCode::Halt);
+        return std::move(program);
+    }
+
+private:
+    ExpressionBytecode program;
+    std::map<std::string, std::uint16_t> nameIndices;
+
+    static std::uint16_t operand(std::size_t value, const char* what) {
+        if (value > std::numeric_limits<std::uint16_t>::max()) {
+            throw std::runtime_error(std::string("The code is too large to compile (too many ") + what + ")");
+        }
+        return static_cast<std::uint16_t>(value);
+    }
+
+    std::size_t emit(OpCode op, std::uint16_t a = 0, std::uint16_t b = 0, std::uint16_t c = 0) {
+        program.code.push_back(Instruction{op, a, b, c});
+        return program.code.size() - 1;
+    }
+
+    // Points the jump at the given index to the next instruction.
+    void patchJump(std::size_t jump) {
+        program.code[jump].b = operand(program.code.size(), "instructions");
+    }
+
+    std::uint16_t useRegister(std::size_t index) {
+        std::uint16_t reg = operand(index, "nested operations");
+        if (reg >= program.registerCount) {
+            program.registerCount = operand(index + 1, "nested operations");
+        }
+        return reg;
+    }
+
+    std::uint16_t constant(const Value& value) {
+        program.constants.push_back(value);
+        return operand(program.constants.size() - 1, "literals");
+    }
+
+    std::uint16_t name(const std::string& text) {
+        auto found = nameIndices.find(text);
+        if (found != nameIndices.end()) {
+            return found->second;
+        }
+        program.names.push_back(text);
+        std::uint16_t index = operand(program.names.size() - 1, "names");
+        nameIndices.emplace(text, index);
+        return index;
+    }
+
+    // Slot of a variable (always declared).
+    static std::uint16_t variableSlot(const ExpressionNode& node) {
+        return operand(static_cast<std::size_t>(node.slot), "variables");
+    }
+
+    // Slot of an input or output plus one, 0 if it is not declared.
+    static std::uint16_t ioSlot(const ExpressionNode& node) {
+        return operand(static_cast<std::size_t>(node.slot + 1), "inputs or outputs");
+    }
+
+    // The operation of a binary operator, in the constant form if the right operand is a literal.
+    static OpCode binaryOpCode(ExpressionOp op, bool constantOperand) {
+        static const ExpressionOp kOperators[] = {
+            ExpressionOp::Add, ExpressionOp::Sub, ExpressionOp::Mul, ExpressionOp::Div, ExpressionOp::Mod,
+            ExpressionOp::Less, ExpressionOp::LessEqual, ExpressionOp::Greater,
+            ExpressionOp::GreaterEqual, ExpressionOp::Equal, ExpressionOp::NotEqual
+        };
+        int index = static_cast<int>(std::find(std::begin(kOperators), std::end(kOperators), op) - std::begin(kOperators));
+        OpCode first = constantOperand ? OpCode::AddK : OpCode::Add;
+        return static_cast<OpCode>(static_cast<int>(first) + index);
+    }
+
+    // Checks whether a node always gives a boolean, which needs no conversion in && and ||.
+    static bool isBoolean(const ExpressionNode& node) {
+        switch (node.kind) {
+            case ExpressionNodeKind::Binary:
+                return node.op != ExpressionOp::Add && node.op != ExpressionOp::Sub && node.op != ExpressionOp::Mul &&
+                       node.op != ExpressionOp::Div && node.op != ExpressionOp::Mod;
+            case ExpressionNodeKind::Logical:
+                return true;
+            case ExpressionNodeKind::Unary:
+                return node.op == ExpressionOp::Not;
+            case ExpressionNodeKind::Call:
+                return node.function == ExpressionFunction::Defined;
+            case ExpressionNodeKind::Literal:
+                return std::holds_alternative<bool>(node.literal);
+            default:
+                return false;
+        }
+    }
+
+    // Compiles a binary operation of register target and an operand.
+    void compileBinary(ExpressionOp op, std::size_t target, const ExpressionNode& right) {
+        std::uint16_t reg = useRegister(target);
+        if (right.kind == ExpressionNodeKind::Literal) {
+            emit(binaryOpCode(op, true), reg, reg, constant(right.literal));
+            return;
+        }
+        compileNode(right, target + 1);
+        emit(binaryOpCode(op, false), reg, reg, useRegister(target + 1));
+    }
+
+    // Compiles a node to instructions which leave its value in register target.
+    void compileNode(const ExpressionNode& node, std::size_t target) {
+        std::uint16_t reg = useRegister(target);
+        switch (node.kind) {
+            case ExpressionNodeKind::Literal:
+                emit(OpCode::LoadConst, reg, constant(node.literal));
+                break;
+            case ExpressionNodeKind::Variable:
+                emit(OpCode::LoadVar, reg, variableSlot(node));
+                break;
+            case ExpressionNodeKind::Unary:
+                compileNode(*node.operands[0], target);
+                emit(node.op == ExpressionOp::Not ? OpCode::Not
+                     : node.op == ExpressionOp::Negate ? OpCode::Negate : OpCode::Plus, reg, reg);
+                break;
+            case ExpressionNodeKind::Binary:
+                compileNode(*node.operands[0], target);
+                compileBinary(node.op, target, *node.operands[1]);
+                break;
+            case ExpressionNodeKind::Logical: {
+                compileNode(*node.operands[0], target);
+                if (!isBoolean(*node.operands[0])) {
+                    emit(OpCode::ToBool, reg, reg);
+                }
+                std::size_t shortCircuit = emit(node.op == ExpressionOp::And ? OpCode::JumpIfFalse : OpCode::JumpIfTrue, reg);
+                compileNode(*node.operands[1], target);
+                if (!isBoolean(*node.operands[1])) {
+                    emit(OpCode::ToBool, reg, reg);
+                }
+                patchJump(shortCircuit);
+                break;
+            }
+            case ExpressionNodeKind::Conditional: {
+                compileNode(*node.operands[0], target);
+                std::size_t toElse = emit(OpCode::JumpIfFalse, reg);
+                compileNode(*node.operands[1], target);
+                std::size_t toEnd = emit(OpCode::Jump);
+                patchJump(toElse);
+                compileNode(*node.operands[2], target);
+                patchJump(toEnd);
+                break;
+            }
+            case ExpressionNodeKind::Assign:
+                if (node.op != ExpressionOp::None && node.operands[0]->kind == ExpressionNodeKind::Literal) {
+                    emit(OpCode::LoadVar, reg, variableSlot(node));
+                    compileBinary(node.op, target, *node.operands[0]);
+                } else if (node.op != ExpressionOp::None) {
+                    // Compound assignment: the value is evaluated before the variable is read
+                    compileNode(*node.operands[0], target);
+                    std::uint16_t current = useRegister(target + 1);
+                    emit(OpCode::LoadVar, current, variableSlot(node));
+                    emit(binaryOpCode(node.op, false), reg, current, reg);
+                } else {
+                    compileNode(*node.operands[0], target);
+                }
+                emit(OpCode::StoreVar, reg, variableSlot(node), name(node.name));
+                break;
+            case ExpressionNodeKind::Increment:
+                emit(node.op == ExpressionOp::Add ? (node.prefix ? OpCode::PreInc : OpCode::PostInc)
+                                                  : (node.prefix ? OpCode::PreDec : OpCode::PostDec),
+                     reg, variableSlot(node), name(node.name));
+                break;
+            case ExpressionNodeKind::Call:
+                compileCall(node, target);
+                break;
+        }
+    }
+
+    void compileCall(const ExpressionNode& node, std::size_t target) {
+        std::uint16_t reg = useRegister(target);
+        bool literalName = !node.name.empty();
+        switch (node.function) {
+            case ExpressionFunction::Valueof:
+            case ExpressionFunction::Defined: {
+                bool valueof = node.function == ExpressionFunction::Valueof;
+                if (literalName) {
+                    emit(valueof ? OpCode::Valueof : OpCode::Defined, reg, ioSlot(node), name(node.name));
+                } else {
+                    compileNode(*node.operands[0], target);
+                    emit(valueof ? OpCode::ValueofName : OpCode::DefinedName, reg);
+                }
+                break;
+            }
+            case ExpressionFunction::Elapsed:
+                emit(OpCode::Elapsed, reg);
+                break;
+            case ExpressionFunction::Output:
+                if (literalName) {
+                    compileNode(*node.operands[0], target);
+                    emit(OpCode::Output, reg, ioSlot(node), name(node.name));
+                } else {
+                    compileNode(*node.operands[0], target);
+                    compileNode(*node.operands[1], target + 1);
+                    emit(OpCode::OutputName, reg, useRegister(target + 1));
+                }
+                break;
+            default: {
+                compileNode(*node.operands[0], target);
+                OpCode op = node.function == ExpressionFunction::Stoll ? OpCode::Stoll
+                          : node.function == ExpressionFunction::Atoll ? OpCode::Atoll
+                          : node.function == ExpressionFunction::Stod ? OpCode::Stod
+                          : node.function == ExpressionFunction::Atof ? OpCode::Atof : OpCode::ToString;
+                emit(op, reg, reg);
+                break;
+            }
+        }
+    }
+
+    void compileBlock(const std::vector<ExpressionStatement>& statements) {
+        for (const ExpressionStatement& statement : statements) {
+            switch (statement.kind) {
+                case ExpressionStatement::Kind::Expression:
+                    if (statement.expression) {
+                        compileNode(*statement.expression, 0);
+                    }
+                    break;
+                case ExpressionStatement::Kind::Block:
+                    compileBlock(statement.body);
+                    break;
+                case ExpressionStatement::Kind::If: {
+                    compileNode(*statement.expression, 0);
+                    std::size_t toElse = emit(OpCode::JumpIfFalse, 0);
+                    compileBlock(statement.body);
+                    if (statement.elseBody.empty()) {
+                        patchJump(toElse);
+                        break;
+                    }
+                    std::size_t toEnd = emit(OpCode::Jump);
+                    patchJump(toElse);
+                    compileBlock(statement.elseBody);
+                    patchJump(toEnd);
+                    break;
+                }
+            }
+        }
+    }
+};
+
+// The registers of the running programs. A program can run while another one is in output()
+// (when a handler evaluates an expression), so each run takes a frame on top of the stack. The
+// values above the top are kept, so that a run does not construct and destroy its registers.
+struct RegisterStack {
+    std::vector<Value> values;
+    std::size_t top = 0;
+};
+
+// Gives the registers of a finished program back to the register stack.
+struct RegisterFrame {
+    RegisterStack& stack;
+    std::size_t base;
+    ~RegisterFrame() { stack.top = base; }
+};
+
+} // namespace
+
+ExpressionBytecode compileExpression(const ExpressionNode& root) {
+    return Compiler().compileExpression(root);
+}
+
+ExpressionBytecode compileStatements(const std::vector<ExpressionStatement>& statements) {
+    return Compiler().compileStatements(statements);
+}
+
+Value runBytecode(const ExpressionBytecode& bytecode, ExpressionEnvironment& environment) {
+    thread_local RegisterStack registerStack;
+    RegisterFrame frame{registerStack, registerStack.top};
+    registerStack.top = frame.base + bytecode.registerCount;
+    if (registerStack.values.size() < registerStack.top) {
+        registerStack.values.resize(registerStack.top);
+    }
+    Value* r = registerStack.values.data() + frame.base;
+
+    const Instruction* code = bytecode.code.data();
+    std::size_t pc = 0;
+    for (;;) {
+        const Instruction& instruction = code[pc++];
+        const std::uint16_t a = instruction.a, b = instruction.b, c = instruction.c;
+        switch (instruction.op) {
+            case OpCode::LoadConst:
+                r[a] = bytecode.constants[b];
+                break;
+            case OpCode::LoadVar:
+                r[a] = environment.variable(b);
+                break;
+            case OpCode::StoreVar: {
+                Value& variable = environment.variable(b);
+                variable = convertForAssignment(variable, std::move(r[a]), bytecode.names[c]);
+                r[a] = variable;
+                break;
+            }
+            case OpCode::Add:
+            case OpCode::Sub:
+            case OpCode::Mul:
+            case OpCode::Div:
+            case OpCode::Mod:
+                r[a] = arithmeticFast(binaryOperator(instruction.op), r[b], r[c]);
+                break;
+            case OpCode::AddK:
+            case OpCode::SubK:
+            case OpCode::MulK:
+            case OpCode::DivK:
+            case OpCode::ModK:
+                r[a] = arithmeticFast(binaryOperator(instruction.op), r[b], bytecode.constants[c]);
+                break;
+            case OpCode::Less:
+            case OpCode::LessEqual:
+            case OpCode::Greater:
+            case OpCode::GreaterEqual:
+            case OpCode::Equal:
+            case OpCode::NotEqual:
+                r[a] = compareFast(binaryOperator(instruction.op), r[b], r[c]);
+                break;
+            case OpCode::LessK:
+            case OpCode::LessEqualK:
+            case OpCode::GreaterK:
+            case OpCode::GreaterEqualK:
+            case OpCode::EqualK:
+            case OpCode::NotEqualK:
+                r[a] = compareFast(binaryOperator(instruction.op), r[b], bytecode.constants[c]);
+                break;
+            case OpCode::Not:
+                r[a] = !valueToBool(r[b]);
+                break;
+            case OpCode::Negate:
+            case OpCode::Plus: {
+                const Value& operand = r[b];
+                if (!isNumeric(operand)) evaluationError("A string is used as a number");
+                bool negate = instruction.op == OpCode::Negate;
+                if (isFloat(operand)) {
+                    r[a] = negate ? -toDouble(operand) : toDouble(operand);
+                } else {
+                    r[a] = negate ? -toInteger(operand) : toInteger(operand);
+                }
+                break;
+            }
+            case OpCode::ToBool:
+                r[a] = valueToBool(r[b]);
+                break;
+            case OpCode::PreInc:
+            case OpCode::PreDec:
+            case OpCode::PostInc:
+            case OpCode::PostDec: {
+                Value& variable = environment.variable(b);
+                if (!isNumeric(variable) || std::holds_alternative<bool>(variable)) {
+                    evaluationError("Cannot increment or decrement variable '" + bytecode.names[c] + "'");
+                }
+                bool prefix = instruction.op == OpCode::PreInc || instruction.op == OpCode::PreDec;
+                if (!prefix) {
+                    r[a] = variable;
+                }
+                variable = arithmetic(instruction.op == OpCode::PreInc || instruction.op == OpCode::PostInc
+                                          ? ExpressionOp::Add : ExpressionOp::Sub,
+                                      variable, Value(1LL));
+                if (prefix) {
+                    r[a] = variable;
+                }
+                break;
+            }
+            case OpCode::Jump:
+                pc = b;
+                break;
+            case OpCode::JumpIfFalse:
+                if (!valueToBool(r[a])) pc = b;
+                break;
+            case OpCode::JumpIfTrue:
+                if (valueToBool(r[a])) pc = b;
+                break;
+            case OpCode::Valueof: {
+                const std::string* value = environment.inputValue(static_cast<int>(b) - 1, bytecode.names[c]);
+                r[a] = value ? *value : std::string();
+                break;
+            }
+            case OpCode::ValueofName: {
+                const std::string* value = environment.inputValue(-1, stringArgument(r[a], "valueof/defined/output"));
+                r[a] = value ? *value : std::string();
+                break;
+            }
+            case OpCode::Defined:
+                r[a] = environment.inputValue(static_cast<int>(b) - 1, bytecode.names[c]) != nullptr;
+                break;
+            case OpCode::DefinedName:
+                r[a] = environment.inputValue(-1, stringArgument(r[a], "valueof/defined/output")) != nullptr;
+                break;
+            case OpCode::Output:
+            case OpCode::OutputName: {
+                // The output handler may run another program, which can move the register stack
+                std::string computedName;
+                Value value;
+                if (instruction.op == OpCode::Output) {
+                    value = std::move(r[a]);
+                } else {
+                    computedName = stringArgument(r[a], "valueof/defined/output");
+                    value = std::move(r[b]);
+                }
+                environment.output(instruction.op == OpCode::Output ? static_cast<int>(b) - 1 : -1,
+                                   instruction.op == OpCode::Output ? bytecode.names[c] : computedName, value);
+                r = registerStack.values.data() + frame.base;
+                r[a] = 0LL;
+                break;
+            }
+            case OpCode::Elapsed:
+                r[a] = environment.elapsedMs();
+                break;
+            case OpCode::Stoll:
+            case OpCode::Atoll:
+            case OpCode::Stod:
+            case OpCode::Atof:
+                r[a] = convertText(instruction.op, r[b]);
+                break;
+            case OpCode::ToString:
+                if (const double* number = std::get_if<double>(&r[b])) {
+                    r[a] = std::to_string(*number); // Fixed notation with 6 decimals, unlike valueToString()
+                } else {
+                    r[a] = valueToString(r[b]);
+                }
+                break;
+            case OpCode::Return:
+                return std::move(r[a]);
+            case OpCode::Halt:
+                return 0LL;
+        }
+    }
+}
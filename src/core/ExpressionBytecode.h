@@ -0,0 +1,172 @@
+/**
+ * @file ExpressionBytecode.h
+ * @brief Declares the syntax tree and the bytecode of the interpreter's expression language.
+ * @details Internal to Expression.cpp and ExpressionBytecode.cpp. The parser builds a syntax tree
+ * of each guard, delay and action once, when the machine is started; the tree is compiled to a
+ * compact register-based bytecode which a small virtual machine executes on every evaluation.
+ * @authors xsimonl00, xsiaket00
+ * @date Last modified: 2025-05-05
+ */
+
+#ifndef EXPRESSIONBYTECODE_H
+#define EXPRESSIONBYTECODE_H
+
+#include "Expression.h"
+#include <cstdint>
+
+// --- Syntax tree ---
+
+/**
+ * @brief Kind of a node of the syntax tree.
+ */
+enum class ExpressionNodeKind {
+    Literal,     // literal
+    Variable,    // slot
+    Unary,       // op operands[0]
+    Binary,      // operands[0] op operands[1]
+    Logical,     // operands[0] &&/|| operands[1], short-circuit
+    Conditional, // operands[0] ? operands[1] : operands[2]
+    Assign,      // slot (op)= operands[0]; op is None for a plain assignment
+    Increment,   // ++/-- on slot; op is Add or Sub, prefix tells the form
+    Call         // function(operands...)
+};
+
+/**
+ * @brief Operator of a node of the syntax tree.
+ */
+enum class ExpressionOp {
+    None, Add, Sub, Mul, Div, Mod,
+    Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual,
+    And, Or, Not, Negate, Plus
+};
+
+/**
+ * @brief Function called by a node of the syntax tree.
+ */
+enum class ExpressionFunction {
+    Valueof,  // valueof(input)
+    Defined,  // defined(input)
+    Elapsed,  // elapsed()
+    Output,   // output(output, value)
+    Stoll,    // std::stoi/stol/stoll, throw on invalid text
+    Atoll,    // atoi/atol/atoll, 0 on invalid text
+    Stod,     // std::stof/stod/stold, throw on invalid text
+    Atof,     // atof, 0 on invalid text
+    ToString  // std::to_string
+};
+
+/**
+ * @brief Node of the syntax tree of an expression.
+ */
+struct ExpressionNode {
+    ExpressionNodeKind kind = ExpressionNodeKind::Literal;
+    ExpressionOp op = ExpressionOp::None;
+    bool prefix = true;
+    ExpressionFunction function = ExpressionFunction::Elapsed;
+    Value literal;
+    // Slot of the variable, or of the input/output named by a literal first argument (-1 if undeclared).
+    int slot = -1;
+    // Name of the variable, or the literal input/output name of a call (empty if it is computed).
+    std::string name;
+    std::vector<std::unique_ptr<ExpressionNode>> operands;
+};
+
+/**
+ * @brief Statement of an action.
+ */
+struct ExpressionStatement {
+    enum class Kind { Expression, If, Block };
+    Kind kind = Kind::Expression;
+    // The expression, or the condition of an if; null for an empty statement.
+    std::unique_ptr<ExpressionNode> expression;
+    // The statements of a block, or the then-branch of an if.
+    std::vector<ExpressionStatement> body;
+    // The else-branch of an if.
+    std::vector<ExpressionStatement> elseBody;
+};
+
+// --- Bytecode ---
+
+/**
+ * @brief Operation of a bytecode instruction.
+ * @details R[x] is register x of the running program, K[x] constant x and N[x] name x. The slot
+ * of an input or output is stored plus one, so that 0 stands for an undeclared name (slot -1).
+ */
+enum class OpCode : std::uint8_t {
+    LoadConst,      // R[a] = K[b]
+    LoadVar,        // R[a] = variable b
+    StoreVar,       // variable b (named N[c]) = R[a], converted to its type; R[a] = the stored value
+    Add, Sub, Mul, Div, Mod,                                 // R[a] = R[b] op R[c]
+    Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, // R[a] = R[b] op R[c]
+    AddK, SubK, MulK, DivK, ModK,                            // R[a] = R[b] op K[c]
+    LessK, LessEqualK, GreaterK, GreaterEqualK, EqualK, NotEqualK, // R[a] = R[b] op K[c]
+    Not,            // R[a] = !R[b]
+    Negate,         // R[a] = -R[b]
+    Plus,           // R[a] = +R[b]
+    ToBool,         // R[a] = (bool)R[b]
+    PreInc, PreDec, PostInc, PostDec, // R[a] = ++/-- variable b (named N[c])
+    Jump,           // pc = b
+    JumpIfFalse,    // if (!R[a]) pc = b
+    JumpIfTrue,     // if (R[a]) pc = b
+    Valueof,        // R[a] = valueof(input slot b - 1, named N[c])
+    ValueofName,    // R[a] = valueof(input named R[a])
+    Defined,        // R[a] = defined(input slot b - 1, named N[c])
+    DefinedName,    // R[a] = defined(input named R[a])
+    Output,         // output(output slot b - 1 named N[c], R[a]); R[a] = 0
+    OutputName,     // output(output named R[a], R[b]); R[a] = 0
+    Elapsed,        // R[a] = elapsed()
+    Stoll, Atoll, Stod, Atof, ToString, // R[a] = function(R[b])
+    Return,         // Ends the program with the result R[a]
+    Halt            // Ends the program without a result
+};
+
+/**
+ * @brief One instruction: the operation and up to three operands (registers, slots, indices or jump targets).
+ */
+struct Instruction {
+    OpCode op;
+    std::uint16_t a;
+    std::uint16_t b;
+    std::uint16_t c;
+};
+
+/**
+ * @brief A compiled expression or action.
+ */
+struct ExpressionBytecode {
+    /** @brief The instructions, ending with Return or Halt. */
+    std::vector<Instruction> code;
+    /** @brief The literals of the source. */
+    std::vector<Value> constants;
+    /** @brief The names of the variables, inputs and outputs, for lookups by name and messages. */
+    std::vector<std::string> names;
+    /** @brief Number of registers the program uses. */
+    std::uint16_t registerCount = 0;
+};
+
+/**
+ * @brief Compiles the syntax tree of an expression.
+ * @param root The root of the tree.
+ * @return ExpressionBytecode The program, which returns the value of the expression.
+ * @throws std::runtime_error if the expression exceeds the limits of the bytecode.
+ */
+ExpressionBytecode compileExpression(const ExpressionNode& root);
+
+/**
+ * @brief Compiles the statements of an action.
+ * @param statements The statements.
+ * @return ExpressionBytecode The program, which returns no result.
+ * @throws std::runtime_error if the action exceeds the limits of the bytecode.
+ */
+ExpressionBytecode compileStatements(const std::vector<ExpressionStatement>& statements);
+
+/**
+ * @brief Runs a compiled expression or action.
+ * @param bytecode The program.
+ * @param environment The state the program works on.
+ * @return Value The result of an expression, 0 for an action.
+ * @throws std::runtime_error on an invalid operation (e.g. division by zero, string arithmetic).
+ */
+Value runBytecode(const ExpressionBytecode& bytecode, ExpressionEnvironment& environment);
+
+#endif // EXPRESSIONBYTECODE_H
@@ -57,6 +57,7 @@ void Machine::addVariable(std::unique_ptr<Variable> variable) {
         throw std::runtime_error("Variable with name '" + name + "' already exists.");
     }
     variables[name] = std::move(variable);
+    variableOrder.push_back(name);
 }
 
 
@@ -172,6 +173,7 @@ void Machine::removeVariable(const std::string& name) {
     auto it = variables.find(name);
     if (it != variables.end()) {
         variables.erase(it);
+        variableOrder.erase(std::find(variableOrder.begin(), variableOrder.end(), name));
     }
 }
 
@@ -196,6 +198,11 @@ const std::map<std::string, std::unique_ptr<Variable>>& Machine::getVariables()
 }
 
 
+const std::vector<std::string>& Machine::getVariableOrder() const {
+    return variableOrder;
+}
+
+
 const std::map<std::string, std::unique_ptr<Input>>& Machine::getInputs() const {
     return inputs;
 }
@@ -266,3 +273,352 @@ std::optional<std::string> Machine::getLastOutputValue(const std::string& name)
 
 
 
+
+// --- Interpreter ---
+
+namespace {
+
+// Bound on a chain of immediate transitions taken without waiting; a cycle of unguarded
+// immediate transitions would otherwise never return to the caller.
+constexpr int kMaxImmediateTransitions = 100000;
+
+} // namespace
+
+void Machine::setInterpreterHandlers(StateChangedHandler onState, ValueChangedHandler onOutput,
+                                     ValueChangedHandler onVariable, InterpreterErrorHandler onError) {
+    onStateChanged = std::move(onState);
+    onOutputChanged = std::move(onOutput);
+    onVariableChanged = std::move(onVariable);
+    onInterpreterError = std::move(onError);
+}
+
+void Machine::compileForInterpreter() {
+    interpreterSymbols = ExpressionSymbols();
+    runtimeVariables.clear();
+    runtimeVariableNames.clear();
+    // Slots in the order of the model, so the variables are reported in the order the generated code sends them.
+    for (const std::string& name : variableOrder) {
+        const auto& variable = variables.at(name);
+        interpreterSymbols.variables.emplace(name, static_cast<int>(runtimeVariables.size()));
+        runtimeVariableNames.push_back(name);
+        try {
+            runtimeVariables.push_back(parseVariableValue(variable->getValueAsString(), variable->getTypeHint()));
+        } catch (const std::runtime_error& e) {
+            throw std::runtime_error("Variable '" + name + "': " + e.what());
+        }
+    }
+    for (const auto& pair : inputs) {
+        interpreterSymbols.inputs.emplace(pair.first, static_cast<int>(interpreterSymbols.inputs.size()));
+    }
+    for (const auto& pair : outputs) {
+        interpreterSymbols.outputs.emplace(pair.first, static_cast<int>(interpreterSymbols.outputs.size()));
+    }
+    runtimeInputs.assign(inputs.size(), std::nullopt);
+    undeclaredInputs.clear();
+
+    compiledStates.clear();
+    compiledTransitions.clear();
+    std::map<const State*, std::size_t> stateIndex;
+    for (const auto& [name, state] : states) {
+        CompiledState compiled;
+        compiled.name = name;
+        try {
+            compiled.action = ActionProgram::parse(state->getAction(), interpreterSymbols);
+        } catch (const std::runtime_error& e) {
+            throw std::runtime_error("State '" + name + "', action: " + e.what());
+        }
+        stateIndex.emplace(state.get(), compiledStates.size());
+        compiledStates.push_back(std::move(compiled));
+    }
+
+    // Transitions keep the order of the model, which is also the order the generated code checks them in.
+    for (const auto& transition : transitions) {
+        auto source = stateIndex.find(transition->getSourceState());
+        auto target = stateIndex.find(transition->getTargetState());
+        if (source == stateIndex.end() || target == stateIndex.end()) {
+            throw std::runtime_error("Transition " + std::to_string(transition->getTransitionId()) +
+                                     " connects a state which is not part of the machine.");
+        }
+        TransitionCondition condition = transition->parseCondition();
+        CompiledTransition compiled;
+        compiled.event = condition.event;
+        compiled.delayMs = condition.delayMs;
+        compiled.target = target->second;
+        compiled.description = compiledStates[source->second].name + " -> " + compiledStates[target->second].name;
+        try {
+            if (!condition.guard.empty()) {
+                compiled.guard = Expression::parse(condition.guard, interpreterSymbols);
+            }
+            if (!condition.delayVariable.empty()) {
+                compiled.delayExpression = Expression::parse(condition.delayVariable, interpreterSymbols);
+            }
+        } catch (const std::runtime_error& e) {
+            throw std::runtime_error("Transition " + compiled.description + ": " + e.what());
+        }
+
+        std::size_t index = compiledTransitions.size();
+        CompiledState& sourceState = compiledStates[source->second];
+        if (compiled.event.empty()) {
+            sourceState.eventlessTransitions.push_back(index);
+        } else {
+            sourceState.eventTransitions[compiled.event].push_back(index);
+        }
+        compiledTransitions.push_back(std::move(compiled));
+    }
+}
+
+void Machine::start() {
+    if (initialStateName.empty() || !states.count(initialStateName)) {
+        throw std::runtime_error("Cannot start: the initial state is not set.");
+    }
+    running = false;
+    activeTimers.clear();
+    compileForInterpreter();
+
+    // compiledStates follows the order of the states map
+    currentState = static_cast<std::size_t>(std::distance(states.begin(), states.find(initialStateName)));
+    terminationRequested = false;
+    running = true;
+    std::cout << "Machine '" << machineName << "' started in state '" << initialStateName << "' (interpreted)." << std::endl;
+
+    executeCurrentStateAction();
+    checkAndExecuteImmediateTransitions();
+}
+
+bool Machine::step(const std::optional<std::pair<std::string, std::string>>& externalEvent) {
+    if (!running) {
+        return false;
+    }
+    if (externalEvent) {
+        processInputEvent(externalEvent->first, externalEvent->second);
+    }
+    fireDueTimers();
+    return running;
+}
+
+void Machine::processInputEvent(const std::string& inputName, const std::string& value) {
+    if (!running) {
+        return;
+    }
+    auto slot = interpreterSymbols.inputs.find(inputName);
+    if (slot != interpreterSymbols.inputs.end()) {
+        runtimeInputs[static_cast<std::size_t>(slot->second)] = value;
+    } else {
+        undeclaredInputs[inputName] = value;
+    }
+    if (checkAndExecuteEventTransitions(inputName, value)) {
+        // Transitions leaving the new state
+        checkAndExecuteImmediateTransitions();
+    }
+}
+
+const std::string& Machine::getCurrentStateName() const {
+    return currentStateName;
+}
+
+bool Machine::isTerminationRequested() const {
+    return terminationRequested;
+}
+
+void Machine::requestTermination() {
+    terminationRequested = true;
+    running = false;
+    cancelPendingTimers();
+}
+
+std::optional<std::chrono::steady_clock::time_point> Machine::getNextTimerExpiry() const {
+    if (!running || activeTimers.empty()) {
+        return std::nullopt;
+    }
+    return activeTimers.front().expiryTime;
+}
+
+void Machine::executeCurrentStateAction() {
+    const CompiledState& state = compiledStates[currentState];
+    stateEntryTime = std::chrono::steady_clock::now();
+    currentStateName = state.name;
+    if (onStateChanged) {
+        onStateChanged(state.name);
+    }
+    try {
+        state.action.execute(*this);
+    } catch (const std::runtime_error& e) {
+        reportInterpreterError("State '" + state.name + "', action: " + e.what());
+    }
+    if (onVariableChanged) {
+        for (std::size_t slot = 0; slot < runtimeVariables.size(); ++slot) {
+            onVariableChanged(runtimeVariableNames[slot], valueToString(runtimeVariables[slot]));
+        }
+    }
+}
+
+bool Machine::checkAndExecuteImmediateTransitions() {
+    bool transitionTaken = false;
+    bool immediateFound;
+    int chainLength = 0;
+    do {
+        immediateFound = false;
+        std::size_t target = currentState;
+        // Delayed transitions are scheduled until the first enabled immediate one is found
+        for (std::size_t index : compiledStates[currentState].eventlessTransitions) {
+            const CompiledTransition& transition = compiledTransitions[index];
+            if (!evaluateGuardCondition(transition)) {
+                continue;
+            }
+            if (transition.delayMs == 0 && transition.delayExpression.empty()) {
+                target = transition.target;
+                immediateFound = true;
+                break;
+            }
+            long long delayMs = evaluateDelay(transition);
+            if (delayMs >= 0) {
+                scheduleDelayedTransition(index, delayMs);
+            }
+        }
+        if (immediateFound) {
+            if (++chainLength > kMaxImmediateTransitions) {
+                reportInterpreterError("Endless chain of immediate transitions in state '" + compiledStates[currentState].name + "', stopping.");
+                requestTermination();
+                break;
+            }
+            performStateTransition(target);
+            transitionTaken = true;
+        }
+    } while (immediateFound && running);
+    return transitionTaken;
+}
+
+bool Machine::checkAndExecuteEventTransitions(const std::string& inputName, const std::string& value) {
+    (void)value; // Already stored, the guards read it through valueof()
+    const CompiledState& state = compiledStates[currentState];
+    auto candidates = state.eventTransitions.find(inputName);
+    if (candidates == state.eventTransitions.end()) {
+        return false;
+    }
+    for (std::size_t index : candidates->second) {
+        const CompiledTransition& transition = compiledTransitions[index];
+        if (!evaluateGuardCondition(transition)) {
+            continue;
+        }
+        if (transition.delayMs == 0 && transition.delayExpression.empty()) {
+            // The first enabled immediate transition is taken
+            performStateTransition(transition.target);
+            return true;
+        }
+        // A delayed one is scheduled, and the search goes on
+        long long delayMs = evaluateDelay(transition);
+        if (delayMs >= 0) {
+            scheduleDelayedTransition(index, delayMs);
+        }
+    }
+    return false;
+}
+
+bool Machine::fireDueTimers() {
+    bool transitionTaken = false;
+    const auto now = std::chrono::steady_clock::now();
+    while (running && !activeTimers.empty() && activeTimers.front().expiryTime <= now) {
+        std::pop_heap(activeTimers.begin(), activeTimers.end());
+        std::size_t transition = activeTimers.back().transition;
+        activeTimers.pop_back();
+        // The transition cancels the other timers of the state
+        performStateTransition(compiledTransitions[transition].target);
+        checkAndExecuteImmediateTransitions();
+        transitionTaken = true;
+    }
+    return transitionTaken;
+}
+
+long long Machine::evaluateDelay(const CompiledTransition& transition) {
+    if (transition.delayExpression.empty()) {
+        return transition.delayMs;
+    }
+    try {
+        Value delay = transition.delayExpression.evaluate(*this);
+        if (const long long* integer = std::get_if<long long>(&delay)) return *integer;
+        if (const double* number = std::get_if<double>(&delay)) return static_cast<long long>(*number);
+        if (const bool* flag = std::get_if<bool>(&delay)) return *flag ? 1 : 0;
+        throw std::runtime_error("the delay is not a number");
+    } catch (const std::runtime_error& e) {
+        reportInterpreterError("Transition " + transition.description + ", delay: " + e.what());
+        return -1;
+    }
+}
+
+void Machine::scheduleDelayedTransition(std::size_t transition, long long delayMs) {
+    if (delayMs <= 0) {
+        // As the runtime's timers, only positive delays are scheduled
+        reportInterpreterError("Transition " + compiledTransitions[transition].description +
+                               ": attempted to schedule timer with non-positive delay.");
+        return;
+    }
+    activeTimers.push_back(ActiveTimer{std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs),
+                                       transition, nextTimerSequence++});
+    std::push_heap(activeTimers.begin(), activeTimers.end());
+}
+
+void Machine::cancelPendingTimers() {
+    activeTimers.clear();
+}
+
+void Machine::performStateTransition(std::size_t targetState) {
+    cancelPendingTimers();
+    currentState = targetState;
+    executeCurrentStateAction();
+}
+
+bool Machine::evaluateGuardCondition(const CompiledTransition& transition) {
+    if (transition.guard.empty()) {
+        return true;
+    }
+    try {
+        return valueToBool(transition.guard.evaluate(*this));
+    } catch (const std::runtime_error& e) {
+        reportInterpreterError("Transition " + transition.description + ", guard: " + e.what());
+        return false;
+    }
+}
+
+void Machine::reportInterpreterError(const std::string& message) {
+    if (onInterpreterError) {
+        onInterpreterError(message);
+    } else {
+        std::cerr << "Interpreter error: " << message << std::endl;
+    }
+}
+
+// --- ExpressionEnvironment ---
+
+Value& Machine::variable(int slot) {
+    return runtimeVariables[static_cast<std::size_t>(slot)];
+}
+
+const std::string* Machine::inputValue(int slot, const std::string& name) const {
+    if (slot < 0) {
+        // A computed name may still be a declared input
+        auto declared = interpreterSymbols.inputs.find(name);
+        if (declared == interpreterSymbols.inputs.end()) {
+            auto undeclared = undeclaredInputs.find(name);
+            return undeclared != undeclaredInputs.end() ? &undeclared->second : nullptr;
+        }
+        slot = declared->second;
+    }
+    const std::optional<std::string>& value = runtimeInputs[static_cast<std::size_t>(slot)];
+    return value ? &*value : nullptr;
+}
+
+long long Machine::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - stateEntryTime).count();
+}
+
+void Machine::output(int slot, const std::string& name, const Value& value) {
+    (void)slot; // The model's outputs are looked up by name, they may be edited while the machine runs
+    std::string text = valueToString(value);
+    auto it = outputs.find(name);
+    if (it != outputs.end()) {
+        it->second->recordSentValue(text);
+    }
+    if (onOutputChanged) {
+        onOutputChanged(name, text);
+    }
+}
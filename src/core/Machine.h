@@ -17,6 +17,8 @@
 #include <memory>
 #include <optional>
 #include <chrono> // For time points and durations
+#include <functional>
+#include <cstdint>
 
 // Core components
 #include "State.h"
@@ -24,10 +26,33 @@
 #include "Variable.h"
 #include "Input.h"
 #include "Output.h"
+#include "Expression.h"
 
 
-class Machine {
+/**
+ * @brief A state machine: the model edited in the GUI and an interpreter running it in-process.
+ * @details The interpreter (start(), step(), processInputEvent()) runs the machine without generating
+ * and compiling code, as long as its actions, guards and delays stay within the subset of C++ understood
+ * by the expression language (see Expression.h). It follows the semantics of the generated automaton.
+ * The environment of the expressions is implemented privately.
+ */
+class Machine : private ExpressionEnvironment {
 public:
+    /**
+     * @brief Callback receiving the name of the state the interpreter entered.
+     */
+    using StateChangedHandler = std::function<void(const std::string& /* stateName */)>;
+
+    /**
+     * @brief Callback receiving a new value of an output or a variable during interpretation.
+     */
+    using ValueChangedHandler = std::function<void(const std::string& /* name */, const std::string& /* value */)>;
+
+    /**
+     * @brief Callback receiving an error of the interpreted code (e.g. a division by zero).
+     */
+    using InterpreterErrorHandler = std::function<void(const std::string& /* message */)>;
+
 
     /**
      * @brief Constructs a Machine object with the specified name.
@@ -151,6 +176,12 @@ public:
      * @return A constant reference to a map of variable names and their corresponding unique pointers.
      */
     const std::map<std::string, std::unique_ptr<Variable>>& getVariables() const;
+    /**
+     * @brief Retrieves the names of the variables in the order they were added (the order of the model).
+     * @details The saved model, the generated code and the interpreter list the variables in this order.
+     * @return A constant reference to the variable names in declaration order.
+     */
+    const std::vector<std::string>& getVariableOrder() const;
     /**
      * @brief Retrieves the map of inputs associated with the machine.
      * 
@@ -262,17 +293,32 @@ public:
 
     // --- Interpreter logic ---
 
+    /**
+     * @brief Sets the callbacks through which the interpreter reports what the machine does.
+     * @details Any of them may be empty. The variable handler receives all variables after each state action,
+     * as the generated automaton sends them to the GUI.
+     * @param onState Called when a state is entered.
+     * @param onOutput Called when an action writes an output.
+     * @param onVariable Called with the values of the variables after each state action.
+     * @param onError Called when the interpreted code fails at run time.
+     */
+    void setInterpreterHandlers(StateChangedHandler onState, ValueChangedHandler onOutput,
+                                ValueChangedHandler onVariable, InterpreterErrorHandler onError);
+
     /**
      * @brief Initializes the automaton to its starting state.
-     * @details Must be called before step() or run(). Executes the action of the initial state.
-     * @throws std::runtime_error if initial state is not set or not found.
+     * @details Must be called before step() or run(). Parses the actions, guards and delays, resets
+     * the variables to the values in the model and the inputs to undefined, and enters the initial state.
+     * @throws std::runtime_error if initial state is not set or not found, or if some code of the machine
+     * is outside the subset the interpreter understands (the message names the state or transition).
      */
     void start();
 
     /**
      * @brief Executes a single step of the automaton's logic.
-     * @details Checks for immediate transitions, processes timers, and potentially waits for events.
-     * This is intended for step-by-step simulation or integration into an external event loop.
+     * @details Processes the event (if any) and then takes the delayed transitions whose time has come.
+     * This is intended for step-by-step simulation or integration into an external event loop,
+     * which calls it again at getNextTimerExpiry().
      * @param externalEvent Optional external event to process in this step. Pair of <input_name, value>.
      * @return bool Returns true if the automaton is still running, false if it has terminated.
      */
@@ -304,6 +350,12 @@ public:
      */
     void requestTermination();
 
+    /**
+     * @brief Gets the time at which the next delayed transition is due.
+     * @return std::optional<std::chrono::steady_clock::time_point> The expiry of the earliest timer, or nothing if none is scheduled.
+     */
+    std::optional<std::chrono::steady_clock::time_point> getNextTimerExpiry() const;
+
 
 private:
     
@@ -341,22 +393,124 @@ private:
      */
     struct ActiveTimer {
         std::chrono::time_point<std::chrono::steady_clock> expiryTime;
-        const Transition* transition; // Pointer to the delayed transition
-        // Add other relevant info if needed, e.g., the state it was scheduled from
+        std::size_t transition; // Index of the delayed transition in compiledTransitions
+        std::uint64_t sequence; // Order of scheduling, so timers expiring together fire in that order
 
         // Overload less than operator for sorting or priority queue
         bool operator<(const ActiveTimer& other) const {
-            return expiryTime > other.expiryTime; // Note: > for min-heap behavior with std::priority_queue
+            // Note: > for min-heap behavior with std::push_heap/std::pop_heap
+            return expiryTime != other.expiryTime ? expiryTime > other.expiryTime : sequence > other.sequence;
         }
     };
-    // Using a vector for simplicity now, maybe std::priority_queue later for efficiency
+    // Min-heap of the pending delayed transitions (std::push_heap/std::pop_heap), the earliest at front().
+    // A vector rather than std::priority_queue, so all timers can be dropped on a state change.
     std::vector<ActiveTimer> activeTimers;
 
+    /**
+     * @brief Sequence number of the next scheduled timer.
+     */
+    std::uint64_t nextTimerSequence = 0;
+
+    /**
+     * @brief A transition prepared for interpretation.
+     */
+    struct CompiledTransition {
+        std::string event;         // Triggering input, empty for an event-independent transition
+        Expression guard;          // Empty if the transition has no guard
+        long long delayMs = 0;     // Constant delay, 0 if none (or if delayExpression gives it)
+        Expression delayExpression; // Delay given by a variable (or an expression)
+        std::size_t target = 0;    // Index of the target state in compiledStates
+        std::string description;   // "Source -> Target" for error messages
+    };
+
+    /**
+     * @brief A state prepared for interpretation.
+     */
+    struct CompiledState {
+        std::string name;
+        ActionProgram action;
+        std::vector<std::size_t> eventlessTransitions; // Indices into compiledTransitions, in model order
+        std::map<std::string, std::vector<std::size_t>> eventTransitions; // By triggering input
+    };
+
+    /**
+     * @brief The states of the running machine; compiledStates[currentState] is the active one.
+     */
+    std::vector<CompiledState> compiledStates;
+
+    /**
+     * @brief The transitions of the running machine.
+     */
+    std::vector<CompiledTransition> compiledTransitions;
+
+    /**
+     * @brief Index of the active state in compiledStates.
+     */
+    std::size_t currentState = 0;
+
+    /**
+     * @brief Time the active state was entered (for elapsed()).
+     */
+    std::chrono::steady_clock::time_point stateEntryTime;
+
+    /**
+     * @brief Values and names of the variables while interpreting, by slot; the model keeps the initial values.
+     */
+    std::vector<Value> runtimeVariables;
+    std::vector<std::string> runtimeVariableNames;
+
+    /**
+     * @brief Last values of the declared inputs while interpreting, by slot (nothing until the first event).
+     */
+    std::vector<std::optional<std::string>> runtimeInputs;
+
+    /**
+     * @brief Last values of inputs which are not declared in the machine.
+     */
+    std::map<std::string, std::string> undeclaredInputs;
+
+    /**
+     * @brief Slots of the variables, inputs and outputs the parsed code refers to.
+     */
+    ExpressionSymbols interpreterSymbols;
+
+    /**
+     * @brief Callbacks set by setInterpreterHandlers().
+     */
+    StateChangedHandler onStateChanged;
+    ValueChangedHandler onOutputChanged;
+    ValueChangedHandler onVariableChanged;
+    InterpreterErrorHandler onInterpreterError;
+
+    /**
+     * @brief Parses the actions, guards and delays into compiledStates and compiledTransitions.
+     * @throws std::runtime_error naming the state or transition whose code cannot be interpreted.
+     */
+    void compileForInterpreter();
+
+    /**
+     * @brief Reports an error of the interpreted code through the error handler (or std::cerr).
+     * @param message The error.
+     */
+    void reportInterpreterError(const std::string& message);
+
+    /**
+     * @brief Takes the delayed transitions which are due.
+     * @return bool True if a transition was taken.
+     */
+    bool fireDueTimers();
+
+    // --- ExpressionEnvironment ---
+    Value& variable(int slot) override;
+    const std::string* inputValue(int slot, const std::string& name) const override;
+    long long elapsedMs() const override;
+    void output(int slot, const std::string& name, const Value& value) override;
+
     // --- Private Helper Methods for Interpreter ---
 
     /**
      * @brief Executes the action associated with the current state.
-     * @details Placeholder for action execution logic (parsing/interpreting C++ code).
+     * @details Records the entry time, reports the state, runs the parsed action and reports the variables.
      */
     void executeCurrentStateAction();
 
@@ -374,33 +528,40 @@ private:
      */
     bool checkAndExecuteEventTransitions(const std::string& inputName, const std::string& value);
 
+    /**
+     * @brief Evaluates the delay of a delayed transition.
+     * @param transition The transition.
+     * @return long long The delay in milliseconds, or -1 if it cannot be evaluated.
+     */
+    long long evaluateDelay(const CompiledTransition& transition);
+
 
     /**
      * @brief Schedules a timer for a delayed transition.
-     * @param transition Pointer to the transition to schedule.
+     * @param transition Index of the transition in compiledTransitions.
+     * @param delayMs The delay in milliseconds.
      */
-    void scheduleDelayedTransition(const Transition* transition);
+    void scheduleDelayedTransition(std::size_t transition, long long delayMs);
 
     /**
-     * @brief Removes any scheduled timers associated with transitions originating from a specific state.
-     * @param stateName The name of the state whose outgoing transition timers should be cancelled.
+     * @brief Removes all scheduled timers.
+     * @details Timers are only scheduled for transitions leaving the active state, so a state change cancels all of them.
      */
-    void cancelTimersFromState(const std::string& stateName); // Might not be needed based on exact algorithm interpretation
+    void cancelPendingTimers();
 
     /**
      * @brief Performs the state change and executes the action of the new state.
-     * @param targetStateName The name of the state to transition to.
+     * @param targetState Index of the state to transition to in compiledStates.
      */
-    void performStateTransition(const std::string& targetStateName);
+    void performStateTransition(std::size_t targetState);
 
     /**
-     * @brief Evaluates a guard condition string.
-     * @details Placeholder for guard evaluation logic (parsing/interpreting C++ code). Needs access to variable values and potentially input values.
-     * @param guardCondition The condition string to evaluate.
-     * @param triggeringEventValue Optional value of the event that triggered the check.
-     * @return bool True if the condition is met, false otherwise.
+     * @brief Evaluates the guard of a transition.
+     * @details A guard failing at run time is reported and treated as false.
+     * @param transition The transition.
+     * @return bool True if the transition has no guard or the guard is met, false otherwise.
      */
-    bool evaluateGuardCondition(const std::string& guardCondition, const std::optional<std::string>& triggeringEventValue = std::nullopt);
+    bool evaluateGuardCondition(const CompiledTransition& transition);
 
 
     
@@ -434,6 +595,10 @@ private:
      * as a unique pointer to ensure proper memory management and ownership semantics.
      */
     std::map<std::string, std::unique_ptr<Variable>> variables;
+    /**
+     * @brief Names of the variables in the order they were added.
+     */
+    std::vector<std::string> variableOrder;
     /**
      * @brief A map that associates input names with their corresponding unique pointers to Input objects.
      * 
@@ -9,6 +9,7 @@
 #include "Transition.h" // Make sure this line is exactly like this
 #include "State.h" // Include the State class header
 #include <sstream> // Include for std::ostringstream
+#include <stdexcept> // For std::invalid_argument
 
 
 Transition::Transition(State* sourceState, State* targetState, const int transitionId, 
@@ -89,4 +90,58 @@ int Transition::getDestinationStateId() const {
 
  
  
- 
\ No newline at end of file
+ 
+
+namespace {
+
+// Removes leading and trailing whitespace.
+std::string trimCondition(const std::string& str) {
+    size_t first = str.find_first_not_of(" \t\n\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    size_t last = str.find_last_not_of(" \t\n\r");
+    return str.substr(first, last - first + 1);
+}
+
+} // namespace
+
+TransitionCondition Transition::parseCondition() const {
+    TransitionCondition parts;
+    std::string rest = trimCondition(condition);
+
+    // Delay part (e.g., "@ 5000" or "@ delayVar")
+    size_t atPos = rest.find('@');
+    if (atPos != std::string::npos) {
+        std::string delayPart = trimCondition(rest.substr(atPos + 1));
+        if (!delayPart.empty()) {
+            // A number, otherwise the name of a variable
+            try {
+                size_t processed = 0;
+                parts.delayMs = std::stoll(delayPart, &processed);
+                if (processed != delayPart.length() || parts.delayMs < 0) {
+                    throw std::invalid_argument("");
+                }
+            } catch (...) {
+                parts.delayMs = 0;
+                parts.delayVariable = delayPart;
+            }
+        }
+        rest = trimCondition(rest.substr(0, atPos));
+    } else if (delayMs > 0) {
+        // Delay stored separately in the Transition object
+        parts.delayMs = delayMs;
+    }
+
+    // Guard part (e.g., "[ counter > 5 ]")
+    size_t guardStart = rest.find('[');
+    size_t guardEnd = rest.rfind(']');
+    if (guardStart != std::string::npos && guardEnd != std::string::npos && guardEnd > guardStart) {
+        parts.guard = trimCondition(rest.substr(guardStart + 1, guardEnd - guardStart - 1));
+        rest = trimCondition(rest.substr(0, guardStart));
+    }
+
+    // Whatever remains is the event trigger
+    parts.event = trimCondition(rest);
+    return parts;
+}
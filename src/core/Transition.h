@@ -18,6 +18,29 @@
 
 
 
+/**
+ * @brief The parts of a transition condition "event [guard] @ delay".
+ * @details Every part is optional; an empty string means the part is absent.
+ */
+struct TransitionCondition {
+    /**
+     * @brief Name of the input triggering the transition.
+     */
+    std::string event;
+    /**
+     * @brief Guard expression (without the brackets).
+     */
+    std::string guard;
+    /**
+     * @brief Constant delay in milliseconds, 0 if there is none or it is given by delayVariable.
+     */
+    long long delayMs = 0;
+    /**
+     * @brief Expression (usually a variable name) giving the delay, if the delay is not a number.
+     */
+    std::string delayVariable;
+};
+
 class Transition {
 public:
     /**
@@ -113,6 +136,13 @@ public:
      */
     int getSourceStateId() const;      // <-- AJ TENTO RIADOK
 
+    /**
+     * @brief Splits the condition string into its event, guard and delay.
+     * @details Used by both the code generator and the interpreter, so they read a condition the same way.
+     * @return TransitionCondition The parts of the condition.
+     */
+    TransitionCondition parseCondition() const;
+
     // --- Setters ---
     /**
      * @brief Sets the source state of the transition.
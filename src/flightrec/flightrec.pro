@@ -0,0 +1,21 @@
+# src/flightrec/flightrec.pro
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+TARGET = ifa_flightrec
+
+INCLUDEPATH += \
+    $$PWD/..
+
+SOURCES += \
+    main.cpp
+
+QMAKE_CXXFLAGS += -w
+
+# Only the reader of the flight recorder is taken from the runtime library.
+unix {
+    LIBS += -L$$OUT_PWD/../runtime -lifa_runtime -lpthread
+    PRE_TARGETDEPS += $$OUT_PWD/../runtime/libifa_runtime.a
+}
@@ -0,0 +1,122 @@
+/**
+ * @file main.cpp
+ * @brief Entry point of ifa_flightrec, which decodes the flight recorder file of an automaton.
+ * @details Usage: ifa_flightrec [--last N] [--instance ID] <file>
+ *          Prints the header of the file and the records it holds, oldest first, one per line:
+ *          the time since the start of the engine, the record number, the instance and the event.
+ *          The file can be read while the automaton is running and after it crashed or was killed
+ *          (started with --flight-recorder FILE, see ifa_runtime::Engine::setFlightRecorder()).
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "runtime/ifa_runtime_flight_recorder.h"
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Formats microseconds since the Unix epoch as local time, e.g. "2025-05-05 12:00:00.000123".
+ */
+std::string formatWallClock(std::int64_t unixUs) {
+    std::time_t seconds = static_cast<std::time_t>(unixUs / 1000000);
+    std::tm local{};
+    localtime_r(&seconds, &local);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local);
+    std::ostringstream out;
+    out << text << "." << std::setw(6) << std::setfill('0') << unixUs % 1000000;
+    return out.str();
+}
+
+/**
+ * @brief Prints one record as a line.
+ */
+void printRecord(const ifa_runtime::FlightRecord& record) {
+    using ifa_runtime::FlightEventType;
+    std::string name(record.text, record.nameLength);
+    std::string value(record.text + record.nameLength, record.valueLength);
+    const char* cut = (record.flags & ifa_runtime::kFlightRecordTruncated) ? "..." : "";
+
+    std::cout << "+" << std::fixed << std::setprecision(6) << record.timeUs / 1e6 << " s  #"
+              << std::left << std::setw(8) << record.sequence << std::right << " [" << record.instance << "]  "
+              << std::left << std::setw(13) << ifa_runtime::flightEventName(record.type) << std::right;
+    switch (static_cast<FlightEventType>(record.type)) {
+        case FlightEventType::Input:
+        case FlightEventType::Output:
+            std::cout << name << "=\"" << value << "\"" << cut;
+            break;
+        case FlightEventType::TimerScheduled:
+            std::cout << name << " in " << value << " ms (handle " << record.aux << ")";
+            break;
+        case FlightEventType::TimerCancelled:
+            std::cout << "handle " << record.aux;
+            break;
+        default:
+            std::cout << name << cut;
+            break;
+    }
+    std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    std::size_t last = 0; // 0 = all records
+    long long instance = -1; // -1 = all instances
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--last" && i + 1 < argc) {
+                last = std::stoul(argv[++i]);
+                continue;
+            }
+            if (arg == "--instance" && i + 1 < argc) {
+                instance = std::stoll(argv[++i]);
+                continue;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Error: invalid value '" << argv[i] << "' for " << arg << std::endl;
+            return 2;
+        }
+        if (arg.rfind("--", 0) == 0 || !path.empty()) {
+            path.clear();
+            break;
+        }
+        path = arg;
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--last N] [--instance ID] <file>" << std::endl;
+        return 2;
+    }
+
+    ifa_runtime::FlightRecorderDump dump;
+    std::string error;
+    if (!ifa_runtime::readFlightRecorder(path, dump, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    const ifa_runtime::FlightRecorderHeader& header = dump.header;
+    std::cout << "Flight recorder of process " << header.pid << ", started " << formatWallClock(header.startUnixUs) << "\n"
+              << header.written << " records written, the last " << dump.records.size() << " kept ("
+              << header.capacity << " slots)";
+    if (dump.torn > 0) {
+        std::cout << ", " << dump.torn << " cut off by the end of the process";
+    }
+    std::cout << "\n";
+
+    std::size_t first = (last > 0 && last < dump.records.size()) ? dump.records.size() - last : 0;
+    for (std::size_t i = first; i < dump.records.size(); ++i) {
+        if (instance >= 0 && dump.records[i].instance != static_cast<std::uint64_t>(instance)) {
+            continue;
+        }
+        printRecord(dump.records[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file BuildCache.cpp
+ * @brief Implementation file for the BuildCache class.
+ * @details Computes the content hash of an automaton build and stores, looks up and prunes
+ * the cached executables.
+ * @authors xsimonl00, xsiaket00
+ * @date Last modified: 2025-05-05
+ */
+
+#include "BuildCache.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QStandardPaths>
+#include <QDebug>
+
+BuildCache::BuildCache(const QString& cacheDir, int maxEntries)
+    : cacheDir_(cacheDir), maxEntries_(maxEntries) {}
+
+void BuildCache::addFile(QCryptographicHash& hash, const QString& filePath) {
+    QFile file(filePath);
+    hash.addData(filePath.toUtf8());
+    if (file.open(QIODevice::ReadOnly)) {
+        hash.addData(&file);
+    } else {
+        hash.addData("<missing>");
+    }
+}
+
+QString BuildCache::computeKey(const std::string& source, const QString& templatePath,
+                               const QString& runtimeLibDir, const QString& runtimeIncludeDir,
+                               const QString& compiler, const QStringList& flags) const {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+
+    // Generated source and the template it was rendered from
+    hash.addData(source.data(), static_cast<int>(source.size()));
+    addFile(hash, templatePath);
+
+    // Runtime library and the headers the generated source includes
+    addFile(hash, runtimeLibDir + "/libifa_runtime.a");
+    QDir includeDir(runtimeIncludeDir);
+    const QStringList headers = includeDir.entryList(QStringList() << "*.h", QDir::Files, QDir::Name);
+    for (const QString& header : headers) {
+        addFile(hash, includeDir.filePath(header));
+    }
+
+    // Compiler identity (resolved path and modification time, so an upgrade invalidates the cache) and flags
+    QString compilerPath = QStandardPaths::findExecutable(compiler);
+    hash.addData(compilerPath.toUtf8());
+    hash.addData(QByteArray::number(QFileInfo(compilerPath).lastModified().toMSecsSinceEpoch()));
+    hash.addData(flags.join('\n').toUtf8());
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString BuildCache::entryPath(const QString& key) const {
+    return cacheDir_ + "/" + key;
+}
+
+bool BuildCache::fetch(const QString& key, const QString& destinationPath) const {
+    QString cachedPath = entryPath(key);
+    if (!QFileInfo::exists(cachedPath)) {
+        return false;
+    }
+    QFile::remove(destinationPath);
+    if (!QFile::copy(cachedPath, destinationPath)) {
+        qWarning() << "Build cache: could not copy" << cachedPath << "to" << destinationPath;
+        return false;
+    }
+    QFile::setPermissions(destinationPath, QFile::permissions(cachedPath) | QFile::ExeOwner | QFile::ExeUser);
+
+    // Touch the entry so pruning removes the least recently used executables first
+    QFile cachedFile(cachedPath);
+    if (cachedFile.open(QIODevice::ReadWrite)) {
+        cachedFile.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+    return true;
+}
+
+bool BuildCache::store(const QString& key, const QString& executablePath) {
+    if (!QDir().mkpath(cacheDir_)) {
+        qWarning() << "Build cache: could not create directory" << cacheDir_;
+        return false;
+    }
+    // Copy to a temporary name first so a concurrent fetch never sees a half-written entry
+    QString cachedPath = entryPath(key);
+    QString tempPath = cachedPath + ".tmp";
+    QFile::remove(tempPath);
+    if (!QFile::copy(executablePath, tempPath)) {
+        qWarning() << "Build cache: could not copy" << executablePath << "into the cache";
+        return false;
+    }
+    QFile::remove(cachedPath);
+    if (!QFile::rename(tempPath, cachedPath)) {
+        QFile::remove(tempPath);
+        return false;
+    }
+    prune();
+    return true;
+}
+
+void BuildCache::prune() {
+    QDir dir(cacheDir_);
+    // Sorted by modification time, most recently used first
+    QFileInfoList entries = dir.entryInfoList(QDir::Files, QDir::Time);
+    for (int i = maxEntries_; i < entries.size(); ++i) {
+        QFile::remove(entries[i].absoluteFilePath());
+    }
+}
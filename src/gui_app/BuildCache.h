@@ -0,0 +1,90 @@
+/**
+ * @file BuildCache.h
+ * @brief Declares the BuildCache class, a content-addressed cache of compiled automaton executables.
+ * @details The cache key is a hash over everything that determines the compiled executable: the
+ * rendered C++ source, the code generation template, the runtime library and its headers, and
+ * the compiler with its flags. An unchanged machine therefore reuses its executable instead of
+ * invoking the compiler again.
+ * @authors xsimonl00, xsiaket00
+ * @date Last modified: 2025-05-05
+ */
+
+#ifndef BUILDCACHE_H
+#define BUILDCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QCryptographicHash>
+#include <string>
+
+/**
+ * @brief Content-addressed store of compiled automaton executables.
+ * Every entry is an executable file named after its key in the cache directory. The least
+ * recently used entries are removed once more than the maximum number of entries is stored.
+ */
+class BuildCache {
+public:
+    /**
+     * @brief Constructor.
+     * @param cacheDir Directory holding the cached executables; created on first store.
+     * @param maxEntries Maximum number of executables kept in the cache.
+     */
+    explicit BuildCache(const QString& cacheDir, int maxEntries = 32);
+
+    /**
+     * @brief Computes the cache key of one build.
+     * @param source The rendered C++ source code.
+     * @param templatePath Path of the template the source was rendered from.
+     * @param runtimeLibDir Directory containing libifa_runtime.
+     * @param runtimeIncludeDir Directory containing the runtime headers.
+     * @param compiler Compiler executable.
+     * @param flags All compiler and linker flags, excluding the input and output file paths.
+     * @return QString Hexadecimal SHA-256 key.
+     */
+    QString computeKey(const std::string& source, const QString& templatePath,
+                       const QString& runtimeLibDir, const QString& runtimeIncludeDir,
+                       const QString& compiler, const QStringList& flags) const;
+
+    /**
+     * @brief Copies a cached executable to its destination.
+     * @param key Cache key from computeKey().
+     * @param destinationPath Path the executable is copied to (replaced if it exists).
+     * @return bool True on a cache hit that was copied successfully.
+     */
+    bool fetch(const QString& key, const QString& destinationPath) const;
+
+    /**
+     * @brief Stores a freshly compiled executable under its key.
+     * @param key Cache key from computeKey().
+     * @param executablePath Path of the compiled executable.
+     * @return bool True if the executable was stored.
+     */
+    bool store(const QString& key, const QString& executablePath);
+
+private:
+    /**
+     * @brief Returns the path of the cache entry for a key.
+     * @param key Cache key.
+     * @return QString Path of the entry.
+     */
+    QString entryPath(const QString& key) const;
+
+    /**
+     * @brief Removes the least recently used entries above the maximum number of entries.
+     */
+    void prune();
+
+    /**
+     * @brief Adds the contents of a file to a hash, or a marker if the file cannot be read.
+     * @param hash Hash being computed.
+     * @param filePath File to hash.
+     */
+    static void addFile(QCryptographicHash& hash, const QString& filePath);
+
+    /** @brief Directory holding the cached executables. */
+    QString cacheDir_;
+    /** @brief Maximum number of cached executables. */
+    int maxEntries_;
+};
+
+#endif // BUILDCACHE_H
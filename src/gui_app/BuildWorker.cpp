@@ -0,0 +1,341 @@
+/**
+ * @file BuildWorker.cpp
+ * @brief Implementation file for the BuildWorker class.
+ * @details Saves the model snapshot, renders the C++ source, and compiles it (or fetches it from the
+ * build cache) while streaming the compiler output line by line. Split builds compile the changed
+ * translation units in parallel and link them.
+ * @authors xsimonl00, xsiaket00
+ * @date Last modified: 2025-05-05
+ */
+
+#include "BuildWorker.h"
+#include "BuildCache.h"
+#include "persistence/JsonPersistance.h"
+#include "core/Machine.h" // Complete type needed to resolve CodeGenerator::generate() for a json argument
+#include "nlohmann/json.hpp"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <fstream>
+#include <exception>
+
+namespace {
+
+/**
+ * @brief Writes a generated file unless it already has the given content.
+ * @details Unchanged files keep their modification time, which keeps external tools quiet.
+ * @param filePath Path of the file.
+ * @param content Contents of the file.
+ * @return bool False if the file could not be written.
+ */
+bool writeIfChanged(const QString& filePath, const std::string& content) {
+    QFile existing(filePath);
+    if (existing.open(QIODevice::ReadOnly)) {
+        QByteArray current = existing.readAll();
+        if (current.size() == static_cast<int>(content.size()) &&
+            std::equal(content.begin(), content.end(), current.constData())) {
+            return true;
+        }
+        existing.close();
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(content.data(), static_cast<qint64>(content.size())) == static_cast<qint64>(content.size());
+}
+
+} // namespace
+
+BuildWorker::BuildWorker(std::shared_ptr<const nlohmann::json> snapshot, BuildRequest request, QObject* parent)
+    : QObject(parent), snapshot_(std::move(snapshot)), request_(std::move(request)) {}
+
+void BuildWorker::cancel() {
+    cancelled_.store(true, std::memory_order_relaxed);
+}
+
+bool BuildWorker::isCancelled() const {
+    return cancelled_.load(std::memory_order_relaxed);
+}
+
+void BuildWorker::run() {
+    // --- Save JSON Definition ---
+    emit progress(5, "Saving model");
+    if (!JsonPersistence::saveJsonToFile(*snapshot_, request_.jsonPath.toStdString())) {
+        emit finished(false, false, QString(), "Failed to save automaton model to JSON file: " + request_.jsonPath);
+        return;
+    }
+    emit diagnostic("Saved model to " + request_.jsonPath);
+    if (isCancelled()) {
+        emit finished(false, true, QString(), "Build cancelled.");
+        return;
+    }
+
+    // --- Generate C++ Code ---
+    emit progress(15, "Generating C++ code");
+    std::string cpp_code; // Kept for the build cache key
+    std::vector<CodeGenerator::Unit> units; // Split builds only
+    try {
+        CodeGenerator generator(request_.templatePath.toStdString());
+        if (request_.splitUnits) {
+            units = generator.generateUnits(*snapshot_, request_.unitsBaseName.toStdString());
+            if (!QDir().mkpath(request_.unitsDir)) {
+                throw CodeGenerator::GenerationError("Could not create directory: " + request_.unitsDir.toStdString());
+            }
+            QDir unitsDir(request_.unitsDir);
+            for (const CodeGenerator::Unit& unit : units) {
+                QString unitPath = unitsDir.filePath(QString::fromStdString(unit.fileName));
+                if (!writeIfChanged(unitPath, unit.code)) {
+                    throw CodeGenerator::GenerationError("Failed to write generated file: " + unitPath.toStdString());
+                }
+                cpp_code += unit.code; // The executable depends on every unit
+            }
+        } else {
+            cpp_code = generator.generate(*snapshot_);
+
+            std::ofstream cppFile(request_.generatedCppPath.toStdString());
+            if (!cppFile) {
+                throw CodeGenerator::GenerationError("Failed to open output C++ file for writing: " + request_.generatedCppPath.toStdString());
+            }
+            cppFile << cpp_code;
+            cppFile.close();
+            if (!cppFile) { // Check after closing
+                throw CodeGenerator::GenerationError("Failed to write to output C++ file: " + request_.generatedCppPath.toStdString());
+            }
+        }
+    } catch (const std::exception& e) {
+        QFile::remove(request_.generatedCppPath); // Do not leave an incomplete file behind
+        emit finished(false, false, QString(), QString("Failed to generate C++ code: %1").arg(e.what()));
+        return;
+    }
+    emit diagnostic(request_.splitUnits ? QString("Generated %1 files in %2").arg(units.size()).arg(request_.unitsDir)
+                                        : "Generated " + request_.generatedCppPath);
+    if (isCancelled()) {
+        emit finished(false, true, QString(), "Build cancelled.");
+        return;
+    }
+
+    // --- Reuse a cached build or compile ---
+    emit progress(25, "Looking up build cache");
+    BuildCache buildCache(request_.cacheDir);
+    QString cacheKey = buildCache.computeKey(cpp_code, request_.templatePath, request_.runtimeLibDir, request_.runtimeDir,
+                                             request_.compiler, request_.compileFlags + request_.linkFlags);
+    if (buildCache.fetch(cacheKey, request_.executablePath)) {
+        emit diagnostic("Build cache hit (" + cacheKey.left(12) + "), reusing executable.");
+        emit progress(100, "Done");
+        emit finished(true, false, request_.executablePath, "Automaton is up to date: " + request_.executablePath);
+        return;
+    }
+
+    emit progress(30, "Compiling");
+    QString message;
+    bool compiled = false;
+    if (request_.splitUnits) {
+        // Object files depend on the runtime, compiler and compile flags, but not on the other units
+        QString baseKey = buildCache.computeKey(std::string(), request_.templatePath, request_.runtimeLibDir,
+                                                request_.runtimeDir, request_.compiler, request_.compileFlags);
+        compiled = compileUnits(units, baseKey, message);
+    } else {
+        compiled = compileSingle(message);
+    }
+    if (!compiled) {
+        emit finished(false, isCancelled(), QString(), message);
+        return;
+    }
+    if (!buildCache.store(cacheKey, request_.executablePath)) {
+        emit diagnostic("Warning: could not store the compiled automaton in the build cache.");
+    }
+    emit progress(100, "Done");
+    emit finished(true, false, request_.executablePath, "Automaton compiled successfully: " + request_.executablePath);
+}
+
+bool BuildWorker::compileSingle(QString& message) {
+    QStringList arguments = request_.compileFlags;
+    arguments << request_.generatedCppPath;          // Input generated file
+    arguments << "-o" << request_.executablePath;    // Output executable file
+    arguments << request_.linkFlags;
+    return runCompilerJobs({arguments}, "Compiling", 30, 95, nullptr, message);
+}
+
+bool BuildWorker::compileUnits(const std::vector<CodeGenerator::Unit>& units, const QString& baseKey, QString& message) {
+    // units[0] is the header every source file includes
+    const CodeGenerator::Unit& header = units.front();
+    QDir unitsDir(request_.unitsDir);
+    QStringList objects;
+    QList<QStringList> jobs;
+    QStringList jobObjects;
+    QStringList jobKeys;
+    QSet<QString> currentFiles;
+    currentFiles << QString::fromStdString(header.fileName);
+
+    for (std::size_t i = 1; i < units.size(); ++i) {
+        QString sourceName = QString::fromStdString(units[i].fileName);
+        QString objectName = QFileInfo(sourceName).completeBaseName() + ".o";
+        currentFiles << sourceName << objectName << objectName + ".key";
+        QString source = unitsDir.filePath(sourceName);
+        QString object = unitsDir.filePath(objectName);
+        objects << object;
+
+        QCryptographicHash hash(QCryptographicHash::Sha256);
+        hash.addData(baseKey.toLatin1());
+        hash.addData(header.code.data(), static_cast<int>(header.code.size()));
+        hash.addData(units[i].code.data(), static_cast<int>(units[i].code.size()));
+        QByteArray key = hash.result().toHex();
+
+        QFile keyFile(object + ".key");
+        if (QFileInfo::exists(object) && keyFile.open(QIODevice::ReadOnly) && keyFile.readAll() == key) {
+            continue; // Up to date
+        }
+        keyFile.close();
+        QFile::remove(object + ".key"); // Invalid until the object is compiled again
+        jobs << (request_.compileFlags + QStringList{"-c", source, "-o", object});
+        jobObjects << object;
+        jobKeys << QString::fromLatin1(key);
+    }
+
+    // Files of states that were removed or renamed
+    const QStringList existing = unitsDir.entryList(QStringList() << request_.unitsBaseName + "_*", QDir::Files);
+    for (const QString& fileName : existing) {
+        if (!currentFiles.contains(fileName)) {
+            unitsDir.remove(fileName);
+        }
+    }
+
+    emit diagnostic(QString("%1 of %2 translation units changed.").arg(jobs.size()).arg(units.size() - 1));
+    auto storeKey = [&jobObjects, &jobKeys](int job) {
+        QFile keyFile(jobObjects[job] + ".key");
+        if (keyFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            keyFile.write(jobKeys[job].toLatin1());
+        }
+    };
+    if (!runCompilerJobs(jobs, "Compiling", 30, 85, storeKey, message)) {
+        return false;
+    }
+
+    QStringList linkArguments = objects;
+    linkArguments << "-o" << request_.executablePath;
+    linkArguments << request_.linkFlags;
+    emit progress(90, "Linking");
+    return runCompilerJobs({linkArguments}, "Linking", 90, 95, nullptr, message);
+}
+
+bool BuildWorker::runCompilerJobs(const QList<QStringList>& jobs, const QString& stage, int firstPercent, int lastPercent,
+                                  const std::function<void(int)>& jobSucceeded, QString& message) {
+    if (jobs.isEmpty()) {
+        return true;
+    }
+    const int maxRunning = std::max(1, QThread::idealThreadCount());
+
+    // The worker thread is busy in run(), so the processes are driven by a local event loop
+    QEventLoop loop;
+    QObject owner; // Parent of the compiler processes, deletes them on return
+    int nextJob = 0;
+    int runningJobs = 0;
+    int finishedJobs = 0;
+    bool failed = false;
+
+    auto killAll = [&owner]() {
+        for (QProcess* process : owner.findChildren<QProcess*>()) {
+            if (process->state() != QProcess::NotRunning) {
+                process->kill();
+            }
+        }
+    };
+
+    std::function<void()> startJobs;
+    auto finishJob = [&](int job, bool ok, const QString& error) {
+        --runningJobs;
+        ++finishedJobs;
+        if (ok) {
+            if (jobSucceeded) {
+                jobSucceeded(job);
+            }
+            emit progress(firstPercent + (lastPercent - firstPercent) * finishedJobs / jobs.size(),
+                          jobs.size() > 1 ? QString("%1 (%2/%3)").arg(stage).arg(finishedJobs).arg(jobs.size()) : stage);
+        } else if (!failed && !isCancelled()) {
+            failed = true;
+            message = error;
+            killAll(); // The result is known, do not wait for the other units
+        }
+        startJobs();
+    };
+
+    startJobs = [&]() {
+        while (!failed && !isCancelled() && runningJobs < maxRunning && nextJob < jobs.size()) {
+            const int job = nextJob++;
+            QProcess* process = new QProcess(&owner);
+            process->setWorkingDirectory(request_.projectPath); // Set working directory to project root
+            process->setProcessChannelMode(QProcess::MergedChannels); // Keep warnings and errors in order
+            connect(process, &QProcess::readyRead, &owner, [this, process]() { forwardOutput(*process, false); });
+            connect(process, &QProcess::errorOccurred, &owner, [&, process, job](QProcess::ProcessError error) {
+                if (error == QProcess::FailedToStart) { // finished() is not emitted in this case
+                    finishJob(job, false, "Could not start the compiler process: " + process->errorString());
+                }
+            });
+            connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), &owner,
+                    [&, process, job](int exitCode, QProcess::ExitStatus exitStatus) {
+                forwardOutput(*process, true);
+                if (exitStatus != QProcess::NormalExit) {
+                    finishJob(job, false, "Compiler process failed: " + process->errorString());
+                } else {
+                    finishJob(job, exitCode == 0, QString("Compiler exited with code %1.").arg(exitCode));
+                }
+            });
+            ++runningJobs;
+            emit diagnostic(request_.compiler + " " + jobs[job].join(" "));
+            process->start(request_.compiler, jobs[job]);
+        }
+        if (runningJobs == 0) {
+            loop.quit();
+        }
+    };
+
+    // cancel() is called from the GUI thread; poll the flag instead of blocking the worker thread
+    QTimer cancelTimer;
+    connect(&cancelTimer, &QTimer::timeout, &owner, [&]() {
+        if (isCancelled()) {
+            killAll();
+        }
+    });
+    cancelTimer.start(100);
+
+    startJobs();
+    if (runningJobs > 0) {
+        loop.exec();
+    }
+    cancelTimer.stop();
+
+    if (isCancelled()) {
+        message = "Build cancelled.";
+        QFile::remove(request_.executablePath);
+        return false;
+    }
+    return !failed;
+}
+
+void BuildWorker::forwardOutput(QProcess& process, bool includePartial) {
+    // Only the line break is stripped; leading spaces align the compiler's caret markers
+    auto forwardLine = [this](const QByteArray& line) {
+        QString text = QString::fromLocal8Bit(line);
+        while (text.endsWith('\n') || text.endsWith('\r')) {
+            text.chop(1);
+        }
+        emit diagnostic(text);
+    };
+    while (process.canReadLine()) {
+        forwardLine(process.readLine());
+    }
+    if (includePartial) {
+        QByteArray rest = process.readAll(); // Last line without a line break
+        if (!rest.isEmpty()) {
+            forwardLine(rest);
+        }
+    }
+}
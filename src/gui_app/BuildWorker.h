@@ -0,0 +1,168 @@
+/**
+ * @file BuildWorker.h
+ * @brief Declares the BuildWorker class, which saves, generates and compiles an automaton off the GUI thread.
+ * @details The worker operates on an immutable JSON snapshot of the Machine taken when the build was
+ * requested, so the user can keep editing the model while the build runs. Progress, compiler output
+ * and the result are reported through signals, which Qt delivers to the GUI thread.
+ * @authors xsimonl00, xsiaket00
+ * @date Last modified: 2025-05-05
+ */
+
+#ifndef BUILDWORKER_H
+#define BUILDWORKER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "nlohmann/json_fwd.hpp"
+#include "codegen/CodeGenerator.h"
+
+class QProcess;
+
+/**
+ * @brief Everything one build needs besides the model snapshot. All paths are absolute.
+ */
+struct BuildRequest {
+    /** @brief Path the JSON definition is saved to. */
+    QString jsonPath;
+    /** @brief Path the generated C++ source is written to. */
+    QString generatedCppPath;
+    /** @brief Path of the compiled executable. */
+    QString executablePath;
+    /** @brief Code generation template. */
+    QString templatePath;
+    /** @brief Working directory of the compiler. */
+    QString projectPath;
+    /** @brief Directory containing libifa_runtime. */
+    QString runtimeLibDir;
+    /** @brief Directory containing the runtime headers. */
+    QString runtimeDir;
+    /** @brief Directory of the build cache (see BuildCache). */
+    QString cacheDir;
+    /** @brief Compiler executable. */
+    QString compiler;
+    /** @brief Compiler flags placed before the source file. */
+    QStringList compileFlags;
+    /** @brief Linker flags placed after the output file. */
+    QStringList linkFlags;
+    /**
+     * @brief True to generate a header, a core source file and one source file per state.
+     * Only source files whose content changed are recompiled (in parallel), then all are linked.
+     */
+    bool splitUnits = false;
+    /** @brief Directory of the generated files and object files of a split build. */
+    QString unitsDir;
+    /** @brief Base name of the generated files of a split build. */
+    QString unitsBaseName;
+};
+
+/**
+ * @brief Runs one automaton build (save JSON, generate C++, compile or reuse a cached build).
+ * Meant to be moved to a QThread; run() is started from the thread's started() signal and
+ * finished() is emitted exactly once.
+ */
+class BuildWorker : public QObject {
+    Q_OBJECT // Required for signals and slots
+
+public:
+    /**
+     * @brief Constructor.
+     * @param snapshot JSON definition of the machine taken on the GUI thread; never modified.
+     * @param request Paths, compiler and flags of the build.
+     * @param parent Optional parent object (must be null if the worker is moved to another thread).
+     */
+    BuildWorker(std::shared_ptr<const nlohmann::json> snapshot, BuildRequest request, QObject* parent = nullptr);
+
+    /**
+     * @brief Requests cancellation. Thread-safe; the running compiler is killed within ~100 ms.
+     */
+    void cancel();
+
+public slots:
+    /**
+     * @brief Runs the build on the calling thread and emits finished() at the end.
+     */
+    void run();
+
+signals:
+    /**
+     * @brief Emitted when the build enters a new stage.
+     * @param percent Overall progress (0-100).
+     * @param stage Short description of the stage.
+     */
+    void progress(int percent, const QString& stage);
+
+    /**
+     * @brief Emitted for every line of compiler output (stdout and stderr merged) and build message.
+     * @param line The line without the trailing newline.
+     */
+    void diagnostic(const QString& line);
+
+    /**
+     * @brief Emitted once when the build ends.
+     * @param success True if the executable is ready.
+     * @param cancelled True if the build was cancelled.
+     * @param executablePath Path of the executable (valid if success is true).
+     * @param message Summary of the result, or the error.
+     */
+    void finished(bool success, bool cancelled, const QString& executablePath, const QString& message);
+
+private:
+    /**
+     * @brief Runs compiler invocations, up to one per CPU core at a time, streaming their output
+     *        through diagnostic() and stopping all of them on the first failure or on cancel().
+     * @param jobs Arguments of each compiler invocation.
+     * @param stage Description of the jobs reported with the progress (e.g. "Compiling").
+     * @param firstPercent Progress reported before the first job finishes.
+     * @param lastPercent Progress reported when all jobs have finished.
+     * @param jobSucceeded Called with the index of every job that succeeded.
+     * @param message Receives the error if a job fails.
+     * @return bool True if every job succeeded.
+     */
+    bool runCompilerJobs(const QList<QStringList>& jobs, const QString& stage, int firstPercent, int lastPercent,
+                         const std::function<void(int)>& jobSucceeded, QString& message);
+
+    /**
+     * @brief Compiles the single generated source file into the executable.
+     * @param message Receives the error if the compilation fails.
+     * @return bool True if the compiler succeeded.
+     */
+    bool compileSingle(QString& message);
+
+    /**
+     * @brief Compiles the changed translation units of a split build and links the executable.
+     * @details An object file is reused when the hash stored next to it (".key") matches the hash
+     *          of its source file, the shared header, and the compiler, flags and runtime.
+     * @param units Generated header and source files (see CodeGenerator::generateUnits()).
+     * @param baseKey Build cache key of the compiler, flags and runtime.
+     * @param message Receives the error if the build fails.
+     * @return bool True if the executable was linked.
+     */
+    bool compileUnits(const std::vector<CodeGenerator::Unit>& units, const QString& baseKey, QString& message);
+
+    /**
+     * @brief Emits the complete lines of compiler output available on a process.
+     * @param process The compiler process.
+     * @param includePartial True to also emit a last line without a line break.
+     */
+    void forwardOutput(QProcess& process, bool includePartial);
+
+    /**
+     * @brief Checks whether cancel() was called.
+     * @return bool True if the build should stop.
+     */
+    bool isCancelled() const;
+
+    /** @brief Immutable model snapshot. */
+    std::shared_ptr<const nlohmann::json> snapshot_;
+    /** @brief Paths, compiler and flags of the build. */
+    BuildRequest request_;
+    /** @brief Set by cancel(), polled by the build. */
+    std::atomic<bool> cancelled_{false};
+};
+
+#endif // BUILDWORKER_H
@@ -21,6 +21,8 @@ SOURCES += \
     mainwindow.cpp \
     GraphicsView.cpp \
     mainWindowUtils.cpp \
+    BuildCache.cpp \
+    BuildWorker.cpp \
     ../core/Machine.cpp \
     ../core/State.cpp \
     ../core/Transition.cpp \
@@ -28,15 +30,20 @@ SOURCES += \
     ../core/Input.cpp \
     ../core/Output.cpp \
     ../core/MachineElement.cpp \
+    ../core/Expression.cpp \
+    ../core/ExpressionBytecode.cpp \
     ../codegen/CodeGenerator.cpp \
     ../persistence/JsonPersistance.cpp \
     ../persistence/json_conversions.cpp \
+    ../persistence/io_call_rewriter.cpp \
 
 
 HEADERS += \
     mainwindow.h \
     GraphicsView.h \
     mainWindowUtils.h \
+    BuildCache.h \
+    BuildWorker.h \
     ../core/Machine.h \
     ../core/State.h \
     ../core/Transition.h \
@@ -44,9 +51,12 @@ HEADERS += \
     ../core/Input.h \
     ../core/Output.h \
     ../core/MachineElement.h \
+    ../core/Expression.h \
+    ../core/ExpressionBytecode.h \
     ../codegen/CodeGenerator.h \
     ../persistence/JsonPersistance.h \
     ../persistence/json_conversions.h \
+    ../persistence/io_call_rewriter.h \
 
 
 FORMS += mainwindow.ui
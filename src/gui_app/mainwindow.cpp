@@ -14,6 +14,7 @@
 #include "core/Transition.h" // Needed for creating Transition
 #include "mainWindowUtils.h" // Needed for utility functions
 #include "GraphicsView.h" // Needed for casting ui->graphicsView
+#include "BuildWorker.h" // Needed for building automatons off the GUI thread
 #include <memory>
 #include <QInputDialog>
 #include <QMessageBox>
@@ -47,8 +48,10 @@
 #include <QGroupBox>   
 #include <QCoreApplication> 
 #include <QDir>
+#include <QFileInfo>
 #include "persistence/JsonPersistance.h" 
-#include "codegen/CodeGenerator.h"
+#include "persistence/json_conversions.h" // Needed for the model snapshot of a build
+#include "nlohmann/json.hpp"
 #include <fstream>
 #include <QProcess>
 #include <QUdpSocket> 
@@ -56,7 +59,18 @@
 #include <QFileDialog> 
 #include <QStandardPaths> 
 #include <QLayout>
+#include <QDockWidget>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QPlainTextEdit>
+#include <QHBoxLayout>
+#include <QStatusBar>
+#include <QFontDatabase>
+#include <QTimer>
+#include <QToolBar>
+#include <QAction>
 #include <chrono> 
+#include <algorithm>
 #include <thread> 
 
 MainWindow::MainWindow(QWidget *parent)
@@ -197,13 +211,144 @@ MainWindow::MainWindow(QWidget *parent)
     guiSocket_ = new QUdpSocket(this);
     connect(guiSocket_, &QUdpSocket::readyRead, this, &MainWindow::processPendingDatagrams);
     bindGuiSocket(); // Ensure the socket is listening
-    
+
+    setupBuildPanel();
+    setupSimulationToolBar();
 }
 
 MainWindow::~MainWindow() {
+    // The worker must not outlive the window it reports to
+    if (buildWorker_) {
+        buildWorker_->cancel();
+    }
+    if (buildThread_) {
+        buildThread_->quit();
+        buildThread_->wait();
+    }
     delete ui;
 }
 
+void MainWindow::setupBuildPanel() {
+    buildDock_ = new QDockWidget("Build", this);
+    buildDock_->setObjectName("buildDock");
+    buildDock_->setAllowedAreas(Qt::BottomDockWidgetArea | Qt::RightDockWidgetArea);
+
+    QWidget* panel = new QWidget(buildDock_);
+    QVBoxLayout* panelLayout = new QVBoxLayout(panel);
+    QHBoxLayout* progressLayout = new QHBoxLayout();
+
+    buildProgressBar_ = new QProgressBar(panel);
+    buildProgressBar_->setRange(0, 100);
+    buildProgressBar_->setValue(0);
+    buildProgressBar_->setFormat("Idle");
+    buildCancelButton_ = new QPushButton("Cancel", panel);
+    buildCancelButton_->setEnabled(false);
+    connect(buildCancelButton_, &QPushButton::clicked, this, &MainWindow::onCancelBuildClicked);
+    progressLayout->addWidget(buildProgressBar_);
+    progressLayout->addWidget(buildCancelButton_);
+
+    buildLog_ = new QPlainTextEdit(panel);
+    buildLog_->setReadOnly(true);
+    buildLog_->setLineWrapMode(QPlainTextEdit::NoWrap);
+    buildLog_->setMaximumBlockCount(5000); // Bounded, a template error can print thousands of lines
+    buildLog_->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    panelLayout->addLayout(progressLayout);
+    panelLayout->addWidget(buildLog_);
+    buildDock_->setWidget(panel);
+    addDockWidget(Qt::BottomDockWidgetArea, buildDock_);
+    buildDock_->hide(); // Shown by the first build
+}
+
+
+void MainWindow::setupSimulationToolBar() {
+    QToolBar* toolBar = addToolBar("Simulation");
+    toolBar->setObjectName("simulationToolBar");
+    QAction* simulateAction = toolBar->addAction("Simulate");
+    simulateAction->setToolTip("Run the automaton in the built-in interpreter, without compiling it");
+    connect(simulateAction, &QAction::triggered, this, &MainWindow::onSimulateClicked);
+
+    simulationTimer_ = new QTimer(this);
+    simulationTimer_->setSingleShot(true);
+    simulationTimer_->setTimerType(Qt::PreciseTimer);
+    connect(simulationTimer_, &QTimer::timeout, this, &MainWindow::onSimulationTimer);
+}
+
+void MainWindow::onSimulateClicked() {
+    if (!machine) {
+        QMessageBox::critical(this, "Error", "No automaton model loaded or created.");
+        return;
+    }
+    if (machine->getInitialState() == nullptr) {
+        QMessageBox::warning(this, "Cancelled", "Automaton Initial State Is Not Set.");
+        return;
+    }
+    stopSimulation();
+
+    // The interpreter reports through the same handlers as a compiled automaton. Errors go to the
+    // status bar: a modal message box would run a nested event loop inside the interpreter.
+    machine->setInterpreterHandlers(
+        [this](const std::string& stateName) { handleAutomatonState(QString::fromStdString(stateName)); },
+        [this](const std::string& name, const std::string& value) {
+            handleAutomatonOutput(QString::fromStdString(name), QString::fromStdString(value));
+        },
+        [this](const std::string& name, const std::string& value) {
+            handleAutomatonVariable(QString::fromStdString(name), QString::fromStdString(value));
+        },
+        [this](const std::string& message) {
+            qWarning() << "[Interpreter ERROR]" << QString::fromStdString(message);
+            statusBar()->showMessage("Interpreter error: " + QString::fromStdString(message), 5000);
+        });
+
+    try {
+        simulating_ = true;
+        machine->start();
+    } catch (const std::runtime_error& e) {
+        simulating_ = false;
+        qWarning() << "Cannot interpret the automaton:" << e.what();
+        QMessageBox::warning(this, "Simulation",
+                             QString("The automaton cannot be interpreted:\n%1\n\nUse Run Automat to compile and run it.").arg(e.what()));
+        return;
+    }
+    setInputFieldsEnabled(true);
+    statusBar()->showMessage("Simulating '" + QString::fromStdString(machine->getName()) + "' in the interpreter.", 5000);
+    armSimulationTimer();
+}
+
+void MainWindow::onSimulationTimer() {
+    if (!simulating_ || !machine) {
+        return;
+    }
+    machine->step();
+    armSimulationTimer();
+}
+
+void MainWindow::armSimulationTimer() {
+    std::optional<std::chrono::steady_clock::time_point> expiry;
+    if (simulating_ && machine) {
+        expiry = machine->getNextTimerExpiry();
+    }
+    if (!expiry) {
+        simulationTimer_->stop();
+        return;
+    }
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(*expiry - std::chrono::steady_clock::now()).count();
+    // Rounded up, so the timer does not fire just before the transition is due
+    simulationTimer_->start(static_cast<int>(std::max<long long>(delay + 1, 0)));
+}
+
+void MainWindow::stopSimulation() {
+    if (!simulating_) {
+        return;
+    }
+    simulating_ = false;
+    simulationTimer_->stop();
+    if (machine) {
+        machine->requestTermination();
+        machine->setInterpreterHandlers(nullptr, nullptr, nullptr, nullptr);
+    }
+}
+
 
 void MainWindow::on_setInitialStateButton_clicked() {    
     qDebug() << "Run Automaton button clicked.";
@@ -262,6 +407,10 @@ void MainWindow::on_runAutomatButton_clicked() {
         QMessageBox::warning(this, "Cancelled", "Automaton Initial State Is Not Set.");
         return;
     }
+    if (buildThread_) {
+        statusBar()->showMessage("A build is already running.", 3000);
+        return;
+    }
     
 
     QString automatonName = QString::fromStdString(machine->getName());
@@ -293,114 +442,123 @@ void MainWindow::on_runAutomatButton_clicked() {
          qDebug() << "Directory already exists:" << targetAutomatonDir;
     }
 
-    // --- Save JSON Definition to Target Directory ---
-    QString jsonPath = targetAutomatonDir + "/" + safeDirName + ".json";
-    qDebug() << "Saving current model to JSON:" << jsonPath;
-    if (!JsonPersistence::saveToFile(*machine, jsonPath.toStdString())) { // Use the correct class for saving
-         QMessageBox::critical(this, "Error", "Failed to save automaton model to JSON file.");
-         return;
-    }
-
-    // --- Generate C++ Code to Target Directory ---
-    QString generatedCppPath = targetAutomatonDir + "/" + safeDirName + "_generated.cpp";
-    QString templatePath = projectPath + "/templates/automation_template.tpl"; // Path to the template
-
-    qDebug() << "Generating C++ code from template:" << templatePath << "to:" << generatedCppPath;
+    // --- Paths of the build ---
+    BuildRequest request;
+    request.jsonPath = targetAutomatonDir + "/" + safeDirName + ".json";
+    request.generatedCppPath = targetAutomatonDir + "/" + safeDirName + "_generated.cpp";
+    request.executablePath = targetAutomatonDir + "/" + safeDirName + "_automaton"; // Output file without extension for Linux
+    request.templatePath = projectPath + "/templates/automation_template.tpl"; // Path to the template
+    request.projectPath = projectPath;
+    request.runtimeLibDir = runtimeLibDir;
+    request.runtimeDir = projectPath + "/src/runtime";
+    // The key covers the rendered source, template, runtime library and headers, compiler and flags,
+    // so an unchanged machine reuses its executable and every real change is compiled.
+    request.cacheDir = targetBaseDir + "/.build_cache";
+
+    request.compiler = "g++"; // Assuming g++ is in PATH
+    // Flags are kept apart from the file paths, so they can be part of the build cache key.
+    // The runtime headers no longer include Asio (it is compiled into libifa_runtime).
+    request.compileFlags << "-std=c++17";
+    if (QFileInfo::exists(runtimeLibDir + "/ifa_runtime_pch.h.gch")) {
+        // Precompiled header built with the runtime library (see runtime.pro); GCC finds the .gch
+        // in the library directory before the header itself in the runtime source directory.
+        request.compileFlags << "-I" + runtimeLibDir;
+        request.compileFlags << "-include" << "ifa_runtime_pch.h";
+    }
+    request.compileFlags << "-I" + request.runtimeDir;   // Path to ifa_runtime headers
+    request.linkFlags << "-L" + runtimeLibDir;
+    request.linkFlags << "-lifa_runtime";
+    // Linker flags for Linux
+    request.linkFlags << "-lpthread";
+    request.linkFlags << "-lstdc++fs"; // Required for std::filesystem
+
+    // Large machines: a header, a core file and one file per state, recompiled incrementally
+    request.splitUnits = splitBuildMinStates_ > 0 && static_cast<int>(machine->getStates().size()) >= splitBuildMinStates_;
+    request.unitsDir = targetAutomatonDir + "/units";
+    request.unitsBaseName = safeDirName;
+
+    // --- Snapshot the model ---
+    // Serialized here, on the GUI thread; the build only reads the snapshot, so the user can keep
+    // editing the machine while it runs.
+    std::shared_ptr<const nlohmann::json> snapshot;
     try {
-        CodeGenerator generator(templatePath.toStdString());
-        // Assuming generate takes a Machine object and internally converts it to JSON
-        // Or if CodeGenerator reads JSON, it would read jsonPath
-        std::string cpp_code = generator.generate(*machine, jsonPath.toStdString());
-
-        std::ofstream cppFile(generatedCppPath.toStdString());
-        if (!cppFile) {
-             throw CodeGenerator::GenerationError("Failed to open output C++ file for writing: " + generatedCppPath.toStdString());
-        }
-        cppFile << cpp_code;
-        cppFile.close();
-         if (!cppFile) { // Check after closing
-             throw CodeGenerator::GenerationError("Failed to write to output C++ file: " + generatedCppPath.toStdString());
-         }
-         qInfo() << "C++ code generated successfully.";
-
-         QMessageBox::information(this, "Success", "Automaton JSON and C++ code generated successfully in:\n" + targetAutomatonDir);
-
+        snapshot = std::make_shared<const nlohmann::json>(*machine);
     } catch (const std::exception& e) {
-        QMessageBox::critical(this, "Code Generation Error", QString("Failed to generate C++ code: %1").arg(e.what()));
-        // Optionally delete incomplete files if an error occurred
-        QFile::remove(generatedCppPath);
-        // QFile::remove(jsonPath); // JSON was already successfully saved
+        QMessageBox::critical(this, "Error", QString("Failed to serialize the automaton model: %1").arg(e.what()));
         return;
     }
 
+    // --- Build on a worker thread ---
+    buildAutomatonName_ = automatonName;
+    buildLog_->clear();
+    buildProgressBar_->setValue(0);
+    buildProgressBar_->setFormat("%p%");
+    buildCancelButton_->setEnabled(true);
+    ui->runAutomatButton->setEnabled(false);
+    buildDock_->show();
+
+    QThread* thread = new QThread(this);
+    BuildWorker* worker = new BuildWorker(std::move(snapshot), std::move(request));
+    worker->moveToThread(thread);
+    connect(thread, &QThread::started, worker, &BuildWorker::run);
+    connect(worker, &BuildWorker::progress, this, &MainWindow::onBuildProgress);
+    connect(worker, &BuildWorker::diagnostic, this, &MainWindow::onBuildDiagnostic);
+    connect(worker, &BuildWorker::finished, this, &MainWindow::onBuildFinished);
+    connect(worker, &BuildWorker::finished, thread, &QThread::quit);
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    buildThread_ = thread;
+    buildWorker_ = worker;
+    thread->start();
+    qDebug() << "Build of" << automatonName << "started in the background.";
+}
 
+void MainWindow::onBuildProgress(int percent, const QString& stage) {
+    buildProgressBar_->setValue(percent);
+    buildProgressBar_->setFormat(stage + " (%p%)");
+    statusBar()->showMessage(stage + "...");
+}
 
+void MainWindow::onBuildDiagnostic(const QString& line) {
+    buildLog_->appendPlainText(line);
+}
 
-
-
-
-    // --- Compile C++ Code using g++ ---
-    QString executablePath = targetAutomatonDir + "/" + safeDirName + "_automaton"; // Output file without extension for Linux
-
-    qDebug() << "Compiling" << generatedCppPath << "to" << executablePath;
-
-    QString runtimeDir = projectPath + "/src/runtime";
-    QString asioInclude = projectPath + "/third_party/asio/include";
-
-    QString compiler = "g++"; // Assuming g++ is in PATH
-    QStringList arguments;
-    arguments << "-std=c++17";
-    arguments << "-I" + runtimeDir;         // Path to ifa_runtime headers
-    arguments << "-I" + asioInclude;        // Path to Asio headers
-    arguments << generatedCppPath;          // Input generated file
-    // Output executable file
-    arguments << "-o" << executablePath;
-    arguments << "-L" + runtimeLibDir;
-    arguments << "-lifa_runtime";
-    // Linker flags for Linux
-    arguments << "-lpthread";
-    arguments << "-lstdc++fs"; // Required for std::filesystem
-
-    QProcess compilerProcess;
-    qDebug() << "Compiler command:" << compiler << arguments.join(" ");
-    compilerProcess.setWorkingDirectory(projectPath); // Set working directory to project root
-    compilerProcess.start(compiler, arguments);
-
-    // Wait for compilation to complete and check for errors
-    if (!compilerProcess.waitForStarted(-1)) {
-         QMessageBox::critical(this, "Compilation Error", "Could not start the compiler process: " + compilerProcess.errorString());
-         return;
-    }
-    qDebug() << "Compiler process started, waiting for finish...";
-    if (!compilerProcess.waitForFinished(-1)) {
-         QMessageBox::critical(this, "Compilation Error", "Compiler process timed out or failed to finish: " + compilerProcess.errorString());
-         return;
+void MainWindow::onBuildFinished(bool success, bool cancelled, const QString& executablePath, const QString& message) {
+    buildWorker_ = nullptr;
+    buildThread_ = nullptr; // Deletes itself once its event loop has quit
+    buildCancelButton_->setEnabled(false);
+    ui->runAutomatButton->setEnabled(true);
+    buildLog_->appendPlainText(message);
+    statusBar()->showMessage(message, 5000);
+
+    if (!success) {
+        buildProgressBar_->setFormat(cancelled ? "Cancelled" : "Failed");
+        qWarning() << "Build failed:" << message;
+        return;
     }
+    buildProgressBar_->setFormat("Done");
+    qInfo() << message;
+    launchAutomaton(executablePath, buildAutomatonName_);
+}
 
-    qDebug() << "Compiler process finished with exit code:" << compilerProcess.exitCode();
-    if (compilerProcess.exitCode() != 0) {
-        QString errorOutput = compilerProcess.readAllStandardError();
-        QString stdOutput = compilerProcess.readAllStandardOutput();
-        qDebug() << "Compilation Error Output:\n" << errorOutput;
-        qDebug() << "Compilation Standard Output:\n" << stdOutput;
-        // Display error in a window
-        QMessageBox msgBox;
-        msgBox.setIcon(QMessageBox::Critical);
-        msgBox.setWindowTitle("Compilation Failed");
-        msgBox.setText(QString("Compiler exited with code %1.").arg(compilerProcess.exitCode()));
-        msgBox.setDetailedText("Standard Output:\n" + stdOutput + "\n\nError Output:\n" + errorOutput);
-        msgBox.exec();
-        return; // Compilation error
+void MainWindow::onCancelBuildClicked() {
+    if (buildWorker_) {
+        buildWorker_->cancel();
+        buildCancelButton_->setEnabled(false);
+        buildProgressBar_->setFormat("Cancelling...");
     }
+}
 
-    qInfo() << "Compilation successful: " << executablePath;
-    QMessageBox::information(this, "Compilation Successful", "Automaton compiled successfully:\n" + executablePath);
-
+void MainWindow::launchAutomaton(const QString& executablePath, const QString& automatonName) {
+    stopSimulation(); // Inputs go to the compiled automaton from now on
     // --- Run the compiled automaton (Detached) ---
     qDebug() << "portAutomat:" << QString::fromStdString(portAutomat);
     qDebug() << "portGUI:" << QString::fromStdString(portGUI);
 
     QStringList automatonArgs;
+    if (useBinaryProtocol_) {
+        automatonArgs << "--protocol" << "binary";
+    }
     automatonArgs << QString::number(std::stoi(portAutomat));
 
     automatonArgs << QString::number(std::stoi(portGUI));
@@ -412,11 +570,14 @@ void MainWindow::on_runAutomatButton_clicked() {
     qDebug() << "Arguments passed to automaton:" << automatonArgs;
 
     // Use QProcess::startDetached, which returns PID
-    if (QProcess::startDetached(executablePath, automatonArgs, targetAutomatonDir, &pid)) { // Fourth argument receives PID
+    QString workingDir = QFileInfo(executablePath).absolutePath();
+    if (QProcess::startDetached(executablePath, automatonArgs, workingDir, &pid)) { // Fourth argument receives PID
         qInfo() << "Automaton process" << automatonName << "started successfully (detached) with PID:" << pid;
-        QMessageBox::information(this, "Started", "Automaton '" + automatonName + "' started (PID: " + QString::number(pid) + ").\nListen Port: " + QString::number(std::stoi(portAutomat)) + "\nGUI Port: " + QString::number(std::stoi(portGUI)));
+        QString startedMessage = "Automaton '" + automatonName + "' started (PID: " + QString::number(pid) + "), listen port "
+                                 + QString::number(std::stoi(portAutomat)) + ", GUI port " + QString::number(std::stoi(portGUI)) + ".";
+        buildLog_->appendPlainText(startedMessage);
+        statusBar()->showMessage(startedMessage, 5000);
         setInputFieldsEnabled(true);
-        
 
     } else {
         qCritical() << "Failed to start detached automaton process.";
@@ -426,8 +587,6 @@ void MainWindow::on_runAutomatButton_clicked() {
     }
 
     qDebug() << "Starting automaton on PID:" << pid;
-
-    
 }
 
 void MainWindow::processPendingDatagrams()
@@ -438,228 +597,402 @@ void MainWindow::processPendingDatagrams()
         if (!datagram.isValid()) {
             continue; // Skip invalid datagram
         }
-        QString message = QString::fromUtf8(datagram.data());
+        QByteArray payload = datagram.data();
         QHostAddress senderAddress = datagram.senderAddress();
         quint16 senderPort = datagram.senderPort();
 
         // Log received message
-        qDebug() << "Received from" << senderAddress.toString() << ":" << senderPort << "->" << message;
-
-        // --- Parsing and Processing Message ---
-
-        if (message.startsWith("NAME ")) { // <<< HANDLE NEW MESSAGE
-            QString receivedName = message.mid(5).trimmed();
-            qInfo() << "Received NAME:" << receivedName;
-
-            if (waitingForAutomatonInfo) {
-                // Optional: Stop timeout timer if used
-                // if (connectionTimeoutTimer) connectionTimeoutTimer->stop();
-
-                connectedAutomatonName = receivedName; // Store the name
-                waitingForAutomatonInfo = false; // No longer waiting for initial info
-
-                // --- Construct JSON Path ---
-                QString safeDirName = connectedAutomatonName;
-                safeDirName.replace(QRegExp("[^a-zA-Z0-9_.-]"), "_");
-                QString appDirPath = QCoreApplication::applicationDirPath();
-                QDir buildSubDir(appDirPath);
-                buildSubDir.cdUp(); // Assumes build dir is one level down
-                buildSubDir.cdUp(); // Navigate up twice to reach project root (adjust if needed)
-                buildSubDir.cdUp(); // Navigate up twice to reach project root (adjust if needed)
-
-                QString projectPath = buildSubDir.absolutePath();
-                QString jsonPath = projectPath + "/generated_automatons/" + safeDirName + "/" + safeDirName + ".json";
-                qDebug() << "Looking for JSON definition at:" << jsonPath;
-
-                // --- Check and Load JSON ---
-                if (!QFile::exists(jsonPath)) {
-                    qCritical() << "Automaton definition file not found:" << jsonPath;
-                    QMessageBox::critical(this, "Error", "Connected to automaton '" + connectedAutomatonName + "', but its definition file was not found:\n" + jsonPath);
-                    connectedAutomatonName = ""; // Reset connection state
-                    return; // Stop processing this datagram stream for now
-                }
+        qDebug() << "Received from" << senderAddress.toString() << ":" << senderPort << "->" << payload;
 
-                std::unique_ptr<Machine> loadedMachine = JsonPersistence::loadFromFile(jsonPath.toStdString());
+        // Reply in the protocol the automaton speaks.
+        runtimeUsesBinary_ = ifa_runtime::protocol::isBinaryDatagram(payload.constData(), static_cast<std::size_t>(payload.size()));
 
-                // Check if loading was successful
-                if (!loadedMachine) {
-                    QMessageBox::critical(this, "Load Failed", "Could not load or parse the automaton model from the specified file.\nCheck console output for details.");
-                    qCritical() << "Failed to load machine from:" << jsonPath;
-                    return; // Error during loading
-                }
+        // A batch carries all updates of one automaton step, unpack it record by record.
+        runtimeInstance_ = 0;
+        if (runtimeUsesBinary_) {
+            processBinaryDatagram(payload);
+        } else if (payload.startsWith("BATCH\n")) {
+            processBatchDatagram(payload);
+        } else {
+            processRuntimeMessage(QString::fromUtf8(payload));
+        }
+    }
+}
 
-                qInfo() << "Successfully loaded machine '" << QString::fromStdString(loadedMachine->getName()) << "' from JSON.";
+void MainWindow::processBatchDatagram(const QByteArray& payload)
+{
+    int pos = 6; // Skip "BATCH\n"
+    while (pos < payload.size()) {
+        // Each record is "<length>:<message>"
+        int colon = payload.indexOf(':', pos);
+        bool ok = false;
+        int length = (colon == -1) ? -1 : payload.mid(pos, colon - pos).toInt(&ok);
+        if (!ok || length < 0 || colon + 1 + length > payload.size()) {
+            qWarning() << "Malformed BATCH datagram, dropping remaining records.";
+            return;
+        }
+        processRuntimeMessage(QString::fromUtf8(payload.mid(colon + 1, length)));
+        pos = colon + 1 + length;
+    }
+}
 
-                // --- START OF GUI AND MODEL RESET ---
-                qDebug() << "Preparing to switch models. Clearing old GUI elements and model...";
+void MainWindow::processRuntimeMessage(const QString& message)
+{
+    // --- Parsing the text protocol; the handlers are shared with the binary protocol ---
 
-                // Disconnect old scene 'changed' listeners and clear Graphics Scene
-                for (const auto& conn : stateMoveConnections) {
-                    QObject::disconnect(conn);
-                }
-                stateMoveConnections.clear();
-                qDebug() << "Disconnected old state movement scene listeners.";
-
-                scene->clear();
-                qDebug() << "Graphics scene cleared.";
-
-                // Clear UI Lists (Variables, Inputs, Outputs) by resetting their QGroupBox layouts
-                clearVariableList();
-                clearInputList();
-                clearOutputList();
-                qDebug() << "UI lists (variables, inputs, outputs) cleared by resetting group box layouts.";
-
-                // Delete the old Machine object, if it exists
-                if (machine) {
-                    delete machine;
-                    machine = nullptr;
-                    qDebug() << "Old machine model deleted.";
-                }
+    if (message.startsWith("INSTANCE ")) {
+        runtimeInstance_ = message.mid(9).trimmed().toUInt();
+        return;
+    }
+    if (runtimeInstance_ != 0) {
+        return; // Only instance 0 is shown
+    }
+
+    if (message.startsWith("NAME ")) {
+        handleAutomatonName(message.mid(5).trimmed());
+    } else if (message.startsWith("READY ")) {
+        QString automatonName = message.mid(6);
+        qInfo() << "Automaton" << automatonName << "is READY.";
+    } else if (message.startsWith("STATE ")) {
+        handleAutomatonState(message.mid(6).trimmed());
+    } else if (message.startsWith("OUTPUT ")) {
+        // Parsing: OUTPUT output_name="value"
+        QString dataPart = message.mid(7); // Remove "OUTPUT "
+        int assignmentPos = dataPart.indexOf('=');
+        if (assignmentPos != -1) {
+            QString outputName = dataPart.left(assignmentPos).trimmed();
+            QString outputValue = dataPart.mid(assignmentPos + 1).trimmed();
+            // Remove potential quotes around the value
+            if (outputValue.length() >= 2 && outputValue.startsWith('"') && outputValue.endsWith('"')) {
+                outputValue = outputValue.mid(1, outputValue.length() - 2);
+            }
+            handleAutomatonOutput(outputName, outputValue);
+        } else {
+            qWarning() << "Malformed OUTPUT message:" << message;
+        }
+    } else if (message.startsWith("VAR ")) {
+        // Parsing: VAR var_name="value" (same as OUTPUT)
+        QString dataPart = message.mid(4); // Remove "VAR "
+        int assignmentPos = dataPart.indexOf('=');
+        if (assignmentPos != -1) {
+            QString varName = dataPart.left(assignmentPos).trimmed();
+            QString varValue = dataPart.mid(assignmentPos + 1).trimmed();
+            if (varValue.length() >= 2 && varValue.startsWith('"') && varValue.endsWith('"')) {
+                varValue = varValue.mid(1, varValue.length() - 2);
+            }
+            handleAutomatonVariable(varName, varValue);
+        } else {
+            qWarning() << "Malformed VAR message:" << message;
+        }
+    } else if (message.startsWith("LOG ")) {
+        handleAutomatonLog(message.mid(4)); // Text after "LOG "
+    } else if (message.startsWith("ERROR ")) {
+        handleAutomatonError(message.mid(6)); // Text after "ERROR "
+    } else if (message == "TERMINATING") {
+        handleAutomatonTerminating();
+    } else {
+        qWarning() << "Received unknown message format from runtime:" << message;
+    }
+}
 
-                // Take ownership of the new Machine object
-                machine = loadedMachine.release();
-                qDebug() << "Took ownership of the newly loaded machine object: " << QString::fromStdString(machine->getName());
-                // --- END OF GUI AND MODEL RESET ---
+void MainWindow::processBinaryDatagram(const QByteArray& payload)
+{
+    using namespace ifa_runtime::protocol;
 
-                // --- Populate GUI with new model ---
-                qDebug() << "Redrawing automaton and populating UI from the new model...";
-                redrawAutomatonFromModel(); // Redraws states and transitions on the scene
-                populateUIFromModel();      // Populates QGroupBoxes for vars, ins, outs
+    RecordReader reader(payload.constData(), static_cast<std::size_t>(payload.size()));
+    if (!reader.valid()) {
+        qWarning() << "Received binary datagram with unsupported protocol version, dropping it.";
+        return;
+    }
 
-                setInputFieldsEnabled(true); // Default for a newly loaded, non-connected automaton
-                
-                // Update global ID counters for NEW items to be added via GUI
-                int maxStateIdEncountered = -1;
-                if (machine) {
-                    for (const auto& state_pair : machine->getStates()) {
-                        if (state_pair.second && state_pair.second->getStateId() > maxStateIdEncountered) {
-                            maxStateIdEncountered = state_pair.second->getStateId();
-                        }
-                    }
-                    this->objectStateId = maxStateIdEncountered + 1;
-
-                    int maxTransIdEncountered = -1;
-                    for (const auto& trans_ptr : machine->getTransitions()) {
-                        if (trans_ptr && trans_ptr->getTransitionId() > maxTransIdEncountered) {
-                            maxTransIdEncountered = trans_ptr->getTransitionId();
-                        }
-                    }
-                    this->objectTransitionId = maxTransIdEncountered + 1;
-                    qDebug() << "MainWindow ID counters updated: nextStateId=" << this->objectStateId
-                            << ", nextTransitionId=" << this->objectTransitionId;
-                }
+    // Resolves the id at the start of a record's payload to a symbol name.
+    auto resolve = [this](SymbolKind kind, std::string_view recordPayload, QString& name, QString& value) {
+        std::uint16_t id = 0;
+        std::string_view rawValue;
+        const QStringList& names = runtimeSymbols_[static_cast<std::size_t>(kind)];
+        if (!splitIdPayload(recordPayload, id, rawValue) || id >= names.size()) {
+            return false;
+        }
+        name = names.at(id);
+        value = QString::fromUtf8(rawValue.data(), static_cast<int>(rawValue.size()));
+        return true;
+    };
+    auto text = [](std::string_view recordPayload) {
+        return QString::fromUtf8(recordPayload.data(), static_cast<int>(recordPayload.size()));
+    };
 
+    Record record;
+    while (reader.next(record)) {
+        QString name;
+        QString value;
+        if (record.type == RecordType::Instance) {
+            std::uint32_t instance = 0;
+            if (!readInstancePayload(record.payload, instance)) {
+                qWarning() << "Malformed INSTANCE record, dropping remaining records.";
+                return;
+            }
+            runtimeInstance_ = instance;
+            continue;
+        }
+        if (runtimeInstance_ != 0) {
+            continue; // Only instance 0 is shown
+        }
+        switch (record.type) {
+        case RecordType::Name:
+            // A new symbol table follows the name, forget the previous one.
+            for (QStringList& names : runtimeSymbols_) {
+                names.clear();
+            }
+            handleAutomatonName(text(record.payload).trimmed());
+            break;
+        case RecordType::Ready:
+            for (QStringList& names : runtimeSymbols_) {
+                names.clear();
+            }
+            qInfo() << "Automaton" << text(record.payload) << "is READY.";
+            break;
+        case RecordType::Symbol: {
+            // Payload: kind byte, 16-bit id, name
+            std::uint16_t id = 0;
+            std::string_view symbol;
+            if (record.payload.empty() || static_cast<std::uint8_t>(record.payload[0]) >= kSymbolKindCount ||
+                !splitIdPayload(record.payload.substr(1), id, symbol)) {
+                qWarning() << "Malformed symbol record from runtime.";
+                break;
+            }
+            QStringList& names = runtimeSymbols_[static_cast<std::uint8_t>(record.payload[0])];
+            while (names.size() <= id) {
+                names.append(QString());
+            }
+            names[id] = text(symbol);
+            break;
+        }
+        case RecordType::State:
+            if (resolve(SymbolKind::State, record.payload, name, value)) {
+                handleAutomatonState(name);
             } else {
-                // Received NAME unexpectedly (already connected?) - maybe just log
-                 qWarning() << "Received NAME message while not expecting it (already connected?). Name:" << receivedName;
+                qWarning() << "STATE record with unknown state id.";
             }
-        }else if (message.startsWith("READY ")) {
-            QString automatonName = message.mid(6);
-            qInfo() << "Automaton" << automatonName << "is READY.";
-            
-
-        } else if (message.startsWith("STATE ")) {
-            QString activeStateName = message.mid(6).trimmed();
-            qInfo() << "Automaton entered state:" << activeStateName;
-           
-            // Reset color of ALL states to normal
-            GraphicsView* gView = ui->graphicsView;
-            QGraphicsScene* scene = gView->scene();
-
-            // Iterate through all items in the scene
-            for (QGraphicsItem* item : scene->items()) {
-                QGraphicsEllipseItem* ellipse = dynamic_cast<QGraphicsEllipseItem*>(item);
-                if (ellipse) {
-                    QString ellipseName = ellipse->data(0).toString();  // Read state name
-                    if (ellipseName == activeStateName) {
-                        ellipse->setBrush(QBrush(activeStateColor));
-                    } else {
-                        ellipse->setBrush(QBrush(normalStateColor));
-                    }
-                }
+            break;
+        case RecordType::Output:
+            if (resolve(SymbolKind::Output, record.payload, name, value)) {
+                handleAutomatonOutput(name, value);
+            } else {
+                qWarning() << "OUTPUT record with unknown output id.";
+            }
+            break;
+        case RecordType::Variable:
+            if (resolve(SymbolKind::Variable, record.payload, name, value)) {
+                handleAutomatonVariable(name, value);
+            } else {
+                qWarning() << "VAR record with unknown variable id.";
             }
+            break;
+        case RecordType::Log:
+            handleAutomatonLog(text(record.payload));
+            break;
+        case RecordType::Error:
+            handleAutomatonError(text(record.payload));
+            break;
+        case RecordType::Terminating:
+            handleAutomatonTerminating();
+            break;
+        case RecordType::Text:
+            processRuntimeMessage(text(record.payload));
+            break;
+        default:
+            qWarning() << "Received unexpected binary record type" << static_cast<int>(record.type);
+            break;
+        }
+    }
+    if (reader.malformed()) {
+        qWarning() << "Malformed binary datagram, dropping remaining records.";
+    }
+}
 
-        } else if (message.startsWith("OUTPUT ")) {
-            // Parsing: OUTPUT output_name="value"
-            QString dataPart = message.mid(7); // Remove "OUTPUT "
-            int assignmentPos = dataPart.indexOf('=');
-            if (assignmentPos != -1) {
-                QString outputName = dataPart.left(assignmentPos).trimmed();
-                QString outputValue = dataPart.mid(assignmentPos + 1).trimmed();
-                // Remove potential quotes around the value
-                if (outputValue.length() >= 2 && outputValue.startsWith('"') && outputValue.endsWith('"')) {
-                    outputValue = outputValue.mid(1, outputValue.length() - 2);
-                }
-                qInfo() << "Received OUTPUT:" << outputName << "=" << outputValue;
-                
-                updateOutputDisplay(outputName.toStdString(), outputValue.toStdString());
+void MainWindow::handleAutomatonName(const QString& receivedName)
+{
+    qInfo() << "Received NAME:" << receivedName;
+
+    if (waitingForAutomatonInfo) {
+        // Optional: Stop timeout timer if used
+        // if (connectionTimeoutTimer) connectionTimeoutTimer->stop();
+
+        connectedAutomatonName = receivedName; // Store the name
+        waitingForAutomatonInfo = false; // No longer waiting for initial info
+
+        // --- Construct JSON Path ---
+        QString safeDirName = connectedAutomatonName;
+        safeDirName.replace(QRegExp("[^a-zA-Z0-9_.-]"), "_");
+        QString appDirPath = QCoreApplication::applicationDirPath();
+        QDir buildSubDir(appDirPath);
+        buildSubDir.cdUp(); // Assumes build dir is one level down
+        buildSubDir.cdUp(); // Navigate up twice to reach project root (adjust if needed)
+        buildSubDir.cdUp(); // Navigate up twice to reach project root (adjust if needed)
+
+        QString projectPath = buildSubDir.absolutePath();
+        QString jsonPath = projectPath + "/generated_automatons/" + safeDirName + "/" + safeDirName + ".json";
+        qDebug() << "Looking for JSON definition at:" << jsonPath;
+
+        // --- Check and Load JSON ---
+        if (!QFile::exists(jsonPath)) {
+            qCritical() << "Automaton definition file not found:" << jsonPath;
+            QMessageBox::critical(this, "Error", "Connected to automaton '" + connectedAutomatonName + "', but its definition file was not found:\n" + jsonPath);
+            connectedAutomatonName = ""; // Reset connection state
+            return; // Stop processing this message
+        }
 
+        std::unique_ptr<Machine> loadedMachine = JsonPersistence::loadFromFile(jsonPath.toStdString());
 
+        // Check if loading was successful
+        if (!loadedMachine) {
+            QMessageBox::critical(this, "Load Failed", "Could not load or parse the automaton model from the specified file.\nCheck console output for details.");
+            qCritical() << "Failed to load machine from:" << jsonPath;
+            return; // Error during loading
+        }
 
-            } else {
-                qWarning() << "Malformed OUTPUT message:" << message;
-            }
+        qInfo() << "Successfully loaded machine '" << QString::fromStdString(loadedMachine->getName()) << "' from JSON.";
+
+        // --- START OF GUI AND MODEL RESET ---
+        qDebug() << "Preparing to switch models. Clearing old GUI elements and model...";
+
+        // Disconnect old scene 'changed' listeners and clear Graphics Scene
+        for (const auto& conn : stateMoveConnections) {
+            QObject::disconnect(conn);
+        }
+        stateMoveConnections.clear();
+        qDebug() << "Disconnected old state movement scene listeners.";
+
+        scene->clear();
+        qDebug() << "Graphics scene cleared.";
+
+        // Clear UI Lists (Variables, Inputs, Outputs) by resetting their QGroupBox layouts
+        clearVariableList();
+        clearInputList();
+        clearOutputList();
+        qDebug() << "UI lists (variables, inputs, outputs) cleared by resetting group box layouts.";
+
+        // Delete the old Machine object, if it exists
+        stopSimulation();
+        if (machine) {
+            delete machine;
+            machine = nullptr;
+            qDebug() << "Old machine model deleted.";
+        }
+
+        // Take ownership of the new Machine object
+        machine = loadedMachine.release();
+        qDebug() << "Took ownership of the newly loaded machine object: " << QString::fromStdString(machine->getName());
+        // --- END OF GUI AND MODEL RESET ---
+
+        // --- Populate GUI with new model ---
+        qDebug() << "Redrawing automaton and populating UI from the new model...";
+        redrawAutomatonFromModel(); // Redraws states and transitions on the scene
+        populateUIFromModel();      // Populates QGroupBoxes for vars, ins, outs
 
-        } else if (message.startsWith("VAR ")) {
-            // Parsing: VAR var_name="value" (same as OUTPUT)
-             QString dataPart = message.mid(4); // Remove "VAR "
-            int assignmentPos = dataPart.indexOf('=');
-            if (assignmentPos != -1) {
-                QString varName = dataPart.left(assignmentPos).trimmed();
-                QString varValue = dataPart.mid(assignmentPos + 1).trimmed();
-                if (varValue.length() >= 2 && varValue.startsWith('"') && varValue.endsWith('"')) {
-                    varValue = varValue.mid(1, varValue.length() - 2);
+        setInputFieldsEnabled(true); // Default for a newly loaded, non-connected automaton
+        
+        // Update global ID counters for NEW items to be added via GUI
+        int maxStateIdEncountered = -1;
+        if (machine) {
+            for (const auto& state_pair : machine->getStates()) {
+                if (state_pair.second && state_pair.second->getStateId() > maxStateIdEncountered) {
+                    maxStateIdEncountered = state_pair.second->getStateId();
                 }
-                qInfo() << "Received VAR update:" << varName << "=" << varValue;
-                Variable* variable = machine->getVariable(varName.toStdString());
-                if (variable) {
-                    variable->setValue(varValue.toStdString());
+            }
+            this->objectStateId = maxStateIdEncountered + 1;
+
+            int maxTransIdEncountered = -1;
+            for (const auto& trans_ptr : machine->getTransitions()) {
+                if (trans_ptr && trans_ptr->getTransitionId() > maxTransIdEncountered) {
+                    maxTransIdEncountered = trans_ptr->getTransitionId();
                 }
+            }
+            this->objectTransitionId = maxTransIdEncountered + 1;
+            qDebug() << "MainWindow ID counters updated: nextStateId=" << this->objectStateId
+                    << ", nextTransitionId=" << this->objectTransitionId;
+        }
+
+    } else {
+        // Received NAME unexpectedly (already connected?) - maybe just log
+         qWarning() << "Received NAME message while not expecting it (already connected?). Name:" << receivedName;
+    }
+}
 
-                // NOW SAVE TO GUI:
-                updateVariableDisplay(varName.toStdString(), varValue.toStdString());
+void MainWindow::handleAutomatonState(const QString& activeStateName)
+{
+    qInfo() << "Automaton entered state:" << activeStateName;
+   
+    // Reset color of ALL states to normal
+    GraphicsView* gView = ui->graphicsView;
+    QGraphicsScene* scene = gView->scene();
 
+    // Iterate through all items in the scene
+    for (QGraphicsItem* item : scene->items()) {
+        QGraphicsEllipseItem* ellipse = dynamic_cast<QGraphicsEllipseItem*>(item);
+        if (ellipse) {
+            QString ellipseName = ellipse->data(0).toString();  // Read state name
+            if (ellipseName == activeStateName) {
+                ellipse->setBrush(QBrush(activeStateColor));
             } else {
-                qWarning() << "Malformed VAR message:" << message;
+                ellipse->setBrush(QBrush(normalStateColor));
             }
+        }
+    }
+}
 
-        } else if (message.startsWith("LOG ")) {
-            QString logMsg = message.mid(4); // Get text after "LOG "
-            qInfo() << "[Automaton LOG]" << logMsg;
+void MainWindow::handleAutomatonOutput(const QString& outputName, const QString& outputValue)
+{
+    qInfo() << "Received OUTPUT:" << outputName << "=" << outputValue;
+    updateOutputDisplay(outputName.toStdString(), outputValue.toStdString());
+}
 
-            // Special handling for DEFINITION_PATH (if using this solution)
-            if (logMsg.startsWith("DEFINITION_PATH:")) {
-                QString jsonPath = logMsg.mid(16); // Remove "DEFINITION_PATH:"
-                qInfo() << "Received automaton definition path:" << jsonPath;
-                
-            } else {
-                 
-            }
+void MainWindow::handleAutomatonVariable(const QString& varName, const QString& varValue)
+{
+    qInfo() << "Received VAR update:" << varName << "=" << varValue;
+    Variable* variable = machine ? machine->getVariable(varName.toStdString()) : nullptr;
+    if (variable) {
+        variable->setValue(varValue.toStdString());
+    }
 
-        } else if (message.startsWith("ERROR ")) {
-            QString errorMsg = message.mid(6); // Get text after "ERROR "
-            qWarning() << "[Automaton ERROR]" << errorMsg;
-            
-            QMessageBox::warning(this, "Automaton Error", errorMsg);
+    // NOW SAVE TO GUI:
+    updateVariableDisplay(varName.toStdString(), varValue.toStdString());
+}
 
+void MainWindow::handleAutomatonLog(const QString& logMsg)
+{
+    qInfo() << "[Automaton LOG]" << logMsg;
 
-        } else if (message == "TERMINATING") {
-            qInfo() << "Automaton is TERMINATING.";
-           
-            QMessageBox::information(this, "Automaton", "Automaton terminating...");
-            setInputFieldsEnabled(false);
-            
+    // Special handling for DEFINITION_PATH (if using this solution)
+    if (logMsg.startsWith("DEFINITION_PATH:")) {
+        QString jsonPath = logMsg.mid(16); // Remove "DEFINITION_PATH:"
+        qInfo() << "Received automaton definition path:" << jsonPath;
+        
+    } else {
+         
+    }
+}
 
-            for (QGraphicsItem* item : scene->items()) {
-                QGraphicsEllipseItem* ellipse = dynamic_cast<QGraphicsEllipseItem*>(item);
-                if (ellipse) {
-                    QString ellipseName = ellipse->data(0).toString();  // Read state name
-                    ellipse->setBrush(QBrush(normalStateColor));
-                }
-            }
+void MainWindow::handleAutomatonError(const QString& errorMsg)
+{
+    qWarning() << "[Automaton ERROR]" << errorMsg;
+    
+    QMessageBox::warning(this, "Automaton Error", errorMsg);
+}
 
-        } else {
-            qWarning() << "Received unknown message format from runtime:" << message;
+void MainWindow::handleAutomatonTerminating()
+{
+    qInfo() << "Automaton is TERMINATING.";
+   
+    QMessageBox::information(this, "Automaton", "Automaton terminating...");
+    setInputFieldsEnabled(false);
+    
+
+    for (QGraphicsItem* item : scene->items()) {
+        QGraphicsEllipseItem* ellipse = dynamic_cast<QGraphicsEllipseItem*>(item);
+        if (ellipse) {
+            QString ellipseName = ellipse->data(0).toString();  // Read state name
+            ellipse->setBrush(QBrush(normalStateColor));
         }
     }
 }
@@ -714,16 +1047,28 @@ void MainWindow::updateStateItemColor(QGraphicsItemGroup* item, const QColor& co
 }
 
 void MainWindow::on_terminateAutomatButton_clicked(){
+    if (simulating_) {
+        stopSimulation();
+        handleAutomatonTerminating();
+        return;
+    }
     if (!guiSocket_) {
         qWarning() << "Cannot send TERMINATE message: guiSocket_ is null.";
         return;
     }
 
-    QString message = "CMD|TERMINATE|";
+    QByteArray datagram = "CMD|TERMINATE|";
+    if (runtimeUsesBinary_) {
+        std::string encoded;
+        ifa_runtime::protocol::appendHeader(encoded);
+        char command = static_cast<char>(ifa_runtime::protocol::Command::Terminate);
+        ifa_runtime::protocol::appendRecord(encoded, ifa_runtime::protocol::RecordType::Command, std::string_view(&command, 1));
+        datagram = QByteArray(encoded.data(), static_cast<int>(encoded.size()));
+    }
     QHostAddress runtimeAddr("127.0.0.1");
     quint16 port = static_cast<quint16>(std::stoi(portAutomat)); // portAutomat už máš
 
-    qint64 bytesSent = guiSocket_->writeDatagram(message.toUtf8(), runtimeAddr, port);
+    qint64 bytesSent = guiSocket_->writeDatagram(datagram, runtimeAddr, port);
 
     if (bytesSent == -1) {
         qWarning() << "Failed to send TERMINATE datagram:" << guiSocket_->errorString();
@@ -778,6 +1123,7 @@ void MainWindow::on_connectButton_clicked(){
         qDebug() << "Clearing existing automaton view and model.";
         scene->clear(); // Clear graphics
         
+        stopSimulation();
         delete machine; // Delete the old machine object
         machine = nullptr;
         connectedAutomatonName = "";
@@ -948,6 +1294,7 @@ void MainWindow::on_loadJsonButton_clicked() {
     qDebug() << "UI lists (variables, inputs, outputs) cleared by resetting group box layouts.";
 
     // Delete the old Machine object, if it exists
+    stopSimulation();
     if (machine) {
         delete machine;
         machine = nullptr;
@@ -1687,6 +2034,11 @@ void MainWindow::handleInputReturnPressed() {
     }
     input->updateValue(senderEdit->text().toStdString());
     qDebug() << "Input value edited:" << varName << "New value:" << QString::fromStdString(input->getLastValue().value_or("No value"));
+    if (simulating_) {
+        machine->processInputEvent(varName.toStdString(), senderEdit->text().toStdString());
+        armSimulationTimer();
+        return;
+    }
    //ODOSLANIE
    if (!guiSocket_) {
     qWarning() << "Cannot send INPUT message: guiSocket_ is null.";
@@ -1694,10 +2046,21 @@ void MainWindow::handleInputReturnPressed() {
     }
 
     QString newValue = senderEdit->text();
-    QString message = QString("INPUT|%1|%2").arg(varName).arg(newValue);
+    QByteArray datagram;
+    int inputId = runtimeSymbols_[static_cast<std::size_t>(ifa_runtime::protocol::SymbolKind::Input)].indexOf(varName);
+    if (runtimeUsesBinary_ && inputId >= 0) {
+        // Binary INPUT record: the value is sent as raw bytes, so '|' or quotes need no escaping.
+        std::string encoded;
+        ifa_runtime::protocol::appendHeader(encoded);
+        ifa_runtime::protocol::appendIdRecord(encoded, ifa_runtime::protocol::RecordType::Input,
+                                              static_cast<std::uint16_t>(inputId), newValue.toStdString());
+        datagram = QByteArray(encoded.data(), static_cast<int>(encoded.size()));
+    } else {
+        datagram = QString("INPUT|%1|%2").arg(varName).arg(newValue).toUtf8();
+    }
     QHostAddress runtimeAddr("127.0.0.1");
     quint16 port = static_cast<quint16>(std::stoi(portAutomat));
-    qint64 bytesSent = guiSocket_->writeDatagram(message.toUtf8(), runtimeAddr, port);
+    qint64 bytesSent = guiSocket_->writeDatagram(datagram, runtimeAddr, port);
 
     if (bytesSent == -1) {
         qWarning() << "Failed to send INPUT datagram:" << guiSocket_->errorString();
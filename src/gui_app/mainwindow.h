@@ -18,11 +18,15 @@
 #include <QGraphicsItemGroup> // Needed for pointer type
 #include "core/Machine.h"        // Include Automaton header
 #include <memory>             // For std::unique_ptr
+#include <array>
+#include "runtime/ifa_runtime_protocol.h" // Binary wire protocol shared with the runtime
 // #include "GraphicsView.h" // Include the custom view header - uncomment if using custom GraphicsView
 #include <QUdpSocket> // Potrebný include
 #include <QMap>
 #include <QColor> // Pre farby
 #include <QGroupBox>
+#include <QPointer>
+#include <QThread>
 
 // Forward declaration for the UI class (generated from .ui file)
 QT_BEGIN_NAMESPACE
@@ -31,6 +35,12 @@ QT_END_NAMESPACE
 
 // Forward declaration for the custom GraphicsView if not included above
 class GraphicsView;
+class BuildWorker;
+class QDockWidget;
+class QProgressBar;
+class QPushButton;
+class QPlainTextEdit;
+class QTimer;
 
 /**
  * @brief The main window of the application.
@@ -205,6 +215,43 @@ private slots:
      */
     void processPendingDatagrams();
 
+    /**
+     * @brief Slot receiving the progress of the background build.
+     * @param percent Overall progress (0-100).
+     * @param stage Short description of the current stage.
+     */
+    void onBuildProgress(int percent, const QString& stage);
+
+    /**
+     * @brief Slot receiving one line of compiler output or a build message.
+     * @param line The line to append to the build log.
+     */
+    void onBuildDiagnostic(const QString& line);
+
+    /**
+     * @brief Slot receiving the result of the background build; starts the automaton on success.
+     * @param success True if the executable is ready.
+     * @param cancelled True if the build was cancelled.
+     * @param executablePath Path of the compiled executable.
+     * @param message Summary of the result, or the error.
+     */
+    void onBuildFinished(bool success, bool cancelled, const QString& executablePath, const QString& message);
+
+    /**
+     * @brief Slot triggered by the Cancel button of the build panel.
+     */
+    void onCancelBuildClicked();
+
+    /**
+     * @brief Slot of the Simulate action: runs the machine in the in-process interpreter, without compiling it.
+     */
+    void onSimulateClicked();
+
+    /**
+     * @brief Slot of simulationTimer_: takes the delayed transitions which are due and re-arms the timer.
+     */
+    void onSimulationTimer();
+
     
 
 
@@ -250,6 +297,39 @@ private:
      * @brief Initializes the GUI components and sets up the graphics scene.
      */ 
     QString connectedAutomatonName = "";
+    /**
+     * @brief Symbol names announced by an automaton using the binary protocol.
+     * 
+     * Indexed by symbol kind (state, input, output, variable), each list indexed by symbol id.
+     * Filled from the Symbol records following the automaton's NAME or READY message.
+     */
+    std::array<QStringList, ifa_runtime::protocol::kSymbolKindCount> runtimeSymbols_;
+    /**
+     * @brief True if the last datagram received from the automaton used the binary protocol.
+     * 
+     * Inputs and commands are then sent to the automaton in the binary protocol as well.
+     */
+    bool runtimeUsesBinary_ = false;
+    /**
+     * @brief Automaton instance the messages currently being processed belong to.
+     * 
+     * Reset to 0 for every datagram and set by INSTANCE messages (Instance records in the
+     * binary protocol). The GUI monitors instance 0; updates of other instances are ignored.
+     */
+    quint32 runtimeInstance_ = 0;
+    /**
+     * @brief True to start compiled automatons with the binary protocol ("--protocol binary").
+     * 
+     * The text protocol remains available for debugging by starting the automaton manually.
+     */
+    bool useBinaryProtocol_ = true;
+    /**
+     * @brief Machines with at least this many states are built as one translation unit per state.
+     * 
+     * Editing a state then recompiles only that state's file and relinks; smaller machines are
+     * faster to build as a single file. 0 disables split builds.
+     */
+    int splitBuildMinStates_ = 32;
     /**
      * @brief Initializes the GUI components and sets up the graphics scene.
      */  
@@ -262,6 +342,53 @@ private:
      */
     QTimer *connectionTimeoutTimer = nullptr;
 
+    /** @brief Thread of the running build; null when no build is running. */
+    QPointer<QThread> buildThread_;
+    /** @brief Worker of the running build; deleted when its thread finishes. */
+    QPointer<BuildWorker> buildWorker_;
+    /** @brief Name of the automaton being built, used when it is started. */
+    QString buildAutomatonName_;
+    /** @brief Dock widget showing the build progress and compiler output. */
+    QDockWidget *buildDock_ = nullptr;
+    /** @brief Progress of the running build. */
+    QProgressBar *buildProgressBar_ = nullptr;
+    /** @brief Cancels the running build. */
+    QPushButton *buildCancelButton_ = nullptr;
+    /** @brief Compiler output and build messages. */
+    QPlainTextEdit *buildLog_ = nullptr;
+
+    /**
+     * @brief Creates the dock widget with the build progress bar, Cancel button and log.
+     */
+    void setupBuildPanel();
+
+    /** @brief Fires at the next delayed transition of the simulated machine. */
+    QTimer *simulationTimer_ = nullptr;
+    /** @brief True while the machine runs in the interpreter; inputs then go to it instead of the UDP socket. */
+    bool simulating_ = false;
+
+    /**
+     * @brief Creates the tool bar with the Simulate action and the simulation timer.
+     */
+    void setupSimulationToolBar();
+
+    /**
+     * @brief Arms simulationTimer_ for the next delayed transition of the simulated machine, or stops it if there is none.
+     */
+    void armSimulationTimer();
+
+    /**
+     * @brief Stops the interpreter; called before the machine is terminated or replaced.
+     */
+    void stopSimulation();
+
+    /**
+     * @brief Starts a compiled automaton as a detached process.
+     * @param executablePath Path of the automaton executable.
+     * @param automatonName Name of the automaton, for messages.
+     */
+    void launchAutomaton(const QString& executablePath, const QString& automatonName);
+
     /**
      * @brief Updates the display of a specific output with a new value.
      * 
@@ -428,6 +555,83 @@ private:
      */
     void bindGuiSocket();
 
+    /**
+     * @brief Handles one message received from the running automaton.
+     * 
+     * Parses the text protocol (NAME, READY, STATE, OUTPUT, VAR, LOG, ERROR,
+     * TERMINATING, INSTANCE) and passes the parts to the matching handleAutomaton* method.
+     * 
+     * @param message The complete message text.
+     */
+    void processRuntimeMessage(const QString& message);
+
+    /**
+     * @brief Unpacks a batch datagram and handles each contained message in order.
+     * 
+     * A batch datagram starts with "BATCH\n" followed by records "<length>:<message>",
+     * and carries all updates produced by one run-to-completion step of the automaton.
+     * 
+     * @param payload The raw datagram payload.
+     */
+    void processBatchDatagram(const QByteArray& payload);
+
+    /**
+     * @brief Decodes a binary protocol datagram and handles each contained record in order.
+     * 
+     * Symbol records update runtimeSymbols_; all other records are translated back to
+     * names via the symbol table and passed to the same handlers as the text protocol.
+     * 
+     * @param payload The raw datagram payload.
+     */
+    void processBinaryDatagram(const QByteArray& payload);
+
+    /**
+     * @brief Handles the automaton's name, the reply to GET_STATUS.
+     * 
+     * If the GUI is waiting for a connection, loads the automaton's JSON definition
+     * and rebuilds the model and the GUI from it.
+     * 
+     * @param receivedName The name of the automaton.
+     */
+    void handleAutomatonName(const QString& receivedName);
+
+    /**
+     * @brief Highlights the automaton's current state in the scene.
+     * @param activeStateName The name of the active state.
+     */
+    void handleAutomatonState(const QString& activeStateName);
+
+    /**
+     * @brief Shows a new output value.
+     * @param outputName The name of the output.
+     * @param outputValue The value sent to the output.
+     */
+    void handleAutomatonOutput(const QString& outputName, const QString& outputValue);
+
+    /**
+     * @brief Stores and shows a new variable value.
+     * @param varName The name of the variable.
+     * @param varValue The current value of the variable.
+     */
+    void handleAutomatonVariable(const QString& varName, const QString& varValue);
+
+    /**
+     * @brief Handles a log line sent by the automaton.
+     * @param logMsg The log text.
+     */
+    void handleAutomatonLog(const QString& logMsg);
+
+    /**
+     * @brief Reports an error sent by the automaton to the user.
+     * @param errorMsg The error text.
+     */
+    void handleAutomatonError(const QString& errorMsg);
+
+    /**
+     * @brief Handles the automaton shutting down: disables inputs and clears the state highlight.
+     */
+    void handleAutomatonTerminating();
+
     /**
      * @brief Clears all widgets and items from the given layout.
      * 
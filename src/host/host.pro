@@ -0,0 +1,28 @@
+# src/host/host.pro
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+TARGET = ifa_host
+
+INCLUDEPATH += \
+    $$PWD/..
+
+SOURCES += \
+    main.cpp \
+    ifa_host.cpp
+
+HEADERS += \
+    ifa_host.h
+
+QMAKE_CXXFLAGS += -w
+
+# The plugins are not linked against the runtime: the host links all of it (--whole-archive,
+# also the parts it does not use itself) and exports it to them (-rdynamic).
+unix {
+    LIBS += -Wl,--whole-archive -L$$OUT_PWD/../runtime -lifa_runtime -Wl,--no-whole-archive
+    LIBS += -ldl -lpthread
+    QMAKE_LFLAGS += -rdynamic
+    PRE_TARGETDEPS += $$OUT_PWD/../runtime/libifa_runtime.a
+}
@@ -0,0 +1,139 @@
+/**
+ * @file ifa_host.cpp
+ * @brief Implements the PluginHost class.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_host.h"
+#include "runtime/ifa_runtime_log.h"
+#include <dlfcn.h>
+
+namespace ifa_host {
+
+PluginHost::~PluginHost() {
+    unloadAll();
+}
+
+int PluginHost::load(const std::string& path, const std::vector<std::string>& args, std::string& error) {
+    // RTLD_LOCAL keeps the globals of every automaton private to its plugin; RTLD_NOW reports
+    // missing symbols (e.g. a runtime mismatch) here instead of in the middle of a run.
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        const char* reason = dlerror();
+        error = reason ? reason : "dlopen failed";
+        return -1;
+    }
+    for (const auto& entry : automata_) {
+        if (entry.second->handle == handle) {
+            dlclose(handle); // Drop the reference this call added
+            error = "Plugin '" + path + "' is already loaded (automaton " + std::to_string(entry.first)
+                    + "); load a copy of the file to run it twice.";
+            return -1;
+        }
+    }
+
+    auto entryFunction = reinterpret_cast<ifa_runtime::PluginEntryFunction>(dlsym(handle, IFA_PLUGIN_ENTRY_NAME));
+    const ifa_runtime::AutomatonPlugin* plugin = entryFunction ? entryFunction() : nullptr;
+    if (!plugin) {
+        dlclose(handle);
+        error = "'" + path + "' is not an automaton plugin (no " IFA_PLUGIN_ENTRY_NAME ").";
+        return -1;
+    }
+    if (plugin->abiVersion != ifa_runtime::kPluginAbiVersion) {
+        dlclose(handle);
+        error = "'" + path + "' was built for plugin ABI version " + std::to_string(plugin->abiVersion)
+                + ", the host supports version " + std::to_string(ifa_runtime::kPluginAbiVersion) + ".";
+        return -1;
+    }
+
+    auto automaton = std::make_unique<LoadedAutomaton>();
+    automaton->path = path;
+    automaton->handle = handle;
+    automaton->plugin = plugin;
+    automaton->args.push_back(path);
+    automaton->args.insert(automaton->args.end(), args.begin(), args.end());
+    for (std::string& arg : automaton->args) {
+        automaton->argv.push_back(arg.data());
+    }
+    automaton->argv.push_back(nullptr);
+
+    LoadedAutomaton* running = automaton.get();
+    running->thread = std::thread([running]() {
+        running->exitCode = running->plugin->run(static_cast<int>(running->args.size()), running->argv.data());
+        running->finished.store(true, std::memory_order_release);
+    });
+
+    int id = nextId_++;
+    IFA_LOG_INFO("[Host] Loaded automaton " << id << " '" << plugin->name << "' from " << path);
+    automata_.emplace(id, std::move(automaton));
+    return id;
+}
+
+bool PluginHost::unload(int id) {
+    auto it = automata_.find(id);
+    if (it == automata_.end()) {
+        return false;
+    }
+    stopAndClose(*it->second);
+    IFA_LOG_INFO("[Host] Unloaded automaton " << id << " (exit code " << it->second->exitCode << ").");
+    automata_.erase(it);
+    return true;
+}
+
+void PluginHost::unloadAll() {
+    // Ask all automata to stop first, so they shut down concurrently
+    for (auto& entry : automata_) {
+        if (!entry.second->finished.load(std::memory_order_acquire)) {
+            entry.second->plugin->requestStop();
+        }
+    }
+    while (!automata_.empty()) {
+        unload(automata_.begin()->first);
+    }
+}
+
+int PluginHost::reapFinished() {
+    int reaped = 0;
+    for (auto it = automata_.begin(); it != automata_.end();) {
+        if (it->second->finished.load(std::memory_order_acquire)) {
+            int id = it->first;
+            ++it;
+            unload(id);
+            ++reaped;
+        } else {
+            ++it;
+        }
+    }
+    return reaped;
+}
+
+void PluginHost::list(std::ostream& out) const {
+    for (const auto& entry : automata_) {
+        const LoadedAutomaton& automaton = *entry.second;
+        out << entry.first << "\t" << automaton.plugin->name << "\t"
+            << (automaton.finished.load(std::memory_order_acquire) ? "finished" : "running") << "\t"
+            << automaton.plugin->states.count - 1 << " states\t" << automaton.path << "\n";
+    }
+}
+
+void PluginHost::stopAndClose(LoadedAutomaton& automaton) {
+    if (!automaton.finished.load(std::memory_order_acquire)) {
+        automaton.plugin->requestStop();
+    }
+    if (automaton.thread.joinable()) {
+        automaton.thread.join();
+    }
+    // Flush lines still referring to the plugin's string literals before its code is unmapped
+    ifa_runtime::Logger::instance().flush();
+    dlclose(automaton.handle);
+    automaton.handle = nullptr;
+    if (void* resident = dlopen(automaton.path.c_str(), RTLD_NOW | RTLD_NOLOAD)) {
+        dlclose(resident);
+        IFA_LOG_WARN("[Host] Plugin " << automaton.path << " stays loaded (built without -fno-gnu-unique?);"
+                     << " loading it again reuses its final state.");
+    }
+    automaton.plugin = nullptr;
+}
+
+} // namespace ifa_host
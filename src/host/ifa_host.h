@@ -0,0 +1,117 @@
+/**
+ * @file ifa_host.h
+ * @brief Defines the PluginHost class, which runs automata compiled as shared-object plugins in one process.
+ * @details Each loaded plugin runs its automaton (its own Engine, socket and timers) from a thread
+ *          of its own. When a Scheduler is installed as the process scheduler (as ifa_host does),
+ *          that thread only waits in Engine::run() while the automaton's handlers run on the
+ *          scheduler's worker threads. The host links the runtime and exports it to the plugins,
+ *          so loading an automaton costs a dlopen() instead of a process start and a static link.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_HOST_H
+#define IFA_HOST_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "runtime/ifa_runtime_plugin.h"
+
+namespace ifa_host {
+
+/**
+ * @brief Loads, runs and unloads automaton plugins.
+ * @details Not thread-safe: all methods are called from the host's control thread.
+ */
+class PluginHost {
+public:
+    PluginHost() = default;
+
+    /**
+     * @brief Destructor. Stops and unloads all automata.
+     */
+    ~PluginHost();
+
+    PluginHost(const PluginHost&) = delete;
+    PluginHost& operator=(const PluginHost&) = delete;
+
+    /**
+     * @brief Loads a plugin and starts its automaton on a new thread.
+     * @param path Path of the shared object.
+     * @param args Command line of the automaton without the program name (options and ports).
+     * @param error Receives the reason if loading fails.
+     * @return int Id of the loaded automaton, or -1 on failure.
+     */
+    int load(const std::string& path, const std::vector<std::string>& args, std::string& error);
+
+    /**
+     * @brief Stops an automaton, waits for its thread and unloads its plugin.
+     * @param id Id returned by load().
+     * @return bool False if there is no automaton with this id.
+     */
+    bool unload(int id);
+
+    /**
+     * @brief Stops and unloads all automata.
+     */
+    void unloadAll();
+
+    /**
+     * @brief Unloads the automata that terminated on their own (TERMINATE command, signal, error).
+     * @return int Number of automata unloaded.
+     */
+    int reapFinished();
+
+    /**
+     * @brief Writes one line per loaded automaton (id, name, state, plugin path).
+     * @param out The stream to write to.
+     */
+    void list(std::ostream& out) const;
+
+    /**
+     * @brief Returns the number of loaded automata.
+     * @return std::size_t The number of automata.
+     */
+    std::size_t size() const { return automata_.size(); }
+
+private:
+    /** @brief One loaded plugin and the thread running its automaton. */
+    struct LoadedAutomaton {
+        /** @brief Path of the shared object. */
+        std::string path;
+        /** @brief Handle returned by dlopen(). */
+        void* handle = nullptr;
+        /** @brief Descriptor exported by the plugin. */
+        const ifa_runtime::AutomatonPlugin* plugin = nullptr;
+        /** @brief Command line passed to AutomatonPlugin::run (argv[0] is the path). */
+        std::vector<std::string> args;
+        /** @brief Pointers into args, terminated by nullptr. */
+        std::vector<char*> argv;
+        /** @brief Thread running AutomatonPlugin::run. */
+        std::thread thread;
+        /** @brief Set by the thread when run returned. */
+        std::atomic<bool> finished{false};
+        /** @brief Exit code returned by run. */
+        int exitCode = 0;
+    };
+
+    /**
+     * @brief Stops the automaton if it still runs, joins its thread and closes the plugin.
+     * @param automaton The automaton to unload.
+     */
+    static void stopAndClose(LoadedAutomaton& automaton);
+
+    /** @brief Loaded automata by id. */
+    std::map<int, std::unique_ptr<LoadedAutomaton>> automata_;
+    /** @brief Id of the next loaded automaton. */
+    int nextId_ = 1;
+};
+
+} // namespace ifa_host
+
+#endif // IFA_HOST_H
@@ -0,0 +1,171 @@
+/**
+ * @file main.cpp
+ * @brief Entry point of ifa_host, which runs automata compiled as plugins in one process.
+ * @details Usage: ifa_host [--threads N] [plugin.so [automaton args...]] [-- plugin.so [automaton args...]]...
+ *          The automaton arguments are the options and ports the standalone executable takes.
+ *          All automata run on one ifa_runtime::Scheduler with N worker threads (default: one
+ *          per hardware thread), each automaton on its own strand.
+ *          While running, the host reads commands from stdin:
+ *            load <plugin.so> [automaton args...]   loads and starts an automaton
+ *            unload <id>                            stops and unloads an automaton
+ *            list                                   lists the loaded automata
+ *            stats                                  prints the CPU time used by each automaton
+ *            quit                                   stops all automata and exits
+ *          The host exits on quit or once every automaton has terminated; at the end of stdin it
+ *          keeps running the loaded automata (e.g. when started in the background).
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_host.h"
+#include "runtime/ifa_runtime_scheduler.h"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <poll.h>
+#include <unistd.h>
+
+namespace {
+
+/** @brief How often the control loop checks for terminated automata (ms). */
+constexpr int kPollIntervalMs = 200;
+
+/**
+ * @brief Loads one plugin and reports the result on stdout/stderr.
+ * @return bool True if the plugin was loaded.
+ */
+bool loadAndReport(ifa_host::PluginHost& host, const std::string& path, const std::vector<std::string>& args) {
+    std::string error;
+    int id = host.load(path, args, error);
+    if (id < 0) {
+        std::cerr << "Error: " << error << std::endl;
+        return false;
+    }
+    std::cout << "loaded " << id << std::endl;
+    return true;
+}
+
+/**
+ * @brief Prints one line per engine running on the scheduler.
+ */
+void printStats(const ifa_runtime::Scheduler& scheduler) {
+    for (const ifa_runtime::EngineUsage& usage : scheduler.usage()) {
+        std::cout << usage.automatonName << "\t" << (usage.running ? "running" : "stopped") << "\t"
+                  << std::fixed << std::setprecision(3) << usage.cpuTime.count() / 1e6 << " ms CPU\t"
+                  << usage.handlers << " handlers\n";
+    }
+    std::cout << std::flush;
+}
+
+/**
+ * @brief Executes one command line read from stdin.
+ * @return bool False if the host should exit.
+ */
+bool executeCommand(ifa_host::PluginHost& host, const ifa_runtime::Scheduler& scheduler, const std::string& line) {
+    std::istringstream words(line);
+    std::string command;
+    if (!(words >> command)) {
+        return true; // Empty line
+    }
+    if (command == "load") {
+        std::string path;
+        if (!(words >> path)) {
+            std::cerr << "Error: usage: load <plugin.so> [args...]" << std::endl;
+            return true;
+        }
+        std::vector<std::string> args;
+        for (std::string arg; words >> arg;) {
+            args.push_back(arg);
+        }
+        loadAndReport(host, path, args);
+    } else if (command == "unload") {
+        int id = 0;
+        if (!(words >> id) || !host.unload(id)) {
+            std::cerr << "Error: no automaton with this id." << std::endl;
+        } else {
+            std::cout << "unloaded " << id << std::endl;
+        }
+    } else if (command == "list") {
+        host.list(std::cout);
+        std::cout << std::flush;
+    } else if (command == "stats") {
+        printStats(scheduler);
+    } else if (command == "quit") {
+        return false;
+    } else {
+        std::cerr << "Error: unknown command '" << command << "' (load, unload, list, stats, quit)." << std::endl;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int first = 1;
+    unsigned threads = 0;
+    if (argc > 2 && std::string(argv[1]) == "--threads") {
+        threads = static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10));
+        first = 3;
+    }
+
+    // Installed before any plugin is loaded: the automata create their Engine when the plugin
+    // is loaded, and Engine() attaches to the process scheduler.
+    ifa_runtime::Scheduler scheduler(threads);
+    ifa_runtime::Scheduler::setProcessScheduler(&scheduler);
+    // Declared after the scheduler, so the automata are unloaded before the workers stop
+    ifa_host::PluginHost host;
+
+    // Initial plugins: each group of arguments separated by "--" is one plugin and its arguments
+    for (int i = first; i < argc;) {
+        std::string path = argv[i++];
+        std::vector<std::string> args;
+        while (i < argc && std::string(argv[i]) != "--") {
+            args.push_back(argv[i++]);
+        }
+        if (i < argc) {
+            ++i; // Skip "--"
+        }
+        if (!loadAndReport(host, path, args)) {
+            return 1;
+        }
+    }
+
+    std::string pending;
+    bool inputOpen = true;
+    bool running = true;
+    while (running) {
+        // Without stdin, poll() only sleeps until the next check for terminated automata
+        pollfd input{inputOpen ? STDIN_FILENO : -1, POLLIN, 0};
+        int ready = ::poll(&input, 1, kPollIntervalMs);
+        if (ready > 0) {
+            char buffer[4096];
+            ssize_t received = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (received <= 0) {
+                inputOpen = false;
+                if (host.size() == 0) {
+                    break;
+                }
+            } else {
+                pending.append(buffer, static_cast<std::size_t>(received));
+                std::size_t end;
+                while (running && (end = pending.find('\n')) != std::string::npos) {
+                    std::string line = pending.substr(0, end);
+                    pending.erase(0, end + 1);
+                    running = executeCommand(host, scheduler, line);
+                }
+            }
+        }
+
+        int terminated = host.reapFinished();
+        if (terminated > 0) {
+            std::cout << "terminated " << terminated << std::endl;
+            if (host.size() == 0) {
+                break; // Every automaton terminated on its own (TERMINATE command, Ctrl+C)
+            }
+        }
+    }
+
+    host.unloadAll();
+    return 0;
+}
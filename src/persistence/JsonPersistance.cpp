@@ -24,7 +24,19 @@ bool JsonPersistence::saveToFile(const Machine& machine, const std::string& file
         // This implicitly calls the `to_json(json& j, const Machine& m)` function
         // defined in "json_conversions.cpp".
         json machine_json = machine;
+        return saveJsonToFile(machine_json, filename);
 
+    } catch (const json::exception& e) {
+        std::cerr << "Error during JSON serialization or file writing: " << e.what() << std::endl;
+        return false;
+    } catch (const std::exception& e) {
+        std::cerr << "An unexpected error occurred during saving: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool JsonPersistence::saveJsonToFile(const json& machine_json, const std::string& filename) {
+    try {
         // Write the JSON object to the specified file
         std::ofstream outFile(filename);
         if (!outFile.is_open()) {
@@ -41,7 +53,7 @@ bool JsonPersistence::saveToFile(const Machine& machine, const std::string& file
         return true;
 
     } catch (const json::exception& e) {
-        std::cerr << "Error during JSON serialization or file writing: " << e.what() << std::endl;
+        std::cerr << "Error during JSON file writing: " << e.what() << std::endl;
         return false;
     } catch (const std::exception& e) {
         std::cerr << "An unexpected error occurred during saving: " << e.what() << std::endl;
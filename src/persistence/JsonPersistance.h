@@ -10,6 +10,7 @@
 
 #include <string>
 #include <memory>
+#include "nlohmann/json_fwd.hpp"
 
 // Forward declaration of the Machine class.
 // This avoids including the full Machine.h header here, reducing dependencies.
@@ -33,6 +34,15 @@ public:
      */
     static bool saveToFile(const Machine& machine, const std::string& filename); // Použi std::string
 
+    /**
+     * @brief Saves an already serialized machine definition to a specified JSON file.
+     * @details Used to save a snapshot of the model taken earlier (e.g. by a background build).
+     * @param machineJson The machine definition produced by to_json(json&, const Machine&).
+     * @param filename The path (including filename) where the JSON data should be saved.
+     * @return bool True if the data was successfully saved to the file, false otherwise.
+     */
+    static bool saveJsonToFile(const nlohmann::json& machineJson, const std::string& filename);
+
     /**
      * @brief Loads a machine definition from a specified JSON file.
      * @param filename The path (including filename) of the JSON file to load.
@@ -0,0 +1,132 @@
+/**
+ * @file io_call_rewriter.cpp
+ * @brief Implements the rewriting of input/output calls in action and guard code.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "io_call_rewriter.h"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+
+// Returns the position after the string or character literal starting at code[pos] (a quote,
+// or the 'R' of a raw string literal). An unterminated literal ends at the end of its line.
+size_t skip_literal(const std::string &code, size_t pos)
+{
+    if (code[pos] == 'R')
+    {
+        // R"delim( ... )delim"
+        size_t open = code.find('(', pos + 2);
+        if (open == std::string::npos)
+            return code.size();
+        std::string closing = ")" + code.substr(pos + 2, open - pos - 2) + "\"";
+        size_t close = code.find(closing, open + 1);
+        return close == std::string::npos ? code.size() : close + closing.size();
+    }
+    const char quote = code[pos];
+    size_t i = pos + 1;
+    while (i < code.size() && code[i] != quote && code[i] != '\n')
+        i += (code[i] == '\\') ? 2 : 1;
+    return std::min(i + 1, code.size());
+}
+
+} // namespace
+
+std::string rewrite_io_calls(const std::string &code,
+                             const std::map<std::string, size_t> &input_slots,
+                             const std::map<std::string, size_t> &output_slots)
+{
+    auto is_identifier = [](char c)
+    { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+    auto skip_space = [&code](size_t i)
+    {
+        while (i < code.size() && std::isspace(static_cast<unsigned char>(code[i])))
+            ++i;
+        return i;
+    };
+
+    std::string result;
+    result.reserve(code.size());
+    std::string previous; // The last two characters of code outside comments and whitespace
+    size_t i = 0;
+    while (i < code.size())
+    {
+        const char c = code[i];
+        size_t next = i + 1;
+        if (c == '/' && next < code.size() && (code[next] == '/' || code[next] == '*'))
+        {
+            size_t end = code[next] == '/' ? code.find('\n', i) : code.find("*/", i + 2);
+            next = end == std::string::npos ? code.size() : (code[i + 1] == '/' ? end : end + 2);
+            result.append(code, i, next - i);
+            i = next;
+            continue;
+        }
+        if (c == '"' || c == '\'')
+        {
+            next = skip_literal(code, i);
+        }
+        else if (is_identifier(c))
+        {
+            // A number may hold digit separators (1'000'000), which are not character literals.
+            const bool number = std::isdigit(static_cast<unsigned char>(c));
+            while (next < code.size() && (is_identifier(code[next]) ||
+                                          (number && code[next] == '\'' && next + 1 < code.size() &&
+                                           is_identifier(code[next + 1]))))
+                ++next;
+            const std::string word = code.substr(i, next - i);
+            const bool raw_string = next < code.size() && code[next] == '"' && word.back() == 'R' &&
+                                    (word == "R" || word == "LR" || word == "uR" || word == "UR" || word == "u8R");
+            const bool member = !previous.empty() &&
+                                (previous.back() == '.' || previous == "->" || previous == "::");
+            if (raw_string)
+            {
+                next = skip_literal(code, next - 1);
+            }
+            else if (!member && (word == "valueof" || word == "defined" || word == "output"))
+            {
+                // Match  ( "name" )  or  ( "name" ,  with a plain (escape-free) literal name.
+                size_t open = skip_space(next);
+                size_t quote = open < code.size() && code[open] == '(' ? skip_space(open + 1) : code.size();
+                if (quote < code.size() && code[quote] == '"')
+                {
+                    size_t close = code.find_first_of("\"\\\n", quote + 1);
+                    size_t after = close != std::string::npos && code[close] == '"' ? skip_space(close + 1) : code.size();
+                    const bool is_output = word == "output";
+                    const auto &slots = is_output ? output_slots : input_slots;
+                    // output() takes a value (ends with ','), valueof()/defined() only the name (ends with ')')
+                    if (after < code.size() && code[after] == (is_output ? ',' : ')'))
+                    {
+                        auto slot = slots.find(code.substr(quote + 1, close - quote - 1));
+                        if (slot != slots.end())
+                        {
+                            const std::string index = std::to_string(slot->second);
+                            if (word == "valueof")
+                                result += "inputValueAt(" + index + ")";
+                            else if (word == "defined")
+                                result += "inputDefinedAt(" + index + ")";
+                            else
+                                result += "outputAt(" + index + ",";
+                            previous = code[after];
+                            i = after + 1;
+                            continue;
+                        }
+                    }
+                }
+            }
+        }
+        result.append(code, i, next - i);
+        for (size_t k = i; k < next; ++k)
+        {
+            if (std::isspace(static_cast<unsigned char>(code[k])))
+                continue;
+            if (previous.size() == 2)
+                previous.erase(0, 1);
+            previous += code[k];
+        }
+        i = next;
+    }
+    return result;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file io_call_rewriter.h
+ * @brief Declares the rewriting of input/output calls in action and guard code to slot accesses.
+ * @details Used by add_codegen_data() when preparing a model for the code generator. Kept free
+ *          of Qt and of the core classes so it can be tested on its own.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IO_CALL_REWRITER_H
+#define IO_CALL_REWRITER_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+/**
+ * @brief Rewrites input/output calls with a literal name into direct slot accesses.
+ * @details Calls of valueof("x"), defined("x") and output("y", ...) naming a declared input or
+ *          output become inputValueAt(i), inputDefinedAt(i) and outputAt(i, ...) of the generated
+ *          automaton, so they need no name lookup at run time. The code is scanned token by token:
+ *          comments, string/character literals (raw strings included) and numbers with digit
+ *          separators are copied as they are, and so are member or qualified calls (a.output(...),
+ *          p->valueof(...), ns::defined(...)), calls with other arguments and calls with undeclared names.
+ * @param code The action or guard code.
+ * @param input_slots Slot index of every declared input, by name.
+ * @param output_slots Slot index of every declared output, by name.
+ * @return std::string The rewritten code.
+ */
+std::string rewrite_io_calls(const std::string &code,
+                             const std::map<std::string, size_t> &input_slots,
+                             const std::map<std::string, size_t> &output_slots);
+
+#endif // IO_CALL_REWRITER_H
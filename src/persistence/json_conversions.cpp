@@ -6,6 +6,7 @@
  */
 
 #include "json_conversions.h"
+#include "io_call_rewriter.h"
 #include "core/Machine.h"
 #include "core/State.h"
 #include "core/Transition.h"
@@ -19,6 +20,9 @@
 #include <iostream>
 #include <stdexcept>
 #include <vector>
+#include <map>
+#include <cstdint>
+#include <cctype>
 #include <QDebug>
 
 // Use alias for convenience
@@ -63,6 +67,56 @@ inline std::string trim_string(const std::string &str)
     return str.substr(first, (last - first + 1));  // Extract the trimmed substring
 }
 
+// Hash of an event name used for the perfect-hash event dispatch of the generated code:
+// FNV-1a (32 bit) starting from a seeded offset basis, with a final shift to mix the high
+// bits into the low ones. automation_template.tpl evaluates the same function (eventHash),
+// so the two must be kept identical.
+inline std::uint32_t event_hash(const std::string &name, std::uint32_t seed)
+{
+    std::uint32_t h = 2166136261u ^ seed;
+    for (unsigned char c : name)
+    {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+// Searches a seed and a power-of-two table size for which event_hash() sends every name to
+// its own slot. Fills "event_hash_seed", "event_hash_size" and "event_hash_slots" (event id
+// per slot, -1 for an empty slot). The table starts at twice the number of names and is
+// doubled whenever no seed out of a bounded number of attempts is collision free.
+inline void add_event_hash(json &j, const std::vector<std::string> &names)
+{
+    constexpr std::uint32_t kSeedsPerSize = 4096;
+    std::uint32_t size = 1;
+    while (size < 2 * names.size())
+        size <<= 1;
+
+    std::vector<int> slots;
+    for (;; size <<= 1)
+    {
+        for (std::uint32_t seed = 0; seed < kSeedsPerSize; ++seed)
+        {
+            slots.assign(size, -1);
+            bool collision = false;
+            for (size_t id = 0; id < names.size() && !collision; ++id)
+            {
+                int &slot = slots[event_hash(names[id], seed) & (size - 1)];
+                collision = slot >= 0;
+                slot = static_cast<int>(id);
+            }
+            if (!collision)
+            {
+                j["event_hash_seed"] = seed;
+                j["event_hash_size"] = size;
+                j["event_hash_slots"] = slots;
+                return;
+            }
+        }
+    }
+}
+
 void to_json(json &j, const State &s)
 {
     j = json{
@@ -100,57 +154,11 @@ void to_json(json &j, const Transition &t)
 {
     // Parse the combined condition string from the Transition object
     // into its constituent parts (event, guard, delay).
-
-    std::string condition_str = trim_string(t.getCondition()); // Get full condition string and trim
-    std::string event_trigger = "";
-    std::string guard_condition = "";
-    long long delay_value = 0;
-    std::string delay_variable_original = "";
-
-    // Check for delay part (e.g., "@ 5000" or "@ delayVar")
-    size_t at_pos = condition_str.find('@');
-    if (at_pos != std::string::npos)
-    { /* ... parsovanie delay ... */
-        std::string delay_part = trim_string(condition_str.substr(at_pos + 1));
-        if (!delay_part.empty())
-        {
-            // Try to parse as a number first
-            try
-            {
-                size_t processed = 0;
-                delay_value = std::stoll(delay_part, &processed);
-                // Check if the entire string was processed and value is non-negative
-                if (processed != delay_part.length() || delay_value < 0)
-                    throw std::invalid_argument("");
-            }
-            catch (...)
-            {
-                // If parsing as number fails, assume it's a variable name
-                delay_variable_original = delay_part;
-                delay_value = -1; // Indicate delay is variable-based
-            }
-        }
-        condition_str = trim_string(condition_str.substr(0, at_pos)); // Remove delay part from condition
-    }
-    else if (t.getDelayMs() > 0)
-    {
-        // Handle case where delay might be stored separately in the Transition object
-        delay_value = t.getDelayMs();
-    }
-
-    // Check for guard condition part (e.g., "[ counter > 5 ]")
-    size_t guard_start = condition_str.find('[');
-    size_t guard_end = condition_str.rfind(']');
-
-    // Ensure both brackets are found and in the correct order
-    if (guard_start != std::string::npos && guard_end != std::string::npos && guard_end > guard_start)
-    {
-        guard_condition = trim_string(condition_str.substr(guard_start + 1, guard_end - guard_start - 1));
-        condition_str = trim_string(condition_str.substr(0, guard_start));
-    }
-
-    // Whatever remains is the event trigger
-    event_trigger = trim_string(condition_str);
+    TransitionCondition condition = t.parseCondition();
+    const std::string &event_trigger = condition.event;
+    const std::string &guard_condition = condition.guard;
+    long long delay_value = condition.delayMs;
+    const std::string &delay_variable_original = condition.delayVariable;
 
     // --- Build the JSON object ---
     j = json{
@@ -210,9 +218,9 @@ void to_json(json &j, const Machine &m)
     }
 
     j["variables"] = json::array();
-    for (const auto &pair : m.getVariables())
+    for (const std::string &name : m.getVariableOrder())
     {
-        j["variables"].push_back(*pair.second);
+        j["variables"].push_back(*m.getVariables().at(name));
     }
 
     // Serialize initial state information
@@ -239,6 +247,119 @@ void to_json(json &j, const Machine &m)
     }
 }
 
+void add_codegen_data(json &j)
+{
+    // Inputs and outputs are stored in fixed slots in the generated code; the slot is the
+    // position in these arrays (which is also the symbol id of the binary protocol).
+    std::map<std::string, size_t> input_slots;
+    std::map<std::string, size_t> output_slots;
+    for (const auto &name_json : j["inputs"])
+        input_slots.emplace(name_json.get<std::string>(), input_slots.size());
+    for (const auto &name_json : j["outputs"])
+        output_slots.emplace(name_json.get<std::string>(), output_slots.size());
+
+    for (auto &state_json : j["states"])
+        state_json["action_cpp"] = rewrite_io_calls(state_json.value("action", ""), input_slots, output_slots);
+    for (auto &trans_json : j["transitions"])
+    {
+        if (trans_json["guard"].is_string())
+            trans_json["guard_cpp"] = rewrite_io_calls(trans_json["guard"].get<std::string>(), input_slots, output_slots);
+    }
+
+    // Transitions grouped by source state, so the template iterates the outgoing transitions of
+    // each state instead of all transitions per state: "outgoing_transitions" (all of them, for
+    // the guard and delay functions generated with the state) and "eventless_transitions"
+    // (immediate or delayed ones). Event-triggered transitions are also grouped in
+    // "transition_table" below.
+    std::map<std::string, json *> states_by_name;
+    for (auto &state_json : j["states"])
+    {
+        state_json["outgoing_transitions"] = json::array();
+        state_json["eventless_transitions"] = json::array();
+        states_by_name.emplace(state_json["name"].get<std::string>(), &state_json);
+    }
+    for (const auto &trans_json : j["transitions"])
+    {
+        auto state = states_by_name.find(trans_json["source"].get<std::string>());
+        if (state == states_by_name.end())
+            continue;
+        (*state->second)["outgoing_transitions"].push_back(trans_json);
+        if (!trans_json["event"].is_string())
+            (*state->second)["eventless_transitions"].push_back(trans_json);
+    }
+
+    // --- Event dispatch data ---
+    // Every input is an event (so an input's event id equals its symbol id); event names used
+    // by transitions without a matching input are appended after them.
+    std::vector<std::string> event_names;
+    std::map<std::string, size_t> event_ids;
+    for (const auto &name_json : j["inputs"])
+    {
+        std::string name = name_json.get<std::string>();
+        if (event_ids.emplace(name, event_names.size()).second)
+            event_names.push_back(name);
+    }
+    for (const auto &trans_json : j["transitions"])
+    {
+        if (trans_json["event"].is_string())
+        {
+            std::string name = trans_json["event"].get<std::string>();
+            if (event_ids.emplace(name, event_names.size()).second)
+                event_names.push_back(name);
+        }
+    }
+
+    j["events"] = json::array();
+    std::map<std::string, int> enum_id_uses;
+    for (size_t id = 0; id < event_names.size(); ++id)
+    {
+        // Names differing only in sanitized characters would collide as enumerators
+        std::string enum_id = "EVENT_" + sanitize_for_identifier(event_names[id]);
+        if (enum_id_uses[enum_id]++ > 0)
+            enum_id += "_" + std::to_string(id);
+        j["events"].push_back(json{{"name", event_names[id]}, {"enum_id", enum_id}, {"id", id}});
+    }
+    add_event_hash(j, event_names);
+
+    // Dense [state][event] table: each cell is a range into "event_transitions", which lists the
+    // event-triggered transitions grouped by source state and event, in model order. Row 0 is
+    // State::STATE_NULL, the following rows follow the order of "states" (the State enum order).
+    std::map<std::string, size_t> state_rows;
+    for (const auto &state_json : j["states"])
+        state_rows.emplace(state_json["name"].get<std::string>(), state_rows.size() + 1);
+
+    std::vector<std::vector<std::vector<const json *>>> cells(
+        state_rows.size() + 1, std::vector<std::vector<const json *>>(event_names.size()));
+    for (const auto &trans_json : j["transitions"])
+    {
+        auto row = state_rows.find(trans_json["source"].get<std::string>());
+        if (row != state_rows.end() && trans_json["event"].is_string())
+            cells[row->second][event_ids.at(trans_json["event"].get<std::string>())].push_back(&trans_json);
+    }
+
+    json event_transitions = json::array();
+    json transition_table = json::array();
+    for (const auto &row_cells : cells)
+    {
+        json row = json::array();
+        for (const auto &cell : row_cells)
+        {
+            row.push_back(json{{"first", event_transitions.size()}, {"count", cell.size()}});
+            for (const json *trans_json : cell)
+            {
+                event_transitions.push_back(json{
+                    {"template_index0", (*trans_json)["template_index0"]},
+                    {"target_enum_id", (*trans_json)["target_enum_id"]},
+                    {"has_guard", (*trans_json)["guard"].is_string()},
+                    {"has_delay", !(*trans_json)["delay"].is_null() || (*trans_json)["delay_var_original"].is_string()}});
+            }
+        }
+        transition_table.push_back(row);
+    }
+    j["event_transitions"] = event_transitions;
+    j["transition_table"] = transition_table;
+}
+
 
 
 void from_json(const json &j, State &s)
@@ -53,6 +53,16 @@ void to_json(json& j, const Transition& t);
  */
 void to_json(json& j, const Machine& m);
 
+/**
+ * @brief Adds the data only the code generator needs to a serialized Machine.
+ * @details Derives from the saved model (as written by to_json(json&, const Machine&)) the
+ *          actions and guards with resolved input/output slots, the transitions grouped by
+ *          source state, the event ids, the perfect hash of the event names and the dense
+ *          state x event transition table. Kept out of to_json() so saved models stay small.
+ * @param j Reference to the serialized Machine to extend.
+ */
+void add_codegen_data(json& j);
+
 
 /**
  * @brief Finds a State within a Machine by its name. (Helper for deserialization).
@@ -0,0 +1,10 @@
+/**
+ * @file ifa_runtime_asio.cpp
+ * @brief Compiles the Asio implementation once into libifa_runtime.
+ * @details The runtime is built with ASIO_SEPARATE_COMPILATION, so the headers only declare the
+ *          non-template Asio functions and this translation unit provides their definitions.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include <asio/impl/src.hpp>
@@ -0,0 +1,80 @@
+/**
+ * @file ifa_runtime_clock.h
+ * @brief Defines the clocks the timers of the engine and the automaton's elapsed() run on.
+ * @details Internal to libifa_runtime; the automaton reads the time through Engine::now().
+ *          A SteadyClock follows real time. A VirtualClock only moves when the engine advances
+ *          it: with nothing left to do, the engine jumps it to the next timer expiry
+ *          (discrete-event simulation), so a machine waiting for long delays runs in no time.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_CLOCK_H
+#define IFA_RUNTIME_CLOCK_H
+
+#include <chrono>
+
+namespace ifa_runtime {
+
+/**
+ * @brief Source of the current time of an engine.
+ */
+class Clock {
+public:
+    /** @brief Time point of all clocks; a virtual clock keeps the steady clock's epoch. */
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    virtual ~Clock() = default;
+
+    /**
+     * @brief Gets the current time.
+     * @return TimePoint The time.
+     */
+    virtual TimePoint now() const = 0;
+
+    /**
+     * @brief Checks whether the time only moves when advanceTo() is called.
+     * @return bool True for a virtual clock.
+     */
+    virtual bool isVirtual() const = 0;
+
+    /**
+     * @brief Moves a virtual clock forward; a clock following real time ignores the call.
+     * @param time The new time; an earlier time than now() leaves the clock unchanged.
+     */
+    virtual void advanceTo(TimePoint time) = 0;
+};
+
+/**
+ * @brief Clock following real time (std::chrono::steady_clock).
+ */
+class SteadyClock final : public Clock {
+public:
+    TimePoint now() const override { return std::chrono::steady_clock::now(); }
+    bool isVirtual() const override { return false; }
+    void advanceTo(TimePoint) override {}
+};
+
+/**
+ * @brief Clock of a discrete-event simulation, moved forward by the engine only.
+ * @details Starts at the real time of its construction.
+ */
+class VirtualClock final : public Clock {
+public:
+    VirtualClock() : now_(std::chrono::steady_clock::now()) {}
+    TimePoint now() const override { return now_; }
+    bool isVirtual() const override { return true; }
+    void advanceTo(TimePoint time) override {
+        if (time > now_) {
+            now_ = time;
+        }
+    }
+
+private:
+    /** @brief The current virtual time. */
+    TimePoint now_;
+};
+
+} // namespace ifa_runtime
+
+#endif // IFA_RUNTIME_CLOCK_H
@@ -5,28 +5,90 @@
  * @date 2025-05-05 // Date of last modification
  */
 
-#include "ifa_runtime_engine.h"
+#include "ifa_runtime_engine_impl.h"
+#include "ifa_runtime_scheduler_impl.h"
 #include "ifa_runtime_udp.h"     
 #include "ifa_runtime_timers.h"  
-#include <iostream>              
+#include "ifa_runtime_log.h"
 #include <utility>               
 #include <asio/signal_set.hpp>   
+#include <charconv>
 
 namespace ifa_runtime {
 
-Engine::Engine() : signals_(std::make_unique<asio::signal_set>(io_context_, SIGINT, SIGTERM))
+namespace {
+// First line of every batch datagram (see EngineImpl::batchBuffer_).
+constexpr char kBatchPrefix[] = "BATCH\n";
+constexpr std::size_t kBatchPrefixLength = sizeof(kBatchPrefix) - 1;
+// Size of an encoded Instance record (see protocol::appendInstanceRecord()).
+constexpr std::size_t kInstanceRecordSize = protocol::kRecordHeaderSize + 4;
+
+// Appends one batch record "<length>:<message>" (see EngineImpl::batchBuffer_).
+void appendBatchEntry(std::string& out, std::string_view message) {
+    char header[24];
+    char* headerEnd = std::to_chars(header, header + sizeof(header) - 1, message.size()).ptr;
+    *headerEnd++ = ':';
+    out.append(header, static_cast<std::size_t>(headerEnd - header));
+    out.append(message.data(), message.size());
+}
+
+// Text message announcing the instance of the messages following it in a datagram.
+std::string instanceMessage(std::uint32_t instance) {
+    return "INSTANCE " + std::to_string(instance);
+}
+
+// Size of the batch record appendBatchEntry() produces for a message of the given size.
+std::size_t batchEntrySize(std::size_t messageSize) {
+    char header[24];
+    return static_cast<std::size_t>(std::to_chars(header, header + sizeof(header), messageSize).ptr - header) + 1 + messageSize;
+}
+} // namespace
+
+EngineImpl::EngineImpl(Scheduler* scheduler)
+    : io_context_(scheduler ? nullptr : std::make_unique<asio::io_context>()),
+      scheduler_(scheduler ? &scheduler->impl() : nullptr),
+      executor_(scheduler_ ? EngineExecutor(asio::make_strand(scheduler_->context())) : EngineExecutor(io_context_->get_executor())),
+      clock_(std::make_unique<SteadyClock>()),
+      signals_(std::make_unique<asio::signal_set>(executor_, SIGINT, SIGTERM))
 {
-    std::cout << "[Engine] Created." << std::endl;
+    IFA_LOG_DEBUG("[Engine] Created.");
+
+    if (scheduler_) {
+        // Handlers share the worker threads with other engines, measure their CPU time per engine.
+        tracker_.setAccounting(true);
+        scheduler_->attach(this);
+        // Signals are awaited from run(), once the automaton has started up (see armHandlers()).
+    } else {
+        waitForSignals();
+    }
+}
 
-    // io_context_ is default constructed automatically.
-    signals_->async_wait([this](const asio::error_code& error, int signal_number) {
+EngineImpl::~EngineImpl() {
+    if (scheduler_) {
+        if (!isStopped()) {
+            // Never ran to the end (e.g. the automaton failed before run()): close everything on the strand
+            asio::post(executor_, tracker_.track([this]() {
+                signals_->cancel();
+                if (timerManager_) timerManager_->cancelAllTimers();
+                if (communicator_) communicator_->shutdown();
+            }));
+        }
+        // The handlers queued on the shared io_context must not outlive the engine.
+        tracker_.waitIdle();
+        scheduler_->detach(this);
+    }
+    IFA_LOG_DEBUG("[Engine] Destroyed.");
+}
+
+void EngineImpl::waitForSignals() {
+    signals_->async_wait(tracker_.track([this](const asio::error_code& error, int signal_number) {
         if (!error) {
-            std::cout << "[Engine] Termination signal (" << signal_number << ") received. Stopping..." << std::endl;
+            IFA_LOG_INFO("[Engine] Termination signal (" << signal_number << ") received. Stopping...");
             // Call the registered termination handler, if it exists.
              if (onTerminate_) {
                 // Post the handler to the io_context to run within the event loop's thread,
                 // avoiding potential threading issues.
-                asio::post(io_context_, onTerminate_);
+                asio::post(executor_, tracker_.track(onTerminate_));
              } else {
                  // If no handler is set, stop the engine directly.
                  stop();
@@ -38,57 +100,193 @@ Engine::Engine() : signals_(std::make_unique<asio::signal_set>(io_context_, SIGI
                  handleError("Error waiting for signals: " + error.message());
             }
         }
-    });
+    }));
 }
 
-Engine::~Engine() {
-    std::cout << "[Engine] Destroyed." << std::endl;
+void EngineImpl::armHandlers() {
+    std::vector<std::function<void()>> deferred;
+    {
+        std::lock_guard<std::mutex> lock(runMutex_);
+        if (stopped_) {
+            return; // stop() was called before run(), the socket is closed already
+        }
+        handlersArmed_ = true;
+        deferred.swap(deferredHandlers_);
+    }
+    communicator_->holdSending(false);
+    timerManager_->holdWakeups(false);
+    communicator_->startReceive();
+    waitForSignals();
+    if (replay_) {
+        scheduleReplayFeed();
+    }
+    for (auto& handler : deferred) {
+        asio::post(executor_, tracker_.track(std::move(handler)));
+    }
 }
 
+void EngineImpl::postHandler(std::function<void()> handler) {
+    if (scheduler_) {
+        std::lock_guard<std::mutex> lock(runMutex_);
+        if (!handlersArmed_) {
+            deferredHandlers_.push_back(std::move(handler));
+            return;
+        }
+    }
+    asio::post(executor_, tracker_.track(std::move(handler)));
+}
 
-bool Engine::initialize(const std::string& automatonName, int listen_port, const std::string& gui_host, int gui_port) {
-    std::cout << "[Engine] Initializing for automaton: " << automatonName << "..." << std::endl;
+bool EngineImpl::isStopped() {
+    std::lock_guard<std::mutex> lock(runMutex_);
+    return stopped_;
+}
+
+EngineUsage EngineImpl::usage() const {
+    EngineUsage usage;
+    usage.cpuTime = std::chrono::nanoseconds(tracker_.cpuNanoseconds());
+    usage.handlers = tracker_.executions();
+    usage.running = running_.load();
+    return usage;
+}
+
+bool EngineImpl::initialize(const std::string& automatonName, int listen_port, const std::string& gui_host, int gui_port) {
+    IFA_LOG_INFO("[Engine] Initializing for automaton: " << automatonName << "...");
     automatonName_ = automatonName; // Store the automaton name
+    if (scheduler_) {
+        scheduler_->setName(this, automatonName);
+    }
     try {
 
         // Create the UDP communicator, providing lambdas that wrap the engine's internal handlers.
-        communicator_ = std::make_unique<UdpCommunicator>(io_context_,
+        communicator_ = std::make_unique<UdpCommunicator>(executor_, tracker_,
             // UdpReceiveHandler lambda: delegates to handleIncomingUdp
-            [this](const std::string& type, const std::string& name, const std::string& value){
+            [this](std::string_view type, std::string_view name, std::string_view value){
                  handleIncomingUdp(type, name, value);
             },
             // UdpErrorHandler lambda: delegates to handleError
-            [this](const std::string& msg){ handleError(msg); }
+            [this](const std::string& msg){ handleError(msg); },
+            UdpReceiveConfig{receiveMaxDatagramSize_, receiveBatchSize_, receiveSocketBufferSize_}
         );
+        // Binary protocol datagrams are decoded by the engine, which owns the symbol tables.
+        communicator_->setBinaryHandler([this](const char* data, std::size_t length) {
+            handleIncomingBinary(data, length);
+        });
 
         // Create the Timer manager, providing a lambda that wraps handleTimeout.
-        timerManager_ = std::make_unique<TimerManager>(io_context_,
+        timerManager_ = std::make_unique<TimerManager>(executor_, tracker_, *clock_,
             // TimerTimeoutHandler lambda: delegates to handleTimeout
-             [this](const std::string& stateName){ handleTimeout(stateName); } // TimerTimeoutHandler
+             [this](std::uint32_t instanceId, const std::string& stateName){ handleTimeout(instanceId, stateName); } // TimerTimeoutHandler
         );
+        // Time 0 of the journal is tick 0 of the timers, so replayed steps at their recorded times
+        // round the expiries of their timers to the recorded ticks.
+        journalStart_ = timerManager_->epoch();
+        if (replay_) {
+            replayTimer_ = std::make_unique<asio::steady_timer>(executor_);
+        }
+        if (flightRecorder_) {
+            // Wall-clock time of time 0, for the decoder to print absolute times.
+            auto sinceStart = clock_->now() - journalStart_;
+            auto start = std::chrono::system_clock::now() - std::chrono::duration_cast<std::chrono::system_clock::duration>(sinceStart);
+            flightRecorder_->setStartTime(std::chrono::duration_cast<std::chrono::microseconds>(start.time_since_epoch()).count());
+            flightRecorder_->record(FlightEventType::Start, journalTime(), 0, automatonName);
+        }
 
         // Initialize the communicator (binds socket, resolves destination).
         if (!communicator_->initialize(listen_port, gui_host, gui_port)) {
             throw std::runtime_error("UDP Communicator initialization failed.");
         }
 
-        // Start listening for incoming UDP messages.
-        communicator_->startReceive();
+        if (scheduler_) {
+            // The automaton starts up on its own thread until run(): keep everything that would
+            // queue a handler on the strand held, armHandlers() starts it.
+            communicator_->holdSending(true);
+            timerManager_->holdWakeups(true);
+        } else {
+            // Start listening for incoming UDP messages.
+            communicator_->startReceive();
+        }
 
         // Send the initial "READY" message to the GUI.
         sendReady();
 
-        std::cout << "[Engine] Initialization complete. Ready message sent." << std::endl;
+        IFA_LOG_INFO("[Engine] Initialization complete. Ready message sent.");
         return true;
 
     } catch (const std::exception& e) {
-        std::cerr << "[Engine] FATAL: Engine initialization failed: " << e.what() << std::endl;
+        IFA_LOG_ERROR("[Engine] FATAL: Engine initialization failed: " << e.what());
+        return false;
+    }
+}
+
+void EngineImpl::setClockMode(ClockMode mode) {
+    if (timerManager_) {
+        IFA_LOG_ERROR("[Engine] ERROR: The clock cannot be changed after initialize().");
+        return;
+    }
+    if (mode == ClockMode::Virtual && scheduler_) {
+        IFA_LOG_WARN("[Engine] WARNING: Virtual time needs an engine with its own event loop; using real time.");
+        return;
+    }
+    if (mode == ClockMode::Virtual) {
+        clock_ = std::make_unique<VirtualClock>();
+    } else {
+        clock_ = std::make_unique<SteadyClock>();
+    }
+}
+
+bool EngineImpl::setJournal(const std::string& path) {
+    if (timerManager_) {
+        IFA_LOG_ERROR("[Journal] ERROR: The journal has to be set before initialize().");
+        return false;
+    }
+    auto journal = std::make_unique<JournalWriter>();
+    if (!journal->open(path)) {
+        IFA_LOG_ERROR("[Journal] ERROR: Cannot create journal '" << path << "'.");
+        return false;
+    }
+    journal_ = std::move(journal);
+    IFA_LOG_INFO("[Journal] Recording to '" << path << "'.");
+    return true;
+}
+
+bool EngineImpl::setReplay(const std::string& path, ReplayPace pace) {
+    if (timerManager_) {
+        IFA_LOG_ERROR("[Replay] ERROR: The replay has to be set before initialize().");
+        return false;
+    }
+    std::vector<JournalRecord> records;
+    std::string error;
+    if (!readJournal(path, records, error)) {
+        IFA_LOG_ERROR("[Replay] ERROR: " << error);
         return false;
     }
+    if (pace == ReplayPace::Fastest) {
+        setClockMode(ClockMode::Virtual); // Keeps real time on a scheduler
+    }
+    IFA_LOG_INFO("[Replay] Replaying " << records.size() << " records of '" << path << "'"
+                 << (clock_->isVirtual() ? " in virtual time." : " at the recorded pace."));
+    replay_ = std::make_unique<JournalReplay>(std::move(records));
+    return true;
 }
 
-void Engine::setEventHandlers(EventHandler onEvent, TimeoutHandler onTimeout, TerminationHandler onTerminate, ErrorHandler onError, StatusRequestHandler onStatusRequest) {
-    std::cout << "[Engine] Setting event handlers." << std::endl;
+bool EngineImpl::setFlightRecorder(const std::string& path, std::size_t capacity) {
+    if (timerManager_) {
+        IFA_LOG_ERROR("[FlightRecorder] ERROR: The flight recorder has to be set before initialize().");
+        return false;
+    }
+    auto recorder = std::make_unique<FlightRecorder>();
+    std::string error;
+    if (!recorder->open(path, capacity, error)) {
+        IFA_LOG_ERROR("[FlightRecorder] ERROR: " << error);
+        return false;
+    }
+    flightRecorder_ = std::move(recorder);
+    IFA_LOG_INFO("[FlightRecorder] Keeping the last events in '" << path << "'.");
+    return true;
+}
+
+void EngineImpl::setEventHandlers(EventHandler onEvent, TimeoutHandler onTimeout, TerminationHandler onTerminate, ErrorHandler onError, StatusRequestHandler onStatusRequest) {
+    IFA_LOG_DEBUG("[Engine] Setting event handlers.");
     // Store the provided handlers using std::move for efficiency.
     onEvent_ = std::move(onEvent);
     onTimeout_ = std::move(onTimeout);
@@ -97,143 +295,546 @@ void Engine::setEventHandlers(EventHandler onEvent, TimeoutHandler onTimeout, Te
     onStatusRequest_ = std::move(onStatusRequest);
 }
 
+void EngineImpl::setInstanceHandlers(InstanceEventHandler onEvent, InstanceTimeoutHandler onTimeout) {
+    onInstanceEvent_ = std::move(onEvent);
+    onInstanceTimeout_ = std::move(onTimeout);
+}
+
+void EngineImpl::setCheckpointHandler(CheckpointHandler onCheckpoint) {
+    onCheckpoint_ = std::move(onCheckpoint);
+}
 
-void Engine::run() {
+void EngineImpl::setInstance(std::uint32_t instanceId) {
+    instance_ = instanceId;
+}
+
+
+void EngineImpl::run() {
     // Pre-run checks: ensure components are initialized and handlers are set.
     if (!communicator_ || !timerManager_) {
         handleError("Engine cannot run: Not initialized.");
         return;
     }
     // Check if essential handlers are provided.
-    if (!onEvent_ || !onTimeout_ || !onTerminate_ || !onError_) {
+    // (the instance handlers replace onEvent_ and onTimeout_ when set)
+    if (!(onEvent_ || onInstanceEvent_) || !(onTimeout_ || onInstanceTimeout_) || !onTerminate_ || !onError_) {
          handleError("Engine cannot run: Event handlers not set.");
         return;
     }
 
-    std::cout << "[Engine] Starting event loop (io_context.run())..." << std::endl;
-    // Start the Asio event loop. This will block and process asynchronous operations
-    // (UDP I/O, timers, signals) until io_context.stop() is called or there's no more work.
-    io_context_.run();
-    std::cout << "[Engine] Event loop finished." << std::endl;
+    running_ = true;
+    if (replay_ && !scheduler_) {
+        scheduleReplayFeed();
+    }
+    if (scheduler_) {
+        IFA_LOG_INFO("[Engine] Running on the scheduler's worker threads...");
+        // The handlers run on the strand from now on; this thread only waits for stop().
+        asio::post(executor_, tracker_.track([this]() { armHandlers(); }));
+        {
+            std::unique_lock<std::mutex> lock(runMutex_);
+            runChanged_.wait(lock, [this]() { return stopped_; });
+        }
+        tracker_.waitIdle();
+    } else if (clock_->isVirtual()) {
+        IFA_LOG_INFO("[Engine] Starting event loop in virtual time...");
+        runVirtualTime();
+    } else {
+        IFA_LOG_INFO("[Engine] Starting event loop (io_context.run())...");
+        // Start the Asio event loop. This will block and process asynchronous operations
+        // (UDP I/O, timers, signals) until io_context.stop() is called or there's no more work.
+        io_context_->run();
+    }
+    running_ = false;
+    IFA_LOG_INFO("[Engine] Event loop finished.");
 }
 
-void Engine::stop() {
+void EngineImpl::runVirtualTime() {
+    while (!io_context_->stopped()) {
+        // Everything that is ready (received datagrams, sends, signals) runs at the current time.
+        io_context_->poll();
+        if (io_context_->stopped()) {
+            break;
+        }
+        // Idle: jump to the next timer expiry. The timeout steps are posted and run by the next
+        // poll(), at the time they expired.
+        if (!timerManager_->advanceToNextTimer()) {
+            // No timers pending, time stands still until the next message arrives.
+            io_context_->run_one();
+        }
+    }
+}
+
+void EngineImpl::stop() {
     // Attempt to send a TERMINATING message to the GUI first.
     sendTerminating();
+    // Don't lose updates of an unfinished batch (stop() may be called from inside a step).
+    flushBatch();
+    if (journal_) {
+        journal_->flush();
+    }
+    if (flightRecorder_) {
+        flightRecorder_->record(FlightEventType::Stop, journalTime(), 0, {});
+    }
+    if (replay_ && !replayReported_) {
+        replayReported_ = true;
+        if (replayTimer_) {
+            replayTimer_->cancel();
+        }
+        replay_->report();
+    }
 
-    std::cout << "[Engine] Stopping event loop..." << std::endl;
+    IFA_LOG_INFO("[Engine] Stopping event loop...");
     // Cancel any pending asynchronous operations to allow io_context.run() to return.
     signals_->cancel(); // Cancel waiting for OS signals.
     if(timerManager_) timerManager_->cancelAllTimers(); // Cancel all 
-    if(communicator_) communicator_->shutdown(); // Shutdown the UDP communicator (closes socket).
+    if(communicator_) {
+        communicator_->shutdown(); // Flush the send queue and close the socket.
+        UdpSendStats stats = communicator_->getSendStats();
+        IFA_LOG_INFO("[Engine] UDP send stats: " << stats.messagesSent << " datagrams, " << stats.bytesSent
+                     << " bytes, " << stats.sendCalls << " send calls, max queue depth " << stats.maxQueueDepth
+                     << ", " << stats.drops << " dropped");
+        UdpReceiveStats received = communicator_->getReceiveStats();
+        IFA_LOG_INFO("[Engine] UDP receive stats: " << received.datagramsReceived << " datagrams, " << received.bytesReceived
+                     << " bytes, " << received.receiveCalls << " receive calls, " << received.truncated << " truncated, "
+                     << received.kernelDrops << " dropped by the kernel");
+    }
     
-    // Explicitly stop the io_context if it hasn't stopped already.
-    if (!io_context_.stopped()) {
-        io_context_.stop();
+    if (scheduler_) {
+        // The shared io_context keeps running; wake up run()
+        std::lock_guard<std::mutex> lock(runMutex_);
+        stopped_ = true;
+        runChanged_.notify_all();
+    } else if (!io_context_->stopped()) {
+        // Explicitly stop the io_context if it hasn't stopped already.
+        io_context_->stop();
     }
 }
 
+void EngineImpl::requestStop() {
+    // Same path as a termination signal; posting is safe from any thread
+    postHandler([this]() {
+        if (scheduler_ && isStopped()) {
+            return; // Already stopped, the engine only waits for its handlers
+        }
+        IFA_LOG_INFO("[Engine] Stop requested. Stopping...");
+        if (onTerminate_) {
+            onTerminate_();
+        } else {
+            stop();
+        }
+    });
+}
+
 // --- API volané z generovaného kódu ---
 
-void Engine::sendReady() {
+void EngineImpl::setWireProtocol(protocol::WireProtocol wireProtocol) {
+    flushBatch(); // A batch never mixes the two protocols.
+    wireProtocol_ = wireProtocol;
+}
+
+protocol::WireProtocol EngineImpl::wireProtocol() const {
+    return wireProtocol_;
+}
+
+void EngineImpl::setSymbols(protocol::SymbolKind kind, std::vector<std::string> names) {
+    auto index = static_cast<std::size_t>(kind);
+    symbolIds_[index].clear();
+    for (std::size_t id = 0; id < names.size() && id <= 0xFFFF; ++id) {
+        symbolIds_[index].emplace(names[id], static_cast<std::uint16_t>(id));
+    }
+    symbolNames_[index] = std::move(names);
+}
+
+bool EngineImpl::lookupSymbol(protocol::SymbolKind kind, std::string_view name, std::uint16_t& id) const {
+    const auto& ids = symbolIds_[static_cast<std::size_t>(kind)];
+    auto it = ids.find(name);
+    if (it == ids.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+std::string_view EngineImpl::symbolName(protocol::SymbolKind kind, std::uint16_t id) const {
+    const auto& names = symbolNames_[static_cast<std::size_t>(kind)];
+    return id < names.size() ? std::string_view(names[id]) : std::string_view();
+}
+
+void EngineImpl::sendSymbolTable() {
+    // One record per symbol; large tables are split over several datagrams by the batching logic.
+    for (std::size_t kind = 0; kind < protocol::kSymbolKindCount; ++kind) {
+        const auto& names = symbolNames_[kind];
+        for (std::size_t id = 0; id < names.size() && id <= 0xFFFF; ++id) {
+            recordBuffer_.clear();
+            protocol::appendSymbolRecord(recordBuffer_, static_cast<protocol::SymbolKind>(kind), static_cast<std::uint16_t>(id), names[id]);
+            dispatchRecord(recordBuffer_);
+        }
+    }
+}
+
+void EngineImpl::sendReady() {
     if (!communicator_) return; // Don't send if communicator isn't initialized
+    if (wireProtocol_ == protocol::WireProtocol::Binary) {
+        // The GUI learns the symbol ids together with the READY message.
+        beginBatch();
+        recordBuffer_.clear();
+        protocol::appendRecord(recordBuffer_, protocol::RecordType::Ready, automatonName_);
+        dispatchRecord(recordBuffer_);
+        sendSymbolTable();
+        endBatch();
+        IFA_LOG_DEBUG("[Engine->GUI] Sent: READY " << automatonName_ << " (binary, with symbol table)");
+        return;
+    }
     std::string message = "READY " + automatonName_;
-    communicator_->sendMessage(message);
-    std::cout << "[Engine->GUI] Sent: " << message << std::endl;
+    dispatchMessage(message);
+    IFA_LOG_DEBUG("[Engine->GUI] Sent: " << message);
 }
 
-void Engine::sendStateUpdate(const std::string& stateName) {
+void EngineImpl::sendName() {
+    if (!communicator_) return;
+    if (wireProtocol_ == protocol::WireProtocol::Binary) {
+        // A GUI connecting to a running automaton learns the symbol ids from the NAME reply.
+        beginBatch();
+        recordBuffer_.clear();
+        protocol::appendRecord(recordBuffer_, protocol::RecordType::Name, automatonName_);
+        dispatchRecord(recordBuffer_);
+        sendSymbolTable();
+        endBatch();
+        IFA_LOG_DEBUG("[Engine->GUI] Sent: NAME " << automatonName_ << " (binary, with symbol table)");
+        return;
+    }
+    std::string message = "NAME " + automatonName_;
+    dispatchMessage(message);
+    IFA_LOG_DEBUG("[Engine->GUI] Sent: " << message);
+}
+
+void EngineImpl::sendStateUpdate(const std::string& stateName) {
     if (!communicator_) return;
+    std::uint16_t id = 0;
+    if (wireProtocol_ == protocol::WireProtocol::Binary && lookupSymbol(protocol::SymbolKind::State, stateName, id)) {
+        sendStateById(id);
+        return;
+    }
+    if (journal_ || replay_ || flightRecorder_) {
+        journalEmitted(JournalRecordType::State, stateName);
+    }
     // Format: STATE <stateName>
     std::string message = "STATE " + stateName;
-    communicator_->sendMessage(message);
-    std::cout << "[Engine->GUI] Sent: " << message << std::endl;
+    dispatchMessage(message);
+    IFA_LOG_DEBUG("[Engine->GUI] Sent: " << message);
 }
 
-void Engine::sendOutputUpdate(const std::string& outputName, const std::string& value) {
+void EngineImpl::sendStateById(std::uint16_t stateId) {
     if (!communicator_) return;
+    std::string_view name = symbolName(protocol::SymbolKind::State, stateId);
+    if (wireProtocol_ == protocol::WireProtocol::Text) {
+        sendStateUpdate(std::string(name));
+        return;
+    }
+    if (journal_ || replay_ || flightRecorder_) {
+        journalEmitted(JournalRecordType::State, name);
+    }
+    recordBuffer_.clear();
+    protocol::appendIdRecord(recordBuffer_, protocol::RecordType::State, stateId);
+    dispatchRecord(recordBuffer_);
+    IFA_LOG_DEBUG("[Engine->GUI] Sent: STATE " << name);
+}
+
+void EngineImpl::sendOutputUpdate(const std::string& outputName, const std::string& value) {
+    if (!communicator_) return;
+    std::uint16_t id = 0;
+    if (wireProtocol_ == protocol::WireProtocol::Binary && lookupSymbol(protocol::SymbolKind::Output, outputName, id)) {
+        sendOutputById(id, value);
+        return;
+    }
+    if (journal_ || replay_ || flightRecorder_) {
+        journalEmitted(JournalRecordType::Output, outputName, value);
+    }
     // Format: OUTPUT <outputName>="<value>"
     std::string message = "OUTPUT " + outputName + "=\"" + value + "\""; // Príklad formátu
-    communicator_->sendMessage(message);
-     std::cout << "[Engine->GUI] Sent: " << message << std::endl;
+    dispatchMessage(message);
+     IFA_LOG_DEBUG("[Engine->GUI] Sent: " << message);
 }
 
-void Engine::sendVarUpdate(const std::string& varName, const std::string& value) {
+void EngineImpl::sendOutputById(std::uint16_t outputId, std::string_view value) {
     if (!communicator_) return;
+    std::string_view name = symbolName(protocol::SymbolKind::Output, outputId);
+    if (wireProtocol_ == protocol::WireProtocol::Text) {
+        sendOutputUpdate(std::string(name), std::string(value));
+        return;
+    }
+    if (journal_ || replay_ || flightRecorder_) {
+        journalEmitted(JournalRecordType::Output, name, value);
+    }
+    // The value is carried as raw bytes, so quotes or '|' in it need no escaping.
+    recordBuffer_.clear();
+    protocol::appendIdRecord(recordBuffer_, protocol::RecordType::Output, outputId, value);
+    dispatchRecord(recordBuffer_);
+    IFA_LOG_DEBUG("[Engine->GUI] Sent: OUTPUT " << name << "=\"" << value << "\"");
+}
+
+void EngineImpl::sendVarUpdate(const std::string& varName, const std::string& value) {
+    if (!communicator_) return;
+    std::uint16_t id = 0;
+    if (wireProtocol_ == protocol::WireProtocol::Binary && lookupSymbol(protocol::SymbolKind::Variable, varName, id)) {
+        sendVarById(id, value);
+        return;
+    }
     // Format: VAR <varName>="<value>"
     std::string message = "VAR " + varName + "=\"" + value + "\"";
-    communicator_->sendMessage(message);
-    std::cout << "[Engine->GUI] Sent: " << message << std::endl;
+    dispatchMessage(message);
+    IFA_LOG_DEBUG("[Engine->GUI] Sent: " << message);
 }
 
-void Engine::sendLog(const std::string& message) {
+void EngineImpl::sendVarById(std::uint16_t varId, std::string_view value) {
+    if (!communicator_) return;
+    std::string_view name = symbolName(protocol::SymbolKind::Variable, varId);
+    if (wireProtocol_ == protocol::WireProtocol::Text) {
+        sendVarUpdate(std::string(name), std::string(value));
+        return;
+    }
+    recordBuffer_.clear();
+    protocol::appendIdRecord(recordBuffer_, protocol::RecordType::Variable, varId, value);
+    dispatchRecord(recordBuffer_);
+    IFA_LOG_DEBUG("[Engine->GUI] Sent: VAR " << name << "=\"" << value << "\"");
+}
+
+void EngineImpl::sendLog(const std::string& message) {
     if (!communicator_) return;
+    if (wireProtocol_ == protocol::WireProtocol::Binary) {
+        recordBuffer_.clear();
+        protocol::appendRecord(recordBuffer_, protocol::RecordType::Log, message);
+        dispatchRecord(recordBuffer_);
+        IFA_LOG_DEBUG("[Engine->GUI] Sent: LOG " << message);
+        return;
+    }
     // Assume the message itself doesn't contain characters that break the simple protocol.
     // Format: LOG <message>
     std::string formatted_message = "LOG " + message;
-    communicator_->sendMessage(formatted_message);
-    std::cout << "[Engine->GUI] Sent: " << formatted_message << std::endl;
+    dispatchMessage(formatted_message);
+    IFA_LOG_DEBUG("[Engine->GUI] Sent: " << formatted_message);
 }
 
 
-void Engine::sendError(const std::string& message) {
+void EngineImpl::sendError(const std::string& message) {
     if (!communicator_) return;
+    if (wireProtocol_ == protocol::WireProtocol::Binary) {
+        recordBuffer_.clear();
+        protocol::appendRecord(recordBuffer_, protocol::RecordType::Error, message);
+        dispatchRecord(recordBuffer_);
+        IFA_LOG_ERROR("[Engine->GUI] Sent: ERROR " << message);
+        handleError(message);
+        return;
+    }
     // Format: ERROR <message>
     std::string formatted_message = "ERROR " + message;
-    communicator_->sendMessage(formatted_message);
-    std::cerr << "[Engine->GUI] Sent: " << formatted_message << std::endl;
+    dispatchMessage(formatted_message);
+    IFA_LOG_ERROR("[Engine->GUI] Sent: " << formatted_message);
     handleError(message);
 }
 
-void Engine::sendTerminating() {
+void EngineImpl::sendTerminating() {
     if (!communicator_) return;
-    communicator_->sendMessage("TERMINATING");
-    std::cout << "[Engine->GUI] Sent: TERMINATING" << std::endl;
+    if (wireProtocol_ == protocol::WireProtocol::Binary) {
+        recordBuffer_.clear();
+        protocol::appendRecord(recordBuffer_, protocol::RecordType::Terminating, {});
+        dispatchRecord(recordBuffer_);
+    } else {
+        dispatchMessage("TERMINATING");
+    }
+    IFA_LOG_DEBUG("[Engine->GUI] Sent: TERMINATING");
 }
 
 // Sends a raw, unformatted message string via the communicator.
-void Engine::sendMessage(const std::string& message) {
+void EngineImpl::sendMessage(const std::string& message) {
     if (!communicator_) {
         // Avoid calling handleError here as it might also use the communicator
-        std::cerr << "[Engine] Warning: Attempted to sendMessage before communicator is initialized." << std::endl;
+        IFA_LOG_WARN("[Engine] Warning: Attempted to sendMessage before communicator is initialized.");
         return;
     }
-    // Directly use the communicator to send the raw message
-    communicator_->sendMessage(message);
+    // Send the raw message unchanged (it still takes part in batching)
+    dispatchMessage(message);
     // Optional: Log that a generic message was sent
-    std::cout << "[Engine->GUI] Sent: " << message << std::endl;
+    IFA_LOG_DEBUG("[Engine->GUI] Sent: " << message);
+}
+
+void EngineImpl::setReceiveOptions(std::size_t maxDatagramSize, std::size_t batchSize, int socketReceiveBufferSize) {
+    if (communicator_) {
+        IFA_LOG_WARN("[Engine] Warning: Receive options must be set before initialize(), ignored.");
+        return;
+    }
+    receiveMaxDatagramSize_ = maxDatagramSize;
+    receiveBatchSize_ = batchSize;
+    receiveSocketBufferSize_ = socketReceiveBufferSize;
+}
+
+void EngineImpl::setBatchingEnabled(bool enabled) {
+    if (!enabled) {
+        flushBatch(); // Don't strand messages collected so far.
+    }
+    batchingEnabled_ = enabled;
 }
 
-void Engine::scheduleTimer(long long delayMs, const std::string& targetStateName) {
-    if (!timerManager_) return;
+void EngineImpl::beginBatch() {
+    ++batchDepth_;
+}
+
+void EngineImpl::endBatch() {
+    if (batchDepth_ > 0 && --batchDepth_ == 0) {
+        flushBatch();
+        if (journal_) {
+            journal_->flush(); // The journal holds every completed step
+        }
+    }
+}
+
+void EngineImpl::dispatchMessage(const std::string& message) {
+    if (!communicator_) return;
+    if (wireProtocol_ == protocol::WireProtocol::Binary) {
+        // Text messages travel verbatim inside a Text record.
+        std::string record;
+        protocol::appendRecord(record, protocol::RecordType::Text, message);
+        dispatchRecord(record);
+        return;
+    }
+    if (!batchingEnabled_ || batchDepth_ == 0) {
+        sendUnbatchedMessage(message);
+        return;
+    }
+
+    // Record "<length>:" followed by the raw message bytes, preceded by an INSTANCE message if
+    // the message belongs to another instance than the previous one in the datagram.
+    std::size_t entrySize = batchEntrySize(message.size());
+    auto markerSize = [this]() {
+        return instance_ != batchInstance_ ? batchEntrySize(instanceMessage(instance_).size()) : 0;
+    };
+
+    // Start a new datagram if this record would push the current one over the size limit.
+    if (batchCount_ > 0 && batchBuffer_.size() + markerSize() + entrySize > kMaxBatchDatagramSize) {
+        flushBatch();
+    }
+    if (batchCount_ == 0 && kBatchPrefixLength + markerSize() + entrySize > kMaxBatchDatagramSize) {
+        // A single oversized message is sent on its own.
+        sendUnbatchedMessage(message);
+        return;
+    }
+    if (batchCount_ == 0) {
+        batchBuffer_.assign(kBatchPrefix, kBatchPrefixLength);
+    }
+    if (instance_ != batchInstance_) {
+        appendBatchEntry(batchBuffer_, instanceMessage(instance_));
+        batchInstance_ = instance_;
+    }
+    appendBatchEntry(batchBuffer_, message);
+    ++batchCount_;
+}
+
+void EngineImpl::sendUnbatchedMessage(const std::string& message) {
+    if (instance_ == 0) {
+        communicator_->sendMessage(message);
+        return;
+    }
+    std::string datagram(kBatchPrefix, kBatchPrefixLength);
+    appendBatchEntry(datagram, instanceMessage(instance_));
+    appendBatchEntry(datagram, message);
+    communicator_->sendMessage(datagram);
+}
+
+void EngineImpl::dispatchRecord(const std::string& record) {
+    if (!communicator_) return;
+    if (!batchingEnabled_ || batchDepth_ == 0) {
+        // One record per datagram, preceded by the instance it belongs to (unless instance 0).
+        datagramBuffer_.clear();
+        protocol::appendHeader(datagramBuffer_);
+        if (instance_ != 0) {
+            protocol::appendInstanceRecord(datagramBuffer_, instance_);
+        }
+        datagramBuffer_ += record;
+        communicator_->sendMessage(datagramBuffer_);
+        return;
+    }
+    // Binary records are length-prefixed already; a batch is a datagram with several of them.
+    std::size_t markerSize = instance_ != batchInstance_ ? kInstanceRecordSize : 0;
+    if (batchCount_ > 0 && batchBuffer_.size() + markerSize + record.size() > kMaxBatchDatagramSize) {
+        flushBatch();
+    }
+    if (batchCount_ == 0) {
+        batchBuffer_.clear();
+        protocol::appendHeader(batchBuffer_);
+    }
+    if (instance_ != batchInstance_) {
+        protocol::appendInstanceRecord(batchBuffer_, instance_);
+        batchInstance_ = instance_;
+    }
+    batchBuffer_ += record;
+    ++batchCount_;
+}
+
+void EngineImpl::flushBatch() {
+    if (batchCount_ == 0 || !communicator_) return;
+    communicator_->sendMessage(batchBuffer_);
+    batchBuffer_.clear();
+    batchCount_ = 0;
+    batchInstance_ = 0; // Every datagram starts at instance 0
+}
+
+std::uint64_t EngineImpl::scheduleTimer(long long delayMs, const std::string& targetStateName) {
+    if (!timerManager_) return kInvalidTimerHandle;
     if (delayMs <= 0) {
         // Timers are only for positive delays; immediate transitions are handled differently.
         handleError("Attempted to schedule timer with non-positive delay.");
-        return;
+        return kInvalidTimerHandle;
+    }
+    IFA_LOG_DEBUG("[Engine] Scheduling timer: " << delayMs << "ms -> " << targetStateName);
+    std::uint64_t handle = timerManager_->scheduleTimer(delayMs, targetStateName, instance_);
+    if (flightRecorder_) {
+        char delay[24];
+        auto printed = std::to_chars(delay, delay + sizeof(delay), delayMs);
+        flightRecorder_->record(FlightEventType::TimerScheduled, journalTime(), instance_, targetStateName,
+                                std::string_view(delay, static_cast<std::size_t>(printed.ptr - delay)), handle);
     }
-    std::cout << "[Engine] Scheduling timer: " << delayMs << "ms -> " << targetStateName << std::endl;
-    timerManager_->scheduleTimer(delayMs, targetStateName);
+    return handle;
 }
 
-void Engine::cancelAllTimers() {
-     if (!timerManager_) return;
-     std::cout << "[Engine] Cancelling all timers." << std::endl;
+long long EngineImpl::timerRemaining(std::uint64_t timerHandle) const {
+    if (!timerManager_) return -1;
+    return timerManager_->remainingMs(timerHandle);
+}
+
+bool EngineImpl::cancelTimer(std::uint64_t timerHandle) {
+    if (!timerManager_) return false;
+    bool cancelled = timerManager_->cancelTimer(timerHandle);
+    if (cancelled && flightRecorder_) {
+        flightRecorder_->record(FlightEventType::TimerCancelled, journalTime(), instance_, {}, {}, timerHandle);
+    }
+    return cancelled;
+}
+
+void EngineImpl::cancelAllTimers() {
+     if (!timerManager_ || timerManager_->activeTimerCount() == 0) return;
+     IFA_LOG_DEBUG("[Engine] Cancelling all timers.");
      timerManager_->cancelAllTimers();
 }
 
 
 
-void Engine::handleIncomingUdp(const std::string& type, const std::string& name, const std::string& value) {
-    std::cout << "[Engine] Handling incoming UDP: Type='" << type << "' Name='" << name << "' Value='" << value << "'" << std::endl;
+void EngineImpl::handleIncomingUdp(std::string_view type, std::string_view name, std::string_view value) {
+    IFA_LOG_DEBUG("[Engine] Handling incoming UDP: Type='" << type << "' Name='" << name << "' Value='" << value << "'");
 
     if (type == "INPUT") {
-        // If it's an input event, call the registered onEvent_ handler.
-        if (onEvent_) {
-            // Post the callback to the io_context to ensure it runs in the main event loop thread.
-            asio::post(io_context_, [this, name, value]() { onEvent_(name, value); });
-        } else {
-             std::cerr << "[Engine] Warning: onEvent_ handler not set!" << std::endl;
+        // "name@id" addresses one instance of the automaton, a plain name instance 0.
+        std::uint32_t instanceId = 0;
+        std::size_t at = name.rfind('@');
+        if (at != std::string_view::npos) {
+            const char* idEnd = name.data() + name.size();
+            auto parsed = std::from_chars(name.data() + at + 1, idEnd, instanceId);
+            if (parsed.ec != std::errc() || parsed.ptr != idEnd || at + 1 == name.size()) {
+                handleError("Received INPUT with invalid instance id: " + std::string(name));
+                return;
+            }
+            name = name.substr(0, at);
         }
+        handleInput(instanceId, name, value);
     } else if (type == "CMD") {
         // If it's a command:
         if (name == "TERMINATE") {
@@ -242,66 +843,451 @@ void Engine::handleIncomingUdp(const std::string& type, const std::string& name,
         } else if (name == "GET_STATUS") {
             // Handle the GET_STATUS command.
             handleGetStatus();
+        } else if (name == "CHECKPOINT") {
+            // Handle the CHECKPOINT command.
+            handleCheckpoint();
         } else {
              // Handle unknown commands.
-             handleError("Received unknown command: " + name);
+             handleError("Received unknown command: " + std::string(name));
         }
     }
     else {
         // Handle unknown message types.
-        handleError("Received unknown message type: " + type);
+        handleError("Received unknown message type: " + std::string(type));
     }
 }
 
-void Engine::handleTerminationCommand() {
-     std::cout << "[Engine] Handling termination command." << std::endl;
+void EngineImpl::handleInput(std::uint32_t instanceId, std::string_view name, std::string_view value) {
+    if (replay_ && !replayFeeding_) {
+        IFA_LOG_DEBUG("[Replay] Ignoring INPUT " << name << " from the GUI.");
+        return;
+    }
+    if (journal_) {
+        journal_->append(JournalRecordType::Input, journalTime(), instanceId, name, value);
+    }
+    if (flightRecorder_) {
+        flightRecorder_->record(FlightEventType::Input, journalTime(), instanceId, name, value);
+    }
+    // The receive handler already runs on the event loop thread, so the callback is
+    // invoked directly with views into the receive buffer instead of posting copies.
+    if (onInstanceEvent_) {
+        runInstanceStep(instanceId, [&]() { onInstanceEvent_(instanceId, name, value); });
+    } else if (!onEvent_) {
+        IFA_LOG_WARN("[Engine] Warning: onEvent_ handler not set!");
+    } else if (instanceId != 0) {
+        handleError("Received INPUT for instance " + std::to_string(instanceId) + " of a single-instance automaton.");
+    } else {
+        runStep([&]() { onEvent_(name, value); });
+    }
+}
+
+void EngineImpl::handleIncomingBinary(const char* data, std::size_t length) {
+    protocol::RecordReader reader(data, length);
+    if (!reader.valid()) {
+        handleError("Received binary datagram with unsupported protocol version.");
+        return;
+    }
+    protocol::Record record;
+    std::uint32_t instanceId = 0; // Set by Instance records, for the Input records following them
+    while (reader.next(record)) {
+        switch (record.type) {
+        case protocol::RecordType::Instance:
+            if (!protocol::readInstancePayload(record.payload, instanceId)) {
+                handleError("Received malformed INSTANCE record.");
+                return;
+            }
+            break;
+        case protocol::RecordType::Input: {
+            // Translate the input id back to its name; the value is passed on as raw bytes.
+            std::uint16_t id = 0;
+            std::string_view value;
+            std::string_view name;
+            if (protocol::splitIdPayload(record.payload, id, value)) {
+                name = symbolName(protocol::SymbolKind::Input, id);
+            }
+            if (name.empty()) {
+                handleError("Received INPUT record for unknown input id " + std::to_string(id));
+                break;
+            }
+            handleInput(instanceId, name, value);
+            break;
+        }
+        case protocol::RecordType::Command: {
+            auto command = record.payload.empty() ? 0 : static_cast<std::uint8_t>(record.payload[0]);
+            if (command == static_cast<std::uint8_t>(protocol::Command::Terminate)) {
+                handleIncomingUdp("CMD", "TERMINATE", {});
+            } else if (command == static_cast<std::uint8_t>(protocol::Command::GetStatus)) {
+                handleIncomingUdp("CMD", "GET_STATUS", {});
+            } else if (command == static_cast<std::uint8_t>(protocol::Command::Checkpoint)) {
+                handleIncomingUdp("CMD", "CHECKPOINT", {});
+            } else {
+                handleError("Received unknown binary command: " + std::to_string(command));
+            }
+            break;
+        }
+        default:
+            handleError("Received unexpected binary record type: " + std::to_string(static_cast<int>(record.type)));
+            break;
+        }
+    }
+    if (reader.malformed()) {
+        handleError("Received malformed binary datagram.");
+    }
+}
+
+void EngineImpl::handleTerminationCommand() {
+     IFA_LOG_INFO("[Engine] Handling termination command.");
+     if (journal_) {
+         journal_->append(JournalRecordType::Command, journalTime(), 0, "TERMINATE");
+     }
+     if (flightRecorder_) {
+         flightRecorder_->record(FlightEventType::Command, journalTime(), 0, "TERMINATE");
+     }
      if (onTerminate_) {
         // Post the callback to run within the io_context.
-         asio::post(io_context_, onTerminate_);
+         asio::post(executor_, tracker_.track(onTerminate_));
      } else {
         // If no handler, stop the engine immediately.
          stop();
      }
 }
 
-void Engine::handleGetStatus() {
-    std::cout << "[Engine] Handling GET_STATUS request." << std::endl;
+void EngineImpl::handleGetStatus() {
+    IFA_LOG_DEBUG("[Engine] Handling GET_STATUS request.");
+    if (replay_ && !replayFeeding_) {
+        IFA_LOG_DEBUG("[Replay] Ignoring GET_STATUS from the GUI.");
+        return;
+    }
+    if (journal_) {
+        journal_->append(JournalRecordType::Command, journalTime(), 0, "GET_STATUS");
+    }
+    if (flightRecorder_) {
+        flightRecorder_->record(FlightEventType::Command, journalTime(), 0, "GET_STATUS");
+    }
     if (onStatusRequest_) {
         // The onStatusRequest_ handler (in generated code) is responsible for calling
         // sendStateUpdate, sendVarUpdate, sendOutputUpdate etc.
-         asio::post(io_context_, onStatusRequest_);
+         asio::post(executor_, tracker_.track([this]() { runStep(onStatusRequest_); }));
+    } else {
+        IFA_LOG_WARN("[Engine] Warning: onStatusRequest_ handler not set!");
+    }
+}
+
+void EngineImpl::handleCheckpoint() {
+    IFA_LOG_DEBUG("[Engine] Handling CHECKPOINT request.");
+    if (flightRecorder_) {
+        flightRecorder_->record(FlightEventType::Command, journalTime(), 0, "CHECKPOINT");
+    }
+    if (onCheckpoint_) {
+        // Not journaled: a checkpoint does not change the automaton.
+        asio::post(executor_, tracker_.track([this]() { runStep(onCheckpoint_); }));
     } else {
-        std::cerr << "[Engine] Warning: onStatusRequest_ handler not set!" << std::endl;
+        handleError("Received CHECKPOINT, but the automaton does not support checkpoints.");
     }
 }
 
-void Engine::handleTimeout(const std::string& targetStateName) {
-    std::cout << "[Engine] Handling timeout for target state: " << targetStateName << std::endl;
-     if (onTimeout_) {
+void EngineImpl::handleTimeout(std::uint32_t instanceId, const std::string& targetStateName) {
+    IFA_LOG_DEBUG("[Engine] Handling timeout for target state: " << targetStateName);
+     if (onInstanceTimeout_) {
+         ++pendingTimeoutSteps_;
+         asio::post(executor_, tracker_.track([this, instanceId, targetStateName]() {
+            journalTimeout(instanceId, targetStateName);
+            runInstanceStep(instanceId, [&]() { onInstanceTimeout_(instanceId, targetStateName); });
+         }));
+     } else if (onTimeout_) {
+         ++pendingTimeoutSteps_;
         // Post the callback to run within the io_context.
-         asio::post(io_context_, [this, targetStateName]() {
-            onTimeout_(targetStateName);
-         });
+         asio::post(executor_, tracker_.track([this, targetStateName]() {
+            journalTimeout(0, targetStateName);
+            runStep([&]() { onTimeout_(targetStateName); });
+         }));
      } else {
-          std::cerr << "[Engine] Warning: onTimeout_ handler not set!" << std::endl;
+          IFA_LOG_WARN("[Engine] Warning: onTimeout_ handler not set!");
      }
 }
 
-void Engine::handleError(const std::string& errorMessage) {
-    std::cerr << "[Engine] Error occurred: " << errorMessage << std::endl;
+std::uint64_t EngineImpl::journalTime() const {
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock_->now() - journalStart_).count();
+    return elapsed > 0 ? static_cast<std::uint64_t>(elapsed) : 0;
+}
+
+void EngineImpl::journalEmitted(JournalRecordType type, std::string_view name, std::string_view value) {
+    if (journal_) {
+        journal_->append(type, journalTime(), instance_, name, value);
+    }
+    if (replay_) {
+        replay_->checkEmitted(type, instance_, name, value);
+    }
+    if (flightRecorder_) {
+        flightRecorder_->record(type == JournalRecordType::State ? FlightEventType::State : FlightEventType::Output,
+                                journalTime(), instance_, name, value);
+    }
+}
+
+void EngineImpl::journalTimeout(std::uint32_t instanceId, const std::string& targetStateName) {
+    --pendingTimeoutSteps_;
+    if (journal_) {
+        journal_->append(JournalRecordType::Timer, journalTime(), instanceId, targetStateName);
+    }
+    if (flightRecorder_) {
+        flightRecorder_->record(FlightEventType::TimerFired, journalTime(), instanceId, targetStateName);
+    }
+    if (replay_ && !replayReported_) {
+        replay_->checkTimer(instanceId, targetStateName);
+        // Continue behind the handlers the step posts, like after a fed record.
+        scheduleReplayFeed();
+    }
+}
+
+void EngineImpl::scheduleReplayFeed() {
+    if (replayFeedScheduled_) {
+        return;
+    }
+    replayFeedScheduled_ = true;
+    asio::post(executor_, tracker_.track([this]() {
+        replayFeedScheduled_ = false;
+        feedReplay();
+    }));
+}
+
+void EngineImpl::feedReplay() {
+    if (replayReported_) {
+        return; // Stopped
+    }
+    const JournalRecord* record = replay_->nextInbound();
+    if (!record) {
+        IFA_LOG_INFO("[Replay] End of the journal reached.");
+        requestStop();
+        return;
+    }
+    Clock::TimePoint due = journalStart_ + std::chrono::microseconds(record->timeUs);
+    if (record->type == JournalRecordType::Timer) {
+        // The step of the timer continues the replay; fail if no timer is left to fire.
+        if (timerManager_->activeTimerCount() == 0 && pendingTimeoutSteps_ == 0) {
+            replay_->fail("The journal expects TIMER " + record->name + " (instance " +
+                          std::to_string(record->instance) + "), but no timer is pending");
+            requestStop();
+        }
+        // In virtual time the timer fires at its recorded time, late by as much as it was in the
+        // recording, so the timers its step starts expire in the recorded order too.
+        clock_->advanceTo(due);
+        return;
+    }
+    if (clock_->isVirtual()) {
+        clock_->advanceTo(due);
+    } else if (due > clock_->now()) {
+        // Wait for the recorded time of the record.
+        replayFeedScheduled_ = true;
+        replayTimer_->expires_at(due);
+        replayTimer_->async_wait(tracker_.track([this](const asio::error_code& error) {
+            replayFeedScheduled_ = false;
+            if (!error) {
+                feedReplay();
+            }
+        }));
+        return;
+    }
+    replayFeeding_ = true;
+    if (record->type == JournalRecordType::Input) {
+        handleInput(record->instance, record->name, record->value);
+    } else if (record->name == "TERMINATE") {
+        handleTerminationCommand();
+    } else {
+        handleGetStatus();
+    }
+    replayFeeding_ = false;
+    replay_->consumeInbound();
+    scheduleReplayFeed();
+}
+
+void EngineImpl::handleError(const std::string& errorMessage) {
+    IFA_LOG_ERROR("[Engine] Error occurred: " << errorMessage);
+    if (flightRecorder_) {
+        flightRecorder_->record(FlightEventType::Error, journalTime(), instance_, errorMessage);
+    }
 
     // Send an ERROR message to the GUI, if the communicator is available.
     if (communicator_) {
-        std::string formatted_message = "ERROR " + errorMessage;
-        // Use sendMessage directly to avoid potential recursion if sendMessage itself fails.
-        communicator_->sendMessage(formatted_message);
-        std::cerr << "[Engine->GUI] Sent: " << formatted_message << std::endl;
+        // Use dispatchMessage/dispatchRecord directly to avoid potential recursion if sending itself fails.
+        if (wireProtocol_ == protocol::WireProtocol::Binary) {
+            recordBuffer_.clear();
+            protocol::appendRecord(recordBuffer_, protocol::RecordType::Error, errorMessage);
+            dispatchRecord(recordBuffer_);
+            IFA_LOG_ERROR("[Engine->GUI] Sent: ERROR " << errorMessage);
+        } else {
+            std::string formatted_message = "ERROR " + errorMessage;
+            dispatchMessage(formatted_message);
+            IFA_LOG_ERROR("[Engine->GUI] Sent: " << formatted_message);
+        }
     }
 
     // Call the registered onError_ callback, if it exists
     if (onError_) {
-        asio::post(io_context_, [this, errorMessage](){ onError_(errorMessage); });
+        postHandler([this, errorMessage](){ onError_(errorMessage); });
     }
 }
 
-} // namespace ifa_runtime
\ No newline at end of file
+
+// --- Engine: forwarding to the implementation ---
+
+Engine::Engine() : impl_(std::make_unique<EngineImpl>(Scheduler::processScheduler())) {}
+
+Engine::Engine(Scheduler& scheduler) : impl_(std::make_unique<EngineImpl>(&scheduler)) {}
+
+Engine::~Engine() = default;
+
+bool Engine::initialize(const std::string& automatonName,int listen_port, const std::string& gui_host, int gui_port) {
+    return impl_->initialize(automatonName, listen_port, gui_host, gui_port);
+}
+
+void Engine::setClockMode(ClockMode mode) {
+    impl_->setClockMode(mode);
+}
+
+bool Engine::setJournal(const std::string& path) {
+    return impl_->setJournal(path);
+}
+
+bool Engine::setReplay(const std::string& path, ReplayPace pace) {
+    return impl_->setReplay(path, pace);
+}
+
+bool Engine::replayMatched() const {
+    return impl_->replayMatched();
+}
+
+bool Engine::setFlightRecorder(const std::string& path, std::size_t capacity) {
+    return impl_->setFlightRecorder(path, capacity);
+}
+
+std::chrono::steady_clock::time_point Engine::now() const {
+    return impl_->now();
+}
+
+void Engine::setEventHandlers(EventHandler onEvent, TimeoutHandler onTimeout, TerminationHandler onTerminate, ErrorHandler onError,StatusRequestHandler onStatusRequest) {
+    impl_->setEventHandlers(std::move(onEvent), std::move(onTimeout), std::move(onTerminate), std::move(onError), std::move(onStatusRequest));
+}
+
+void Engine::setInstanceHandlers(InstanceEventHandler onEvent, InstanceTimeoutHandler onTimeout) {
+    impl_->setInstanceHandlers(std::move(onEvent), std::move(onTimeout));
+}
+
+void Engine::setCheckpointHandler(CheckpointHandler onCheckpoint) {
+    impl_->setCheckpointHandler(std::move(onCheckpoint));
+}
+
+void Engine::setInstance(std::uint32_t instanceId) {
+    impl_->setInstance(instanceId);
+}
+
+void Engine::run() {
+    impl_->run();
+}
+
+void Engine::stop() {
+    impl_->stop();
+}
+
+void Engine::requestStop() {
+    impl_->requestStop();
+}
+
+EngineUsage Engine::usage() const {
+    EngineUsage usage = impl_->usage();
+    usage.automatonName = impl_->automatonName();
+    return usage;
+}
+
+void Engine::setWireProtocol(protocol::WireProtocol wireProtocol) {
+    impl_->setWireProtocol(wireProtocol);
+}
+
+protocol::WireProtocol Engine::wireProtocol() const {
+    return impl_->wireProtocol();
+}
+
+void Engine::setSymbols(protocol::SymbolKind kind, std::vector<std::string> names) {
+    impl_->setSymbols(kind, std::move(names));
+}
+
+void Engine::sendReady() {
+    impl_->sendReady();
+}
+
+void Engine::sendName() {
+    impl_->sendName();
+}
+
+void Engine::sendStateById(std::uint16_t stateId) {
+    impl_->sendStateById(stateId);
+}
+
+void Engine::sendOutputById(std::uint16_t outputId, std::string_view value) {
+    impl_->sendOutputById(outputId, value);
+}
+
+void Engine::sendVarById(std::uint16_t varId, std::string_view value) {
+    impl_->sendVarById(varId, value);
+}
+
+void Engine::sendStateUpdate(const std::string& stateName) {
+    impl_->sendStateUpdate(stateName);
+}
+
+void Engine::sendOutputUpdate(const std::string& outputName, const std::string& value) {
+    impl_->sendOutputUpdate(outputName, value);
+}
+
+void Engine::sendVarUpdate(const std::string& varName, const std::string& value) {
+    impl_->sendVarUpdate(varName, value);
+}
+
+void Engine::sendLog(const std::string& message) {
+    impl_->sendLog(message);
+}
+
+void Engine::sendError(const std::string& message) {
+    impl_->sendError(message);
+}
+
+void Engine::sendTerminating() {
+    impl_->sendTerminating();
+}
+
+void Engine::sendMessage(const std::string& message) {
+    impl_->sendMessage(message);
+}
+
+void Engine::setReceiveOptions(std::size_t maxDatagramSize, std::size_t batchSize, int socketReceiveBufferSize) {
+    impl_->setReceiveOptions(maxDatagramSize, batchSize, socketReceiveBufferSize);
+}
+
+void Engine::setBatchingEnabled(bool enabled) {
+    impl_->setBatchingEnabled(enabled);
+}
+
+void Engine::beginBatch() {
+    impl_->beginBatch();
+}
+
+void Engine::endBatch() {
+    impl_->endBatch();
+}
+
+std::uint64_t Engine::scheduleTimer(long long delayMs, const std::string& targetStateName) {
+    return impl_->scheduleTimer(delayMs, targetStateName);
+}
+
+long long Engine::timerRemaining(std::uint64_t timerHandle) const {
+    return impl_->timerRemaining(timerHandle);
+}
+
+bool Engine::cancelTimer(std::uint64_t timerHandle) {
+    return impl_->cancelTimer(timerHandle);
+}
+
+void Engine::cancelAllTimers() {
+    impl_->cancelAllTimers();
+}
+
+} // namespace ifa_runtime
@@ -4,7 +4,8 @@
  * @details This class orchestrates communication (UDP), timer management, and the
  *          main event loop (Asio io_context) for the generated automaton code.
  *          It provides an API for the generated code to interact with the environment
- *          and handles incoming messages from the GUI/monitor.
+ *          and handles incoming messages from the GUI/monitor. The header is a thin
+ *          interface: the implementation, and with it Asio, lives in libifa_runtime.
  * @authors Your Authors (xsiaket00, xsimonl00)
  * @date 2025-05-05 // Date of last modification
  */
@@ -12,32 +13,53 @@
 #ifndef IFA_RUNTIME_ENGINE_H
 #define IFA_RUNTIME_ENGINE_H
 
-#include <asio.hpp>
 #include <string>
+#include <string_view>
 #include <functional> // Pre std::function (callbacky)
-#include <optional>
-#include <chrono>
 #include <memory> // Pre unique_ptr
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <chrono>
+#include "ifa_runtime_protocol.h"
+#include "ifa_runtime_scheduler.h"
 
 namespace ifa_runtime {
 
-// Forward declarations for internal implementation classes
-// This avoids including their full headers here, reducing coupling.
-class UdpCommunicator;
-class TimerManager;
+// Forward declaration of the implementation (ifa_runtime_engine_impl.h).
+// Keeps Asio and the engine internals out of this header, so the generated code compiles quickly.
+class EngineImpl;
 
 /**
  * @brief Callback function type for handling external input events.
+ * @details The views point into the engine's receive buffer and are only valid during the call;
+ *          the handler must copy whatever it wants to keep.
  * @param input_name The name of the input channel that received the event.
  * @param value The string value associated with the event.
  */
-using EventHandler = std::function<void(const std::string& /*input_name*/, const std::string& /*value*/)>;
+using EventHandler = std::function<void(std::string_view /*input_name*/, std::string_view /*value*/)>;
 /**
  * @brief Callback function type for handling timer timeouts.
  * @param target_state_name The name of the state the automaton should transition to upon timeout.
  */
 using TimeoutHandler = std::function<void(const std::string& /*target_state_name*/)>;
 
+/**
+ * @brief Callback function type for handling input events addressed to one automaton instance.
+ * @details Used by automata running several instances in one process (see Engine::setInstance()).
+ *          The views are only valid during the call, as with EventHandler.
+ * @param instance_id The instance the event is addressed to ("INPUT|name@id|value").
+ * @param input_name The name of the input channel that received the event.
+ * @param value The string value associated with the event.
+ */
+using InstanceEventHandler = std::function<void(std::uint32_t /*instance_id*/, std::string_view /*input_name*/, std::string_view /*value*/)>;
+/**
+ * @brief Callback function type for handling the timeout of a timer scheduled by one automaton instance.
+ * @param instance_id The instance that scheduled the timer.
+ * @param target_state_name The name of the state the instance should transition to.
+ */
+using InstanceTimeoutHandler = std::function<void(std::uint32_t /*instance_id*/, const std::string& /*target_state_name*/)>;
+
 /**
  * @brief Callback function type for handling an external termination command or signal.
  */
@@ -52,19 +74,59 @@ using ErrorHandler = std::function<void(const std::string& /*error_message*/)>;
  * @details The implementation should call sendStateUpdate, sendVarUpdate, etc.
  */
 using StatusRequestHandler = std::function<void()>;
+/**
+ * @brief Callback function type for handling a request to save a checkpoint of the automaton.
+ * @details The implementation writes the state of all instances to its snapshot file.
+ */
+using CheckpointHandler = std::function<void()>;
+
+/**
+ * @brief The time the timers of an engine and the automaton's elapsed() run on.
+ */
+enum class ClockMode {
+    /** @brief Real time (std::chrono::steady_clock). */
+    Real,
+    /**
+     * @brief Discrete-event virtual time: whenever the engine has nothing to do, the clock jumps
+     *        straight to the next timer expiry, so delays take no real time. Without pending
+     *        timers the engine waits for the next message as usual.
+     */
+    Virtual
+};
+
+/**
+ * @brief Pace at which a journal is replayed (see Engine::setReplay()).
+ */
+enum class ReplayPace {
+    /** @brief The inputs are fed back at their recorded times, in real time. */
+    Recorded,
+    /** @brief As fast as possible, in virtual time (see ClockMode::Virtual). */
+    Fastest
+};
 
 /**
  * @brief The core runtime engine class.
  * @details Manages the Asio event loop, UDP communication, timer scheduling,
  *          and interaction with the generated automaton code via callbacks.
+ *          All calls are forwarded to EngineImpl.
  */
 class Engine {
 public:
     /**
      * @brief Constructs the Engine instance. Initializes Asio components.
+     * @details The engine runs on the Scheduler set by Scheduler::setProcessScheduler() if there is
+     *          one, otherwise on its own io_context.
      */
     Engine();
 
+    /**
+     * @brief Constructs an engine whose handlers run on the worker threads of a scheduler.
+     * @details The handlers of the engine are serialized on a strand, so the automaton sees the
+     *          same run-to-completion semantics as with its own io_context.
+     * @param scheduler The scheduler; must outlive the engine.
+     */
+    explicit Engine(Scheduler& scheduler);
+
     /**
      * @brief Destructor. Cleans up resources.
      */
@@ -80,6 +142,66 @@ public:
      */
     bool initialize(const std::string& automatonName,int listen_port, const std::string& gui_host, int gui_port);
     
+    /**
+     * @brief Selects the clock of the engine. Must be called before initialize().
+     * @details Virtual time needs the event loop of run() and is only available to an engine with
+     *          its own io_context; an engine on a Scheduler keeps real time.
+     * @param mode The clock mode.
+     */
+    void setClockMode(ClockMode mode);
+
+    /**
+     * @brief Journals what the automaton receives and emits to a file. Must be called before initialize().
+     * @details Every INPUT and CMD the engine handles and every timer expiry is recorded with its
+     *          time when the automaton handles it, every STATE and OUTPUT when it is sent. The file
+     *          is written at the end of every step. See setReplay().
+     * @param path The journal file; an existing file is overwritten.
+     * @return bool True if the file could be created.
+     */
+    bool setJournal(const std::string& path);
+
+    /**
+     * @brief Replays a journal instead of taking inputs from the GUI. Must be called before initialize().
+     * @details run() feeds the recorded INPUT and CMD messages back in their recorded order,
+     *          waiting for the recorded timer expiries in between, and compares every STATE and
+     *          OUTPUT the automaton sends with the journal. INPUT and GET_STATUS from the GUI are
+     *          ignored meanwhile. The engine terminates when the journal has been replayed; the
+     *          result is logged and available from replayMatched(). The Fastest pace selects
+     *          virtual time, which an engine on a Scheduler cannot use (it replays at the
+     *          recorded pace instead).
+     * @param path The journal file written with setJournal().
+     * @param pace The pace of the replay.
+     * @return bool True if the journal could be read.
+     */
+    bool setReplay(const std::string& path, ReplayPace pace);
+
+    /**
+     * @brief Gets the result of the replay once run() has returned.
+     * @return bool True if the automaton reproduced the journal exactly (or nothing was replayed).
+     */
+    bool replayMatched() const;
+
+    /**
+     * @brief Keeps the last events of the engine in a memory-mapped file. Must be called before initialize().
+     * @details Every input, command, state entered, output, timer scheduled, cancelled or fired
+     *          and error is written as a fixed-size record into a ring buffer mapped from the file,
+     *          overwriting the oldest record once it is full. Writing a record costs a copy, no
+     *          system call, and the file survives a crash or kill of the process; decode it with
+     *          ifa_flightrec.
+     * @param path The file; an existing file is overwritten.
+     * @param capacity Number of records kept (rounded up to a power of two, 64 bytes each).
+     * @return bool True if the file could be created and mapped.
+     */
+    bool setFlightRecorder(const std::string& path, std::size_t capacity);
+
+    /**
+     * @brief Gets the current time of the engine's clock.
+     * @details The time the automaton measures elapsed() with; in virtual time it only moves
+     *          when the engine advances it to a timer expiry.
+     * @return std::chrono::steady_clock::time_point The current time.
+     */
+    std::chrono::steady_clock::time_point now() const;
+
     /**
      * @brief Sets the callback functions provided by the generated automaton code.
      * @param onEvent Handler for input events.
@@ -89,34 +211,134 @@ public:
      * @param onStatusRequest Handler for status requests from the GUI.
      */
     void setEventHandlers(EventHandler onEvent, TimeoutHandler onTimeout, TerminationHandler onTerminate, ErrorHandler onError,StatusRequestHandler onStatusRequest);
-    
+
+    /**
+     * @brief Sets the handlers of an automaton running several instances on this engine.
+     * @details When set, they replace the onEvent and onTimeout handlers of setEventHandlers() for
+     *          all instances, including instance 0. Without them only instance 0 exists and inputs
+     *          addressed to another instance are reported as errors.
+     * @param onEvent Handler for input events.
+     * @param onTimeout Handler for timer expirations.
+     */
+    void setInstanceHandlers(InstanceEventHandler onEvent, InstanceTimeoutHandler onTimeout);
+
+    /**
+     * @brief Sets the handler of the "CHECKPOINT" command.
+     * @details Without it the command is reported as an error. The handler runs as a step of
+     *          its own, between the steps of the automaton.
+     * @param onCheckpoint Handler writing the checkpoint.
+     */
+    void setCheckpointHandler(CheckpointHandler onCheckpoint);
+
+    /**
+     * @brief Selects the automaton instance subsequent messages and timers belong to.
+     * @details The engine selects the instance itself around the handlers it calls for an
+     *          instance, and instance 0 otherwise; the automaton only calls this for work it
+     *          does on its own (entering the initial states, answering GET_STATUS). Messages of
+     *          an instance other than 0 are preceded by an "INSTANCE <id>" message (an Instance
+     *          record in the binary protocol) within their datagram, and timers scheduled
+     *          while an instance is selected expire on that instance.
+     * @param instanceId The instance id.
+     */
+    void setInstance(std::uint32_t instanceId);
+
     /**
      * @brief Starts the Asio io_context event loop.
      * @details This function blocks until the io_context is stopped (e.g., via stop() or signal).
-     *          The automaton logic runs within this event loop.
+     *          The automaton logic runs within this event loop. On a scheduler the handlers run
+     *          on the worker threads and the calling thread only waits for the engine to stop.
      */
     void run();
 
     /**
      * @brief Stops the Asio io_context event loop gracefully.
      * @details Cancels pending operations (timers, signals) and stops the io_context.
-     *          Sends a TERMINATING message before stopping.
+     *          Sends a TERMINATING message before stopping. Must be called from the thread
+     *          running the event loop (e.g. from a callback); use requestStop() elsewhere.
      */
     void stop();
 
+    /**
+     * @brief Asks the engine to terminate; may be called from any thread.
+     * @details Posts the request to the event loop, where it is handled like SIGINT/SIGTERM: the
+     *          termination handler is called (or stop() if there is none). Used by a plugin host
+     *          to stop an automaton running on another thread.
+     */
+    void requestStop();
+
+    /**
+     * @brief Returns the resources used by the engine so far.
+     * @details The CPU time is measured per handler on a scheduler only (a standalone engine is
+     *          a process of its own); it is zero otherwise. May be called from any thread after initialize().
+     * @return EngineUsage The usage.
+     */
+    EngineUsage usage() const;
+
+    /**
+     * @brief Selects the wire protocol used towards the GUI.
+     * @details Inbound datagrams are accepted in both protocols regardless of this setting.
+     * @param wireProtocol The protocol for outbound messages.
+     */
+    void setWireProtocol(protocol::WireProtocol wireProtocol);
+
+    /**
+     * @brief Gets the wire protocol used towards the GUI.
+     * @return protocol::WireProtocol The current protocol.
+     */
+    protocol::WireProtocol wireProtocol() const;
+
+    /**
+     * @brief Registers the names behind the numeric ids of one kind of symbol.
+     * @details The id of a symbol is its index in names. The tables are announced to the GUI
+     *          with READY and NAME in the binary protocol and used to translate ids back to
+     *          names in the text protocol.
+     * @param kind The kind of symbols.
+     * @param names The symbol names, indexed by id.
+     */
+    void setSymbols(protocol::SymbolKind kind, std::vector<std::string> names);
+
     /**
      * @brief Sends a "READY" message to the GUI, indicating the automaton is initialized.
+     * @details In the binary protocol the symbol dictionary follows the message.
      */
     void sendReady();
 
+    /**
+     * @brief Sends the automaton's name to the GUI ("NAME" message, reply to GET_STATUS).
+     * @details In the binary protocol the symbol dictionary follows the message.
+     */
+    void sendName();
+
+    /**
+     * @brief Sends the current state to the GUI by its symbol id.
+     * @param stateId Id of the currently active state (see setSymbols()).
+     */
+    void sendStateById(std::uint16_t stateId);
+
+    /**
+     * @brief Sends an output value update to the GUI by the output's symbol id.
+     * @param outputId Id of the output channel (see setSymbols()).
+     * @param value The string value sent to the output.
+     */
+    void sendOutputById(std::uint16_t outputId, std::string_view value);
+
+    /**
+     * @brief Sends a variable value update to the GUI by the variable's symbol id.
+     * @param varId Id of the variable (see setSymbols()).
+     * @param value The current string value of the variable.
+     */
+    void sendVarById(std::uint16_t varId, std::string_view value);
+
     /**
      * @brief Sends the current state name to the GUI.
+     * @details In the binary protocol the name is translated to its symbol id.
      * @param stateName The name of the currently active state.
      */
     void sendStateUpdate(const std::string& stateName);
 
     /**
      * @brief Sends an output value update to the GUI.
+     * @details In the binary protocol the name is translated to its symbol id.
      * @param outputName The name of the output channel.
      * @param value The string value sent to the output.
      */
@@ -124,6 +346,7 @@ public:
 
      /**
      * @brief Sends an internal variable value update to the GUI.
+     * @details In the binary protocol the name is translated to its symbol id.
      * @param varName The name of the variable.
      * @param value The current string value of the variable.
      */
@@ -150,88 +373,72 @@ public:
     /**
      * @brief Sends a raw message string via the communicator.
      * @details Useful for potentially custom or future message types not covered by specific methods.
+     *          In the binary protocol the message is carried verbatim in a Text record.
      * @param message The complete message string to send.
      */
     void sendMessage(const std::string& message);
 
     /**
-     * @brief Schedules a timer for a delayed transition.
-     * @param delayMs The delay in milliseconds. Must be positive.
-     * @param targetStateName The name of the state to transition to upon timeout.
+     * @brief Configures the UDP receive path. Must be called before initialize().
+     * @param maxDatagramSize Largest inbound datagram accepted; longer ones are counted and discarded.
+     * @param batchSize Maximum number of datagrams read per socket wakeup.
+     * @param socketReceiveBufferSize Requested SO_RCVBUF size in bytes, 0 keeps the system default.
      */
-    void scheduleTimer(long long delayMs, const std::string& targetStateName);
+    void setReceiveOptions(std::size_t maxDatagramSize, std::size_t batchSize, int socketReceiveBufferSize);
 
     /**
-     * @brief Cancels all currently scheduled timers.
+     * @brief Enables or disables batching of outbound updates.
+     * @details When enabled, all messages produced while handling one event, timeout or
+     *          status request (or between beginBatch() and endBatch()) are coalesced into
+     *          as few datagrams as possible instead of one datagram per message.
+     * @param enabled True to enable batching.
      */
-    void cancelAllTimers();
+    void setBatchingEnabled(bool enabled);
 
-private:
-    /**
-     * @brief The core Asio I/O execution context for managing asynchronous operations.
-     */
-    asio::io_context io_context_;
     /**
-     * @brief Unique pointer to the UDP communicator instance. Hides Asio details.
+     * @brief Opens a batch scope. Calls may be nested; the batch is flushed by the outermost endBatch().
+     * @details The engine opens a scope automatically around every callback it invokes; the generated
+     *          code only needs this for work done outside callbacks (e.g. entering the initial state).
      */
-    std::unique_ptr<UdpCommunicator> communicator_;
+    void beginBatch();
 
     /**
-     * @brief Unique pointer to the Timer manager instance. Hides Asio details.
+     * @brief Closes a batch scope and flushes the accumulated messages when the outermost scope ends.
      */
-    std::unique_ptr<TimerManager> timerManager_;
+    void endBatch();
 
     /**
-     * @brief The name of the automaton instance this engine is running.
-     */
-    std::string automatonName_;
-
-    /** @brief Callback for input events. */
-    EventHandler onEvent_;
-    /** @brief Callback for timer timeouts. */
-    TimeoutHandler onTimeout_;
-    /** @brief Callback for termination command/signal. */
-    TerminationHandler onTerminate_;
-    /** @brief Callback for errors. */
-    ErrorHandler onError_;
-    /** @brief Callback for status requests. */
-    StatusRequestHandler onStatusRequest_;
-
-    /**
-     * @brief Asio signal set to handle termination signals (SIGINT, SIGTERM) gracefully.
-     */
-    std::unique_ptr<asio::signal_set> signals_;
-
-    /**
-     * @brief Internal handler for incoming UDP messages.
-     * @details Parses the message type and delegates to appropriate handlers (onEvent_, handleTerminationCommand, handleGetStatus).
-     * @param type Message type ("INPUT", "CMD", etc.).
-     * @param name Message name (input name, command name).
-     * @param value Message value.
+     * @brief Schedules a timer for a delayed transition of the selected instance (see setInstance()).
+     * @param delayMs The delay in milliseconds. Must be positive.
+     * @param targetStateName The name of the state to transition to upon timeout.
+     * @return std::uint64_t Handle of the scheduled timer (usable with cancelTimer()), 0 if nothing was scheduled.
      */
-    void handleIncomingUdp(const std::string& type, const std::string& name, const std::string& value);
+    std::uint64_t scheduleTimer(long long delayMs, const std::string& targetStateName);
 
     /**
-     * @brief Handles the "TERMINATE" command received via UDP. Invokes onTerminate_ callback.
+     * @brief Cancels a single scheduled timer.
+     * @param timerHandle Handle returned by scheduleTimer().
+     * @return bool True if the timer was pending and has been cancelled.
      */
-    void handleTerminationCommand();
+    bool cancelTimer(std::uint64_t timerHandle);
 
     /**
-     * @brief Handles the "GET_STATUS" command received via UDP. Invokes onStatusRequest_ callback.
+     * @brief Gets the time left until a scheduled timer expires (e.g. to save it in a checkpoint).
+     * @param timerHandle Handle returned by scheduleTimer().
+     * @return long long Milliseconds left (0 if it is due), -1 if the timer is no longer pending.
      */
-    void handleGetStatus();
+    long long timerRemaining(std::uint64_t timerHandle) const;
 
     /**
-     * @brief Handles a timeout event triggered by the TimerManager. Invokes onTimeout_ callback.
-     * @param targetStateName The target state associated with the expired timer.
+     * @brief Cancels all currently scheduled timers.
      */
-    void handleTimeout(const std::string& targetStateName);
+    void cancelAllTimers();
 
+private:
     /**
-     * @brief Internal error handling routine. Logs the error and calls the onError_ callback.
-     * @param errorMessage The description of the error.
+     * @brief The implementation; holds the Asio io_context, communicator, timers and buffers.
      */
-    void handleError(const std::string& errorMessage);
+    std::unique_ptr<EngineImpl> impl_;
 
     // --- Prevent copying/moving ---
     Engine(const Engine&) = delete;
@@ -0,0 +1,669 @@
+/**
+ * @file ifa_runtime_engine_impl.h
+ * @brief Defines EngineImpl, the implementation behind the public Engine interface.
+ * @details Internal to libifa_runtime: this is the only engine header that includes Asio, so the
+ *          generated automata never compile Asio. Engine forwards every call to EngineImpl.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_ENGINE_IMPL_H
+#define IFA_RUNTIME_ENGINE_IMPL_H
+
+#include "ifa_runtime_engine.h"
+#include "ifa_runtime_executor.h"
+#include "ifa_runtime_scheduler.h"
+#include "ifa_runtime_clock.h"
+#include "ifa_runtime_journal.h"
+#include "ifa_runtime_flight_recorder.h"
+#include <asio.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <map>
+
+namespace ifa_runtime {
+
+// Forward declarations for internal implementation classes
+class UdpCommunicator;
+class TimerManager;
+class SchedulerImpl;
+
+/**
+ * @brief Implementation of the runtime engine.
+ * @details Manages the Asio event loop, UDP communication, timer scheduling,
+ *          and interaction with the generated automaton code via callbacks.
+ *          The public methods mirror those of Engine (see ifa_runtime_engine.h for their documentation).
+ */
+class EngineImpl {
+public:
+    /**
+     * @brief Constructs the implementation. Initializes Asio components.
+     * @param scheduler Scheduler whose worker threads run the engine (on a strand of its
+     *                  io_context), or nullptr for an engine with its own io_context.
+     */
+    explicit EngineImpl(Scheduler* scheduler);
+
+    /**
+     * @brief Destructor. Cleans up resources.
+     * @details On a scheduler, stops the engine if it still runs and waits until no handler
+     *          referring to it is queued on the shared io_context.
+     */
+    ~EngineImpl();
+
+    /**
+     * @brief Initializes the engine components (UDP, Timers).
+     * @param automatonName The name of the automaton instance.
+     * @param listen_port The local UDP port the engine should listen on.
+     * @param gui_host The hostname or IP address of the GUI/monitor.
+     * @param gui_port The UDP port the GUI/monitor is listening on.
+     * @return bool True if initialization is successful, false otherwise.
+     */
+    bool initialize(const std::string& automatonName,int listen_port, const std::string& gui_host, int gui_port);
+    
+    /**
+     * @brief Selects the clock of the engine. Must be called before initialize().
+     * @param mode The clock mode.
+     */
+    void setClockMode(ClockMode mode);
+
+    /**
+     * @brief Journals what the automaton receives and emits. Must be called before initialize().
+     * @param path The journal file.
+     * @return bool True if the file could be created.
+     */
+    bool setJournal(const std::string& path);
+
+    /**
+     * @brief Replays a journal instead of taking inputs from the GUI. Must be called before initialize().
+     * @param path The journal file.
+     * @param pace The pace of the replay.
+     * @return bool True if the journal could be read.
+     */
+    bool setReplay(const std::string& path, ReplayPace pace);
+
+    /**
+     * @brief Gets the result of the replay.
+     * @return bool True if the journal has been reproduced (or nothing was replayed).
+     */
+    bool replayMatched() const { return !replay_ || replay_->matched(); }
+
+    /**
+     * @brief Keeps the last events of the engine in a memory-mapped file. Must be called before initialize().
+     * @param path The file.
+     * @param capacity Number of records kept.
+     * @return bool True if the file could be created and mapped.
+     */
+    bool setFlightRecorder(const std::string& path, std::size_t capacity);
+
+    /**
+     * @brief Gets the current time of the engine's clock.
+     * @return Clock::TimePoint The current time.
+     */
+    Clock::TimePoint now() const { return clock_->now(); }
+
+    /**
+     * @brief Sets the callback functions provided by the generated automaton code.
+     * @param onEvent Handler for input events.
+     * @param onTimeout Handler for timer expirations.
+     * @param onTerminate Handler for termination requests.
+     * @param onError Handler for reporting errors.
+     * @param onStatusRequest Handler for status requests from the GUI.
+     */
+    void setEventHandlers(EventHandler onEvent, TimeoutHandler onTimeout, TerminationHandler onTerminate, ErrorHandler onError,StatusRequestHandler onStatusRequest);
+
+    /**
+     * @brief Sets the handlers of an automaton running several instances on this engine.
+     * @param onEvent Handler for input events.
+     * @param onTimeout Handler for timer expirations.
+     */
+    void setInstanceHandlers(InstanceEventHandler onEvent, InstanceTimeoutHandler onTimeout);
+
+    /**
+     * @brief Sets the handler of the "CHECKPOINT" command.
+     * @param onCheckpoint Handler writing the checkpoint.
+     */
+    void setCheckpointHandler(CheckpointHandler onCheckpoint);
+
+    /**
+     * @brief Selects the automaton instance subsequent messages and timers belong to.
+     * @param instanceId The instance id.
+     */
+    void setInstance(std::uint32_t instanceId);
+
+    /**
+     * @brief Starts the Asio io_context event loop.
+     * @details This function blocks until the io_context is stopped (e.g., via stop() or signal).
+     *          The automaton logic runs within this event loop. On a scheduler the handlers run
+     *          on the worker threads and the calling thread only waits for the engine to stop.
+     */
+    void run();
+
+    /**
+     * @brief Stops the Asio io_context event loop gracefully.
+     * @details Cancels pending operations (timers, signals) and stops the io_context.
+     *          Sends a TERMINATING message before stopping.
+     */
+    void stop();
+
+    /**
+     * @brief Returns the CPU time and handler count of the engine (the name is left empty).
+     * @return EngineUsage The usage; the CPU time is only measured on a scheduler.
+     */
+    EngineUsage usage() const;
+
+    /**
+     * @brief Returns the name passed to initialize().
+     * @return const std::string& The automaton name.
+     */
+    const std::string& automatonName() const { return automatonName_; }
+
+    /**
+     * @brief Posts a termination request to the event loop; thread-safe.
+     */
+    void requestStop();
+
+    /**
+     * @brief Selects the wire protocol used towards the GUI.
+     * @details Inbound datagrams are accepted in both protocols regardless of this setting.
+     * @param wireProtocol The protocol for outbound messages.
+     */
+    void setWireProtocol(protocol::WireProtocol wireProtocol);
+
+    /**
+     * @brief Gets the wire protocol used towards the GUI.
+     * @return protocol::WireProtocol The current protocol.
+     */
+    protocol::WireProtocol wireProtocol() const;
+
+    /**
+     * @brief Registers the names behind the numeric ids of one kind of symbol.
+     * @details The id of a symbol is its index in names. The tables are announced to the GUI
+     *          with READY and NAME in the binary protocol and used to translate ids back to
+     *          names in the text protocol.
+     * @param kind The kind of symbols.
+     * @param names The symbol names, indexed by id.
+     */
+    void setSymbols(protocol::SymbolKind kind, std::vector<std::string> names);
+
+    /**
+     * @brief Sends a "READY" message to the GUI, indicating the automaton is initialized.
+     * @details In the binary protocol the symbol dictionary follows the message.
+     */
+    void sendReady();
+
+    /**
+     * @brief Sends the automaton's name to the GUI ("NAME" message, reply to GET_STATUS).
+     * @details In the binary protocol the symbol dictionary follows the message.
+     */
+    void sendName();
+
+    /**
+     * @brief Sends the current state to the GUI by its symbol id.
+     * @param stateId Id of the currently active state (see setSymbols()).
+     */
+    void sendStateById(std::uint16_t stateId);
+
+    /**
+     * @brief Sends an output value update to the GUI by the output's symbol id.
+     * @param outputId Id of the output channel (see setSymbols()).
+     * @param value The string value sent to the output.
+     */
+    void sendOutputById(std::uint16_t outputId, std::string_view value);
+
+    /**
+     * @brief Sends a variable value update to the GUI by the variable's symbol id.
+     * @param varId Id of the variable (see setSymbols()).
+     * @param value The current string value of the variable.
+     */
+    void sendVarById(std::uint16_t varId, std::string_view value);
+
+    /**
+     * @brief Sends the current state name to the GUI.
+     * @details In the binary protocol the name is translated to its symbol id.
+     * @param stateName The name of the currently active state.
+     */
+    void sendStateUpdate(const std::string& stateName);
+
+    /**
+     * @brief Sends an output value update to the GUI.
+     * @details In the binary protocol the name is translated to its symbol id.
+     * @param outputName The name of the output channel.
+     * @param value The string value sent to the output.
+     */
+    void sendOutputUpdate(const std::string& outputName, const std::string& value);
+
+     /**
+     * @brief Sends an internal variable value update to the GUI.
+     * @details In the binary protocol the name is translated to its symbol id.
+     * @param varName The name of the variable.
+     * @param value The current string value of the variable.
+     */
+    void sendVarUpdate(const std::string& varName, const std::string& value);
+
+    /**
+     * @brief Sends a log message to the GUI.
+     * @param message The log message content.
+     */
+    void sendLog(const std::string& message);
+
+    /**
+     * @brief Sends an error message originating from the automaton logic to the GUI.
+     * @details Also calls the internal handleError method.
+     * @param message The error message content.
+     */
+    void sendError(const std::string& message);
+
+    /**
+     * @brief Sends a "TERMINATING" message to the GUI. Called before shutting down.
+     */
+    void sendTerminating();
+
+    /**
+     * @brief Sends a raw message string via the communicator.
+     * @details Useful for potentially custom or future message types not covered by specific methods.
+     *          In the binary protocol the message is carried verbatim in a Text record.
+     * @param message The complete message string to send.
+     */
+    void sendMessage(const std::string& message);
+
+    /**
+     * @brief Configures the UDP receive path. Must be called before initialize().
+     * @param maxDatagramSize Largest inbound datagram accepted; longer ones are counted and discarded.
+     * @param batchSize Maximum number of datagrams read per socket wakeup.
+     * @param socketReceiveBufferSize Requested SO_RCVBUF size in bytes, 0 keeps the system default.
+     */
+    void setReceiveOptions(std::size_t maxDatagramSize, std::size_t batchSize, int socketReceiveBufferSize);
+
+    /**
+     * @brief Enables or disables batching of outbound updates.
+     * @details When enabled, all messages produced while handling one event, timeout or
+     *          status request (or between beginBatch() and endBatch()) are coalesced into
+     *          as few datagrams as possible instead of one datagram per message.
+     * @param enabled True to enable batching.
+     */
+    void setBatchingEnabled(bool enabled);
+
+    /**
+     * @brief Opens a batch scope. Calls may be nested; the batch is flushed by the outermost endBatch().
+     * @details The engine opens a scope automatically around every callback it invokes; the generated
+     *          code only needs this for work done outside callbacks (e.g. entering the initial state).
+     */
+    void beginBatch();
+
+    /**
+     * @brief Closes a batch scope and flushes the accumulated messages when the outermost scope ends.
+     */
+    void endBatch();
+
+    /**
+     * @brief Schedules a timer for a delayed transition of the selected instance (see setInstance()).
+     * @param delayMs The delay in milliseconds. Must be positive.
+     * @param targetStateName The name of the state to transition to upon timeout.
+     * @return std::uint64_t Handle of the scheduled timer (usable with cancelTimer()), 0 if nothing was scheduled.
+     */
+    std::uint64_t scheduleTimer(long long delayMs, const std::string& targetStateName);
+
+    /**
+     * @brief Cancels a single scheduled timer.
+     * @param timerHandle Handle returned by scheduleTimer().
+     * @return bool True if the timer was pending and has been cancelled.
+     */
+    bool cancelTimer(std::uint64_t timerHandle);
+
+    /**
+     * @brief Gets the time left until a scheduled timer expires.
+     * @param timerHandle Handle returned by scheduleTimer().
+     * @return long long Milliseconds left, -1 if the timer is no longer pending.
+     */
+    long long timerRemaining(std::uint64_t timerHandle) const;
+
+    /**
+     * @brief Cancels all currently scheduled timers.
+     */
+    void cancelAllTimers();
+
+private:
+    /**
+     * @brief Counts the handlers queued for this engine and their CPU time.
+     * @details Declared first: the handlers still queued in io_context_ release it when they are destroyed.
+     */
+    HandlerTracker tracker_;
+    /**
+     * @brief The core Asio I/O execution context of a standalone engine (nullptr on a scheduler).
+     */
+    std::unique_ptr<asio::io_context> io_context_;
+    /**
+     * @brief The scheduler the engine is attached to, or nullptr.
+     */
+    SchedulerImpl* scheduler_ = nullptr;
+    /**
+     * @brief Executor of all handlers: io_context_, or a strand of the scheduler's io_context.
+     */
+    EngineExecutor executor_;
+    /**
+     * @brief The clock of the timers and of now(); declared before the TimerManager referring to it.
+     */
+    std::unique_ptr<Clock> clock_;
+    /**
+     * @brief Unique pointer to the UDP communicator instance. Hides Asio details.
+     */
+    std::unique_ptr<UdpCommunicator> communicator_;
+
+    /**
+     * @brief Unique pointer to the Timer manager instance. Hides Asio details.
+     */
+    std::unique_ptr<TimerManager> timerManager_;
+
+    /**
+     * @brief The name of the automaton instance this engine is running.
+     */
+    std::string automatonName_;
+
+    /** @brief Callback for input events. */
+    EventHandler onEvent_;
+    /** @brief Callback for timer timeouts. */
+    TimeoutHandler onTimeout_;
+    /** @brief Callback for termination command/signal. */
+    TerminationHandler onTerminate_;
+    /** @brief Callback for errors. */
+    ErrorHandler onError_;
+    /** @brief Callback for status requests. */
+    StatusRequestHandler onStatusRequest_;
+    /** @brief Callback for input events of several instances; replaces onEvent_ when set. */
+    InstanceEventHandler onInstanceEvent_;
+    /** @brief Callback for timeouts of several instances; replaces onTimeout_ when set. */
+    InstanceTimeoutHandler onInstanceTimeout_;
+    /** @brief Callback for checkpoint requests. */
+    CheckpointHandler onCheckpoint_;
+
+    /** @brief The instance selected by setInstance(). */
+    std::uint32_t instance_ = 0;
+    /** @brief The instance the records appended to the current batch belong to. */
+    std::uint32_t batchInstance_ = 0;
+
+    // --- Journal and replay ---
+    /** @brief Writer of the journal, nullptr unless setJournal() succeeded. */
+    std::unique_ptr<JournalWriter> journal_;
+    /** @brief The replayed journal, nullptr unless setReplay() succeeded. */
+    std::unique_ptr<JournalReplay> replay_;
+    /** @brief Time 0 of the journal and of the replayed records (tick 0 of the timers). */
+    Clock::TimePoint journalStart_;
+    /** @brief Waits for the recorded time of the next replayed record (real time only). */
+    std::unique_ptr<asio::steady_timer> replayTimer_;
+    /** @brief True while feedReplay() is posted or replayTimer_ is armed. */
+    bool replayFeedScheduled_ = false;
+    /** @brief True while a replayed record is delivered, so it is not ignored as coming from the GUI. */
+    bool replayFeeding_ = false;
+    /** @brief Timer expiries whose step has been posted but has not run yet. */
+    std::size_t pendingTimeoutSteps_ = 0;
+    /** @brief True once the result of the replay has been logged. */
+    bool replayReported_ = false;
+    /** @brief Ring buffer of the last events, nullptr unless setFlightRecorder() succeeded. */
+    std::unique_ptr<FlightRecorder> flightRecorder_;
+
+    /**
+     * @brief Asio signal set to handle termination signals (SIGINT, SIGTERM) gracefully.
+     */
+    std::unique_ptr<asio::signal_set> signals_;
+
+    // --- Running on a scheduler ---
+    /** @brief Guards stopped_, handlersArmed_ and deferredHandlers_. */
+    std::mutex runMutex_;
+    /** @brief Signals changes of stopped_. */
+    std::condition_variable runChanged_;
+    /** @brief Set by stop(); run() returns once it is set and no handler is queued. */
+    bool stopped_ = false;
+    /** @brief Set by armHandlers(); handlers are posted directly from then on. */
+    bool handlersArmed_ = false;
+    /** @brief Handlers posted before run(), posted by armHandlers(). */
+    std::vector<std::function<void()>> deferredHandlers_;
+    /** @brief True while run() has not returned. */
+    std::atomic<bool> running_{false};
+
+    /**
+     * @brief Maximum size of one batch datagram, chosen to fit a typical Ethernet MTU.
+     */
+    static constexpr std::size_t kMaxBatchDatagramSize = 1400;
+
+    /** @brief Maximum inbound datagram size passed to the communicator (see setReceiveOptions()). */
+    std::size_t receiveMaxDatagramSize_ = 2048;
+    /** @brief Number of datagrams read per socket wakeup. */
+    std::size_t receiveBatchSize_ = 32;
+    /** @brief Requested SO_RCVBUF size, 0 for the system default. */
+    int receiveSocketBufferSize_ = 0;
+
+    /** @brief Protocol used for outbound messages. */
+    protocol::WireProtocol wireProtocol_ = protocol::WireProtocol::Text;
+    /** @brief Symbol names indexed by id, one table per SymbolKind. */
+    std::array<std::vector<std::string>, protocol::kSymbolKindCount> symbolNames_;
+    /** @brief Reverse lookup from symbol name to id, one table per SymbolKind. */
+    std::array<std::map<std::string, std::uint16_t, std::less<>>, protocol::kSymbolKindCount> symbolIds_;
+    /** @brief Scratch buffer for encoding one binary record, reused between messages. */
+    std::string recordBuffer_;
+    /** @brief Scratch buffer for a binary datagram sent outside a batch. */
+    std::string datagramBuffer_;
+
+    /** @brief True if outbound messages are batched (see setBatchingEnabled()). */
+    bool batchingEnabled_ = false;
+    /** @brief Nesting depth of open batch scopes. */
+    int batchDepth_ = 0;
+    /** @brief Number of messages currently held in batchBuffer_. */
+    std::size_t batchCount_ = 0;
+    /**
+     * @brief The batch datagram being assembled.
+     * @details Format: "BATCH\n" followed by records "<length>:<message>", where length is the
+     *          decimal byte length of the message, so messages may contain any characters.
+     *          In the binary protocol the batch is simply a binary datagram holding several records.
+     */
+    std::string batchBuffer_;
+
+    /**
+     * @brief Sends a formatted message, either directly or by appending it to the current batch.
+     * @details In the binary protocol the message is wrapped into a Text record.
+     * @param message The complete message string.
+     */
+    void dispatchMessage(const std::string& message);
+
+    /**
+     * @brief Sends an encoded binary record, either in its own datagram or as part of the current batch.
+     * @param record The encoded record (without datagram header).
+     */
+    void dispatchRecord(const std::string& record);
+
+    /**
+     * @brief Sends the symbol dictionary as Symbol records (binary protocol only).
+     */
+    void sendSymbolTable();
+
+    /**
+     * @brief Looks up the id of a symbol by name.
+     * @param kind The kind of the symbol.
+     * @param name The name of the symbol.
+     * @param id Receives the id if found.
+     * @return bool True if the symbol is known.
+     */
+    bool lookupSymbol(protocol::SymbolKind kind, std::string_view name, std::uint16_t& id) const;
+
+    /**
+     * @brief Looks up the name of a symbol by id.
+     * @param kind The kind of the symbol.
+     * @param id The id of the symbol.
+     * @return std::string_view The name, or an empty view for unknown ids.
+     */
+    std::string_view symbolName(protocol::SymbolKind kind, std::uint16_t id) const;
+
+    /**
+     * @brief Sends the current batch (if any) as one datagram and resets the buffer.
+     */
+    void flushBatch();
+
+    /**
+     * @brief Runs one run-to-completion step of the automaton inside a batch scope.
+     * @param step The callback invocation to run.
+     */
+    template <typename Step>
+    void runStep(Step&& step) {
+        beginBatch();
+        step();
+        endBatch();
+    }
+
+    /**
+     * @brief Runs one step of an automaton instance with the instance selected (see setInstance()).
+     * @param instanceId The instance.
+     * @param step The callback invocation to run.
+     */
+    template <typename Step>
+    void runInstanceStep(std::uint32_t instanceId, Step&& step) {
+        beginBatch();
+        setInstance(instanceId);
+        step();
+        setInstance(0);
+        endBatch();
+    }
+
+    /**
+     * @brief Sends one message of the selected instance outside a batch.
+     * @details An instance other than 0 needs its INSTANCE message in the same datagram, so the
+     *          message is framed as a batch of two.
+     * @param message The complete message string.
+     */
+    void sendUnbatchedMessage(const std::string& message);
+
+    /**
+     * @brief Internal handler for incoming UDP messages.
+     * @details Parses the message type and delegates to appropriate handlers (onEvent_, handleTerminationCommand, handleGetStatus).
+     * @param type Message type ("INPUT", "CMD", etc.).
+     * @param name Message name (input name, command name).
+     * @param value Message value.
+     */
+    void handleIncomingUdp(std::string_view type, std::string_view name, std::string_view value);
+
+    /**
+     * @brief Delivers an input event to an instance (onInstanceEvent_, or onEvent_ for instance 0).
+     * @param instanceId The addressed instance.
+     * @param name The input name.
+     * @param value The input value.
+     */
+    void handleInput(std::uint32_t instanceId, std::string_view name, std::string_view value);
+
+    /**
+     * @brief Internal handler for incoming binary protocol datagrams.
+     * @details Translates Input and Command records into the same calls handleIncomingUdp() makes
+     *          for the text protocol; Instance records address the Input records following them.
+     * @param data Pointer to the datagram.
+     * @param length Length of the datagram in bytes.
+     */
+    void handleIncomingBinary(const char* data, std::size_t length);
+
+    /**
+     * @brief Handles the "TERMINATE" command received via UDP. Invokes onTerminate_ callback.
+     */
+    void handleTerminationCommand();
+
+    /**
+     * @brief Handles the "GET_STATUS" command received via UDP. Invokes onStatusRequest_ callback.
+     */
+    void handleGetStatus();
+
+    /**
+     * @brief Handles the "CHECKPOINT" command received via UDP. Invokes onCheckpoint_ callback.
+     */
+    void handleCheckpoint();
+
+    /**
+     * @brief Handles a timeout event triggered by the TimerManager. Invokes onTimeout_ callback.
+     * @param instanceId The instance that scheduled the timer.
+     * @param targetStateName The target state associated with the expired timer.
+     */
+    void handleTimeout(std::uint32_t instanceId, const std::string& targetStateName);
+
+    /**
+     * @brief Runs the io_context in virtual time (see ClockMode::Virtual).
+     * @details Runs the ready handlers; when none is left, fires the next timers on the advanced
+     *          clock, or blocks for the next handler if no timer is pending.
+     */
+    void runVirtualTime();
+
+    /**
+     * @brief Gets the time of a journal or flight record made now.
+     * @return std::uint64_t Microseconds since journalStart_.
+     */
+    std::uint64_t journalTime() const;
+
+    /**
+     * @brief Journals, checks and flight-records a STATE or OUTPUT of the selected instance.
+     * @param type JournalRecordType::State or JournalRecordType::Output.
+     * @param name The state or output name.
+     * @param value The output value.
+     */
+    void journalEmitted(JournalRecordType type, std::string_view name, std::string_view value = {});
+
+    /**
+     * @brief Journals, checks and flight-records a timer expiry right before its step runs.
+     * @param instanceId The instance of the timer.
+     * @param targetStateName The target state of the timer.
+     */
+    void journalTimeout(std::uint32_t instanceId, const std::string& targetStateName);
+
+    /**
+     * @brief Posts feedReplay(), unless it is already posted or waiting.
+     */
+    void scheduleReplayFeed();
+
+    /**
+     * @brief Feeds the next inbound record of the replay back.
+     * @details An INPUT or CMD is delivered at its recorded time, and the next one is posted behind
+     *          the handlers the delivery queued. A recorded timer expiry is waited for: the step of
+     *          the timer continues the replay. At the end of the journal the engine terminates.
+     */
+    void feedReplay();
+
+    /**
+     * @brief Starts waiting for SIGINT/SIGTERM; the handler terminates the automaton.
+     */
+    void waitForSignals();
+
+    /**
+     * @brief Starts receiving, the timer wakeups, the sending and the signal wait (scheduler only).
+     * @details Posted to the strand by run(). Until then initialize() keeps all of them held, so
+     *          no handler of the engine can run on a worker thread concurrently with the code the
+     *          automaton executes on its own thread between initialize() and run(), and no worker
+     *          thread is occupied while the automaton starts up.
+     */
+    void armHandlers();
+
+    /**
+     * @brief Posts a handler to the engine's executor.
+     * @details On a scheduler, handlers posted before run() are kept and posted by armHandlers().
+     * @param handler The handler.
+     */
+    void postHandler(std::function<void()> handler);
+
+    /**
+     * @brief Checks whether stop() has been called.
+     * @return bool True if the engine has stopped.
+     */
+    bool isStopped();
+
+    /**
+     * @brief Internal error handling routine. Logs the error and calls the onError_ callback.
+     * @param errorMessage The description of the error.
+     */
+    void handleError(const std::string& errorMessage);
+
+    // --- Prevent copying/moving ---
+    EngineImpl(const EngineImpl&) = delete;
+    EngineImpl& operator=(const EngineImpl&) = delete;
+};
+
+} // namespace ifa_runtime
+#endif // IFA_RUNTIME_ENGINE_IMPL_H
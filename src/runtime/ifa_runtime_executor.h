@@ -0,0 +1,177 @@
+/**
+ * @file ifa_runtime_executor.h
+ * @brief Defines the executor and handler bookkeeping shared by the engine, the UDP communicator and the timers.
+ * @details Internal to libifa_runtime. A standalone engine runs its handlers on its own io_context;
+ *          an engine attached to a Scheduler runs them on a strand of the scheduler's shared
+ *          io_context. Every handler an engine hands to Asio is wrapped by HandlerTracker::track(),
+ *          which counts the handlers still pending (so an engine on a shared pool knows when no
+ *          handler refers to it any more) and, on a shared pool, the CPU time spent in them.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_EXECUTOR_H
+#define IFA_RUNTIME_EXECUTOR_H
+
+#include <asio.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <time.h>
+
+namespace ifa_runtime {
+
+/**
+ * @brief Executor the handlers of one engine run on (its io_context, or its strand on a Scheduler).
+ */
+using EngineExecutor = asio::any_io_executor;
+
+/**
+ * @brief Counts the pending handlers of one engine and the CPU time they used.
+ * @details acquire()/release() are called by TrackedHandler; the counters may be read from any thread.
+ */
+class HandlerTracker {
+public:
+    /**
+     * @brief Enables measuring the CPU time of every handler (one clock_gettime per call and end).
+     * @param enabled True to measure.
+     */
+    void setAccounting(bool enabled) { accounting_ = enabled; }
+
+    /**
+     * @brief Checks whether the CPU time of handlers is measured.
+     * @return bool True if it is.
+     */
+    bool accounting() const { return accounting_; }
+
+    /**
+     * @brief Registers a new pending handler.
+     */
+    void acquire() { pending_.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Unregisters a pending handler (after it ran or was discarded).
+     */
+    void release() {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+            idle_.notify_all();
+        }
+    }
+
+    /**
+     * @brief Blocks until no handler is pending.
+     */
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(idleMutex_);
+        idle_.wait(lock, [this]() { return pending_.load(std::memory_order_acquire) == 0; });
+    }
+
+    /**
+     * @brief Adds one handler execution to the statistics.
+     * @param cpuNanoseconds CPU time the handler used.
+     */
+    void addExecution(std::uint64_t cpuNanoseconds) {
+        cpuNanoseconds_.fetch_add(cpuNanoseconds, std::memory_order_relaxed);
+        executions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the CPU time spent in handlers (0 unless accounting is enabled).
+     * @return std::uint64_t Nanoseconds.
+     */
+    std::uint64_t cpuNanoseconds() const { return cpuNanoseconds_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of measured handler executions.
+     * @return std::uint64_t The number of executions.
+     */
+    std::uint64_t executions() const { return executions_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the CPU time used so far by the calling thread.
+     * @return std::uint64_t Nanoseconds.
+     */
+    static std::uint64_t threadCpuNanoseconds() {
+        timespec now{};
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return static_cast<std::uint64_t>(now.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(now.tv_nsec);
+    }
+
+    /**
+     * @brief Wraps a completion handler so it is counted while pending and measured when it runs.
+     * @param handler The handler.
+     * @return The wrapped handler (move-only).
+     */
+    template <typename Handler>
+    auto track(Handler&& handler);
+
+private:
+    /** @brief Handlers created and not yet destroyed. */
+    std::atomic<std::size_t> pending_{0};
+    /** @brief CPU time of the measured executions. */
+    std::atomic<std::uint64_t> cpuNanoseconds_{0};
+    /** @brief Number of measured executions. */
+    std::atomic<std::uint64_t> executions_{0};
+    /** @brief True to measure executions; set before the first handler is created. */
+    bool accounting_ = false;
+    /** @brief Guards idle_. */
+    std::mutex idleMutex_;
+    /** @brief Signalled when pending_ drops to zero. */
+    std::condition_variable idle_;
+};
+
+/**
+ * @brief A completion handler registered with a HandlerTracker for as long as it exists.
+ * @tparam Handler Type of the wrapped handler.
+ */
+template <typename Handler>
+class TrackedHandler {
+public:
+    TrackedHandler(HandlerTracker& tracker, Handler handler) : tracker_(&tracker), handler_(std::move(handler)) {
+        tracker_->acquire();
+    }
+
+    TrackedHandler(TrackedHandler&& other) noexcept : tracker_(other.tracker_), handler_(std::move(other.handler_)) {
+        other.tracker_ = nullptr;
+    }
+
+    TrackedHandler(const TrackedHandler&) = delete;
+    TrackedHandler& operator=(const TrackedHandler&) = delete;
+    TrackedHandler& operator=(TrackedHandler&&) = delete;
+
+    ~TrackedHandler() {
+        if (tracker_) {
+            tracker_->release();
+        }
+    }
+
+    template <typename... Args>
+    void operator()(Args&&... args) {
+        if (!tracker_->accounting()) {
+            handler_(std::forward<Args>(args)...);
+            return;
+        }
+        std::uint64_t start = HandlerTracker::threadCpuNanoseconds();
+        handler_(std::forward<Args>(args)...);
+        tracker_->addExecution(HandlerTracker::threadCpuNanoseconds() - start);
+    }
+
+private:
+    /** @brief The tracker, nullptr once moved from. */
+    HandlerTracker* tracker_;
+    /** @brief The wrapped handler. */
+    Handler handler_;
+};
+
+template <typename Handler>
+auto HandlerTracker::track(Handler&& handler) {
+    return TrackedHandler<std::decay_t<Handler>>(*this, std::forward<Handler>(handler));
+}
+
+} // namespace ifa_runtime
+
+#endif // IFA_RUNTIME_EXECUTOR_H
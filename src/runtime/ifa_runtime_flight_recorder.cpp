@@ -0,0 +1,194 @@
+/**
+ * @file ifa_runtime_flight_recorder.cpp
+ * @brief Implements the memory-mapped flight recorder of an engine.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_runtime_flight_recorder.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define IFA_FLIGHT_RECORDER_MMAP 1
+#endif
+
+namespace ifa_runtime {
+
+namespace {
+
+// First bytes of a flight recorder file.
+constexpr char kFlightRecorderMagic[8] = { 'I', 'F', 'A', 'F', 'L', 'R', 'E', 'C' };
+
+// Bounds of the number of records kept.
+constexpr std::size_t kMinCapacity = 64;
+constexpr std::size_t kMaxCapacity = std::size_t(1) << 24;
+
+} // namespace
+
+// --- FlightRecorder ---
+
+FlightRecorder::~FlightRecorder() {
+#ifdef IFA_FLIGHT_RECORDER_MMAP
+    if (header_) {
+        // The pages stay in the file; no msync(), the kernel writes them back on its own.
+        munmap(header_, mappedSize_);
+    }
+#endif
+}
+
+bool FlightRecorder::open(const std::string& path, std::size_t capacity, std::string& error) {
+#ifdef IFA_FLIGHT_RECORDER_MMAP
+    std::size_t slots = kMinCapacity;
+    while (slots < std::min(capacity, kMaxCapacity)) {
+        slots <<= 1;
+    }
+    std::size_t size = sizeof(FlightRecorderHeader) + slots * sizeof(FlightRecord);
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        error = "Cannot create '" + path + "': " + std::strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        error = "Cannot size '" + path + "': " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping keeps the file
+    if (mapping == MAP_FAILED) {
+        error = "Cannot map '" + path + "': " + std::strerror(errno);
+        return false;
+    }
+
+    // The file is zero-filled by ftruncate(): every slot starts empty (sequence 0).
+    header_ = static_cast<FlightRecorderHeader*>(mapping);
+    records_ = reinterpret_cast<FlightRecord*>(static_cast<char*>(mapping) + sizeof(FlightRecorderHeader));
+    mappedSize_ = size;
+    mask_ = slots - 1;
+    std::memcpy(header_->magic, kFlightRecorderMagic, sizeof(kFlightRecorderMagic));
+    header_->version = kFlightRecorderVersion;
+    header_->recordSize = sizeof(FlightRecord);
+    header_->capacity = slots;
+    header_->pid = static_cast<std::uint32_t>(getpid());
+    return true;
+#else
+    (void)capacity;
+    error = "The flight recorder needs mmap(), which this platform does not have ('" + path + "' not created)";
+    return false;
+#endif
+}
+
+void FlightRecorder::setStartTime(std::int64_t unixUs) {
+    if (header_) {
+        header_->startUnixUs = unixUs;
+    }
+}
+
+void FlightRecorder::record(FlightEventType type, std::uint64_t timeUs, std::uint32_t instance,
+                            std::string_view name, std::string_view value, std::uint64_t aux) {
+    if (!records_) {
+        return;
+    }
+    FlightRecord& slot = records_[next_ & mask_];
+    // Invalidate the slot first and publish it last, so a record the end of the process cuts
+    // off never passes for a complete one (the fences only keep the compiler from reordering
+    // the stores; the kernel keeps whatever reached the mapping).
+    slot.sequence = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::size_t nameLength = std::min(name.size(), sizeof(slot.text));
+    std::size_t valueLength = std::min(value.size(), sizeof(slot.text) - nameLength);
+    std::memcpy(slot.text, name.data(), nameLength);
+    std::memcpy(slot.text + nameLength, value.data(), valueLength);
+    slot.timeUs = timeUs;
+    slot.aux = aux;
+    slot.instance = instance;
+    slot.type = static_cast<std::uint8_t>(type);
+    slot.nameLength = static_cast<std::uint8_t>(nameLength);
+    slot.valueLength = static_cast<std::uint8_t>(valueLength);
+    slot.flags = (nameLength < name.size() || valueLength < value.size()) ? kFlightRecordTruncated : 0;
+
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.sequence = ++next_;
+    header_->written = next_;
+}
+
+// --- Reading ---
+
+bool readFlightRecorder(const std::string& path, FlightRecorderDump& dump, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "Cannot open '" + path + "'";
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(FlightRecorderHeader)) {
+        error = "'" + path + "' is not a flight recorder file";
+        return false;
+    }
+    std::memcpy(&dump.header, data.data(), sizeof(FlightRecorderHeader));
+    const FlightRecorderHeader& header = dump.header;
+    if (std::memcmp(header.magic, kFlightRecorderMagic, sizeof(kFlightRecorderMagic)) != 0) {
+        error = "'" + path + "' is not a flight recorder file";
+        return false;
+    }
+    if (header.version != kFlightRecorderVersion || header.recordSize != sizeof(FlightRecord)) {
+        error = "'" + path + "' was written by an unsupported version (" + std::to_string(header.version) + ")";
+        return false;
+    }
+    if (header.capacity == 0 || header.capacity > kMaxCapacity ||
+        data.size() < sizeof(FlightRecorderHeader) + header.capacity * sizeof(FlightRecord)) {
+        error = "'" + path + "' is truncated";
+        return false;
+    }
+
+    dump.records.clear();
+    dump.torn = 0;
+    const char* ring = data.data() + sizeof(FlightRecorderHeader);
+    for (std::uint64_t index = 0; index < header.capacity; ++index) {
+        FlightRecord record;
+        std::memcpy(&record, ring + index * sizeof(FlightRecord), sizeof(FlightRecord));
+        if (record.sequence == 0) {
+            if (record.type != 0) {
+                ++dump.torn; // Overwriting this slot was cut off
+            }
+            continue;
+        }
+        if (((record.sequence - 1) % header.capacity) != index ||
+            record.nameLength + record.valueLength > sizeof(record.text)) {
+            ++dump.torn;
+            continue;
+        }
+        dump.records.push_back(record);
+    }
+    std::sort(dump.records.begin(), dump.records.end(),
+              [](const FlightRecord& a, const FlightRecord& b) { return a.sequence < b.sequence; });
+    return true;
+}
+
+const char* flightEventName(std::uint8_t type) {
+    switch (static_cast<FlightEventType>(type)) {
+        case FlightEventType::Start: return "START";
+        case FlightEventType::Input: return "INPUT";
+        case FlightEventType::Command: return "CMD";
+        case FlightEventType::State: return "STATE";
+        case FlightEventType::Output: return "OUTPUT";
+        case FlightEventType::TimerScheduled: return "TIMER_SET";
+        case FlightEventType::TimerCancelled: return "TIMER_CANCEL";
+        case FlightEventType::TimerFired: return "TIMER_FIRED";
+        case FlightEventType::Error: return "ERROR";
+        case FlightEventType::Stop: return "STOP";
+    }
+    return "?";
+}
+
+} // namespace ifa_runtime
@@ -0,0 +1,191 @@
+/**
+ * @file ifa_runtime_flight_recorder.h
+ * @brief Defines the flight recorder: a memory-mapped ring buffer of the last events of an engine.
+ * @details With a flight recorder (Engine::setFlightRecorder()) the engine writes a fixed-size
+ *          record for every input, command, state entered, output, timer scheduled, cancelled or
+ *          fired and error into a file mapped into memory. Writing a record is a copy into the
+ *          mapping, no system call; the kernel keeps the pages of a killed or crashed process, so
+ *          the file holds the last events up to the very end. ifa_flightrec decodes the file.
+ *
+ *          File layout: a FlightRecorderHeader followed by the ring of FlightRecord slots. The
+ *          sequence number of a record is written last, so a record cut off by the end of the
+ *          process is recognized (and skipped) by the reader.
+ *          Needs POSIX mmap(); on other platforms open() fails.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_FLIGHT_RECORDER_H
+#define IFA_RUNTIME_FLIGHT_RECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ifa_runtime {
+
+/**
+ * @brief Type of a flight record.
+ */
+enum class FlightEventType : std::uint8_t {
+    /** @brief The engine was initialized (name: automaton). */
+    Start = 1,
+    /** @brief INPUT handled by an instance (name, value). */
+    Input = 2,
+    /** @brief CMD handled by the engine (name: TERMINATE, GET_STATUS or CHECKPOINT). */
+    Command = 3,
+    /** @brief State entered by an instance (name: state). */
+    State = 4,
+    /** @brief OUTPUT sent by an instance (name, value). */
+    Output = 5,
+    /** @brief Timer scheduled by an instance (name: target state, value: delay in ms, aux: handle). */
+    TimerScheduled = 6,
+    /** @brief Timer cancelled by an instance (aux: handle). */
+    TimerCancelled = 7,
+    /** @brief Timer expiry handled by an instance (name: target state). */
+    TimerFired = 8,
+    /** @brief Error reported by the engine (name: the beginning of the message). */
+    Error = 9,
+    /** @brief The engine stopped. */
+    Stop = 10
+};
+
+/**
+ * @brief Header at the start of a flight recorder file.
+ */
+struct FlightRecorderHeader {
+    /** @brief "IFAFLREC". */
+    char magic[8];
+    /** @brief Format version (kFlightRecorderVersion). */
+    std::uint32_t version;
+    /** @brief sizeof(FlightRecord). */
+    std::uint32_t recordSize;
+    /** @brief Number of record slots in the ring (a power of two). */
+    std::uint64_t capacity;
+    /** @brief Records written so far; record n is in slot n % capacity. */
+    std::uint64_t written;
+    /** @brief Wall-clock time of time 0 of the records, in microseconds since the Unix epoch. */
+    std::int64_t startUnixUs;
+    /** @brief Process id of the writer. */
+    std::uint32_t pid;
+    /** @brief Unused, zero. */
+    std::uint32_t reserved[21];
+};
+
+/**
+ * @brief One slot of the ring; one cache line.
+ */
+struct FlightRecord {
+    /** @brief Record number + 1, written last; 0 while the slot is empty or being written. */
+    std::uint64_t sequence;
+    /** @brief Microseconds since time 0 on the engine's clock. */
+    std::uint64_t timeUs;
+    /** @brief Timer handle of TimerScheduled and TimerCancelled records. */
+    std::uint64_t aux;
+    /** @brief The automaton instance. */
+    std::uint32_t instance;
+    /** @brief The FlightEventType. */
+    std::uint8_t type;
+    /** @brief Bytes of the name in text. */
+    std::uint8_t nameLength;
+    /** @brief Bytes of the value in text, following the name. */
+    std::uint8_t valueLength;
+    /** @brief kFlightRecordTruncated if the name or value did not fit. */
+    std::uint8_t flags;
+    /** @brief The name followed by the value, not terminated. */
+    char text[32];
+};
+
+static_assert(sizeof(FlightRecorderHeader) == 128, "FlightRecorderHeader is part of the file format");
+static_assert(sizeof(FlightRecord) == 64, "FlightRecord is part of the file format");
+
+/** @brief Version of the file format. */
+constexpr std::uint32_t kFlightRecorderVersion = 1;
+/** @brief FlightRecord::flags bit: the name or value has been cut to fit the record. */
+constexpr std::uint8_t kFlightRecordTruncated = 0x01;
+
+/**
+ * @brief Writes flight records into a memory-mapped file.
+ */
+class FlightRecorder {
+public:
+    FlightRecorder() = default;
+    ~FlightRecorder();
+
+    /**
+     * @brief Creates (or truncates) the file and maps it.
+     * @param path The file path.
+     * @param capacity Number of records kept, rounded up to a power of two (at least 64).
+     * @param error Receives the reason on failure.
+     * @return bool True if the file is mapped.
+     */
+    bool open(const std::string& path, std::size_t capacity, std::string& error);
+
+    /**
+     * @brief Sets the wall-clock time of time 0 of the records.
+     * @param unixUs Microseconds since the Unix epoch.
+     */
+    void setStartTime(std::int64_t unixUs);
+
+    /**
+     * @brief Writes one record, overwriting the oldest one once the ring is full.
+     * @param type The type of the record.
+     * @param timeUs Microseconds since time 0.
+     * @param instance The automaton instance.
+     * @param name The name; cut to fit the record.
+     * @param value The value; cut to fit after the name.
+     * @param aux The timer handle.
+     */
+    void record(FlightEventType type, std::uint64_t timeUs, std::uint32_t instance,
+                std::string_view name, std::string_view value = {}, std::uint64_t aux = 0);
+
+private:
+    /** @brief The mapping, nullptr unless open() succeeded. */
+    FlightRecorderHeader* header_ = nullptr;
+    /** @brief The ring, right after the header. */
+    FlightRecord* records_ = nullptr;
+    /** @brief header_->capacity - 1. */
+    std::uint64_t mask_ = 0;
+    /** @brief Number of the next record (header_->written is only updated, never read back). */
+    std::uint64_t next_ = 0;
+    /** @brief Size of the mapping in bytes. */
+    std::size_t mappedSize_ = 0;
+
+    // --- Prevent copying ---
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+};
+
+/**
+ * @brief Contents of a flight recorder file, as read by readFlightRecorder().
+ */
+struct FlightRecorderDump {
+    /** @brief The header. */
+    FlightRecorderHeader header;
+    /** @brief The complete records, oldest first. */
+    std::vector<FlightRecord> records;
+    /** @brief Slots holding a record cut off by the end of the writer. */
+    std::size_t torn = 0;
+};
+
+/**
+ * @brief Reads a flight recorder file (also while it is being written).
+ * @param path The file path.
+ * @param dump Receives the contents.
+ * @param error Receives the reason on failure.
+ * @return bool True if the file is a flight recorder of this version.
+ */
+bool readFlightRecorder(const std::string& path, FlightRecorderDump& dump, std::string& error);
+
+/**
+ * @brief Gets the name of a record type, e.g. "TIMER_FIRED".
+ * @param type The FlightEventType value.
+ * @return const char* The name, "?" for an unknown type.
+ */
+const char* flightEventName(std::uint8_t type);
+
+} // namespace ifa_runtime
+
+#endif // IFA_RUNTIME_FLIGHT_RECORDER_H
@@ -0,0 +1,238 @@
+/**
+ * @file ifa_runtime_journal.cpp
+ * @brief Implements writing, reading and replaying the journal of an engine.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_runtime_journal.h"
+#include "ifa_runtime_log.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <utility>
+
+namespace ifa_runtime {
+
+namespace {
+
+// First bytes of a journal file: the magic and the format version.
+constexpr char kJournalMagic[] = { 'I', 'F', 'A', 'J', 1 };
+
+// Number of divergences logged one by one; the rest are only counted.
+constexpr std::size_t kMaxLoggedMismatches = 10;
+
+// Appends an unsigned LEB128 varint.
+void appendVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Reads an unsigned LEB128 varint; false if the data ends first.
+bool readVarint(const std::string& data, std::size_t& offset, std::uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; offset < data.size() && shift < 64; shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(data[offset++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reads a length-prefixed string; false if the data ends first.
+bool readString(const std::string& data, std::size_t& offset, std::string& text) {
+    std::uint64_t length = 0;
+    if (!readVarint(data, offset, length) || length > data.size() - offset) {
+        return false;
+    }
+    text.assign(data, offset, static_cast<std::size_t>(length));
+    offset += static_cast<std::size_t>(length);
+    return true;
+}
+
+// Name of a record type as used in the messages of the replay.
+const char* typeName(JournalRecordType type) {
+    switch (type) {
+        case JournalRecordType::Input: return "INPUT";
+        case JournalRecordType::Command: return "CMD";
+        case JournalRecordType::Timer: return "TIMER";
+        case JournalRecordType::State: return "STATE";
+        case JournalRecordType::Output: return "OUTPUT";
+    }
+    return "?";
+}
+
+// Describes a record, e.g. "OUTPUT led="1" (instance 0)".
+std::string describe(JournalRecordType type, std::uint32_t instance, std::string_view name, std::string_view value) {
+    std::ostringstream text;
+    text << typeName(type) << " " << name;
+    if (type == JournalRecordType::Input || type == JournalRecordType::Output) {
+        text << "=\"" << value << "\"";
+    }
+    text << " (instance " << instance << ")";
+    return text.str();
+}
+
+} // namespace
+
+// --- JournalWriter ---
+
+JournalWriter::~JournalWriter() {
+    if (file_) {
+        flush();
+        std::fclose(file_);
+    }
+}
+
+bool JournalWriter::open(const std::string& path) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+    buffer_.assign(kJournalMagic, sizeof(kJournalMagic));
+    flush();
+    return true;
+}
+
+void JournalWriter::append(JournalRecordType type, std::uint64_t timeUs, std::uint32_t instance,
+                           std::string_view name, std::string_view value) {
+    if (!file_) {
+        return;
+    }
+    timeUs = std::max(timeUs, lastTimeUs_);
+    buffer_.push_back(static_cast<char>(type));
+    appendVarint(buffer_, timeUs - lastTimeUs_);
+    appendVarint(buffer_, instance);
+    appendVarint(buffer_, name.size());
+    buffer_.append(name.data(), name.size());
+    appendVarint(buffer_, value.size());
+    buffer_.append(value.data(), value.size());
+    lastTimeUs_ = timeUs;
+}
+
+void JournalWriter::flush() {
+    if (!file_ || buffer_.empty()) {
+        return;
+    }
+    if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size() || std::fflush(file_) != 0) {
+        IFA_LOG_ERROR("[Journal] ERROR: Writing the journal failed, it is incomplete.");
+    }
+    buffer_.clear();
+}
+
+// --- Reading ---
+
+bool readJournal(const std::string& path, std::vector<JournalRecord>& records, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "Cannot open journal '" + path + "'";
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(kJournalMagic) || !std::equal(kJournalMagic, kJournalMagic + sizeof(kJournalMagic), data.begin())) {
+        error = "'" + path + "' is not a journal of this version";
+        return false;
+    }
+    std::size_t offset = sizeof(kJournalMagic);
+    std::uint64_t timeUs = 0;
+    while (offset < data.size()) {
+        JournalRecord record;
+        unsigned char type = static_cast<unsigned char>(data[offset++]);
+        if (type < static_cast<unsigned char>(JournalRecordType::Input) || type > static_cast<unsigned char>(JournalRecordType::Output)) {
+            error = "Unknown record type " + std::to_string(type) + " in journal '" + path + "'";
+            return false;
+        }
+        std::uint64_t delta = 0;
+        std::uint64_t instance = 0;
+        if (!readVarint(data, offset, delta) || !readVarint(data, offset, instance) ||
+            !readString(data, offset, record.name) || !readString(data, offset, record.value)) {
+            IFA_LOG_WARN("[Journal] WARNING: The last record of '" << path << "' is incomplete and ignored.");
+            break;
+        }
+        timeUs += delta;
+        record.type = static_cast<JournalRecordType>(type);
+        record.timeUs = timeUs;
+        record.instance = static_cast<std::uint32_t>(instance);
+        records.push_back(std::move(record));
+    }
+    return true;
+}
+
+// --- JournalReplay ---
+
+JournalReplay::JournalReplay(std::vector<JournalRecord> records) {
+    for (JournalRecord& record : records) {
+        if (record.type == JournalRecordType::State || record.type == JournalRecordType::Output) {
+            emitted_.push_back(std::move(record));
+        } else {
+            inbound_.push_back(std::move(record));
+        }
+    }
+}
+
+const JournalRecord* JournalReplay::nextInbound() {
+    return nextInbound_ < inbound_.size() ? &inbound_[nextInbound_] : nullptr;
+}
+
+void JournalReplay::consumeInbound() {
+    if (nextInbound_ < inbound_.size()) {
+        ++nextInbound_;
+    }
+}
+
+void JournalReplay::checkTimer(std::uint32_t instance, std::string_view target) {
+    const JournalRecord* expected = nextInbound();
+    if (!expected || expected->type != JournalRecordType::Timer) {
+        fail("Unexpected " + describe(JournalRecordType::Timer, instance, target, {}) + ", the journal has " +
+             (expected ? describe(expected->type, expected->instance, expected->name, expected->value) : "nothing more"));
+        return;
+    }
+    if (expected->instance != instance || expected->name != target) {
+        fail("Expected " + describe(expected->type, expected->instance, expected->name, expected->value) +
+             ", got " + describe(JournalRecordType::Timer, instance, target, {}));
+    }
+    consumeInbound();
+}
+
+void JournalReplay::checkEmitted(JournalRecordType type, std::uint32_t instance, std::string_view name, std::string_view value) {
+    if (nextEmitted_ >= emitted_.size()) {
+        fail("Unexpected " + describe(type, instance, name, value) + " after the end of the journal");
+        return;
+    }
+    const JournalRecord& expected = emitted_[nextEmitted_++];
+    if (expected.type != type || expected.instance != instance || expected.name != name ||
+        (type == JournalRecordType::Output && expected.value != value)) {
+        fail("Message " + std::to_string(nextEmitted_) + ": expected " +
+             describe(expected.type, expected.instance, expected.name, expected.value) +
+             ", got " + describe(type, instance, name, value));
+    }
+}
+
+void JournalReplay::fail(const std::string& message) {
+    if (++mismatches_ <= kMaxLoggedMismatches) {
+        IFA_LOG_ERROR("[Replay] MISMATCH: " << message);
+    }
+}
+
+bool JournalReplay::matched() const {
+    return mismatches_ == 0 && nextEmitted_ == emitted_.size() && nextInbound_ == inbound_.size();
+}
+
+void JournalReplay::report() const {
+    if (matched()) {
+        IFA_LOG_INFO("[Replay] OK: " << inbound_.size() << " inbound records replayed, all "
+                     << emitted_.size() << " STATE/OUTPUT messages match the journal.");
+        return;
+    }
+    IFA_LOG_ERROR("[Replay] FAILED: " << mismatches_ << " mismatch(es); " << nextInbound_ << " of "
+                  << inbound_.size() << " inbound records replayed, " << nextEmitted_ << " of "
+                  << emitted_.size() << " STATE/OUTPUT messages reproduced.");
+}
+
+} // namespace ifa_runtime
@@ -0,0 +1,191 @@
+/**
+ * @file ifa_runtime_journal.h
+ * @brief Defines the journal of an engine: what the automaton received and emitted, for replay.
+ * @details Internal to libifa_runtime. With a journal (Engine::setJournal()) the engine appends a
+ *          record for every inbound INPUT and CMD and every timer firing, at the point the
+ *          automaton handles it, and for every STATE and OUTPUT it sends. A replay
+ *          (Engine::setReplay()) feeds the inbound records back in their order and checks that
+ *          the automaton emits the recorded STATE/OUTPUT sequence.
+ *
+ *          File format: the magic "IFAJ" and a version byte, followed by the records. A record is
+ *          its type (one byte), the time since the previous record in microseconds, the instance
+ *          id, the name and the value; numbers are unsigned LEB128 varints and the strings are
+ *          prefixed with their length. The name is the input, command, timer target state, state
+ *          or output name; only Input and Output records have a value.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_JOURNAL_H
+#define IFA_RUNTIME_JOURNAL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ifa_runtime {
+
+/**
+ * @brief Type of a journal record.
+ */
+enum class JournalRecordType : std::uint8_t {
+    /** @brief INPUT delivered to an instance (name, value). */
+    Input = 1,
+    /** @brief CMD handled by the engine (name: TERMINATE or GET_STATUS). */
+    Command = 2,
+    /** @brief Timer expiry handled by an instance (name: target state). */
+    Timer = 3,
+    /** @brief STATE sent by an instance (name: state). */
+    State = 4,
+    /** @brief OUTPUT sent by an instance (name, value). */
+    Output = 5
+};
+
+/**
+ * @brief One record read from a journal.
+ */
+struct JournalRecord {
+    /** @brief The type of the record. */
+    JournalRecordType type = JournalRecordType::Input;
+    /** @brief Microseconds since the journal was started. */
+    std::uint64_t timeUs = 0;
+    /** @brief The automaton instance. */
+    std::uint32_t instance = 0;
+    /** @brief Input, command, target state, state or output name. */
+    std::string name;
+    /** @brief Value of an Input or Output record. */
+    std::string value;
+};
+
+/**
+ * @brief Appends records to a journal file.
+ * @details Records are collected in a buffer and written by flush(), which the engine calls at
+ *          the end of every step, so the file holds every completed step.
+ */
+class JournalWriter {
+public:
+    JournalWriter() = default;
+    ~JournalWriter();
+
+    /**
+     * @brief Creates (or truncates) the journal file and writes its header.
+     * @param path The file path.
+     * @return bool True if the file could be opened.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Appends one record to the buffer.
+     * @param type The type of the record.
+     * @param timeUs Microseconds since the journal was started; never decreases.
+     * @param instance The automaton instance.
+     * @param name The name of the record.
+     * @param value The value (Input and Output records).
+     */
+    void append(JournalRecordType type, std::uint64_t timeUs, std::uint32_t instance,
+                std::string_view name, std::string_view value = {});
+
+    /**
+     * @brief Writes the buffered records to the file.
+     */
+    void flush();
+
+private:
+    /** @brief The open file, nullptr if open() failed. */
+    std::FILE* file_ = nullptr;
+    /** @brief Encoded records not written yet. */
+    std::string buffer_;
+    /** @brief Time of the last record, the base of the next time delta. */
+    std::uint64_t lastTimeUs_ = 0;
+
+    // --- Prevent copying ---
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+};
+
+/**
+ * @brief Reads a whole journal file.
+ * @param path The file path.
+ * @param records Receives the records.
+ * @param error Receives the reason on failure.
+ * @return bool True if the file is a valid journal; a record cut off at the end (the process
+ *         died while writing it) is dropped without an error.
+ */
+bool readJournal(const std::string& path, std::vector<JournalRecord>& records, std::string& error);
+
+/**
+ * @brief Progress and result of a replay.
+ * @details The engine takes the inbound records (Input, Command, Timer) in order with
+ *          nextInbound() and compares everything the automaton emits against the recorded
+ *          State/Output records.
+ */
+class JournalReplay {
+public:
+    /**
+     * @brief Loads the records of a journal.
+     * @param records The records (see readJournal()).
+     */
+    explicit JournalReplay(std::vector<JournalRecord> records);
+
+    /**
+     * @brief Gets the next inbound record to feed back.
+     * @return const JournalRecord* The record, or nullptr when all of them have been fed.
+     */
+    const JournalRecord* nextInbound();
+
+    /**
+     * @brief Marks the record returned by nextInbound() as fed back.
+     */
+    void consumeInbound();
+
+    /**
+     * @brief Checks a timer expiry against the next inbound record, which has to be its Timer record.
+     * @param instance The instance of the timer.
+     * @param target The target state of the timer.
+     */
+    void checkTimer(std::uint32_t instance, std::string_view target);
+
+    /**
+     * @brief Checks a STATE or OUTPUT the automaton emitted against the next recorded one.
+     * @param type JournalRecordType::State or JournalRecordType::Output.
+     * @param instance The emitting instance.
+     * @param name The state or output name.
+     * @param value The output value.
+     */
+    void checkEmitted(JournalRecordType type, std::uint32_t instance, std::string_view name, std::string_view value = {});
+
+    /**
+     * @brief Reports a divergence found by the engine itself (e.g. a recorded timer that never fires).
+     * @param message The description.
+     */
+    void fail(const std::string& message);
+
+    /**
+     * @brief Checks whether the replay has matched the journal so far and all emissions were checked.
+     * @return bool True if every recorded STATE/OUTPUT and timer has been reproduced exactly.
+     */
+    bool matched() const;
+
+    /**
+     * @brief Logs the result of the replay.
+     */
+    void report() const;
+
+private:
+    /** @brief Inbound records (Input, Command, Timer) in recorded order. */
+    std::vector<JournalRecord> inbound_;
+    /** @brief Emitted records (State, Output) in recorded order. */
+    std::vector<JournalRecord> emitted_;
+    /** @brief Index of the next inbound record to feed. */
+    std::size_t nextInbound_ = 0;
+    /** @brief Index of the next emitted record to compare. */
+    std::size_t nextEmitted_ = 0;
+    /** @brief Number of divergences found. */
+    std::size_t mismatches_ = 0;
+};
+
+} // namespace ifa_runtime
+
+#endif // IFA_RUNTIME_JOURNAL_H
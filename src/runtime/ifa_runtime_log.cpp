@@ -0,0 +1,207 @@
+/**
+ * @file ifa_runtime_log.cpp
+ * @brief Implements the asynchronous logger of the IFA runtime engine.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_runtime_log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace ifa_runtime {
+
+namespace {
+
+// Upper bound for one sleep of the writer thread; covers a wakeup lost to a race.
+constexpr auto kIdleWait = std::chrono::milliseconds(100);
+
+} // namespace
+
+bool parseLogLevel(std::string_view name, LogLevel& level) {
+    static constexpr std::pair<std::string_view, LogLevel> kNames[] = {
+        {"trace", LogLevel::Trace}, {"debug", LogLevel::Debug}, {"info", LogLevel::Info},
+        {"warn", LogLevel::Warn},   {"error", LogLevel::Error}, {"off", LogLevel::Off}};
+    for (const auto& entry : kNames) {
+        if (entry.first == name) {
+            level = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+Logger& Logger::instance() {
+    // Deliberately leaked: the logger must outlive every static object that may log while
+    // being destroyed. The ring is drained by the atexit handler instead of a destructor.
+    static Logger* logger = [] {
+        Logger* created = new Logger();
+        std::atexit([] { Logger::instance().shutdown(); });
+        return created;
+    }();
+    return *logger;
+}
+
+Logger::Logger() : slots_(new Slot[kCapacity]) {
+    for (std::size_t i = 0; i < kCapacity; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    thread_ = std::thread([this] { run(); });
+}
+
+void Logger::setLevel(LogLevel level) {
+    level_.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel Logger::level() const {
+    return static_cast<LogLevel>(level_.load(std::memory_order_relaxed));
+}
+
+std::uint64_t Logger::droppedLines() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void Logger::write(LogLevel level, std::string_view text) {
+    if (stopped_.load(std::memory_order_acquire)) {
+        writeLine(level, text);
+        std::fflush(level >= LogLevel::Warn ? stderr : stdout);
+        return;
+    }
+
+    // Claim a slot (bounded multi-producer queue: a slot is free for position pos when its
+    // sequence equals pos, and holds data for the consumer when it equals pos + 1).
+    std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &slots_[pos & (kCapacity - 1)];
+        std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed); // Ring full, never block the caller
+            return;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t length = std::min(text.size(), kMaxLineLength);
+    std::memcpy(slot->text, text.data(), length);
+    slot->length = static_cast<std::uint16_t>(length);
+    slot->level = level;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    // Pairs with the store to sleeping_ in run(): either the writer sees the new slot or we see it sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        wakeup_.notify_one();
+    }
+}
+
+void Logger::flush() {
+    std::size_t target = enqueuePos_.load(std::memory_order_acquire);
+    while (!stopped_.load(std::memory_order_acquire) && dequeuePos_.load(std::memory_order_acquire) < target) {
+        wakeup_.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void Logger::shutdown() {
+    if (stopping_.exchange(true)) {
+        return;
+    }
+    wakeup_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    stopped_.store(true, std::memory_order_release);
+    // Lines queued while the writer thread was finishing
+    drain();
+}
+
+void Logger::run() {
+    for (;;) {
+        bool wrote = drain();
+        if (stopping_.load(std::memory_order_acquire)) {
+            drain();
+            return;
+        }
+        if (wrote) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const Slot& next = slots_[dequeuePos_.load(std::memory_order_relaxed) & (kCapacity - 1)];
+        bool pending = next.sequence.load(std::memory_order_acquire) == dequeuePos_.load(std::memory_order_relaxed) + 1;
+        if (!pending && !stopping_.load(std::memory_order_acquire)) {
+            wakeup_.wait_for(lock, kIdleWait);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool Logger::drain() {
+    bool wroteOut = false;
+    bool wroteErr = false;
+    std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots_[pos & (kCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            break;
+        }
+        writeLine(slot.level, std::string_view(slot.text, slot.length));
+        (slot.level >= LogLevel::Warn ? wroteErr : wroteOut) = true;
+        slot.sequence.store(pos + kCapacity, std::memory_order_release);
+        ++pos;
+        dequeuePos_.store(pos, std::memory_order_release);
+    }
+
+    std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != droppedReported_) {
+        std::fprintf(stderr, "[Log] Warning: %llu log lines dropped (ring buffer full).\n",
+                     static_cast<unsigned long long>(dropped - droppedReported_));
+        droppedReported_ = dropped;
+        wroteErr = true;
+    }
+
+    // One flush per burst instead of one per line
+    if (wroteOut) {
+        std::fflush(stdout);
+    }
+    if (wroteErr) {
+        std::fflush(stderr);
+    }
+    return wroteOut || wroteErr;
+}
+
+void Logger::writeLine(LogLevel level, std::string_view text) {
+    std::FILE* stream = level >= LogLevel::Warn ? stderr : stdout;
+    std::fwrite(text.data(), 1, text.size(), stream);
+    std::fputc('\n', stream);
+}
+
+LogLine& LogLine::operator<<(double value) {
+    // Same default formatting as an std::ostream (precision 6, %g)
+    char digits[32];
+    int length = std::snprintf(digits, sizeof(digits), "%g", value);
+    if (length > 0) {
+        append(std::string_view(digits, std::min(static_cast<std::size_t>(length), sizeof(digits) - 1)));
+    }
+    return *this;
+}
+
+void LogLine::append(std::string_view text) {
+    std::size_t length = std::min(text.size(), Logger::kMaxLineLength - length_);
+    std::memcpy(buffer_ + length_, text.data(), length);
+    length_ += length;
+}
+
+} // namespace ifa_runtime
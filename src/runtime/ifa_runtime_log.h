@@ -0,0 +1,304 @@
+/**
+ * @file ifa_runtime_log.h
+ * @brief Defines the asynchronous logger used by the IFA runtime engine and the generated automata.
+ * @details Log lines are formatted on the calling thread into a fixed-size buffer, pushed into a
+ *          lock-free ring buffer and written to stdout/stderr by a background thread, so the event
+ *          loop never blocks on console I/O. Levels below IFA_LOG_COMPILED_LEVEL are removed by the
+ *          preprocessor; the remaining ones are filtered at run time (see Logger::setLevel()).
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_LOG_H
+#define IFA_RUNTIME_LOG_H
+
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Lowest log level compiled into a translation unit (0 = Trace ... 4 = Error, 5 = Off).
+ * @details Define it on the compiler command line (e.g. -DIFA_LOG_COMPILED_LEVEL=2) to remove the
+ *          Trace and Debug statements, including the evaluation of their arguments, entirely.
+ */
+#ifndef IFA_LOG_COMPILED_LEVEL
+#define IFA_LOG_COMPILED_LEVEL 0
+#endif
+
+namespace ifa_runtime {
+
+/**
+ * @brief Severity of a log line. Warn and Error lines go to stderr, the others to stdout.
+ */
+enum class LogLevel : int {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+    /** @brief Disables logging when used as the threshold. */
+    Off = 5
+};
+
+/**
+ * @brief Parses a log level name ("trace", "debug", "info", "warn", "error", "off").
+ * @param name The level name.
+ * @param level Receives the parsed level.
+ * @return bool False if the name is not a known level.
+ */
+bool parseLogLevel(std::string_view name, LogLevel& level);
+
+/**
+ * @brief Process-wide asynchronous logger.
+ * @details Producers claim a slot of a bounded multi-producer ring buffer with a single atomic
+ *          compare-and-swap and never block; when the ring is full the line is dropped and
+ *          counted. A background thread drains the ring, writes the lines with one fwrite per
+ *          burst and flushes once the ring is empty. The logger is created on first use, lives
+ *          until the end of the process and drains the ring when the process exits normally.
+ */
+class Logger {
+public:
+    /** @brief Longest log line kept; longer lines are truncated. */
+    static constexpr std::size_t kMaxLineLength = 256;
+    /** @brief Number of slots in the ring buffer (a power of two). */
+    static constexpr std::size_t kCapacity = 4096;
+
+    /**
+     * @brief Returns the process-wide logger, starting its writer thread on first use.
+     * @return Logger& The logger.
+     */
+    static Logger& instance();
+
+    /**
+     * @brief Sets the run-time threshold; lines below it are discarded before formatting.
+     * @param level The new threshold.
+     */
+    void setLevel(LogLevel level);
+
+    /**
+     * @brief Returns the run-time threshold.
+     * @return LogLevel The current threshold.
+     */
+    LogLevel level() const;
+
+    /**
+     * @brief Checks whether a line of the given level passes the run-time threshold.
+     * @param level Level of the line.
+     * @return bool True if the line would be written.
+     */
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Queues one line for the writer thread.
+     * @details Never blocks. After shutdown() the line is written synchronously instead.
+     * @param level Level of the line.
+     * @param text Text of the line without the trailing newline; truncated to kMaxLineLength.
+     */
+    void write(LogLevel level, std::string_view text);
+
+    /**
+     * @brief Blocks until every line queued before the call has been written.
+     */
+    void flush();
+
+    /**
+     * @brief Drains the ring buffer and stops the writer thread.
+     * @details Called automatically at normal process exit.
+     */
+    void shutdown();
+
+    /**
+     * @brief Returns the number of lines dropped because the ring buffer was full.
+     * @return std::uint64_t The drop counter.
+     */
+    std::uint64_t droppedLines() const;
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+private:
+    /** @brief One ring buffer slot; sequence implements the bounded-queue handshake. */
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        LogLevel level = LogLevel::Info;
+        std::uint16_t length = 0;
+        char text[kMaxLineLength];
+    };
+
+    Logger();
+
+    /**
+     * @brief Body of the writer thread.
+     */
+    void run();
+
+    /**
+     * @brief Writes all lines currently in the ring buffer.
+     * @return bool True if at least one line was written.
+     */
+    bool drain();
+
+    /**
+     * @brief Writes one line directly to its stream.
+     * @param level Level of the line.
+     * @param text Text of the line.
+     */
+    static void writeLine(LogLevel level, std::string_view text);
+
+    /** @brief Ring buffer slots. */
+    std::unique_ptr<Slot[]> slots_;
+    /** @brief Next position producers claim. */
+    std::atomic<std::size_t> enqueuePos_{0};
+    /** @brief Next position the writer thread consumes. */
+    std::atomic<std::size_t> dequeuePos_{0};
+    /** @brief Run-time threshold. */
+    std::atomic<int> level_{static_cast<int>(LogLevel::Info)};
+    /** @brief Lines dropped because the ring was full. */
+    std::atomic<std::uint64_t> dropped_{0};
+    /** @brief Drops already reported by the writer thread. */
+    std::uint64_t droppedReported_ = 0;
+    /** @brief True while the writer thread waits for work. */
+    std::atomic<bool> sleeping_{false};
+    /** @brief True once shutdown() was requested. */
+    std::atomic<bool> stopping_{false};
+    /** @brief True once the writer thread has exited. */
+    std::atomic<bool> stopped_{false};
+    /** @brief Protects the wait of the writer thread. */
+    std::mutex mutex_;
+    /** @brief Wakes the writer thread. */
+    std::condition_variable wakeup_;
+    /** @brief Writer thread. */
+    std::thread thread_;
+};
+
+/**
+ * @brief Formats one log line into a stack buffer and queues it when destroyed.
+ * @details Supports the usual stream syntax for strings, characters, booleans and arithmetic
+ *          types without allocating; other types fall back to std::ostringstream.
+ */
+class LogLine {
+public:
+    /**
+     * @brief Starts a line.
+     * @param level Level of the line.
+     */
+    explicit LogLine(LogLevel level) : level_(level) {}
+
+    /**
+     * @brief Queues the formatted line.
+     */
+    ~LogLine() { Logger::instance().write(level_, std::string_view(buffer_, length_)); }
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    LogLine& operator<<(std::string_view text) {
+        append(text);
+        return *this;
+    }
+
+    LogLine& operator<<(const char* text) { return *this << std::string_view(text ? text : "(null)"); }
+
+    LogLine& operator<<(const std::string& text) { return *this << std::string_view(text); }
+
+    LogLine& operator<<(char c) { return *this << std::string_view(&c, 1); }
+
+    LogLine& operator<<(bool value) { return *this << std::string_view(value ? "1" : "0"); }
+
+    LogLine& operator<<(double value);
+
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>, LogLine&>
+    operator<<(T value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));
+        return *this;
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_floating_point_v<T> && !std::is_same_v<T, double>, LogLine&>
+    operator<<(T value) {
+        return *this << static_cast<double>(value);
+    }
+
+    template <typename T>
+    std::enable_if_t<!std::is_arithmetic_v<T> && !std::is_convertible_v<const T&, std::string_view> &&
+                     !std::is_convertible_v<const T&, const char*>, LogLine&>
+    operator<<(const T& value) {
+        std::ostringstream stream;
+        stream << value;
+        return *this << stream.str();
+    }
+
+private:
+    /**
+     * @brief Appends text, truncating at Logger::kMaxLineLength.
+     * @param text Text to append.
+     */
+    void append(std::string_view text);
+
+    /** @brief Level of the line. */
+    LogLevel level_;
+    /** @brief Number of bytes used in buffer_. */
+    std::size_t length_ = 0;
+    /** @brief Formatted text. */
+    char buffer_[Logger::kMaxLineLength];
+};
+
+} // namespace ifa_runtime
+
+/**
+ * @brief Logs a stream expression at the given level if it passes the run-time threshold.
+ * @details The expression is only evaluated when the line is written.
+ */
+#define IFA_LOG_AT(level, expr)                                                         \
+    do {                                                                                \
+        if (::ifa_runtime::Logger::instance().enabled(level)) {                         \
+            ::ifa_runtime::LogLine ifa_log_line_(level);                                \
+            ifa_log_line_ << expr;                                                      \
+        }                                                                               \
+    } while (0)
+
+#if IFA_LOG_COMPILED_LEVEL <= 0
+#define IFA_LOG_TRACE(expr) IFA_LOG_AT(::ifa_runtime::LogLevel::Trace, expr)
+#else
+#define IFA_LOG_TRACE(expr) do {} while (0)
+#endif
+
+#if IFA_LOG_COMPILED_LEVEL <= 1
+#define IFA_LOG_DEBUG(expr) IFA_LOG_AT(::ifa_runtime::LogLevel::Debug, expr)
+#else
+#define IFA_LOG_DEBUG(expr) do {} while (0)
+#endif
+
+#if IFA_LOG_COMPILED_LEVEL <= 2
+#define IFA_LOG_INFO(expr) IFA_LOG_AT(::ifa_runtime::LogLevel::Info, expr)
+#else
+#define IFA_LOG_INFO(expr) do {} while (0)
+#endif
+
+#if IFA_LOG_COMPILED_LEVEL <= 3
+#define IFA_LOG_WARN(expr) IFA_LOG_AT(::ifa_runtime::LogLevel::Warn, expr)
+#else
+#define IFA_LOG_WARN(expr) do {} while (0)
+#endif
+
+#if IFA_LOG_COMPILED_LEVEL <= 4
+#define IFA_LOG_ERROR(expr) IFA_LOG_AT(::ifa_runtime::LogLevel::Error, expr)
+#else
+#define IFA_LOG_ERROR(expr) do {} while (0)
+#endif
+
+#endif // IFA_RUNTIME_LOG_H
@@ -0,0 +1,37 @@
+/**
+ * @file ifa_runtime_pch.h
+ * @brief Precompiled header for the generated automaton translation unit.
+ * @details Bundles the runtime interface with the standard headers the generated code uses.
+ *          runtime.pro precompiles it next to libifa_runtime (ifa_runtime_pch.h.gch) with the
+ *          flags the GUI compiles generated code with; the GUI passes "-include ifa_runtime_pch.h"
+ *          when that file exists. The generated code still includes everything it needs itself,
+ *          so it compiles without the precompiled header too.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_PCH_H
+#define IFA_RUNTIME_PCH_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "ifa_runtime_engine.h"
+#include "ifa_runtime_log.h"
+#include "ifa_runtime_plugin.h"
+#include "ifa_runtime_snapshot.h"
+
+#endif // IFA_RUNTIME_PCH_H
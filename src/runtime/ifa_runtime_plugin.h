@@ -0,0 +1,79 @@
+/**
+ * @file ifa_runtime_plugin.h
+ * @brief Defines the binary interface between a plugin host and automata compiled as shared objects.
+ * @details A generated automaton compiled with -DIFA_AUTOMATON_PLUGIN (and -fPIC -shared
+ *          -fvisibility=hidden -fno-gnu-unique) exports the function IFA_PLUGIN_ENTRY instead of
+ *          main(). The function returns a descriptor with the automaton's metadata and its entry points. The plugin is not linked against
+ *          libifa_runtime: it uses the runtime of the host, which exports it (-rdynamic), so all
+ *          automata of a host share one runtime and one logger. -fno-gnu-unique is required for
+ *          dlclose() to unload the plugin; otherwise its globals survive until it is loaded again.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_PLUGIN_H
+#define IFA_RUNTIME_PLUGIN_H
+
+#include <cstdint>
+
+/** @brief Name of the function exported by a plugin. */
+#define IFA_PLUGIN_ENTRY ifa_automaton_plugin
+/** @brief Name of the exported function as a string, for dlsym(). */
+#define IFA_PLUGIN_ENTRY_NAME "ifa_automaton_plugin"
+/** @brief Declares the exported entry function (plugins are compiled with -fvisibility=hidden). */
+#define IFA_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+
+namespace ifa_runtime {
+
+/**
+ * @brief Version of the plugin interface; a host rejects plugins built for another version.
+ * @details Increment it whenever AutomatonPlugin or the meaning of its members changes.
+ */
+constexpr std::uint32_t kPluginAbiVersion = 1;
+
+/**
+ * @brief Names of one kind of symbol, indexed by symbol id (see protocol::SymbolKind).
+ */
+struct PluginSymbolList {
+    /** @brief The names; names[count] is nullptr. */
+    const char* const* names;
+    /** @brief Number of names. */
+    std::uint32_t count;
+};
+
+/**
+ * @brief Descriptor of an automaton plugin; returned by IFA_PLUGIN_ENTRY, valid while the plugin is loaded.
+ * @details The automaton's state lives in the plugin's globals, so a loaded plugin runs at most
+ *          one automaton at a time (load a copy of the file to run the same automaton twice).
+ */
+struct AutomatonPlugin {
+    /** @brief kPluginAbiVersion the plugin was built with. */
+    std::uint32_t abiVersion;
+    /** @brief Name of the automaton. */
+    const char* name;
+    /** @brief State names; id 0 is STATE_NULL. */
+    PluginSymbolList states;
+    /** @brief Input names. */
+    PluginSymbolList inputs;
+    /** @brief Output names. */
+    PluginSymbolList outputs;
+    /** @brief Variable names. */
+    PluginSymbolList variables;
+    /**
+     * @brief Runs the automaton until it terminates, like main() of the standalone executable.
+     * @details Takes the same command line (argv[0] is the program name) and blocks the calling thread.
+     * @return int Exit code.
+     */
+    int (*run)(int argc, char* argv[]);
+    /**
+     * @brief Asks the running automaton to terminate (see Engine::requestStop()); callable from any thread.
+     */
+    void (*requestStop)();
+};
+
+/** @brief Type of the function exported by a plugin. */
+using PluginEntryFunction = const AutomatonPlugin* (*)();
+
+} // namespace ifa_runtime
+
+#endif // IFA_RUNTIME_PLUGIN_H
@@ -0,0 +1,127 @@
+/**
+ * @file ifa_runtime_protocol.cpp
+ * @brief Implements encoding and decoding of the binary wire protocol.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_runtime_protocol.h"
+#include <algorithm>
+
+namespace ifa_runtime {
+namespace protocol {
+
+namespace {
+
+// Appends a 16-bit value in little-endian byte order.
+inline void appendU16(std::string& out, std::uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+// Reads a 16-bit little-endian value (the caller checks that 2 bytes are available).
+inline std::uint16_t readU16(const char* data) {
+    return static_cast<std::uint16_t>(static_cast<unsigned char>(data[0]) |
+                                      (static_cast<unsigned char>(data[1]) << 8));
+}
+
+// Appends a 32-bit value in little-endian byte order.
+inline void appendU32(std::string& out, std::uint32_t value) {
+    appendU16(out, static_cast<std::uint16_t>(value & 0xFFFF));
+    appendU16(out, static_cast<std::uint16_t>(value >> 16));
+}
+
+} // namespace
+
+bool isBinaryDatagram(const char* data, std::size_t length) {
+    return length >= kHeaderSize && std::equal(kMagic, kMagic + sizeof(kMagic), data);
+}
+
+void appendHeader(std::string& out) {
+    out.append(kMagic, sizeof(kMagic));
+    out.push_back(static_cast<char>(kVersion));
+}
+
+void appendRecord(std::string& out, RecordType type, std::string_view payload) {
+    std::size_t length = std::min(payload.size(), kMaxRecordPayload);
+    out.push_back(static_cast<char>(type));
+    appendU16(out, static_cast<std::uint16_t>(length));
+    out.append(payload.data(), length);
+}
+
+void appendIdRecord(std::string& out, RecordType type, std::uint16_t id, std::string_view value) {
+    std::size_t length = std::min(value.size(), kMaxRecordPayload - 2);
+    out.push_back(static_cast<char>(type));
+    appendU16(out, static_cast<std::uint16_t>(length + 2));
+    appendU16(out, id);
+    out.append(value.data(), length);
+}
+
+void appendSymbolRecord(std::string& out, SymbolKind kind, std::uint16_t id, std::string_view name) {
+    std::size_t length = std::min(name.size(), kMaxRecordPayload - 3);
+    out.push_back(static_cast<char>(RecordType::Symbol));
+    appendU16(out, static_cast<std::uint16_t>(length + 3));
+    out.push_back(static_cast<char>(kind));
+    appendU16(out, id);
+    out.append(name.data(), length);
+}
+
+void appendInstanceRecord(std::string& out, std::uint32_t instance) {
+    out.push_back(static_cast<char>(RecordType::Instance));
+    appendU16(out, 4);
+    appendU32(out, instance);
+}
+
+bool readInstancePayload(std::string_view payload, std::uint32_t& instance) {
+    if (payload.size() != 4) {
+        return false;
+    }
+    instance = readU16(payload.data()) | (static_cast<std::uint32_t>(readU16(payload.data() + 2)) << 16);
+    return true;
+}
+
+bool splitIdPayload(std::string_view payload, std::uint16_t& id, std::string_view& value) {
+    if (payload.size() < 2) {
+        return false;
+    }
+    id = readU16(payload.data());
+    value = payload.substr(2);
+    return true;
+}
+
+RecordReader::RecordReader(const char* data, std::size_t length) {
+    if (isBinaryDatagram(data, length) && static_cast<std::uint8_t>(data[sizeof(kMagic)]) == kVersion) {
+        valid_ = true;
+        remaining_ = std::string_view(data + kHeaderSize, length - kHeaderSize);
+    }
+}
+
+bool RecordReader::valid() const {
+    return valid_;
+}
+
+bool RecordReader::next(Record& record) {
+    if (!valid_ || malformed_ || remaining_.empty()) {
+        return false;
+    }
+    if (remaining_.size() < kRecordHeaderSize) {
+        malformed_ = true;
+        return false;
+    }
+    std::size_t length = readU16(remaining_.data() + 1);
+    if (remaining_.size() < kRecordHeaderSize + length) {
+        malformed_ = true;
+        return false;
+    }
+    record.type = static_cast<RecordType>(static_cast<std::uint8_t>(remaining_[0]));
+    record.payload = remaining_.substr(kRecordHeaderSize, length);
+    remaining_.remove_prefix(kRecordHeaderSize + length);
+    return true;
+}
+
+bool RecordReader::malformed() const {
+    return malformed_;
+}
+
+} // namespace protocol
+} // namespace ifa_runtime
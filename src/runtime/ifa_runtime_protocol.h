@@ -0,0 +1,235 @@
+/**
+ * @file ifa_runtime_protocol.h
+ * @brief Defines the binary wire protocol spoken between the GUI and a generated automaton.
+ * @details The header has no Asio or Qt dependency so it can be shared by the runtime and the GUI.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_PROTOCOL_H
+#define IFA_RUNTIME_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ifa_runtime {
+namespace protocol {
+
+/**
+ * @brief Wire protocol used for the traffic between the GUI and the automaton.
+ */
+enum class WireProtocol {
+    /** @brief Human-readable text messages ("STATE Idle", "INPUT|name|value", ...). */
+    Text,
+    /** @brief Versioned, length-prefixed binary records with numeric symbol ids. */
+    Binary
+};
+
+/**
+ * @brief Magic bytes opening every binary datagram.
+ * @details A text datagram never starts with a NUL byte, so the two protocols can be told apart
+ *          by looking at the first bytes of a datagram.
+ */
+constexpr char kMagic[3] = {'\0', 'I', 'F'};
+
+/**
+ * @brief Version of the binary protocol, the byte following the magic.
+ */
+constexpr std::uint8_t kVersion = 1;
+
+/**
+ * @brief Size of the datagram header (magic + version).
+ */
+constexpr std::size_t kHeaderSize = sizeof(kMagic) + 1;
+
+/**
+ * @brief Size of a record header (type byte + 16-bit little-endian payload length).
+ */
+constexpr std::size_t kRecordHeaderSize = 3;
+
+/**
+ * @brief Largest payload a single record can carry.
+ */
+constexpr std::size_t kMaxRecordPayload = 0xFFFF;
+
+/**
+ * @brief Type of one record in a binary datagram.
+ * @details Records with an id start their payload with the 16-bit little-endian id; the rest
+ *          of the payload is the raw value bytes (no quoting or escaping).
+ */
+enum class RecordType : std::uint8_t {
+    /** @brief Automaton -> GUI: automaton name, reply to GET_STATUS. Payload: name. */
+    Name = 0x01,
+    /** @brief Automaton -> GUI: automaton is ready. Payload: name. */
+    Ready = 0x02,
+    /** @brief Automaton -> GUI: symbol dictionary entry. Payload: kind byte, id, symbol name. */
+    Symbol = 0x03,
+    /** @brief Automaton -> GUI: current state. Payload: state id. */
+    State = 0x10,
+    /** @brief Automaton -> GUI: output value. Payload: output id, value. */
+    Output = 0x11,
+    /** @brief Automaton -> GUI: variable value. Payload: variable id, value. */
+    Variable = 0x12,
+    /** @brief Automaton -> GUI: log line. Payload: text. */
+    Log = 0x13,
+    /** @brief Automaton -> GUI: error report. Payload: text. */
+    Error = 0x14,
+    /** @brief Automaton -> GUI: automaton is shutting down. Empty payload. */
+    Terminating = 0x15,
+    /** @brief Either direction: a text protocol message carried verbatim. Payload: message. */
+    Text = 0x16,
+    /**
+     * @brief Either direction: the following records of the datagram concern one automaton instance.
+     * @details Payload: 32-bit little-endian instance id. Every datagram starts at instance 0, so
+     *          a single-instance automaton never sends this record.
+     */
+    Instance = 0x17,
+    /** @brief GUI -> automaton: input event. Payload: input id, value. */
+    Input = 0x20,
+    /** @brief GUI -> automaton: command. Payload: one Command byte. */
+    Command = 0x21
+};
+
+/**
+ * @brief Kind of symbol a numeric id refers to.
+ */
+enum class SymbolKind : std::uint8_t {
+    State = 0,
+    Input = 1,
+    Output = 2,
+    Variable = 3
+};
+
+/**
+ * @brief Number of SymbolKind values.
+ */
+constexpr std::size_t kSymbolKindCount = 4;
+
+/**
+ * @brief Commands carried by a RecordType::Command record.
+ */
+enum class Command : std::uint8_t {
+    Terminate = 1,
+    GetStatus = 2,
+    Checkpoint = 3
+};
+
+/**
+ * @brief One decoded record. The payload points into the datagram it was read from.
+ */
+struct Record {
+    /** @brief Type of the record. */
+    RecordType type = RecordType::Text;
+    /** @brief Raw payload bytes. */
+    std::string_view payload;
+};
+
+/**
+ * @brief Checks whether a datagram uses the binary protocol.
+ * @param data Pointer to the datagram.
+ * @param length Length of the datagram in bytes.
+ * @return bool True if the datagram starts with the binary magic (any version).
+ */
+bool isBinaryDatagram(const char* data, std::size_t length);
+
+/**
+ * @brief Appends the datagram header (magic + version) to a buffer.
+ * @param out Buffer receiving the header.
+ */
+void appendHeader(std::string& out);
+
+/**
+ * @brief Appends one record to a buffer.
+ * @param out Buffer receiving the record.
+ * @param type Type of the record.
+ * @param payload Payload bytes; truncated to kMaxRecordPayload.
+ */
+void appendRecord(std::string& out, RecordType type, std::string_view payload);
+
+/**
+ * @brief Appends one record whose payload starts with a symbol id.
+ * @param out Buffer receiving the record.
+ * @param type Type of the record.
+ * @param id Symbol id written in front of the value.
+ * @param value Value bytes following the id; truncated to fit into kMaxRecordPayload.
+ */
+void appendIdRecord(std::string& out, RecordType type, std::uint16_t id, std::string_view value = {});
+
+/**
+ * @brief Appends a symbol dictionary record to a buffer.
+ * @param out Buffer receiving the record.
+ * @param kind Kind of the symbol.
+ * @param id Numeric id of the symbol.
+ * @param name Name of the symbol.
+ */
+void appendSymbolRecord(std::string& out, SymbolKind kind, std::uint16_t id, std::string_view name);
+
+/**
+ * @brief Appends an Instance record to a buffer.
+ * @param out Buffer receiving the record.
+ * @param instance The instance id.
+ */
+void appendInstanceRecord(std::string& out, std::uint32_t instance);
+
+/**
+ * @brief Reads the instance id from the payload of an Instance record.
+ * @param payload Payload of the record.
+ * @param instance Receives the instance id.
+ * @return bool False if the payload does not hold a 32-bit id.
+ */
+bool readInstancePayload(std::string_view payload, std::uint32_t& instance);
+
+/**
+ * @brief Splits a payload into its leading symbol id and the remaining value.
+ * @param payload Payload of an id record.
+ * @param id Receives the id.
+ * @param value Receives the bytes following the id.
+ * @return bool False if the payload is too short to contain an id.
+ */
+bool splitIdPayload(std::string_view payload, std::uint16_t& id, std::string_view& value);
+
+/**
+ * @brief Iterates over the records of one binary datagram without copying.
+ */
+class RecordReader {
+public:
+    /**
+     * @brief Constructs a reader over a datagram.
+     * @param data Pointer to the datagram; must stay valid while the reader is used.
+     * @param length Length of the datagram in bytes.
+     */
+    RecordReader(const char* data, std::size_t length);
+
+    /**
+     * @brief Checks the datagram header.
+     * @return bool True if the datagram has the binary magic and a supported version.
+     */
+    bool valid() const;
+
+    /**
+     * @brief Reads the next record.
+     * @param record Receives the record.
+     * @return bool False at the end of the datagram or if the remaining bytes are malformed.
+     */
+    bool next(Record& record);
+
+    /**
+     * @brief Checks whether reading stopped at malformed data rather than the end of the datagram.
+     * @return bool True if a truncated record was encountered.
+     */
+    bool malformed() const;
+
+private:
+    /** @brief Remaining, not yet consumed bytes of the datagram. */
+    std::string_view remaining_;
+    /** @brief True if the header is valid. */
+    bool valid_ = false;
+    /** @brief True if a truncated record was encountered. */
+    bool malformed_ = false;
+};
+
+} // namespace protocol
+} // namespace ifa_runtime
+#endif // IFA_RUNTIME_PROTOCOL_H
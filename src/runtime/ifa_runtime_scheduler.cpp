@@ -0,0 +1,113 @@
+/**
+ * @file ifa_runtime_scheduler.cpp
+ * @brief Implements the Scheduler class.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_runtime_scheduler_impl.h"
+#include "ifa_runtime_engine_impl.h"
+#include "ifa_runtime_log.h"
+#include <algorithm>
+#include <atomic>
+
+namespace ifa_runtime {
+
+namespace {
+// Scheduler that Engine() attaches to (see Scheduler::setProcessScheduler).
+std::atomic<Scheduler*> installedScheduler{nullptr};
+} // namespace
+
+SchedulerImpl::SchedulerImpl(unsigned threadCount) : workGuard_(asio::make_work_guard(context_)) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this]() { context_.run(); });
+    }
+    IFA_LOG_INFO("[Scheduler] Started " << threadCount << " worker threads.");
+}
+
+SchedulerImpl::~SchedulerImpl() {
+    shutdown();
+}
+
+void SchedulerImpl::shutdown() {
+    if (workers_.empty()) {
+        return;
+    }
+    workGuard_.reset();
+    context_.stop();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    IFA_LOG_INFO("[Scheduler] Worker threads stopped.");
+}
+
+std::vector<EngineUsage> SchedulerImpl::usage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<EngineUsage> result;
+    result.reserve(attached_.size());
+    for (const Attached& entry : attached_) {
+        EngineUsage usage = entry.engine->usage();
+        usage.automatonName = entry.automatonName;
+        result.push_back(std::move(usage));
+    }
+    return result;
+}
+
+void SchedulerImpl::attach(const EngineImpl* engine) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    attached_.push_back(Attached{engine, {}});
+}
+
+void SchedulerImpl::detach(const EngineImpl* engine) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    attached_.erase(std::remove_if(attached_.begin(), attached_.end(),
+                                   [engine](const Attached& entry) { return entry.engine == engine; }),
+                    attached_.end());
+}
+
+void SchedulerImpl::setName(const EngineImpl* engine, const std::string& automatonName) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Attached& entry : attached_) {
+        if (entry.engine == engine) {
+            entry.automatonName = automatonName;
+        }
+    }
+}
+
+
+// --- Scheduler: forwarding to the implementation ---
+
+Scheduler::Scheduler(unsigned threadCount) : impl_(std::make_unique<SchedulerImpl>(threadCount)) {}
+
+Scheduler::~Scheduler() {
+    // Engine() must not attach to a scheduler that is going away
+    Scheduler* self = this;
+    installedScheduler.compare_exchange_strong(self, nullptr);
+}
+
+void Scheduler::shutdown() {
+    impl_->shutdown();
+}
+
+unsigned Scheduler::threadCount() const {
+    return impl_->threadCount();
+}
+
+std::vector<EngineUsage> Scheduler::usage() const {
+    return impl_->usage();
+}
+
+void Scheduler::setProcessScheduler(Scheduler* scheduler) {
+    installedScheduler.store(scheduler);
+}
+
+Scheduler* Scheduler::processScheduler() {
+    return installedScheduler.load();
+}
+
+} // namespace ifa_runtime
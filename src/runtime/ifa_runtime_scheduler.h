@@ -0,0 +1,112 @@
+/**
+ * @file ifa_runtime_scheduler.h
+ * @brief Defines the Scheduler class, a thread pool shared by the engines of several automata.
+ * @details Without a scheduler every Engine owns an io_context and run() drives it on the calling
+ *          thread, so an automaton uses at most one core. Engines attached to a Scheduler run
+ *          their handlers on its shared io_context instead, each engine on its own strand: the
+ *          handlers of one automaton still run one at a time (run-to-completion), while different
+ *          automata run in parallel on all worker threads. The io_context queue is FIFO and each
+ *          handler does a bounded amount of work (one receive batch, the timers due at one tick,
+ *          one step), so a busy automaton cannot starve the others.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_SCHEDULER_H
+#define IFA_RUNTIME_SCHEDULER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ifa_runtime {
+
+// Forward declaration of the implementation (ifa_runtime_scheduler_impl.h), keeps Asio out of this header.
+class SchedulerImpl;
+
+/**
+ * @brief Resource usage of one engine attached to a Scheduler.
+ */
+struct EngineUsage {
+    /** @brief Name of the automaton (empty until the engine is initialized). */
+    std::string automatonName;
+    /** @brief CPU time spent in the engine's handlers on the worker threads. */
+    std::chrono::nanoseconds cpuTime{0};
+    /** @brief Number of handlers executed. */
+    std::uint64_t handlers = 0;
+    /** @brief True while Engine::run() has not returned. */
+    bool running = false;
+};
+
+/**
+ * @brief A pool of worker threads running the event loops of many engines.
+ * @details Engines attach to a scheduler when they are constructed: explicitly with
+ *          Engine(Scheduler&), or implicitly with Engine() after setProcessScheduler(). The
+ *          scheduler must outlive its engines.
+ */
+class Scheduler {
+public:
+    /**
+     * @brief Creates the shared io_context and starts the worker threads.
+     * @param threadCount Number of worker threads; 0 uses one per hardware thread.
+     */
+    explicit Scheduler(unsigned threadCount = 0);
+
+    /**
+     * @brief Destructor. Stops and joins the worker threads (see shutdown()).
+     */
+    ~Scheduler();
+
+    /**
+     * @brief Stops the shared io_context and joins the worker threads.
+     * @details All attached engines must have stopped before; handlers still queued are discarded.
+     */
+    void shutdown();
+
+    /**
+     * @brief Returns the number of worker threads.
+     * @return unsigned The number of threads.
+     */
+    unsigned threadCount() const;
+
+    /**
+     * @brief Returns the usage of every attached engine, in order of attachment.
+     * @return std::vector<EngineUsage> One entry per engine.
+     */
+    std::vector<EngineUsage> usage() const;
+
+    /**
+     * @brief Sets the scheduler engines created with Engine() attach to.
+     * @details Used by a plugin host: the automata construct their engine themselves (as a global
+     *          initialized when the plugin is loaded), so the host installs its scheduler first.
+     * @param scheduler The scheduler, or nullptr to make Engine() standalone again.
+     */
+    static void setProcessScheduler(Scheduler* scheduler);
+
+    /**
+     * @brief Returns the scheduler set by setProcessScheduler().
+     * @return Scheduler* The scheduler, or nullptr.
+     */
+    static Scheduler* processScheduler();
+
+    /**
+     * @brief Returns the implementation (internal to libifa_runtime).
+     * @return SchedulerImpl& The implementation.
+     */
+    SchedulerImpl& impl() { return *impl_; }
+
+private:
+    /**
+     * @brief The implementation; holds the io_context, the worker threads and the attached engines.
+     */
+    std::unique_ptr<SchedulerImpl> impl_;
+
+    // --- Prevent copying/moving ---
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+};
+
+} // namespace ifa_runtime
+#endif // IFA_RUNTIME_SCHEDULER_H
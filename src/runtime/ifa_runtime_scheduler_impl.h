@@ -0,0 +1,98 @@
+/**
+ * @file ifa_runtime_scheduler_impl.h
+ * @brief Defines SchedulerImpl, the implementation behind the public Scheduler interface.
+ * @details Internal to libifa_runtime, like ifa_runtime_engine_impl.h.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_SCHEDULER_IMPL_H
+#define IFA_RUNTIME_SCHEDULER_IMPL_H
+
+#include "ifa_runtime_scheduler.h"
+#include <asio.hpp>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ifa_runtime {
+
+class EngineImpl;
+
+/**
+ * @brief Implementation of the scheduler.
+ * @details The public methods mirror those of Scheduler (see ifa_runtime_scheduler.h for their documentation).
+ */
+class SchedulerImpl {
+public:
+    /**
+     * @brief Creates the io_context and starts the worker threads.
+     * @param threadCount Number of worker threads; 0 uses one per hardware thread.
+     */
+    explicit SchedulerImpl(unsigned threadCount);
+
+    /**
+     * @brief Destructor. Calls shutdown().
+     */
+    ~SchedulerImpl();
+
+    void shutdown();
+
+    unsigned threadCount() const { return static_cast<unsigned>(workers_.size()); }
+
+    std::vector<EngineUsage> usage() const;
+
+    /**
+     * @brief Returns the shared io_context; engines create their strands on it.
+     * @return asio::io_context& The io_context.
+     */
+    asio::io_context& context() { return context_; }
+
+    /**
+     * @brief Registers an engine for usage(). Called by the engine's constructor.
+     * @param engine The engine.
+     */
+    void attach(const EngineImpl* engine);
+
+    /**
+     * @brief Unregisters an engine. Called by the engine's destructor.
+     * @param engine The engine.
+     */
+    void detach(const EngineImpl* engine);
+
+    /**
+     * @brief Sets the automaton name reported by usage().
+     * @param engine The engine.
+     * @param automatonName The name.
+     */
+    void setName(const EngineImpl* engine, const std::string& automatonName);
+
+private:
+    /** @brief An attached engine and the name reported for it. */
+    struct Attached {
+        /** @brief The engine. */
+        const EngineImpl* engine;
+        /** @brief The automaton name. */
+        std::string automatonName;
+    };
+
+    /** @brief The io_context shared by all attached engines. */
+    asio::io_context context_;
+    /** @brief Keeps the workers running while no engine has work. */
+    std::optional<asio::executor_work_guard<asio::io_context::executor_type>> workGuard_;
+    /** @brief Threads running context_. */
+    std::vector<std::thread> workers_;
+    /** @brief Guards attached_. */
+    mutable std::mutex mutex_;
+    /** @brief The attached engines in order of attachment. */
+    std::vector<Attached> attached_;
+
+    // --- Prevent copying/moving ---
+    SchedulerImpl(const SchedulerImpl&) = delete;
+    SchedulerImpl& operator=(const SchedulerImpl&) = delete;
+};
+
+} // namespace ifa_runtime
+#endif // IFA_RUNTIME_SCHEDULER_IMPL_H
@@ -0,0 +1,213 @@
+/**
+ * @file ifa_runtime_snapshot.cpp
+ * @brief Implements the encoder and decoder of checkpoint snapshots.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_runtime_snapshot.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define IFA_SNAPSHOT_FSYNC 1
+#endif
+
+namespace ifa_runtime {
+
+namespace {
+
+// First bytes of a snapshot file: the magic and the format version.
+constexpr char kSnapshotMagic[] = { 'I', 'F', 'A', 'S', 1 };
+
+#ifdef IFA_SNAPSHOT_FSYNC
+// Writes all of the bytes to a file descriptor, retrying short and interrupted writes.
+bool writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+// Flushes the directory holding path, so that a rename into it survives a crash.
+void syncDirectory(const std::string& path) {
+    std::string::size_type slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd); // Best effort: some file systems refuse fsync() on a directory
+        ::close(fd);
+    }
+}
+#endif
+
+} // namespace
+
+// --- SnapshotWriter ---
+
+void SnapshotWriter::putUnsigned(std::uint64_t value) {
+    while (value >= 0x80) {
+        data_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+}
+
+void SnapshotWriter::putSigned(std::int64_t value) {
+    // Zigzag: small negative numbers stay short too.
+    putUnsigned((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+void SnapshotWriter::putDouble(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        data_.push_back(static_cast<char>(bits >> (8 * i)));
+    }
+}
+
+void SnapshotWriter::putString(std::string_view value) {
+    putUnsigned(value.size());
+    data_.append(value.data(), value.size());
+}
+
+bool SnapshotWriter::writeFile(const std::string& path, std::string& error) const {
+    std::string temporary = path + ".tmp";
+#ifdef IFA_SNAPSHOT_FSYNC
+    // The data must be on disk before the rename, or a crash could leave an empty or partial
+    // file under the new name.
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        error = "Cannot create '" + temporary + "': " + std::strerror(errno);
+        return false;
+    }
+    if (!writeAll(fd, kSnapshotMagic, sizeof(kSnapshotMagic)) || !writeAll(fd, data_.data(), data_.size()) ||
+        ::fsync(fd) != 0) {
+        error = "Cannot write '" + temporary + "': " + std::strerror(errno);
+        ::close(fd);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    if (::close(fd) != 0) {
+        error = "Cannot write '" + temporary + "': " + std::strerror(errno);
+        std::remove(temporary.c_str());
+        return false;
+    }
+#else
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+        file.write(data_.data(), static_cast<std::streamsize>(data_.size()));
+        file.flush();
+        if (!file) {
+            error = "Cannot write '" + temporary + "'";
+            return false;
+        }
+    }
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        error = "Cannot replace '" + path + "': " + std::strerror(errno);
+        std::remove(temporary.c_str());
+        return false;
+    }
+#ifdef IFA_SNAPSHOT_FSYNC
+    syncDirectory(path);
+#endif
+    return true;
+}
+
+// --- SnapshotReader ---
+
+bool SnapshotReader::readFile(const std::string& path, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "Cannot open snapshot '" + path + "'";
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(kSnapshotMagic) || !std::equal(kSnapshotMagic, kSnapshotMagic + sizeof(kSnapshotMagic), data.begin())) {
+        error = "'" + path + "' is not a snapshot of this version";
+        return false;
+    }
+    data_ = data.substr(sizeof(kSnapshotMagic));
+    offset_ = 0;
+    failed_ = false;
+    return true;
+}
+
+bool SnapshotReader::getByte(std::uint8_t& value) {
+    if (failed_ || offset_ >= data_.size()) {
+        failed_ = true;
+        return false;
+    }
+    value = static_cast<std::uint8_t>(data_[offset_++]);
+    return true;
+}
+
+bool SnapshotReader::getUnsigned(std::uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        std::uint8_t byte = 0;
+        if (!getByte(byte)) {
+            return false;
+        }
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    failed_ = true;
+    return false;
+}
+
+bool SnapshotReader::getSigned(std::int64_t& value) {
+    std::uint64_t encoded = 0;
+    if (!getUnsigned(encoded)) {
+        return false;
+    }
+    value = static_cast<std::int64_t>((encoded >> 1) ^ (~(encoded & 1) + 1));
+    return true;
+}
+
+bool SnapshotReader::getDouble(double& value) {
+    std::uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+        std::uint8_t byte = 0;
+        if (!getByte(byte)) {
+            return false;
+        }
+        bits |= static_cast<std::uint64_t>(byte) << (8 * i);
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+bool SnapshotReader::getString(std::string& value) {
+    std::uint64_t length = 0;
+    if (!getUnsigned(length)) {
+        return false;
+    }
+    if (length > data_.size() - offset_) {
+        failed_ = true;
+        return false;
+    }
+    value.assign(data_, offset_, static_cast<std::size_t>(length));
+    offset_ += static_cast<std::size_t>(length);
+    return true;
+}
+
+} // namespace ifa_runtime
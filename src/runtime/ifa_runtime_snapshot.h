@@ -0,0 +1,105 @@
+/**
+ * @file ifa_runtime_snapshot.h
+ * @brief Defines the encoder and decoder of the checkpoint snapshots of generated automata.
+ * @details The generated code decides what a snapshot holds (see the CHECKPOINT command and the
+ *          --resume flag of a generated automaton); this file only provides the encoding.
+ *          File format: the magic "IFAS" and a version byte, followed by the values the automaton
+ *          wrote. Unsigned numbers are LEB128 varints, signed numbers zigzag-encoded varints,
+ *          doubles 8 little-endian bytes and strings are prefixed with their length.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_RUNTIME_SNAPSHOT_H
+#define IFA_RUNTIME_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ifa_runtime {
+
+/**
+ * @brief Builds a snapshot in memory and writes it to a file.
+ */
+class SnapshotWriter {
+public:
+    /** @brief Appends one byte. */
+    void putByte(std::uint8_t value) { data_.push_back(static_cast<char>(value)); }
+    /** @brief Appends an unsigned number. */
+    void putUnsigned(std::uint64_t value);
+    /** @brief Appends a signed number. */
+    void putSigned(std::int64_t value);
+    /** @brief Appends a double. */
+    void putDouble(double value);
+    /** @brief Appends a string. */
+    void putString(std::string_view value);
+
+    /**
+     * @brief Gets the encoded values (without the file header).
+     * @return const std::string& The data.
+     */
+    const std::string& data() const { return data_; }
+
+    /**
+     * @brief Writes the header and the values to a file.
+     * @details The snapshot is written to "<path>.tmp", flushed to disk with fsync() and renamed
+     *          (then the directory is flushed), so the file at path always holds a complete
+     *          snapshot, the new or the previous one, even after a crash. Without POSIX fsync()
+     *          the file is only flushed to the operating system.
+     * @param path The file path.
+     * @param error Receives the reason on failure.
+     * @return bool True if the file has been written.
+     */
+    bool writeFile(const std::string& path, std::string& error) const;
+
+private:
+    /** @brief The encoded values. */
+    std::string data_;
+};
+
+/**
+ * @brief Reads the values of a snapshot in the order they were written.
+ * @details Every get function returns false, and leaves the reader failed, if the data ends
+ *          before the value does.
+ */
+class SnapshotReader {
+public:
+    /**
+     * @brief Reads a snapshot file written by SnapshotWriter::writeFile().
+     * @param path The file path.
+     * @param error Receives the reason on failure.
+     * @return bool True if the file is a snapshot of this version.
+     */
+    bool readFile(const std::string& path, std::string& error);
+
+    /** @brief Reads one byte. */
+    bool getByte(std::uint8_t& value);
+    /** @brief Reads an unsigned number. */
+    bool getUnsigned(std::uint64_t& value);
+    /** @brief Reads a signed number. */
+    bool getSigned(std::int64_t& value);
+    /** @brief Reads a double. */
+    bool getDouble(double& value);
+    /** @brief Reads a string. */
+    bool getString(std::string& value);
+
+    /**
+     * @brief Checks whether a read has run past the end of the data.
+     * @return bool True if the snapshot is truncated or corrupt.
+     */
+    bool failed() const { return failed_; }
+
+private:
+    /** @brief The values of the snapshot. */
+    std::string data_;
+    /** @brief Offset of the next value. */
+    std::size_t offset_ = 0;
+    /** @brief Set by the first read past the end. */
+    bool failed_ = false;
+};
+
+} // namespace ifa_runtime
+
+#endif // IFA_RUNTIME_SNAPSHOT_H
@@ -7,72 +7,322 @@
 
 #include "ifa_runtime_timers.h"
 #include <utility>
+#include <algorithm>
 
 namespace ifa_runtime {
 
-TimerManager::TimerManager(asio::io_context& io_ctx, TimerTimeoutHandler handler)
-    : io_context_(io_ctx), timeoutHandler_(std::move(handler)) {}
+namespace {
+
+// Rotates a 64-bit slot bitmap right so that bit 0 corresponds to slot 'shift'.
+inline std::uint64_t rotateRight(std::uint64_t value, unsigned shift) {
+    shift &= 63u;
+    return shift == 0 ? value : (value >> shift) | (value << (64u - shift));
+}
+
+// Index of the lowest set bit (value must be non-zero).
+inline unsigned lowestBit(std::uint64_t value) {
+    return static_cast<unsigned>(__builtin_ctzll(value));
+}
+
+} // namespace
+
+TimerManager::TimerManager(const EngineExecutor& executor, HandlerTracker& tracker, Clock& clock, TimerTimeoutHandler handler)
+    : clock_(clock),
+      epoch_(clock.now()),
+      wakeTimer_(executor),
+      tracker_(tracker),
+      timeoutHandler_(std::move(handler)) {
+    for (auto& level : slots_) {
+        level.fill(kNil);
+    }
+}
 
 TimerManager::~TimerManager() {
     cancelAllTimers();
 }
 
-int TimerManager::scheduleTimer(long long delayMs, const std::string& targetStateName) {
-    // Generate a unique ID for this timer and increment the counter for the next one.
-    int timerId = nextTimerId_++;
+std::uint64_t TimerManager::nowTick() const {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        clock_.now() - epoch_).count());
+}
+
+std::uint32_t TimerManager::allocateNode() {
+    if (freeHead_ == kNil) {
+        // Pool exhausted: grow it by one node. The vector keeps its capacity, so after the
+        // first burst the pool reaches the working-set size and no further allocation happens.
+        nodes_.emplace_back();
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+    std::uint32_t index = freeHead_;
+    freeHead_ = nodes_[index].next;
+    return index;
+}
+
+void TimerManager::releaseNode(std::uint32_t index) {
+    TimerNode& node = nodes_[index];
+    node.level = -1;
+    node.prev = kNil;
+    // Bump the generation so that outstanding handles to this node become stale (never 0).
+    if (++node.generation == 0) {
+        node.generation = 1;
+    }
+    node.next = freeHead_;
+    freeHead_ = index;
+}
+
+void TimerManager::linkNode(std::uint32_t index) {
+    TimerNode& node = nodes_[index];
+    std::uint64_t expiry = std::max(node.expiryTick, currentTick_);
+    std::uint64_t delta = expiry - currentTick_;
+
+    // Pick the lowest level whose range covers the remaining delay.
+    unsigned level = 0;
+    while (level + 1 < kLevels && delta >= (std::uint64_t{1} << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+    if (delta >= (std::uint64_t{1} << (kSlotBits * kLevels))) {
+        // Beyond the wheel's range: park in the furthest slot, it is re-inserted on cascade.
+        expiry = currentTick_ + (std::uint64_t{1} << (kSlotBits * kLevels)) - 1;
+    }
+    unsigned slot = static_cast<unsigned>((expiry >> (kSlotBits * level)) & kSlotMask);
+
+    // Push to the front of the slot list.
+    node.level = static_cast<std::int8_t>(level);
+    node.slot = static_cast<std::uint8_t>(slot);
+    node.prev = kNil;
+    node.next = slots_[level][slot];
+    if (node.next != kNil) {
+        nodes_[node.next].prev = index;
+    }
+    slots_[level][slot] = index;
+    occupied_[level] |= (std::uint64_t{1} << slot);
+}
+
+void TimerManager::unlinkNode(std::uint32_t index) {
+    TimerNode& node = nodes_[index];
+    unsigned level = static_cast<unsigned>(node.level);
+    unsigned slot = node.slot;
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        slots_[level][slot] = node.next;
+    }
+    if (node.next != kNil) {
+        nodes_[node.next].prev = node.prev;
+    }
+    if (slots_[level][slot] == kNil) {
+        occupied_[level] &= ~(std::uint64_t{1} << slot);
+    }
+    node.prev = kNil;
+    node.next = kNil;
+}
+
+std::uint64_t TimerManager::nextEventTick() const {
+    std::uint64_t best = kNever;
+    for (unsigned level = 0; level < kLevels; ++level) {
+        if (occupied_[level] == 0) {
+            continue;
+        }
+        unsigned shift = kSlotBits * level;
+        std::uint64_t levelTick = currentTick_ >> shift;
+        // Distance (1..64) from the current slot of this level to the next occupied one.
+        unsigned start = static_cast<unsigned>((levelTick + 1) & kSlotMask);
+        std::uint64_t distance = lowestBit(rotateRight(occupied_[level], start)) + 1;
+        std::uint64_t tick = (levelTick + distance) << shift;
+        best = std::min(best, tick);
+    }
+    return best;
+}
+
+void TimerManager::advanceTo(std::uint64_t targetTick) {
+    while (activeCount_ > 0) {
+        std::uint64_t next = nextEventTick();
+        if (next > targetTick) {
+            break;
+        }
+        // Jump straight to the next tick with work; empty slots in between need no processing.
+        currentTick_ = next;
+        // Cascade from the top level down, so nodes moved into a lower level's current slot
+        // are handled in the same tick.
+        for (unsigned level = kLevels - 1; level >= 1; --level) {
+            std::uint64_t lowMask = (std::uint64_t{1} << (kSlotBits * level)) - 1;
+            if ((currentTick_ & lowMask) == 0) {
+                cascadeSlot(level, static_cast<unsigned>((currentTick_ >> (kSlotBits * level)) & kSlotMask));
+            }
+        }
+        expireSlot(static_cast<unsigned>(currentTick_ & kSlotMask));
+    }
+    currentTick_ = std::max(currentTick_, targetTick);
+}
+
+void TimerManager::cascadeSlot(unsigned level, unsigned slot) {
+    std::uint32_t index = slots_[level][slot];
+    slots_[level][slot] = kNil;
+    occupied_[level] &= ~(std::uint64_t{1} << slot);
+    while (index != kNil) {
+        std::uint32_t next = nodes_[index].next;
+        linkNode(index);
+        index = next;
+    }
+}
 
-    // Create a new Asio steady_timer associated with the io_context.
-    auto timer = std::make_unique<asio::steady_timer>(io_context_);
+void TimerManager::expireSlot(unsigned slot) {
+    // Take one node at a time, the handler may cancel or schedule timers: the rest of the slot
+    // stays linked, so cancelTimer() and cancelAllTimers() still see it. A timer scheduled by
+    // the handler expires after currentTick_ and never lands in this slot.
+    while (slots_[0][slot] != kNil) {
+        std::uint32_t index = slots_[0][slot];
+        unlinkNode(index);
+        TimerNode& node = nodes_[index];
+        if (node.expiryTick > currentTick_) {
+            // Not due yet (cannot normally happen at level 0), put it back into a later slot.
+            linkNode(index);
+            continue;
+        }
+        // Release the node before calling the handler; the target name is swapped out
+        // (no copy) and the node gets the scratch buffer's capacity in exchange.
+        std::uint32_t instance = node.instance;
+        expiredTarget_.swap(node.targetStateName);
+        releaseNode(index);
+        --activeCount_;
+        ++expiredCount_;
+        timeoutHandler_(instance, expiredTarget_);
+    }
+}
 
-    // Set the timer to expire after the specified delay from now.
-    timer->expires_after(std::chrono::milliseconds(delayMs));
+void TimerManager::rearm() {
+    if (clock_.isVirtual()) {
+        return; // Driven by advanceToNextTimer()
+    }
+    if (wakeupsHeld_) {
+        return; // Armed by holdWakeups(false)
+    }
+    if (activeCount_ == 0) {
+        if (armedTick_ != kNever) {
+            wakeTimer_.cancel();
+            armedTick_ = kNever;
+        }
+        return;
+    }
+    std::uint64_t next = nextEventTick();
+    if (next == armedTick_) {
+        return; // Already armed for the right tick, leave the pending wait alone.
+    }
+    armedTick_ = next;
+    // expires_at() cancels the pending wait (its handler sees operation_aborted).
+    wakeTimer_.expires_at(epoch_ + std::chrono::milliseconds(next));
+    wakeTimer_.async_wait(tracker_.track([this](const asio::error_code& error) {
+        handleWake(error);
+    }));
+}
 
-    // Start an asynchronous wait operation on the timer.
-    // The provided lambda function will be called when the timer expires or is cancelled.
-    timer->async_wait([this, timerId](const asio::error_code& error) {
-        // Call the internal handleWait method upon completion.
-        // Capture 'this' to call member functions and 'timerId' to know which timer finished.
-        handleWait(error, timerId);
-    });
+void TimerManager::handleWake(const asio::error_code& error) {
+    // Ignore cancelled waits, the timer has been re-armed or the wheel emptied.
+    if (error) {
+        return;
+    }
+    armedTick_ = kNever;
+    advanceTo(nowTick());
+    rearm();
+}
 
-    // Store the new timer and its associated target state name in the map, using the generated ID as the key.
-    // The ActiveTimer struct is created in place using aggregate initialization and std::move for the unique_ptr.
-    activeTimers_[timerId] = ActiveTimer{std::move(timer), targetStateName};
+bool TimerManager::advanceToNextTimer() {
+    if (activeCount_ == 0 || !clock_.isVirtual()) {
+        return false;
+    }
+    // Step over the ticks that only cascade slots, up to the first tick firing a timer.
+    std::uint64_t expired = expiredCount_;
+    while (activeCount_ > 0 && expiredCount_ == expired) {
+        std::uint64_t next = nextEventTick();
+        clock_.advanceTo(epoch_ + std::chrono::milliseconds(next));
+        advanceTo(next);
+    }
+    return true;
+}
 
-    // Return the unique ID assigned to this timer.
-    return timerId;
+void TimerManager::holdWakeups(bool hold) {
+    wakeupsHeld_ = hold;
+    if (!hold) {
+        rearm();
+    }
+}
+
+TimerHandle TimerManager::scheduleTimer(long long delayMs, const std::string& targetStateName, std::uint32_t instance) {
+    // Round the expiry up to the next whole tick so a timer never fires early.
+    auto sinceEpoch = std::chrono::duration_cast<std::chrono::microseconds>(
+        clock_.now() - epoch_).count();
+    std::uint64_t expiry = (static_cast<std::uint64_t>(sinceEpoch) + static_cast<std::uint64_t>(std::max(delayMs, 0LL)) * 1000 + 999) / 1000;
+
+    std::uint32_t index = allocateNode();
+    TimerNode& node = nodes_[index];
+    node.expiryTick = std::max(expiry, currentTick_ + 1);
+    node.targetStateName.assign(targetStateName); // Reuses the node's existing capacity.
+    node.instance = instance;
+    linkNode(index);
+    ++activeCount_;
+
+    // Only touch the Asio timer if this timer is due before the currently armed tick.
+    if (armedTick_ == kNever || nextEventTick() < armedTick_) {
+        rearm();
+    }
+    return (static_cast<TimerHandle>(node.generation) << 32) | index;
+}
+
+bool TimerManager::cancelTimer(TimerHandle handle) {
+    std::uint32_t index = static_cast<std::uint32_t>(handle & 0xFFFFFFFFu);
+    std::uint32_t generation = static_cast<std::uint32_t>(handle >> 32);
+    if (index >= nodes_.size()) {
+        return false;
+    }
+    TimerNode& node = nodes_[index];
+    if (node.level < 0 || node.generation != generation) {
+        return false; // Already fired, cancelled, or the node has been reused.
+    }
+    unlinkNode(index);
+    releaseNode(index);
+    --activeCount_;
+    // The armed wait is left in place; if it fires with nothing due it simply re-arms.
+    if (activeCount_ == 0) {
+        rearm();
+    }
+    return true;
 }
 
 void TimerManager::cancelAllTimers() {
-    // Iterate through all key-value pairs in the activeTimers_ map.
-    // Using structured binding [id, active] for convenience (C++17).
-    for (auto& [id, active] : activeTimers_) {
-        // For each active timer, call its cancel() method.
-        // This will cause any pending async_wait operations to complete immediately
-        // with the error code asio::error::operation_aborted.
-        active.timer->cancel();
-    }
-    // After cancelling all timers, clear the map to remove all entries.
-    activeTimers_.clear();
-}
-
-void TimerManager::handleWait(const asio::error_code& error, int timerId) {
-    // Check if the wait completed without error (i.e., the timer expired naturally).
-    // We ignore cases where the error is asio::error::operation_aborted (timer was cancelled).
-    if (!error) {
-        // Find the timer in the map using its ID.
-        auto it = activeTimers_.find(timerId);
-        // Check if the timer was found in the map (it should be, unless cancelled and removed concurrently, which shouldn't happen in this single-threaded context).
-        if (it != activeTimers_.end()) {
-            // Timer found and expired successfully.
-            // Call the registered timeout handler callback, passing the target state name.
-            timeoutHandler_(it->second.targetStateName);
-            // Remove the timer from the map as it is no longer active.
-            activeTimers_.erase(it);
+    if (activeCount_ == 0) {
+        return;
+    }
+    // Walk only the occupied slots and return every node to the pool.
+    for (unsigned level = 0; level < kLevels; ++level) {
+        while (occupied_[level] != 0) {
+            unsigned slot = lowestBit(occupied_[level]);
+            std::uint32_t index = slots_[level][slot];
+            slots_[level][slot] = kNil;
+            occupied_[level] &= ~(std::uint64_t{1} << slot);
+            while (index != kNil) {
+                std::uint32_t next = nodes_[index].next;
+                releaseNode(index);
+                index = next;
+            }
         }
-        // If there was an error (e.g., cancellation), we simply do nothing,
-        // as the timer is either already removed (by cancelAllTimers) or will be removed later.
     }
+    activeCount_ = 0;
+    rearm();
+}
+
+std::size_t TimerManager::activeTimerCount() const {
+    return activeCount_;
+}
+
+long long TimerManager::remainingMs(TimerHandle handle) const {
+    std::uint32_t index = static_cast<std::uint32_t>(handle & 0xFFFFFFFFu);
+    std::uint32_t generation = static_cast<std::uint32_t>(handle >> 32);
+    if (index >= nodes_.size() || nodes_[index].level < 0 || nodes_[index].generation != generation) {
+        return -1; // Fired, cancelled, or the node has been reused.
+    }
+    std::uint64_t now = nowTick();
+    std::uint64_t expiry = nodes_[index].expiryTick;
+    return expiry > now ? static_cast<long long>(expiry - now) : 0;
 }
 
 } // namespace ifa_runtime
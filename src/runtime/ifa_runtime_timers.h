@@ -9,57 +9,167 @@
 #define IFA_RUNTIME_TIMERS_H
 
 #include <asio.hpp>
+#include "ifa_runtime_executor.h"
+#include "ifa_runtime_clock.h"
 #include <string>
 #include <functional>
 #include <chrono>
-#include <map>
-#include <memory>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <limits>
 
 namespace ifa_runtime {
 
 /**
  * @brief Callback function type invoked when a scheduled timer expires.
  * @details The Engine provides its own method matching this signature.
+ * @param instance_id The automaton instance the timer was scheduled for.
  * @param target_state_name The name of the target state associated with the expired timer.
  */
-using TimerTimeoutHandler = std::function<void(const std::string& /* target_state_name */)>;
+using TimerTimeoutHandler = std::function<void(std::uint32_t /* instance_id */, const std::string& /* target_state_name */)>;
 
 /**
- * @brief Manages Asio steady_timers for scheduling delayed transitions.
- * @details Allows scheduling timers with millisecond delays and cancelling all active timers.
- *          Uses an io_context for asynchronous waits and callbacks upon timeout.
+ * @brief Opaque handle identifying one scheduled timer.
+ * @details The low 32 bits hold the index of the timer node in the pool, the high 32 bits
+ *          hold the generation of that node, so a stale handle never cancels a reused node.
+ */
+using TimerHandle = std::uint64_t;
+
+/**
+ * @brief Handle value that never refers to a scheduled timer.
+ */
+constexpr TimerHandle kInvalidTimerHandle = 0;
+
+/**
+ * @brief Manages delayed transitions using a hierarchical timing wheel.
+ * @details All timers share a single Asio steady_timer which is armed for the next tick
+ *          at which the wheel has work to do. The wheel has 4 levels of 64 slots with a
+ *          resolution of 1 ms, covering delays of up to 64^4 ms (~4.6 hours) directly;
+ *          longer delays are parked in the last slot of the top level and re-inserted
+ *          when they cascade. Timer nodes live in a pool and are linked into intrusive
+ *          lists, so scheduling and cancelling a timer are O(1) and do not allocate once
+ *          the pool has grown to the working-set size.
+ *          With a virtual clock the Asio timer is not used: the engine calls
+ *          advanceToNextTimer() whenever it has nothing else to do.
  */
 class TimerManager {
 private:
+    /** @brief Number of bits of the tick consumed by one wheel level. */
+    static constexpr unsigned kSlotBits = 6;
+    /** @brief Number of slots in one wheel level. */
+    static constexpr unsigned kSlotsPerLevel = 1u << kSlotBits;
+    /** @brief Mask selecting a slot index within one level. */
+    static constexpr std::uint64_t kSlotMask = kSlotsPerLevel - 1;
+    /** @brief Number of wheel levels. */
+    static constexpr unsigned kLevels = 4;
+    /** @brief Sentinel index used for "no node" in the intrusive lists. */
+    static constexpr std::uint32_t kNil = std::numeric_limits<std::uint32_t>::max();
+    /** @brief Sentinel tick meaning "nothing scheduled". */
+    static constexpr std::uint64_t kNever = std::numeric_limits<std::uint64_t>::max();
+
     /**
-     * @brief Internal structure representing an active timer.
-     * @details Holds the Asio timer object and the associated target state name.
+     * @brief Internal structure representing one timer in the node pool.
+     * @details A node is either linked into a wheel slot (level >= 0) or into the free list (level < 0).
      */
-    struct ActiveTimer {
+    struct TimerNode {
         /**
-         * @brief Unique pointer to the Asio steady_timer object.
+         * @brief Absolute tick (milliseconds since epoch_) at which the timer expires.
          */
-        std::unique_ptr<asio::steady_timer> timer;
+        std::uint64_t expiryTick = 0;
         /**
          * @brief The name of the state to transition to when this timer expires.
+         * @details Kept when the node is released so its capacity is reused by the next timer.
          */
         std::string targetStateName;
+        /**
+         * @brief The automaton instance the timer belongs to (see Engine::setInstance()).
+         */
+        std::uint32_t instance = 0;
+        /**
+         * @brief Generation counter, incremented every time the node is released.
+         */
+        std::uint32_t generation = 1;
+        /** @brief Previous node in the slot list (or kNil). */
+        std::uint32_t prev = kNil;
+        /** @brief Next node in the slot list or free list (or kNil). */
+        std::uint32_t next = kNil;
+        /** @brief Wheel level the node is linked into, -1 when the node is free. */
+        std::int8_t level = -1;
+        /** @brief Slot index within the level. */
+        std::uint8_t slot = 0;
     };
+
+    /**
+     * @brief Pool of timer nodes, indexed by the low half of a TimerHandle.
+     */
+    std::vector<TimerNode> nodes_;
+
+    /**
+     * @brief Head of the list of free nodes in nodes_.
+     */
+    std::uint32_t freeHead_ = kNil;
+
+    /**
+     * @brief Heads of the per-slot node lists, one array of slots per level.
+     */
+    std::array<std::array<std::uint32_t, kSlotsPerLevel>, kLevels> slots_;
+
+    /**
+     * @brief Per-level bitmap of non-empty slots, used to find the next slot with work without scanning.
+     */
+    std::array<std::uint64_t, kLevels> occupied_{};
+
     /**
-     * @brief Map storing active timers, keyed by a unique timer ID.
-     * @details Allows efficient lookup and cancellation if individual timer cancellation were needed (currently only cancelAllTimers is implemented).
+     * @brief Number of timers currently scheduled.
      */
-    std::map<int, ActiveTimer> activeTimers_;
+    std::size_t activeCount_ = 0;
 
     /**
-     * @brief Counter to generate unique IDs for newly scheduled timers.
+     * @brief The last tick the wheel has been advanced to.
      */
-    int nextTimerId_ = 0;
+    std::uint64_t currentTick_ = 0;
 
     /**
-     * @brief Reference to the Asio io_context used for running asynchronous timer operations.
+     * @brief The clock the ticks are measured on.
      */
-    asio::io_context& io_context_;
+    Clock& clock_;
+
+    /**
+     * @brief Time point corresponding to tick 0.
+     */
+    Clock::TimePoint epoch_;
+
+    /**
+     * @brief Number of timers expired so far.
+     */
+    std::uint64_t expiredCount_ = 0;
+
+    /**
+     * @brief The single Asio timer driving the wheel.
+     */
+    asio::steady_timer wakeTimer_;
+
+    /**
+     * @brief Counts the pending handlers of the engine (see HandlerTracker).
+     */
+    HandlerTracker& tracker_;
+
+    /**
+     * @brief Tick the wakeTimer_ is currently armed for, kNever when it is idle.
+     */
+    std::uint64_t armedTick_ = kNever;
+
+    /**
+     * @brief True while holdWakeups() keeps the wakeTimer_ from being armed.
+     */
+    bool wakeupsHeld_ = false;
+
+    /**
+     * @brief Scratch string swapped with an expiring node's target so the handler can run
+     *        after the node has been released without copying the name.
+     */
+    std::string expiredTarget_;
 
     /**
      * @brief Callback function invoked when any timer managed by this instance expires.
@@ -67,21 +177,79 @@ private:
     TimerTimeoutHandler timeoutHandler_;
 
     /**
-     * @brief Internal handler called by Asio when a timer's async_wait operation completes.
-     * @details Checks for errors, finds the corresponding timer, invokes the timeoutHandler_,
-     *          and removes the timer from the active map if it expired successfully.
+     * @brief Returns the current tick derived from the clock.
+     */
+    std::uint64_t nowTick() const;
+
+    /**
+     * @brief Takes a node from the free list, growing the pool if necessary.
+     * @return std::uint32_t Index of the node.
+     */
+    std::uint32_t allocateNode();
+
+    /**
+     * @brief Returns a node to the free list and invalidates all handles pointing to it.
+     * @param index Index of the (already unlinked) node.
+     */
+    void releaseNode(std::uint32_t index);
+
+    /**
+     * @brief Links a node into the wheel slot matching its expiry relative to currentTick_.
+     * @param index Index of the node to link.
+     */
+    void linkNode(std::uint32_t index);
+
+    /**
+     * @brief Removes a node from the wheel slot it is linked into.
+     * @param index Index of the node to unlink.
+     */
+    void unlinkNode(std::uint32_t index);
+
+    /**
+     * @brief Computes the next tick after currentTick_ at which a slot has to be cascaded or expired.
+     * @return std::uint64_t The tick, or kNever if no timers are scheduled.
+     */
+    std::uint64_t nextEventTick() const;
+
+    /**
+     * @brief Advances the wheel up to the given tick, cascading slots and firing expired timers.
+     * @param targetTick The tick to advance to.
+     */
+    void advanceTo(std::uint64_t targetTick);
+
+    /**
+     * @brief Re-inserts all nodes of a higher-level slot into the lower levels.
+     * @param level The level of the slot (>= 1).
+     * @param slot The slot index within the level.
+     */
+    void cascadeSlot(unsigned level, unsigned slot);
+
+    /**
+     * @brief Fires all timers in the given level-0 slot.
+     * @param slot The slot index within level 0.
+     */
+    void expireSlot(unsigned slot);
+
+    /**
+     * @brief Arms the wakeTimer_ for the next tick with work, or cancels it when the wheel is empty.
+     */
+    void rearm();
+
+    /**
+     * @brief Internal handler called by Asio when the wakeTimer_'s async_wait operation completes.
      * @param error The error code from the async_wait operation.
-     * @param timerId The unique ID of the timer that completed its wait.
      */
-    void handleWait(const asio::error_code& error, int timerId);
+    void handleWake(const asio::error_code& error);
 
 public:
     /**
      * @brief Constructs the TimerManager.
-     * @param io_ctx Reference to the Asio io_context.
+     * @param executor Executor the expirations are handled on (the engine's io_context or strand).
+     * @param tracker Counts the pending handlers of the engine.
+     * @param clock The clock of the engine; must outlive the manager.
      * @param handler The callback function to be called when a timer expires.
      */
-    TimerManager(asio::io_context& io_ctx, TimerTimeoutHandler handler);
+    TimerManager(const EngineExecutor& executor, HandlerTracker& tracker, Clock& clock, TimerTimeoutHandler handler);
 
     /**
      * @brief Destructor. Cancels all active timers upon destruction.
@@ -90,20 +258,66 @@ public:
 
     /**
      * @brief Schedules a new timer to expire after a specified delay.
-     * @details Creates an asio::steady_timer, sets its expiry time, and starts an asynchronous wait.
-     *          Stores the timer in the activeTimers_ map.
+     * @details Links a pooled node into the wheel and re-arms the underlying Asio timer
+     *          only if the new timer expires before the currently armed tick.
      * @param delayMs The delay in milliseconds until the timer expires.
      * @param targetStateName The name of the state associated with this timer's expiration.
-     * @return int The unique ID assigned to the scheduled timer.
+     * @param instance The automaton instance passed to the timeout handler.
+     * @return TimerHandle Handle that can be passed to cancelTimer().
+     */
+    TimerHandle scheduleTimer(long long delayMs, const std::string& targetStateName, std::uint32_t instance = 0);
+
+    /**
+     * @brief Cancels a single timer.
+     * @param handle Handle returned by scheduleTimer().
+     * @return bool True if the timer was still pending and has been cancelled, false otherwise.
      */
-    int scheduleTimer(long long delayMs, const std::string& targetStateName);
+    bool cancelTimer(TimerHandle handle);
 
     /**
      * @brief Cancels all currently active timers managed by this instance.
-     * @details Iterates through the activeTimers_ map and cancels each Asio timer. Clears the map afterwards.
+     * @details Returns immediately when no timers are scheduled, which is the common case
+     *          on transitions between states without delayed transitions.
      */
     void cancelAllTimers();
+
+    /**
+     * @brief Advances a virtual clock to the next expiry and fires the timers due at it.
+     * @details Called by the engine when no handler is ready. The expiry handlers run before
+     *          the call returns.
+     * @return bool True if the clock has been advanced, false if no timer is scheduled or the
+     *         clock follows real time.
+     */
+    bool advanceToNextTimer();
+
+    /**
+     * @brief Keeps expirations from being handled, or lets them be handled again.
+     * @details While held, timers are scheduled and cancelled as usual but the underlying Asio
+     *          timer is not armed, so no expiry handler is queued on the executor. Releasing
+     *          arms it for the next tick with work; timers that became due meanwhile fire at once.
+     * @param hold True to hold the wakeups, false to release them.
+     */
+    void holdWakeups(bool hold);
+
+    /**
+     * @brief Gets the number of timers currently scheduled.
+     * @return std::size_t Number of pending timers.
+     */
+    std::size_t activeTimerCount() const;
+
+    /**
+     * @brief Gets the time left until a timer expires.
+     * @param handle Handle returned by scheduleTimer().
+     * @return long long Milliseconds until the expiry tick (0 if it is due), -1 if the timer is not pending.
+     */
+    long long remainingMs(TimerHandle handle) const;
+
+    /**
+     * @brief Gets the time of tick 0, from which the expiries are counted.
+     * @return Clock::TimePoint The construction time of the manager.
+     */
+    Clock::TimePoint epoch() const { return epoch_; }
 };
 
 } // namespace ifa_runtime
-#endif // IFA_RUNTIME_TIMERS_H
\ No newline at end of file
+#endif // IFA_RUNTIME_TIMERS_H
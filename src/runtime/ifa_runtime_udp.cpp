@@ -6,16 +6,46 @@
  */
 
 #include "ifa_runtime_udp.h"
+#include "ifa_runtime_protocol.h"
 #include <iostream>
 #include <utility>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
 
 namespace ifa_runtime {
 
-UdpCommunicator::UdpCommunicator(asio::io_context& io_ctx, UdpReceiveHandler receiver, UdpErrorHandler error_handler)
-    : io_context_(io_ctx),
-      socket_(io_ctx),
+UdpCommunicator::UdpCommunicator(const EngineExecutor& executor, HandlerTracker& tracker, UdpReceiveHandler receiver,
+                                 UdpErrorHandler error_handler, const UdpReceiveConfig& receive_config)
+    : executor_(executor),
+      tracker_(tracker),
+      socket_(executor),
+      sendBuffer_(kSendBufferSize),
+      sendQueue_(kSendQueueCapacity),
+      receiveConfig_(receive_config),
       receiveHandler_(std::move(receiver)),
-      errorHandler_(std::move(error_handler)) {}
+      errorHandler_(std::move(error_handler)) {
+    // Keep the receive settings within sane bounds
+    receiveConfig_.maxDatagramSize = std::clamp<std::size_t>(receiveConfig_.maxDatagramSize, 1, kMaxDatagramSize);
+    receiveConfig_.batchSize = std::clamp<std::size_t>(receiveConfig_.batchSize, 1, 1024);
+
+    // One slot per batch entry, one byte longer than the limit to detect over-long datagrams
+    std::size_t slotSize = receiveConfig_.maxDatagramSize + 1;
+    recvStorage_.resize(slotSize * receiveConfig_.batchSize);
+#if defined(__linux__)
+    // The headers point into recvStorage_ and recvControl_, which are never resized afterwards
+    recvHeaders_.resize(receiveConfig_.batchSize);
+    recvIovecs_.resize(receiveConfig_.batchSize);
+    recvControl_.resize(CMSG_SPACE(sizeof(std::uint32_t)) * receiveConfig_.batchSize);
+    for (std::size_t i = 0; i < receiveConfig_.batchSize; ++i) {
+        recvIovecs_[i].iov_base = recvStorage_.data() + i * slotSize;
+        recvIovecs_[i].iov_len = slotSize;
+        std::memset(&recvHeaders_[i], 0, sizeof(mmsghdr));
+        recvHeaders_[i].msg_hdr.msg_iov = &recvIovecs_[i];
+        recvHeaders_[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+}
 
 UdpCommunicator::~UdpCommunicator() {
     shutdown();
@@ -24,13 +54,22 @@ UdpCommunicator::~UdpCommunicator() {
 bool UdpCommunicator::initialize(int listen_port, const std::string& dest_host, int dest_port) {
     try {
         // Create a resolver to convert host/port strings to an endpoint
-        asio::ip::udp::resolver resolver(io_context_);
+        asio::ip::udp::resolver resolver(executor_);
         // Resolve the destination endpoint (take the first result)
         destinationEndpoint_ = *resolver.resolve(asio::ip::udp::v4(), dest_host, std::to_string(dest_port)).begin();
         // Open the socket using IPv4
         socket_.open(asio::ip::udp::v4());
         // Bind the socket to the specified local port and any IPv4 address
         socket_.bind(asio::ip::udp::endpoint(asio::ip::udp::v4(), listen_port));
+        // Enlarge the kernel receive buffer if requested, so input bursts are not dropped
+        if (receiveConfig_.socketReceiveBufferSize > 0) {
+            socket_.set_option(asio::socket_base::receive_buffer_size(receiveConfig_.socketReceiveBufferSize));
+        }
+#if defined(__linux__) && defined(SO_RXQ_OVFL)
+        // Ask the kernel to report how many datagrams it dropped for this socket (best effort)
+        int enable = 1;
+        ::setsockopt(socket_.native_handle(), SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable));
+#endif
         // Mark as initialized
         initialized_ = true;
         return true;
@@ -42,6 +81,15 @@ bool UdpCommunicator::initialize(int listen_port, const std::string& dest_host,
 
 void UdpCommunicator::shutdown() {
     if (initialized_) {
+        // Flush whatever is still queued (e.g. the TERMINATING message) before closing;
+        // anything the socket does not accept without blocking is dropped.
+        drainSendQueue(false);
+        if (sendQueueCount_ > 0) {
+            sendStats_.drops += sendQueueCount_;
+            while (sendQueueCount_ > 0) {
+                popSentMessage();
+            }
+        }
         asio::error_code ec; // Ignored error code for close
         socket_.close(ec);
         initialized_ = false; // Mark as no longer initialized
@@ -49,62 +97,291 @@ void UdpCommunicator::shutdown() {
 }
 
 void UdpCommunicator::sendMessage(const std::string& message) {
-    // Initiate an asynchronous send operation
-    socket_.async_send_to(
-        asio::buffer(message), destinationEndpoint_,
-        // Lambda function as completion handler
-        [this](const asio::error_code& error, std::size_t bytes_transferred) {
-            handleSend(error, bytes_transferred);
-        });
+    std::size_t length = message.size();
+    std::size_t offset = 0;
+    // Drop the message if it can never be sent or there is no room to queue it
+    if (length > kMaxDatagramSize || sendQueueCount_ == kSendQueueCapacity || !reserveSendSpace(length, offset)) {
+        ++sendStats_.drops;
+        return;
+    }
+    // Copy the payload into the owned buffer, the caller's string may go away right after this call
+    std::memcpy(sendBuffer_.data() + offset, message.data(), length);
+    QueuedMessage& entry = sendQueue_[(sendQueueHead_ + sendQueueCount_) % kSendQueueCapacity];
+    entry.offset = offset;
+    entry.length = length;
+    ++sendQueueCount_;
+    sendStats_.maxQueueDepth = std::max(sendStats_.maxQueueDepth, sendQueueCount_);
+
+    // Messages queued within one handler are sent together by a single posted drain step
+    scheduleDrain();
+}
+
+void UdpCommunicator::holdSending(bool hold) {
+    sendingHeld_ = hold;
+    if (!hold && sendQueueCount_ > 0) {
+        scheduleDrain();
+    }
+}
+
+void UdpCommunicator::scheduleDrain() {
+    if (drainPending_ || sendingHeld_) {
+        return;
+    }
+    drainPending_ = true;
+    asio::post(executor_, tracker_.track([this]() {
+        drainPending_ = false;
+        drainSendQueue();
+    }));
+}
+
+UdpSendStats UdpCommunicator::getSendStats() const {
+    UdpSendStats stats = sendStats_;
+    stats.queueDepth = sendQueueCount_;
+    return stats;
+}
+
+bool UdpCommunicator::reserveSendSpace(std::size_t length, std::size_t& offset) {
+    if (sendQueueCount_ == 0) {
+        // Empty queue: start over at the beginning of the buffer
+        sendBufferHead_ = 0;
+        sendBufferTail_ = 0;
+    }
+    if (sendQueueCount_ == 0 || sendBufferTail_ > sendBufferHead_) {
+        // Free space is [tail, end) followed by [0, head)
+        if (length <= kSendBufferSize - sendBufferTail_) {
+            offset = sendBufferTail_;
+        } else if (length <= sendBufferHead_) {
+            offset = 0; // Wrap; the unused tail is reclaimed when the head passes it
+        } else {
+            return false;
+        }
+    } else {
+        // Already wrapped: free space is [tail, head)
+        if (length > sendBufferHead_ - sendBufferTail_) {
+            return false;
+        }
+        offset = sendBufferTail_;
+    }
+    sendBufferTail_ = offset + length;
+    return true;
+}
+
+void UdpCommunicator::popSentMessage() {
+    const QueuedMessage& entry = sendQueue_[sendQueueHead_];
+    sendBufferHead_ = entry.offset + entry.length;
+    sendQueueHead_ = (sendQueueHead_ + 1) % kSendQueueCapacity;
+    --sendQueueCount_;
+}
+
+std::size_t UdpCommunicator::sendBatch(asio::error_code& error) {
+    std::size_t count = std::min(sendQueueCount_, kMaxSendBatch);
+#if defined(__linux__)
+    // Hand the whole batch to the kernel with one sendmmsg call
+    for (std::size_t i = 0; i < count; ++i) {
+        const QueuedMessage& entry = sendQueue_[(sendQueueHead_ + i) % kSendQueueCapacity];
+        sendIovecs_[i].iov_base = sendBuffer_.data() + entry.offset;
+        sendIovecs_[i].iov_len = entry.length;
+        msghdr& header = sendHeaders_[i].msg_hdr;
+        header.msg_name = destinationEndpoint_.data();
+        header.msg_namelen = static_cast<socklen_t>(destinationEndpoint_.size());
+        header.msg_iov = &sendIovecs_[i];
+        header.msg_iovlen = 1;
+        header.msg_control = nullptr;
+        header.msg_controllen = 0;
+        header.msg_flags = 0;
+    }
+    ++sendStats_.sendCalls;
+    int sent = ::sendmmsg(socket_.native_handle(), sendHeaders_.data(), static_cast<unsigned int>(count), MSG_DONTWAIT);
+    if (sent < 0) {
+        error = asio::error_code(errno, asio::error::get_system_category());
+        return 0;
+    }
+    for (int i = 0; i < sent; ++i) {
+        sendStats_.bytesSent += sendIovecs_[i].iov_len;
+    }
+    return static_cast<std::size_t>(sent);
+#else
+    // Portable fallback: one non-blocking send_to per message
+    socket_.non_blocking(true, error);
+    std::size_t sent = 0;
+    while (!error && sent < count) {
+        const QueuedMessage& entry = sendQueue_[(sendQueueHead_ + sent) % kSendQueueCapacity];
+        ++sendStats_.sendCalls;
+        socket_.send_to(asio::buffer(sendBuffer_.data() + entry.offset, entry.length), destinationEndpoint_, 0, error);
+        if (!error) {
+            sendStats_.bytesSent += entry.length;
+            ++sent;
+        }
+    }
+    return sent;
+#endif
+}
+
+void UdpCommunicator::drainSendQueue(bool allowWait) {
+    while (initialized_ && sendQueueCount_ > 0) {
+        asio::error_code error;
+        std::size_t sent = sendBatch(error);
+        for (std::size_t i = 0; i < sent; ++i) {
+            popSentMessage();
+        }
+        sendStats_.messagesSent += sent;
+
+        if (!error) {
+            lastSendFailed_ = false;
+            continue;
+        }
+        if (error == asio::error::would_block || error == asio::error::try_again) {
+            if (sent > 0) {
+                continue; // Partial batch accepted, retry the rest
+            }
+            if (allowWait && !drainPending_) {
+                // Socket send buffer is full: resume once it becomes writable
+                drainPending_ = true;
+                socket_.async_wait(asio::ip::udp::socket::wait_write, tracker_.track([this](const asio::error_code& waitError) {
+                    drainPending_ = false;
+                    if (!waitError) {
+                        drainSendQueue();
+                    }
+                }));
+            }
+            return;
+        }
+        if (sent == 0) {
+            // The first message of the batch failed, drop it so the rest can go out
+            popSentMessage();
+            ++sendStats_.drops;
+        }
+        // Report only the first of consecutive failures; the report itself is queued as a
+        // message and would otherwise keep failing and reporting forever
+        if (!lastSendFailed_) {
+            lastSendFailed_ = true;
+            errorHandler_("Send error: " + error.message());
+        }
+    }
+}
+
+void UdpCommunicator::setBinaryHandler(UdpBinaryHandler handler) {
+    binaryHandler_ = std::move(handler);
+}
+
+UdpReceiveStats UdpCommunicator::getReceiveStats() const {
+    return receiveStats_;
 }
 
 void UdpCommunicator::startReceive() {
-    // Initiate an asynchronous receive operation
-    socket_.async_receive_from(
-        asio::buffer(recvBuffer_), senderEndpoint_,
+    // Wait until at least one datagram is available; the data is read in batches by handleReceive
+    socket_.async_wait(asio::ip::udp::socket::wait_read,
         // Lambda function as completion handler
-        [this](const asio::error_code& error, std::size_t bytes_transferred) {
-            // Call handleReceive when the operation completes
-            handleReceive(error, bytes_transferred);
-        });
-}
-
-void UdpCommunicator::handleReceive(const asio::error_code& error, std::size_t bytes_transferred) {
-    if (!error && bytes_transferred > 0) {
-        // If no error and data was received, parse it
-        parseAndDelegate(recvBuffer_.data(), bytes_transferred);
-    } else if (error) {
-        // If an error occurred (and it wasn't just cancellation), report it
+        tracker_.track([this](const asio::error_code& error) {
+            handleReceive(error);
+        }));
+}
+
+void UdpCommunicator::handleReceive(const asio::error_code& error) {
+    // The wait is cancelled when the socket is closed, stop the receive loop then
+    if (error == asio::error::operation_aborted || !initialized_) {
+        return;
+    }
+    if (error) {
+        // If the wait itself failed, report it
         errorHandler_("Receive error: " + error.message());
+    } else {
+        asio::error_code readError;
+        receiveBatch(readError);
+        if (readError && readError != asio::error::would_block && readError != asio::error::try_again) {
+            errorHandler_("Receive error: " + readError.message());
+        }
+    }
+    // A handler may have shut the communicator down in the meantime
+    if (initialized_) {
+        startReceive();
     }
-    startReceive();
 }
 
-void UdpCommunicator::handleSend(const asio::error_code& error, std::size_t /*bytes_transferred*/) {
-    if (error) {
-        // If an error occurred during sending, report it
-        errorHandler_("Send error: " + error.message());
+void UdpCommunicator::receiveBatch(asio::error_code& error) {
+    std::size_t slotSize = receiveConfig_.maxDatagramSize + 1;
+#if defined(__linux__)
+    // The kernel overwrites msg_controllen, so reset the control buffers before every call
+    std::size_t controlSize = CMSG_SPACE(sizeof(std::uint32_t));
+    for (std::size_t i = 0; i < receiveConfig_.batchSize; ++i) {
+        msghdr& header = recvHeaders_[i].msg_hdr;
+        header.msg_control = recvControl_.data() + i * controlSize;
+        header.msg_controllen = controlSize;
+        header.msg_flags = 0;
+    }
+    ++receiveStats_.receiveCalls;
+    int count = ::recvmmsg(socket_.native_handle(), recvHeaders_.data(),
+                           static_cast<unsigned int>(receiveConfig_.batchSize), MSG_DONTWAIT, nullptr);
+    if (count < 0) {
+        error = asio::error_code(errno, asio::error::get_system_category());
+        return;
+    }
+    for (int i = 0; i < count && initialized_; ++i) {
+        msghdr& header = recvHeaders_[i].msg_hdr;
+#if defined(SO_RXQ_OVFL)
+        // The drop counter is cumulative, keep the latest value reported
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr; cmsg = CMSG_NXTHDR(&header, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+                std::uint32_t dropped = 0;
+                std::memcpy(&dropped, CMSG_DATA(cmsg), sizeof(dropped));
+                receiveStats_.kernelDrops = dropped;
+            }
+        }
+#endif
+        std::size_t length = recvHeaders_[i].msg_len;
+        bool truncated = (header.msg_flags & MSG_TRUNC) != 0 || length > receiveConfig_.maxDatagramSize;
+        deliverDatagram(recvStorage_.data() + i * slotSize, length, truncated);
+    }
+#else
+    // Portable fallback: non-blocking receive_from calls until the socket is empty or the batch is full
+    socket_.non_blocking(true, error);
+    for (std::size_t i = 0; !error && i < receiveConfig_.batchSize && initialized_; ++i) {
+        char* slot = recvStorage_.data() + i * slotSize;
+        ++receiveStats_.receiveCalls;
+        std::size_t length = socket_.receive_from(asio::buffer(slot, slotSize), senderEndpoint_, 0, error);
+        if (error == asio::error::message_size) {
+            error.clear();
+            deliverDatagram(slot, slotSize, true);
+        } else if (!error) {
+            deliverDatagram(slot, length, length > receiveConfig_.maxDatagramSize);
+        }
+    }
+#endif
+}
+
+void UdpCommunicator::deliverDatagram(const char* data, std::size_t length, bool truncated) {
+    ++receiveStats_.datagramsReceived;
+    receiveStats_.bytesReceived += length;
+    if (truncated) {
+        // A cut-off message could be misread (e.g. a shortened value), discard it
+        ++receiveStats_.truncated;
+        return;
+    }
+    if (binaryHandler_ && protocol::isBinaryDatagram(data, length)) {
+        binaryHandler_(data, length);
+    } else if (length > 0) {
+        parseAndDelegate(data, length);
     }
 }
 
 void UdpCommunicator::parseAndDelegate(const char* data, std::size_t length) {
-    // Convert raw data to a string
-    std::string msg(data, length);
+    // View the raw data in place, no copy
+    std::string_view msg(data, length);
 
     // Find the positions of the delimiters
     auto first = msg.find('|');
     auto second = msg.find('|', first + 1);
 
     // Check if both delimiters were found
-    if (first == std::string::npos || second == std::string::npos) {
-        errorHandler_("Malformed message: " + msg);
+    if (first == std::string_view::npos || second == std::string_view::npos) {
+        errorHandler_("Malformed message: " + std::string(msg));
         return;
     }
 
     // Extract the parts based on delimiter positions
-    std::string type = msg.substr(0, first);
-    std::string name = msg.substr(first + 1, second - first - 1);
-    std::string value = msg.substr(second + 1);
+    std::string_view type = msg.substr(0, first);
+    std::string_view name = msg.substr(first + 1, second - first - 1);
+    std::string_view value = msg.substr(second + 1);
 
     // Call the registered receive handler with the parsed parts
     receiveHandler_(type, name, value);
@@ -9,27 +9,91 @@
 #define IFA_RUNTIME_UDP_H
 
 #include <asio.hpp>
+#include "ifa_runtime_executor.h"
 #include <string>
+#include <string_view>
 #include <functional>
 #include <memory>
+#include <vector>
+#include <array>
+#include <cstdint>
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 namespace ifa_runtime {
 
 /**
  * @brief Callback function type for handling received UDP messages.
  * @details The Engine provides its own method matching this signature.
- *          It receives the parsed components of the message.
+ *          It receives the parsed components of the message as views into the receive
+ *          buffer; they are only valid for the duration of the call.
  * @param type The type of the message (e.g., "INPUT", "CMD").
  * @param name The name associated with the message (e.g., input name, command name).
  * @param value The value associated with the message.
  */
-using UdpReceiveHandler = std::function<void(const std::string& /* type */, const std::string& /* name */, const std::string& /* value */ )>;
+using UdpReceiveHandler = std::function<void(std::string_view /* type */, std::string_view /* name */, std::string_view /* value */ )>;
 /**
  * @brief Callback function type for handling UDP communication errors.
  * @details The Engine provides its own method matching this signature.
  * @param errorMessage A string describing the error that occurred.
  */
 using UdpErrorHandler = std::function<void(const std::string& /* error message */)>;
+/**
+ * @brief Callback function type for handling datagrams of the binary protocol.
+ * @details Datagrams starting with the binary magic (see ifa_runtime_protocol.h) are passed
+ *          unparsed; the data is only valid for the duration of the call.
+ * @param data Pointer to the datagram.
+ * @param length Length of the datagram in bytes.
+ */
+using UdpBinaryHandler = std::function<void(const char* /* data */, std::size_t /* length */)>;
+
+/**
+ * @brief Counters describing the outbound queue of a UdpCommunicator.
+ */
+struct UdpSendStats {
+    /** @brief Number of messages currently waiting in the queue. */
+    std::size_t queueDepth = 0;
+    /** @brief Highest queue depth observed since construction. */
+    std::size_t maxQueueDepth = 0;
+    /** @brief Number of datagrams handed to the kernel. */
+    std::uint64_t messagesSent = 0;
+    /** @brief Number of payload bytes handed to the kernel. */
+    std::uint64_t bytesSent = 0;
+    /** @brief Number of send system calls issued (one call sends a whole batch). */
+    std::uint64_t sendCalls = 0;
+    /** @brief Number of messages dropped (queue or buffer full, oversized, or failed to send). */
+    std::uint64_t drops = 0;
+};
+
+/**
+ * @brief Receive-side settings of a UdpCommunicator.
+ */
+struct UdpReceiveConfig {
+    /** @brief Largest datagram accepted; longer datagrams are counted as truncated and discarded. */
+    std::size_t maxDatagramSize = 2048;
+    /** @brief Maximum number of datagrams read per socket wakeup (recvmmsg batch size). */
+    std::size_t batchSize = 32;
+    /** @brief Requested kernel receive buffer size (SO_RCVBUF) in bytes, 0 keeps the system default. */
+    int socketReceiveBufferSize = 0;
+};
+
+/**
+ * @brief Counters describing the inbound side of a UdpCommunicator.
+ */
+struct UdpReceiveStats {
+    /** @brief Number of datagrams read from the socket, including discarded ones. */
+    std::uint64_t datagramsReceived = 0;
+    /** @brief Number of payload bytes read from the socket. */
+    std::uint64_t bytesReceived = 0;
+    /** @brief Number of receive system calls issued (one call reads a whole batch). */
+    std::uint64_t receiveCalls = 0;
+    /** @brief Number of datagrams discarded because they exceeded maxDatagramSize. */
+    std::uint64_t truncated = 0;
+    /** @brief Number of datagrams the kernel dropped because the socket buffer was full (Linux only). */
+    std::uint64_t kernelDrops = 0;
+};
 
 /**
  * @brief Manages UDP socket operations for sending and receiving messages asynchronously.
@@ -41,11 +105,14 @@ class UdpCommunicator {
 public:
     /**
      * @brief Constructs the UdpCommunicator.
-     * @param io_ctx Reference to the Asio io_context for asynchronous operations.
+     * @param executor Executor the completion handlers run on (the engine's io_context or strand).
+     * @param tracker Counts the pending handlers of the engine.
      * @param receiver The callback function to invoke when a message is successfully received and parsed.
      * @param error_handler The callback function to invoke when a communication error occurs.
+     * @param receive_config Receive buffer and batching settings.
      */
-    UdpCommunicator(asio::io_context& io_ctx, UdpReceiveHandler receiver, UdpErrorHandler error_handler);
+    UdpCommunicator(const EngineExecutor& executor, HandlerTracker& tracker, UdpReceiveHandler receiver, UdpErrorHandler error_handler,
+                    const UdpReceiveConfig& receive_config = UdpReceiveConfig{});
     /**
      * @brief Destructor. Cleans up resources by calling shutdown().
      */
@@ -67,24 +134,62 @@ public:
     void shutdown();
 
     /**
-     * @brief Sends a message asynchronously to the configured destination.
-     * @details The message format is determined by the caller (Engine).
+     * @brief Queues a message for sending to the configured destination.
+     * @details The message is copied into the communicator's pre-allocated send buffer, so the caller's
+     *          string does not need to outlive the call. Queued messages are sent in order by a drain
+     *          step posted to the executor, which hands up to kMaxSendBatch datagrams to the kernel
+     *          per system call (sendmmsg on Linux). If the queue or the buffer is full the message is
+     *          dropped and counted in the statistics.
      * @param message The string message to send.
      */
     void sendMessage(const std::string& message);
 
     /**
-     * @brief Starts an asynchronous operation to receive the next UDP datagram.
+     * @brief Keeps queued messages from being sent, or lets them be sent again.
+     * @details While held, sendMessage() only queues (no drain step is posted to the executor).
+     *          Releasing posts the drain step for the messages queued meanwhile.
+     * @param hold True to hold the sending, false to release it.
+     */
+    void holdSending(bool hold);
+
+    /**
+     * @brief Gets a snapshot of the send queue counters.
+     * @return UdpSendStats The current counters.
+     */
+    UdpSendStats getSendStats() const;
+
+    /**
+     * @brief Sets the handler for binary protocol datagrams.
+     * @details Without a handler, binary datagrams are treated like text and rejected as malformed.
+     * @param handler The callback receiving raw binary datagrams.
+     */
+    void setBinaryHandler(UdpBinaryHandler handler);
+
+    /**
+     * @brief Gets a snapshot of the receive counters.
+     * @return UdpReceiveStats The current counters.
+     */
+    UdpReceiveStats getReceiveStats() const;
+
+    /**
+     * @brief Starts waiting asynchronously for the socket to become readable.
      * @details This should be called once initially (e.g., by Engine::initialize)
-     *          to begin listening. The receive loop continues automatically.
+     *          to begin listening. On every wakeup up to UdpReceiveConfig::batchSize
+     *          datagrams are read (with one recvmmsg call on Linux) and dispatched,
+     *          then the wait is re-armed automatically.
      */
     void startReceive();
 
 private:
     /**
-     * @brief Reference to the Asio io_context managing asynchronous operations.
+     * @brief Executor the completion handlers run on.
      */
-    asio::io_context& io_context_;
+    EngineExecutor executor_;
+
+    /**
+     * @brief Counts the pending handlers of the engine (see HandlerTracker).
+     */
+    HandlerTracker& tracker_;
 
     /**
      * @brief The UDP socket used for communication.
@@ -102,9 +207,101 @@ private:
     asio::ip::udp::endpoint senderEndpoint_;
 
     /**
-     * @brief Buffer used for receiving incoming data.
+     * @brief Size in bytes of the pre-allocated send buffer.
      */
-    std::array<char, 1024> recvBuffer_;
+    static constexpr std::size_t kSendBufferSize = 256 * 1024;
+
+    /**
+     * @brief Maximum number of messages waiting in the send queue.
+     */
+    static constexpr std::size_t kSendQueueCapacity = 1024;
+
+    /**
+     * @brief Maximum number of datagrams handed to the kernel in one system call.
+     */
+    static constexpr std::size_t kMaxSendBatch = 64;
+
+    /**
+     * @brief Largest payload that fits into a single UDP datagram over IPv4.
+     */
+    static constexpr std::size_t kMaxDatagramSize = 65507;
+
+    /**
+     * @brief A queued message: a contiguous region of sendBuffer_.
+     */
+    struct QueuedMessage {
+        /** @brief Offset of the message in sendBuffer_. */
+        std::size_t offset = 0;
+        /** @brief Length of the message in bytes. */
+        std::size_t length = 0;
+    };
+
+    /**
+     * @brief Ring buffer owning the payloads of all queued messages.
+     * @details Messages are allocated and released in FIFO order; a message that does not fit
+     *          at the end of the buffer wraps to the start and the unused tail is reclaimed
+     *          once the messages before it have been sent.
+     */
+    std::vector<char> sendBuffer_;
+
+    /** @brief Offset of the oldest queued byte in sendBuffer_. */
+    std::size_t sendBufferHead_ = 0;
+
+    /** @brief Offset at which the next message is written into sendBuffer_. */
+    std::size_t sendBufferTail_ = 0;
+
+    /**
+     * @brief Ring of queued message descriptors.
+     */
+    std::vector<QueuedMessage> sendQueue_;
+
+    /** @brief Index of the oldest entry in sendQueue_. */
+    std::size_t sendQueueHead_ = 0;
+
+    /** @brief Number of entries in sendQueue_. */
+    std::size_t sendQueueCount_ = 0;
+
+    /** @brief True while a drain step is posted or waiting for the socket to become writable. */
+    bool drainPending_ = false;
+
+    /** @brief True while holdSending() keeps the drain step from being posted. */
+    bool sendingHeld_ = false;
+
+    /** @brief True if the last send attempt failed; repeated failures are reported only once. */
+    bool lastSendFailed_ = false;
+
+    /** @brief Send queue counters. */
+    UdpSendStats sendStats_;
+
+#if defined(__linux__)
+    /** @brief Message headers passed to sendmmsg, reused for every batch. */
+    std::array<mmsghdr, kMaxSendBatch> sendHeaders_{};
+    /** @brief I/O vectors referenced by sendHeaders_. */
+    std::array<iovec, kMaxSendBatch> sendIovecs_{};
+#endif
+
+    /**
+     * @brief Receive settings, normalised in the constructor.
+     */
+    UdpReceiveConfig receiveConfig_;
+
+    /**
+     * @brief Storage for one batch of received datagrams, batchSize slots of maxDatagramSize + 1 bytes.
+     * @details The extra byte lets an over-long datagram be detected without relying on MSG_TRUNC.
+     */
+    std::vector<char> recvStorage_;
+
+    /** @brief Receive counters. */
+    UdpReceiveStats receiveStats_;
+
+#if defined(__linux__)
+    /** @brief Message headers passed to recvmmsg, one per batch slot. */
+    std::vector<mmsghdr> recvHeaders_;
+    /** @brief I/O vectors referenced by recvHeaders_. */
+    std::vector<iovec> recvIovecs_;
+    /** @brief Ancillary data buffers (SO_RXQ_OVFL drop counter), one per batch slot. */
+    std::vector<char> recvControl_;
+#endif
 
     /**
      * @brief Callback function invoked when a message is received.
@@ -115,6 +312,11 @@ private:
      * @brief Callback function invoked on communication errors.
      */
     UdpErrorHandler errorHandler_;
+
+    /**
+     * @brief Callback function invoked with binary protocol datagrams.
+     */
+    UdpBinaryHandler binaryHandler_;
     
     /**
      * @brief Flag indicating whether the communicator has been successfully initialized.
@@ -122,23 +324,65 @@ private:
     bool initialized_ = false;
 
     /**
-     * @brief Internal handler called by Asio when an async_receive_from operation completes.
-     * @param error The error code associated with the operation.
-     * @param bytes_transferred The number of bytes received.
+     * @brief Internal handler called by Asio when the socket becomes readable.
+     * @details Reads one batch of datagrams, dispatches them and re-arms the wait.
+     * @param error The error code associated with the wait operation.
+     */
+    void handleReceive(const asio::error_code& error);
+
+    /**
+     * @brief Reads up to batchSize datagrams without blocking and dispatches them.
+     * @param error Receives the error of the read, if any (would_block when the socket is empty).
      */
-    void handleReceive(const asio::error_code& error, std::size_t bytes_transferred);
+    void receiveBatch(asio::error_code& error);
+
+    /**
+     * @brief Counts a received datagram and dispatches it unless it was truncated.
+     * @details Binary protocol datagrams go to binaryHandler_, everything else to parseAndDelegate().
+     * @param data Pointer to the datagram.
+     * @param length Number of bytes stored at data.
+     * @param truncated True if the datagram did not fit into its slot.
+     */
+    void deliverDatagram(const char* data, std::size_t length, bool truncated);
     
     /**
-     * @brief Internal handler called by Asio when an async_send_to operation completes.
-     * @param error The error code associated with the operation.
-     * @param bytes_transferred The number of bytes sent (unused in current implementation).
+     * @brief Reserves a contiguous region for a message in sendBuffer_.
+     * @param length The number of bytes needed.
+     * @param offset Receives the offset of the reserved region.
+     * @return bool True if the region was reserved, false if the buffer is full.
+     */
+    bool reserveSendSpace(std::size_t length, std::size_t& offset);
+
+    /**
+     * @brief Releases the oldest queued message after it has been sent or dropped.
+     */
+    void popSentMessage();
+
+    /**
+     * @brief Sends as many queued messages as the socket accepts without blocking.
+     * @details If the socket's send buffer is full, waits asynchronously until it becomes
+     *          writable and continues from there.
+     * @param allowWait False to give up instead of waiting (used while shutting down).
+     */
+    void drainSendQueue(bool allowWait = true);
+
+    /**
+     * @brief Posts a drain step to the executor unless one is pending or the sending is held.
+     */
+    void scheduleDrain();
+
+    /**
+     * @brief Hands up to kMaxSendBatch queued messages to the kernel in one call.
+     * @param error Receives the error of the call, if any.
+     * @return std::size_t Number of messages the kernel accepted.
      */
-    void handleSend(const asio::error_code& error, std::size_t bytes_transferred);
+    std::size_t sendBatch(asio::error_code& error);
     
     /**
      * @brief Parses a received raw data buffer into type, name, and value components.
      * @details Implements a simple text-based protocol (e.g., TYPE|NAME|VALUE).
      *          Calls the receiveHandler_ upon successful parsing or errorHandler_ on errors.
+     *          The components are passed as views into the buffer, nothing is copied.
      * @param data Pointer to the start of the received data buffer.
      * @param length The number of bytes received.
      */
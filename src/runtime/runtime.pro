@@ -7,6 +7,8 @@ CONFIG += c++17
 TARGET = ifa_runtime
 
 DEFINES += ASIO_STANDALONE
+# Asio's non-template code is compiled once, in ifa_runtime_asio.cpp
+DEFINES += ASIO_SEPARATE_COMPILATION
 
 INCLUDEPATH += \
     $$PWD/.. \                    
@@ -15,13 +17,43 @@ INCLUDEPATH += \
 SOURCES += \
     ifa_runtime_engine.cpp \
     ifa_runtime_udp.cpp \
-    ifa_runtime_timers.cpp
+    ifa_runtime_timers.cpp \
+    ifa_runtime_protocol.cpp \
+    ifa_runtime_log.cpp \
+    ifa_runtime_scheduler.cpp \
+    ifa_runtime_journal.cpp \
+    ifa_runtime_flight_recorder.cpp \
+    ifa_runtime_snapshot.cpp \
+    ifa_runtime_asio.cpp
 
 HEADERS += \
     ifa_runtime_engine.h \
+    ifa_runtime_engine_impl.h \
+    ifa_runtime_executor.h \
+    ifa_runtime_clock.h \
+    ifa_runtime_journal.h \
+    ifa_runtime_flight_recorder.h \
+    ifa_runtime_snapshot.h \
+    ifa_runtime_scheduler.h \
+    ifa_runtime_scheduler_impl.h \
     ifa_runtime_udp.h \
-    ifa_runtime_timers.h
+    ifa_runtime_timers.h \
+    ifa_runtime_protocol.h \
+    ifa_runtime_log.h \
+    ifa_runtime_plugin.h \
+    ifa_runtime_pch.h
 
 QMAKE_CXXFLAGS += -w
 
-unix:LIBS += -lpthread
\ No newline at end of file
+unix:LIBS += -lpthread
+
+# Precompiled header for the generated automata, built next to the library. The flags must
+# match the ones the GUI compiles generated code with (see MainWindow::on_runAutomatButton_clicked).
+unix {
+    pch.target = ifa_runtime_pch.h.gch
+    pch.commands = $$QMAKE_CXX -std=c++17 -x c++-header $$PWD/ifa_runtime_pch.h -o $$OUT_PWD/ifa_runtime_pch.h.gch
+    pch.depends = $$PWD/ifa_runtime_pch.h $$PWD/ifa_runtime_engine.h $$PWD/ifa_runtime_log.h $$PWD/ifa_runtime_protocol.h $$PWD/ifa_runtime_scheduler.h $$PWD/ifa_runtime_plugin.h $$PWD/ifa_runtime_snapshot.h
+    QMAKE_EXTRA_TARGETS += pch
+    POST_TARGETDEPS += ifa_runtime_pch.h.gch
+    QMAKE_CLEAN += ifa_runtime_pch.h.gch
+}
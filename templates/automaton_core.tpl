@@ -0,0 +1,936 @@
+{#
+  automaton_core.tpl - Definitions of the global objects, the transition tables, the transition
+  logic of an AutomatonInstance, the engine callbacks and main() of a generated automaton.
+
+  Included by automation_template.tpl after the state functions; a split build renders it into
+  the core source file, which only changes when the structure of the machine changes.
+#}
+// Automaton name constant, generated from JSON data.
+const std::string AUTOMATON_NAME = "{{ automaton_name }}";
+
+// The event hash must give every event name its own slot.
+{% for ev in events %}
+static_assert(kEventHashSlots[eventHash("{{ ev.name }}") & (kEventHashSize - 1)] == {{ ev.id }}, "Event hash collision: {{ ev.name }}");
+{% endfor %}
+
+// --- Global Objects ---
+// Definitions of the objects declared in automaton_declarations.tpl.
+
+// Maps for converting between state names (strings) and State enum values.
+std::map<std::string, State> stateNameToEnum;
+std::map<State, std::string> stateEnumToName;
+
+// The instances of the automaton, created by automatonMain().
+std::vector<AutomatonInstance> instances;
+// The runtime engine instance managing communication and timers.
+ifa_runtime::Engine engine;
+
+// Creates an instance with the initial values of the variables (quoted for strings).
+AutomatonInstance::AutomatonInstance(std::uint32_t id)
+    : instanceId(id){% for var in variables %},
+      {{ var.name }}({{ var.initial_value_cpp }}){% endfor %} {
+}
+
+// --- Event Transition Table ---
+// One entry per event-triggered transition; entries of the same (state, event) pair are
+// contiguous and keep the order of the model.
+struct EventTransition {
+    bool (AutomatonInstance::*guard)();      // Guard function, nullptr if the transition has no guard
+    State target;                            // Target state
+    long long (AutomatonInstance::*delay)(); // Delay function, nullptr for an immediate transition
+};
+
+constexpr std::size_t kEventTransitionCount = {{ length(event_transitions) }};
+const std::array<EventTransition, kEventTransitionCount> kEventTransitions = { {
+{% for et in event_transitions %}
+    { {% if et.has_guard %}&AutomatonInstance::check_guard_{{ et.template_index0 }}{% else %}nullptr{% endif %}, State::{{ et.target_enum_id }}, {% if et.has_delay %}&AutomatonInstance::transition_delay_{{ et.template_index0 }}{% else %}nullptr{% endif %} },
+{% endfor %}
+} };
+
+// Range of kEventTransitions handling one (state, event) pair.
+struct TransitionRange {
+    std::uint16_t first;
+    std::uint16_t count;
+};
+
+// Dense transition table indexed by [State][Event].
+const std::array<std::array<TransitionRange, kEventCount>, kStateCount> kTransitionTable = { {
+{% for row in transition_table %}
+    { { {% for cell in row %}{ {{ cell.first }}, {{ cell.count }} }, {% endfor %}} },
+{% endfor %}
+} };
+
+#ifdef IFA_AUTOMATON_FLEET
+// Timers of a fleet simulation, defined in automaton_fleet.tpl.
+void fleetSchedule(std::uint32_t instanceId, long long delayMs, State target);
+void fleetCancel(std::uint32_t instanceId);
+#endif
+
+// --- Core Automaton Logic (Callbacks & Processing) ---
+
+// Returns the name of a state for logging ("NULL" for an unknown state). Used inside the log
+// macros, so the name is only looked up if the message is logged.
+const std::string& stateNameOf(State state) {
+    static const std::string kUnknown = "NULL";
+    auto it = stateEnumToName.find(state);
+    return it != stateEnumToName.end() ? it->second : kUnknown;
+}
+
+// Enters the initial state and processes the transitions leaving it.
+void AutomatonInstance::start() {
+    currentState = State::{{ initial_state_enum_id }};
+    // Execute the action of the initial state.
+    executeCurrentStateAction();
+    // Process any immediate/delayed transitions originating from the initial state.
+    processTransitions();
+}
+
+// Executes the action associated with the current state and updates status.
+void AutomatonInstance::executeCurrentStateAction() {
+    // Record the time of entry into this state.
+    stateEntryTime = automatonNow();
+#ifndef IFA_AUTOMATON_FLEET
+    // Send the state update to the GUI via the engine (by id; the State enum value is the state's symbol id).
+    engine.sendStateById(static_cast<std::uint16_t>(currentState));
+#endif
+    IFA_LOG_INFO("[STATE] Entered state: " << stateNameOf(currentState));
+
+    // Execute the specific action function based on the current state enum.
+    switch (currentState) {
+        {% for state in states %}
+        case State::{{ state.enum_id }}: // Case for state: {{ state.name }}
+            {{ state.func_id }}();      // Call generated action function
+            break;
+        {% endfor %}
+        case State::STATE_NULL: break; // Should not happen in normal operation
+    }
+
+#ifndef IFA_AUTOMATON_FLEET // A fleet simulation has no GUI to update
+    // After executing the action, send updates for all variables to the GUI.
+    {% for var in variables %}
+    { // Scope for temporary stringstream
+        std::stringstream ss;
+        ss << {{ var.name }}; // Convert variable value to string
+        engine.sendVarById({{ loop.index }}, ss.str()); // Send update (by variable symbol id)
+    } 
+    {% endfor %}
+#endif
+}
+
+// Performs the transition to the next state.
+void AutomatonInstance::performStateTransition(State nextState) {
+    // Cancel the timers of this instance whenever a state transition occurs (those associated with
+    // the *previous* state's delayed transitions).
+    cancelTransitions();
+    if (currentState != nextState) {
+        IFA_LOG_INFO("[TRANSITION] Changing state from " << stateNameOf(currentState) << " to " << stateNameOf(nextState));
+        IFA_LOG_DEBUG("[TIMER] Cancelling all scheduled timers due to state change.");
+                
+    } else {
+        IFA_LOG_INFO("[TRANSITION] Self-transition in state " << stateNameOf(currentState));
+    }
+    // Update the current state.
+    currentState = nextState;
+    // Execute the action(s) associated with the *new* current state.
+    executeCurrentStateAction();
+}
+
+// Schedules a delayed transition; the engine selected this instance, so the timer expires on it.
+void AutomatonInstance::scheduleTransition(long long delayMs, State target) {
+#ifdef IFA_AUTOMATON_FLEET
+    fleetSchedule(instanceId, delayMs, target);
+#else
+    std::uint64_t timer = engine.scheduleTimer(delayMs, stateEnumToName[target]);
+    if (timer != 0) {
+        pendingTimers.push_back({ timer, target });
+    }
+#endif
+}
+
+// Cancels the delayed transitions of this instance. Handles of timers that already fired are
+// stale and ignored by the engine.
+void AutomatonInstance::cancelTransitions() {
+#ifdef IFA_AUTOMATON_FLEET
+    fleetCancel(instanceId);
+#else
+    for (const PendingTimer& timer : pendingTimers) {
+        engine.cancelTimer(timer.handle);
+    }
+    pendingTimers.clear();
+#endif
+}
+
+// Checks for and executes possible transitions from the current state.
+// Handles both immediate/timer transitions (when event is nullopt) and event-triggered transitions.
+// Returns true if any transition (immediate or event-driven) caused a state change.
+bool AutomatonInstance::processTransitions(std::optional<int> event) {
+    bool transition_taken = false; // Flag to track if any state change 
+    bool immediate_transition_found_in_cycle; // Flag for the inner loop processing immediate transitions.
+
+    // Loop to handle chains of immediate transitions.
+    do {
+        immediate_transition_found_in_cycle = false; // Reset flag for this iteration.
+        State next_state_candidate = currentState; // Store potential next state for immediate transitions.
+
+        // Phase 1: Check for Event-Independent Transitions (Immediate or Delayed)
+        // This phase runs only if no external event is being processed in this call.
+        if (!event) {
+            switch(currentState) {
+                {% for state in states %}
+                // Check transitions originating from state: {{ state.name }}
+                case State::{{ state.enum_id }}: {
+                    bool guard_ok; // Variable to store guard evaluation 
+                     {% for trans in state.eventless_transitions %}
+                            guard_ok = true; // Assume guard is true unless 
+                            {% if trans.guard and trans.guard != "" %}
+                                // Evaluate the guard condition if it exists
+                                guard_ok = check_guard_{{ trans.template_index0 }}();
+                            {% endif %}
+                            if (guard_ok) {
+                                // Check if it's an immediate or delayed transition.
+                                {% if not trans.delay and not trans.delay_var_original %} // Immediate transition (no delay number, no delay variable).
+                                     next_state_candidate = State::{{ trans.target_enum_id }}; // Set target state.
+                                     immediate_transition_found_in_cycle = true;
+                                     goto end_switch_immediate_{{ state.enum_id }};
+                                {% else %} // Delayed transition.
+                                     long long delay_ms = transition_delay_{{ trans.template_index0 }}();
+                                     if (delay_ms >= 0) {
+                                         scheduleTransition(delay_ms, State::{{ trans.target_enum_id }});
+                                     }
+                                {% endif %}
+                            }
+                     {% endfor %}
+                     end_switch_immediate_{{ state.enum_id }}:;
+                    break;
+                    }
+                {% endfor %}
+                default: break;
+            } 
+            if (immediate_transition_found_in_cycle) { 
+                performStateTransition(next_state_candidate); // Execute the state change.
+                transition_taken = true; // Mark that a state change happened.
+                // The outer do-while loop will continue to check for further immediate transitions from the new state.
+            }
+        } // Koniec if (!event)
+
+        // Phase 2: Check for Event-Triggered Transitions
+        // This phase runs only if an external event *is* being processed and no immediate transition was taken in Phase 1.
+        else if (event.has_value() && !immediate_transition_found_in_cycle) {
+            bool event_transition_found = false; // Flag if a valid transition for this event is found.
+            State next_state_event_candidate = currentState; // Potential target state.
+            // O(1) dispatch: index the [state][event] table with the event id.
+            int eventId = event.value();
+            if (eventId >= 0) {
+                const TransitionRange& range = kTransitionTable[static_cast<std::size_t>(currentState)][eventId];
+                for (std::size_t i = range.first; i < range.first + range.count; ++i) {
+                    const EventTransition& trans = kEventTransitions[i];
+                    if (trans.guard && !(this->*trans.guard)()) {
+                        continue;
+                    }
+                    if (!trans.delay) {
+                        // Immediate event transition: the first enabled one is taken.
+                        next_state_event_candidate = trans.target;
+                        event_transition_found = true;
+                        break;
+                    }
+                    // Delayed event transition: schedule it and keep looking.
+                    long long delay_ms = (this->*trans.delay)();
+                    if (delay_ms >= 0) scheduleTransition(delay_ms, trans.target);
+                }
+            }
+            // If an immediate transition triggered by the event was found:
+            if(event_transition_found){
+                 performStateTransition(next_state_event_candidate); // Execute the state change.
+                transition_taken = true; // Mark that a state change happened.
+                 // Clear the event optional so it's not processed again in the next cycle of the do-while loop.
+                 event = std::nullopt; // The outer do-while loop will continue to check for immediate transitions from the *new* state.
+                 }
+        }
+
+    // Continue the loop only if an immediate transition was found and executed in this cycle.
+    // This allows handling chains like A -> B -> C where all transitions are immediate.
+    } while (immediate_transition_found_in_cycle);
+
+    // Return whether any state transition occurred during this call to processTransitions.
+    return transition_taken;
+}
+
+// Handles an INPUT addressed to this instance.
+// The views are only valid during the call, so the value is copied into the input's slot.
+void AutomatonInstance::handleEvent(std::string_view inputName, std::string_view value) {
+    int eventId = lookupEvent(inputName);
+    storeInput(eventId, inputName, value);
+    processEvent(eventId);
+}
+
+// Records the value of an INPUT. The event id of a declared input is also its slot; the slot's
+// string is overwritten in place (reusing its capacity).
+void AutomatonInstance::storeInput(int eventId, std::string_view inputName, std::string_view value) {
+    if (eventId >= 0 && eventId < static_cast<int>(kInputCount)) {
+        InputSlot& input = inputSlots[eventId];
+        input.value.assign(value.data(), value.size());
+        input.defined = true;
+    } else {
+        auto it_input = undeclaredInputValues.find(inputName);
+        if (it_input != undeclaredInputValues.end()) {
+            it_input->second.assign(value.data(), value.size());
+        } else {
+            undeclaredInputValues.emplace(std::string(inputName), std::string(value));
+        }
+    }
+}
+
+// Processes the transitions triggered by an event.
+void AutomatonInstance::processEvent(int eventId) {
+    // Process transitions, passing the received event.
+    if (processTransitions(eventId)) {
+        // If the event caused an immediate state change (returned true),
+        // immediately call processTransitions again without an event
+        // to check for any new immediate/delayed transitions from the *new* state.
+        processTransitions(); // Check for timer scheduling etc. from the new state
+    }
+
+}
+
+// Handles the expiry of a timer scheduled by this instance.
+void AutomatonInstance::handleTimeout(const std::string& targetStateName) {
+    // Find the corresponding State enum value for the target state name.
+    if (stateNameToEnum.count(targetStateName)) {
+        fireTransition(stateNameToEnum.at(targetStateName));
+    } else {
+         IFA_LOG_ERROR("[ERROR] Timeout received for unknown target state: " << targetStateName);
+         engine.sendError("Timeout for unknown target state: " + targetStateName);
+    }
+}
+
+// Takes a delayed transition whose timer expired.
+void AutomatonInstance::fireTransition(State target) {
+    // Perform the state transition indicated by the timer.
+    performStateTransition(target);
+    // After the timer-induced transition, check for any immediate/delayed
+    // transitions that might now be possible from the new state.
+    processTransitions();
+}
+
+// Sends the state, variables and outputs of this instance (reply to GET_STATUS).
+void AutomatonInstance::sendStatus() {
+    // Send the current state update.
+    engine.sendStateById(static_cast<std::uint16_t>(currentState));
+
+    // Send the current values of all variables.
+    {% for var in variables %}
+    {
+        std::stringstream ss;
+        ss << {{ var.name }};
+        engine.sendVarById({{ loop.index }}, ss.str());
+    }
+    {% endfor %}
+
+    IFA_LOG_DEBUG("[Callback] Sending last output values...");
+    for (std::size_t slot = 0; slot < kOutputCount; ++slot) {
+        if (!outputSlots[slot].sent) continue;
+        engine.sendOutputById(static_cast<std::uint16_t>(slot), outputSlots[slot].value);
+        IFA_LOG_DEBUG("[Callback]   Output: " << kOutputNames[slot] << " = " << outputSlots[slot].value);
+    }
+    for(const auto& pair : undeclaredOutputValues) {
+        engine.sendOutputUpdate(pair.first, pair.second);
+        IFA_LOG_DEBUG("[Callback]   Output: " << pair.first << " = " << pair.second);
+    }
+}
+
+// --- Checkpoints ---
+// A snapshot holds the automaton name and, for each instance: its id, the current state, the
+// time spent in it, the variables, the input and output values and the time left of each pending
+// delayed transition. Everything is stored by name, so a rebuilt automaton resumes from a snapshot
+// of its previous version: names it no longer has are skipped and values of variables whose type
+// changed are converted.
+
+// Type tags of the variable values in a snapshot.
+constexpr std::uint8_t kSnapshotBool = 'b';
+constexpr std::uint8_t kSnapshotInteger = 'i';
+constexpr std::uint8_t kSnapshotFloat = 'f';
+constexpr std::uint8_t kSnapshotText = 's';
+
+// Appends a variable value with its type tag.
+template<typename T>
+void putSnapshotValue(ifa_runtime::SnapshotWriter& out, const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        out.putByte(kSnapshotBool);
+        out.putByte(value ? 1 : 0);
+    } else if constexpr (std::is_integral_v<T>) {
+        out.putByte(kSnapshotInteger);
+        out.putSigned(static_cast<std::int64_t>(value));
+    } else if constexpr (std::is_floating_point_v<T>) {
+        out.putByte(kSnapshotFloat);
+        out.putDouble(static_cast<double>(value));
+    } else {
+        std::stringstream ss;
+        ss << value;
+        out.putByte(kSnapshotText);
+        out.putString(ss.str());
+    }
+}
+
+// Reads a value written by putSnapshotValue() into a variable, converting it to the variable's type.
+template<typename T>
+bool getSnapshotValue(ifa_runtime::SnapshotReader& in, T& value) {
+    std::uint8_t tag = 0;
+    std::uint8_t flag = 0;
+    std::int64_t integer = 0;
+    double floating = 0;
+    std::string text;
+    if (!in.getByte(tag)) return false;
+    switch (tag) {
+        case kSnapshotBool:
+            if (!in.getByte(flag)) return false;
+            integer = flag;
+            text = flag ? "1" : "0";
+            break;
+        case kSnapshotInteger:
+            if (!in.getSigned(integer)) return false;
+            text = std::to_string(integer);
+            break;
+        case kSnapshotFloat: {
+            if (!in.getDouble(floating)) return false;
+            std::stringstream ss;
+            ss << floating;
+            text = ss.str();
+            break;
+        }
+        case kSnapshotText:
+            if (!in.getString(text)) return false;
+            break;
+        default:
+            return false;
+    }
+    if constexpr (std::is_arithmetic_v<T>) {
+        if (tag == kSnapshotFloat) {
+            value = static_cast<T>(floating);
+        } else if (tag == kSnapshotText) {
+            std::istringstream ss(text);
+            T parsed{};
+            if (ss >> parsed) value = parsed;
+        } else {
+            value = static_cast<T>(integer);
+        }
+    } else if constexpr (std::is_assignable_v<T&, const std::string&>) {
+        value = text;
+    } else {
+        std::istringstream ss(text);
+        ss >> value;
+    }
+    return true;
+}
+
+// Appends the state, variables, input/output values and pending timers of this instance.
+void AutomatonInstance::saveSnapshot(ifa_runtime::SnapshotWriter& out) const {
+    out.putUnsigned(instanceId);
+    out.putString(stateNameOf(currentState));
+    out.putSigned(elapsed());
+
+    out.putUnsigned({{ length(variables) }});
+    {% for var in variables %}
+    out.putString("{{ var.name }}");
+    putSnapshotValue(out, {{ var.name }});
+    {% endfor %}
+
+    // Inputs and outputs: name, defined/sent flag, value; the declared slots first.
+    out.putUnsigned(kInputCount + undeclaredInputValues.size());
+    for (std::size_t slot = 0; slot < kInputCount; ++slot) {
+        out.putString(kEventNames[slot]);
+        out.putByte(inputSlots[slot].defined ? 1 : 0);
+        out.putString(inputSlots[slot].value);
+    }
+    for (const auto& pair : undeclaredInputValues) {
+        out.putString(pair.first);
+        out.putByte(1);
+        out.putString(pair.second);
+    }
+    out.putUnsigned(kOutputCount + undeclaredOutputValues.size());
+    for (std::size_t slot = 0; slot < kOutputCount; ++slot) {
+        out.putString(kOutputNames[slot]);
+        out.putByte(outputSlots[slot].sent ? 1 : 0);
+        out.putString(outputSlots[slot].value);
+    }
+    for (const auto& pair : undeclaredOutputValues) {
+        out.putString(pair.first);
+        out.putByte(1);
+        out.putString(pair.second);
+    }
+
+    // Delayed transitions: target state and the time left; timers that already fired are skipped.
+    RestoredTimers timers;
+    for (const PendingTimer& timer : pendingTimers) {
+        long long left = engine.timerRemaining(timer.handle);
+        if (left >= 0) timers.emplace_back(left, timer.target);
+    }
+    out.putUnsigned(timers.size());
+    for (const auto& timer : timers) {
+        out.putString(stateNameOf(timer.second));
+        out.putSigned(timer.first);
+    }
+}
+
+// Loads a snapshot of this instance. A state that no longer exists leaves currentState at
+// STATE_NULL, so resume() enters the initial state instead.
+bool AutomatonInstance::restoreSnapshot(ifa_runtime::SnapshotReader& in, RestoredTimers& timers) {
+    std::string name;
+    std::string value;
+    std::int64_t number = 0;
+    std::uint64_t count = 0;
+    std::uint8_t flag = 0;
+
+    if (!in.getString(name) || !in.getSigned(number)) return false;
+    auto state = stateNameToEnum.find(name);
+    currentState = state != stateNameToEnum.end() ? state->second : State::STATE_NULL;
+    if (currentState == State::STATE_NULL) {
+        IFA_LOG_WARN("[Checkpoint] WARNING: Instance " << instanceId << " was in unknown state '" << name << "', restarting it.");
+    }
+    stateEntryTime = automatonNow() - std::chrono::milliseconds(number);
+
+    if (!in.getUnsigned(count)) return false;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (!in.getString(name)) return false;
+        bool known = false;
+        {% for var in variables %}
+        if (!known && name == "{{ var.name }}") {
+            known = true;
+            if (!getSnapshotValue(in, {{ var.name }})) return false;
+        }
+        {% endfor %}
+        if (!known) {
+            IFA_LOG_WARN("[Checkpoint] WARNING: Unknown variable '" << name << "' skipped.");
+            if (!getSnapshotValue(in, value)) return false;
+        }
+    }
+
+    if (!in.getUnsigned(count)) return false;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (!in.getString(name) || !in.getByte(flag) || !in.getString(value)) return false;
+        int slot = inputIndex(name);
+        if (slot >= 0) {
+            inputSlots[slot].defined = flag != 0;
+            inputSlots[slot].value = value;
+        } else if (flag) {
+            undeclaredInputValues[name] = value;
+        }
+    }
+    if (!in.getUnsigned(count)) return false;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (!in.getString(name) || !in.getByte(flag) || !in.getString(value)) return false;
+        int slot = outputIndex(name);
+        if (slot >= 0) {
+            outputSlots[slot].sent = flag != 0;
+            outputSlots[slot].value = value;
+        } else if (flag) {
+            undeclaredOutputValues[name] = value;
+        }
+    }
+
+    if (!in.getUnsigned(count)) return false;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (!in.getString(name) || !in.getSigned(number)) return false;
+        auto target = stateNameToEnum.find(name);
+        if (target == stateNameToEnum.end() || target->second == State::STATE_NULL) {
+            IFA_LOG_WARN("[Checkpoint] WARNING: Delayed transition to unknown state '" << name << "' dropped.");
+            continue;
+        }
+        timers.emplace_back(number, target->second);
+    }
+    return true;
+}
+
+// Continues a restored instance where the snapshot left off. The action of the state already
+// ran before the checkpoint, so it is not executed again.
+void AutomatonInstance::resume(const RestoredTimers& timers) {
+    if (currentState == State::STATE_NULL) {
+        start();
+        return;
+    }
+    for (const auto& timer : timers) {
+        scheduleTransition(std::max(timer.first, 1LL), timer.second);
+    }
+    IFA_LOG_INFO("[STATE] Resumed in state: " << stateNameOf(currentState));
+    sendStatus();
+}
+
+// File the CHECKPOINT command writes (--checkpoint FILE).
+std::string checkpointPath;
+
+// Loads the instances saved in a snapshot file. restored[id] is set for each instance found in
+// it, with its delayed transitions in timers[id]; instances beyond instances.size() are ignored.
+// A snapshot saved by another automaton is refused unless force is set (--resume-force).
+// Returns false if the file cannot be used.
+bool loadCheckpoint(const std::string& path, bool force, std::vector<bool>& restored, std::vector<RestoredTimers>& timers) {
+    ifa_runtime::SnapshotReader snapshot;
+    std::string error;
+    std::string name;
+    std::uint64_t count = 0;
+    if (!snapshot.readFile(path, error)) {
+        IFA_LOG_ERROR("[Checkpoint] ERROR: " << error);
+        return false;
+    }
+    if (!snapshot.getString(name) || !snapshot.getUnsigned(count)) {
+        IFA_LOG_ERROR("[Checkpoint] ERROR: Snapshot '" << path << "' is corrupt.");
+        return false;
+    }
+    if (name != AUTOMATON_NAME) {
+        if (!force) {
+            IFA_LOG_ERROR("[Checkpoint] ERROR: Snapshot '" << path << "' was saved by automaton '" << name
+                          << "', not '" << AUTOMATON_NAME << "' (use --resume-force to load it anyway).");
+            return false;
+        }
+        IFA_LOG_WARN("[Checkpoint] WARNING: Snapshot '" << path << "' was saved by automaton '" << name << "', loading it anyway.");
+    }
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t id = 0;
+        if (!snapshot.getUnsigned(id)) {
+            IFA_LOG_ERROR("[Checkpoint] ERROR: Snapshot '" << path << "' is corrupt.");
+            return false;
+        }
+        bool used = id < instances.size();
+        AutomatonInstance unused(static_cast<std::uint32_t>(id)); // Reads past an instance that is not run
+        RestoredTimers ignored;
+        AutomatonInstance& instance = used ? instances[id] : unused;
+        if (!instance.restoreSnapshot(snapshot, used ? timers[id] : ignored)) {
+            IFA_LOG_ERROR("[Checkpoint] ERROR: Snapshot '" << path << "' is corrupt.");
+            return false;
+        }
+        if (used) {
+            restored[id] = true;
+        } else {
+            IFA_LOG_WARN("[Checkpoint] WARNING: Instance " << id << " of the snapshot is not running, skipped.");
+        }
+    }
+    IFA_LOG_INFO("[Checkpoint] Resuming " << count << " instance(s) from " << path << ".");
+    return true;
+}
+
+// --- Callback Functions Provided to the Engine ---
+
+// Callback function invoked by the Engine when an "INPUT" message is received.
+// The engine has selected the addressed instance (see Engine::setInstance()).
+void handleEventCallback(std::uint32_t instanceId, std::string_view inputName, std::string_view value) {
+    IFA_LOG_DEBUG("[Callback] Received INPUT Event: " << inputName << "@" << instanceId << " = " << value);
+    if (instanceId >= instances.size()) {
+        engine.setInstance(0); // Reported by the process, not by a nonexistent instance
+        engine.sendError("INPUT for unknown instance " + std::to_string(instanceId));
+        return;
+    }
+    instances[instanceId].handleEvent(inputName, value);
+}
+
+// Callback function invoked by the Engine when a scheduled timer expires.
+void handleTimeoutCallback(std::uint32_t instanceId, const std::string& targetStateName) {
+    IFA_LOG_DEBUG("[Callback] Received TIMEOUT for target state: " << targetStateName << "@" << instanceId);
+    if (instanceId < instances.size()) {
+        instances[instanceId].handleTimeout(targetStateName);
+    }
+}
+
+// Callback function invoked by the Engine when a termination request is received (signal or command).
+void handleTerminationCallback() {
+    IFA_LOG_INFO("[Callback] Received TERMINATION request.");
+    engine.stop(); // Engine will send "TERMINATING" message and stop io_context.
+}
+
+// Callback function invoked by the Engine when an internal error occurs.
+void handleErrorCallback(const std::string& errorMessage) {
+    // The Engine already logs the error to cerr and sends an ERROR message to the GUI.
+    // Add any automaton-specific error handling logic here if needed.
+    IFA_LOG_ERROR("[Callback] Received ERROR notification: " << errorMessage);
+    // Example: Stop the automaton on critical errors.
+    // engine.stop(); 
+}
+
+// Callback function invoked by the Engine when a "GET_STATUS" command is received.
+void handleStatusRequestCallback() {
+    
+    IFA_LOG_DEBUG("[Callback] Handling GET_STATUS request...");
+
+    // Send the automaton's name first (in the binary protocol followed by the symbol table)
+    engine.sendName();
+
+    // Then the status of every instance, each announced by its instance id (nothing for instance 0)
+    for (AutomatonInstance& instance : instances) {
+        engine.setInstance(instance.instanceId);
+        instance.sendStatus();
+    }
+    engine.setInstance(0);
+
+    IFA_LOG_DEBUG("[Callback] Status sent.");
+}
+
+// Callback function invoked by the Engine when a "CHECKPOINT" command is received.
+void handleCheckpointCallback() {
+    ifa_runtime::SnapshotWriter snapshot;
+    snapshot.putString(AUTOMATON_NAME);
+    snapshot.putUnsigned(instances.size());
+    for (const AutomatonInstance& instance : instances) {
+        instance.saveSnapshot(snapshot);
+    }
+    std::string error;
+    if (!snapshot.writeFile(checkpointPath, error)) {
+        IFA_LOG_ERROR("[Checkpoint] ERROR: " << error);
+        engine.sendError("Checkpoint failed: " + error);
+        return;
+    }
+    IFA_LOG_INFO("[Checkpoint] " << instances.size() << " instance(s) saved to " << checkpointPath
+                 << " (" << snapshot.data().size() << " bytes).");
+    engine.sendLog("Checkpoint saved to " + checkpointPath);
+}
+
+// Populates the maps for easy conversion between state names and enum values.
+void initStateMaps() {
+    stateNameToEnum["STATE_NULL"] = State::STATE_NULL; // Should not be used normally
+    stateEnumToName[State::STATE_NULL] = "STATE_NULL";
+    {% for state in states %}
+    stateNameToEnum["{{ state.name }}"] = State::{{ state.enum_id }}; // Map name to enum
+    stateEnumToName[State::{{ state.enum_id }}] = "{{ state.name }}"; // Map enum to name
+    {% endfor %}
+}
+
+// --- Main Function ---
+// Runs the automaton until it terminates: main() of the executable, or AutomatonPlugin::run
+// when the automaton is built as a plugin.
+int automatonMain(int argc, char *argv[]) {
+    // --- Default Port Configuration ---
+    int listen_port = 9001; // Default UDP port for this automaton runtime to listen on
+    std::string gui_host = "127.0.0.1"; // Default GUI host (localhost)
+    int gui_port = 9000; // Default UDP port the GUI is expected to listen on
+
+    // --- Command Line Option Parsing ---
+    // Options start with "--" and may appear anywhere; the remaining arguments are the ports.
+    bool batchTelemetry = true; // Coalesce the updates of one step into as few datagrams as possible
+    ifa_runtime::protocol::WireProtocol wireProtocol = ifa_runtime::protocol::WireProtocol::Text;
+    std::size_t recvMaxDatagram = 2048; // Largest inbound datagram accepted
+    std::size_t recvBatch = 32; // Datagrams read per socket wakeup
+    int recvSocketBuffer = 0; // SO_RCVBUF in bytes, 0 = system default
+    unsigned long instanceCount = 1; // Instances of the automaton sharing this process (addressed as "input@id")
+    ifa_runtime::ClockMode clockMode = ifa_runtime::ClockMode::Real;
+    std::string journalPath; // Record what the automaton receives and emits to this file
+    std::string replayPath; // Replay this journal instead of taking inputs from the GUI
+    ifa_runtime::ReplayPace replayPace = ifa_runtime::ReplayPace::Fastest;
+    std::string flightRecorderPath; // Keep the last events in this memory-mapped file (decoded by ifa_flightrec)
+    std::size_t flightRecorderRecords = 4096; // Events kept by the flight recorder
+    checkpointPath = AUTOMATON_NAME + ".ckpt"; // Written by CMD|CHECKPOINT
+    std::string resumePath; // Continue from this snapshot instead of entering the initial state
+    bool resumeForce = false; // Also resume from a snapshot saved by another automaton
+    std::vector<std::string> positionalArgs;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--no-batch") {
+            batchTelemetry = false;
+        } else if (arg == "--virtual-time") {
+            // Discrete-event simulation: when idle, jump straight to the next timer expiry
+            clockMode = ifa_runtime::ClockMode::Virtual;
+        } else if (arg == "--journal" && i + 1 < argc) {
+            journalPath = argv[++i];
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        } else if (arg == "--resume" && i + 1 < argc) {
+            resumePath = argv[++i];
+        } else if (arg == "--resume-force") {
+            resumeForce = true;
+        } else if (arg == "--flight-recorder" && i + 1 < argc) {
+            flightRecorderPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--replay-pace" && i + 1 < argc) {
+            // "fastest" replays in virtual time, "recorded" at the recorded pace in real time
+            std::string value = argv[++i];
+            if (value == "fastest") {
+                replayPace = ifa_runtime::ReplayPace::Fastest;
+            } else if (value == "recorded") {
+                replayPace = ifa_runtime::ReplayPace::Recorded;
+            } else {
+                IFA_LOG_WARN("[Config] WARNING: Unknown replay pace '" << value << "' ignored.");
+            }
+        } else if (arg == "--protocol" && i + 1 < argc) {
+            // Wire protocol towards the GUI: "binary" (compact, id based) or "text" (readable, for debugging)
+            std::string value = argv[++i];
+            if (value == "binary") {
+                wireProtocol = ifa_runtime::protocol::WireProtocol::Binary;
+            } else if (value == "text") {
+                wireProtocol = ifa_runtime::protocol::WireProtocol::Text;
+            } else {
+                IFA_LOG_WARN("[Config] WARNING: Unknown protocol '" << value << "' ignored.");
+            }
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            // Run-time log threshold; levels compiled out with IFA_LOG_COMPILED_LEVEL stay silent
+            ifa_runtime::LogLevel logLevel;
+            if (ifa_runtime::parseLogLevel(argv[++i], logLevel)) {
+                ifa_runtime::Logger::instance().setLevel(logLevel);
+            } else {
+                IFA_LOG_WARN("[Config] WARNING: Unknown log level '" << argv[i] << "' ignored.");
+            }
+        } else if ((arg == "--recv-batch" || arg == "--max-datagram" || arg == "--rcvbuf" || arg == "--instances" || arg == "--flight-recorder-records") && i + 1 < argc) {
+            // Numeric options take their value from the next argument
+            try {
+                unsigned long value = std::stoul(argv[++i]);
+                if (arg == "--recv-batch") recvBatch = value;
+                else if (arg == "--max-datagram") recvMaxDatagram = value;
+                else if (arg == "--flight-recorder-records") flightRecorderRecords = value;
+                else if (arg == "--instances") instanceCount = std::clamp<unsigned long>(value, 1, std::numeric_limits<std::uint32_t>::max());
+                else recvSocketBuffer = static_cast<int>(std::min<unsigned long>(value, std::numeric_limits<int>::max()));
+            } catch (const std::exception& e) {
+                IFA_LOG_WARN("[Config] WARNING: Invalid value '" << argv[i] << "' for option '" << arg << "' ignored.");
+            }
+        } else if (arg.rfind("--", 0) == 0) {
+            IFA_LOG_WARN("[Config] WARNING: Unknown option '" << arg << "' ignored.");
+        } else {
+            positionalArgs.push_back(arg);
+        }
+    }
+    IFA_LOG_INFO("Starting automaton: " << AUTOMATON_NAME);
+
+    // --- Command Line Argument Parsing for Ports ---
+    // Expects: ./automaton_executable [options] <runtime_listen_port> <gui_target_port>
+    if (positionalArgs.size() == 2) {
+        try {
+            // Attempt to convert arguments to integers.
+            listen_port = std::stoi(positionalArgs[0]);
+            gui_port = std::stoi(positionalArgs[1]);
+            IFA_LOG_INFO("[Config] Using ports from command line: Runtime Listen=" << listen_port
+                         << ", GUI Target=" << gui_host << ":" << gui_port);
+        } catch (const std::exception& e) {
+            IFA_LOG_ERROR("[Config] ERROR: Invalid command line arguments. Usage: " << argv[0]
+                         << " [--no-batch] [--virtual-time] [--journal FILE] [--replay FILE] [--replay-pace recorded|fastest] [--flight-recorder FILE] [--flight-recorder-records N] [--checkpoint FILE] [--resume FILE] [--resume-force] [--protocol text|binary] [--instances N] [--recv-batch N] [--max-datagram BYTES] [--rcvbuf BYTES] [--log-level trace|debug|info|warn|error|off] <listen_port> <gui_port>");
+            IFA_LOG_ERROR("[Config] Falling back to default ports.");
+            // Reset to defaults
+            listen_port = 9001;
+            gui_port = 9000;
+             IFA_LOG_INFO("[Config] Default ports: Runtime Listen=" << listen_port
+                         << ", GUI Target=" << gui_host << ":" << gui_port);
+        }
+    } else if (!positionalArgs.empty()) {
+         IFA_LOG_WARN("[Config] WARNING: Incorrect number of arguments. Using default ports.");
+         IFA_LOG_INFO("[Config] Usage: " << argv[0] << " [--no-batch] [--virtual-time] [--journal FILE] [--replay FILE] [--replay-pace recorded|fastest] [--flight-recorder FILE] [--flight-recorder-records N] [--checkpoint FILE] [--resume FILE] [--resume-force] [--protocol text|binary] [--instances N] [--recv-batch N] [--max-datagram BYTES] [--rcvbuf BYTES] [--log-level trace|debug|info|warn|error|off] <listen_port> <gui_port>");
+         IFA_LOG_INFO("[Config] Default ports: Runtime Listen=" << listen_port
+                     << ", GUI Target=" << gui_host << ":" << gui_port);
+    } else {
+         IFA_LOG_INFO("[Config] No command line arguments provided. Using default ports: Runtime Listen=" << listen_port
+                     << ", GUI Target=" << gui_host << ":" << gui_port);
+    }
+
+    // --- Initialize State Maps ---
+    initStateMaps();
+
+    // --- Create the Instances ---
+    // Basic validation: Check if the generated initial state enum is valid.
+    if (State::{{ initial_state_enum_id }} == State::STATE_NULL && "{{ initial_state_name }}" != "") {
+         IFA_LOG_ERROR("[ERROR] Initial state '{{ initial_state_name }}' issue!"); return 1;
+    } else if ("{{ initial_state_name }}" == "") {
+         IFA_LOG_ERROR("[ERROR] No initial state defined!"); return 1;
+    }
+    instances.reserve(instanceCount);
+    for (unsigned long id = 0; id < instanceCount; ++id) {
+        instances.emplace_back(static_cast<std::uint32_t>(id));
+    }
+
+    // --- Initialize and Run the Engine ---
+    // Receive settings have to be in place before the socket is created.
+    engine.setReceiveOptions(recvMaxDatagram, recvBatch, recvSocketBuffer);
+    // The protocol, batching and symbol tables are needed before initialize(), which announces READY.
+    engine.setWireProtocol(wireProtocol);
+    engine.setBatchingEnabled(batchTelemetry);
+    engine.setClockMode(clockMode);
+    if (!journalPath.empty() && !engine.setJournal(journalPath)) {
+        return 1;
+    }
+    if (!replayPath.empty() && !engine.setReplay(replayPath, replayPace)) {
+        return 1;
+    }
+    if (!flightRecorderPath.empty() && !engine.setFlightRecorder(flightRecorderPath, flightRecorderRecords)) {
+        return 1;
+    }
+
+    // --- Resume from a Checkpoint ---
+    // Loaded before initialize(), so an unusable snapshot stops the start-up before READY.
+    std::vector<bool> restored(instances.size(), false);
+    std::vector<RestoredTimers> restoredTimers(instances.size());
+    if (!resumePath.empty() && !loadCheckpoint(resumePath, resumeForce, restored, restoredTimers)) {
+        return 1;
+    }
+
+    // Register the symbol tables; a symbol's id is its index. States are indexed by their
+    // State enum value, so slot 0 belongs to STATE_NULL.
+    engine.setSymbols(ifa_runtime::protocol::SymbolKind::State, { "STATE_NULL",{% for state in states %} "{{ state.name }}",{% endfor %} });
+    engine.setSymbols(ifa_runtime::protocol::SymbolKind::Input, { {% for input in inputs %}"{{ input }}", {% endfor %} });
+    engine.setSymbols(ifa_runtime::protocol::SymbolKind::Output, { {% for output in outputs %}"{{ output }}", {% endfor %} });
+    engine.setSymbols(ifa_runtime::protocol::SymbolKind::Variable, { {% for var in variables %}"{{ var.name }}", {% endfor %} });
+
+    // Initialize the runtime engine with configured ports and automaton name.
+    if (!engine.initialize(AUTOMATON_NAME, listen_port, gui_host, gui_port)) { // <<< POUŽI PREMENNÉ 
+        return 1;  // Exit with error
+    }
+
+    // Register the callback functions defined in this file with the engine; inputs and timeouts
+    // are dispatched to the instance they are addressed to.
+     engine.setEventHandlers(nullptr, nullptr, handleTerminationCallback, handleErrorCallback, handleStatusRequestCallback);
+     engine.setInstanceHandlers(handleEventCallback, handleTimeoutCallback);
+     engine.setCheckpointHandler(handleCheckpointCallback);
+     
+     // --- Automaton Execution Start ---
+     IFA_LOG_INFO("Initial state: {{ initial_state_name }} (" << instances.size() << " instance(s))");
+
+     // Entering the initial state (or resuming a restored instance) is one run-to-completion step,
+     // batched like the engine's callbacks.
+     engine.beginBatch();
+     for (AutomatonInstance& instance : instances) {
+         engine.setInstance(instance.instanceId);
+         if (restored[instance.instanceId]) {
+             instance.resume(restoredTimers[instance.instanceId]);
+         } else {
+             instance.start();
+         }
+     }
+     engine.setInstance(0);
+     engine.endBatch();
+
+    // Start the engine's main event loop (this blocks).
+     IFA_LOG_INFO("Starting engine's event loop...");
+     engine.run();
+     
+     IFA_LOG_INFO("Automaton " << AUTOMATON_NAME << " finished.");
+     if (!replayPath.empty() && !engine.replayMatched()) {
+         return 1; // The automaton diverged from the replayed journal
+     }
+    return 0; 
+}
+
+#ifdef IFA_AUTOMATON_PLUGIN
+// --- Plugin Entry Point ---
+// Built with -DIFA_AUTOMATON_PLUGIN -fPIC -shared -fvisibility=hidden -fno-gnu-unique, the automaton
+// is a shared object loaded by ifa_host (see ifa_runtime_plugin.h) instead of a standalone executable.
+namespace {
+const char* const kPluginStateNames[] = { "STATE_NULL",{% for state in states %} "{{ state.name }}",{% endfor %} nullptr };
+const char* const kPluginInputNames[] = { {% for input in inputs %}"{{ input }}", {% endfor %}nullptr };
+const char* const kPluginOutputNames[] = { {% for output in outputs %}"{{ output }}", {% endfor %}nullptr };
+const char* const kPluginVariableNames[] = { {% for var in variables %}"{{ var.name }}", {% endfor %}nullptr };
+
+void requestStopAutomaton() {
+    engine.requestStop();
+}
+} // namespace
+
+IFA_PLUGIN_EXPORT const ifa_runtime::AutomatonPlugin* IFA_PLUGIN_ENTRY() {
+    static const ifa_runtime::AutomatonPlugin plugin = {
+        ifa_runtime::kPluginAbiVersion,
+        "{{ automaton_name }}",
+        { kPluginStateNames, static_cast<std::uint32_t>(kStateCount) },
+        { kPluginInputNames, static_cast<std::uint32_t>(kInputCount) },
+        { kPluginOutputNames, static_cast<std::uint32_t>(kOutputCount) },
+        { kPluginVariableNames, {{ length(variables) }} },
+        automatonMain,
+        requestStopAutomaton
+    };
+    return &plugin;
+}
+#elif defined(IFA_AUTOMATON_FLEET)
+{% include "automaton_fleet.tpl" %}
+#else
+int main(int argc, char *argv[]) {
+    return automatonMain(argc, argv);
+}
+#endif
@@ -0,0 +1,347 @@
+{#
+  automaton_declarations.tpl - Declarations shared by all parts of a generated automaton.
+
+  Included by automation_template.tpl and rendered on its own as the header of a split build
+  (see CodeGenerator::generateUnits), so it may only contain declarations, constexpr data and
+  inline functions. The definitions are in automaton_core.tpl and automaton_state.tpl.
+#}
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <sstream>
+#include <optional>
+#include <stdexcept>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <array>
+#include <type_traits>
+#include <fstream>
+#include <iomanip>
+#include <csignal>
+#include <utility>
+#include <charconv>
+
+#include "ifa_runtime_engine.h"
+#include "ifa_runtime_log.h"
+#include "ifa_runtime_plugin.h"
+#include "ifa_runtime_snapshot.h"
+
+// Enum defining the possible states of the automaton.
+// Includes a default NULL state and generated states.
+enum class State {
+    STATE_NULL,
+{% for state in states %}
+    {{ state.enum_id }},
+{% endfor %}
+};
+
+// Maps for converting between state names (strings) and State enum values.
+extern std::map<std::string, State> stateNameToEnum; // Map: "StateName" -> State::STATE_ENUM_ID
+extern std::map<State, std::string> stateEnumToName; // Map: State::STATE_ENUM_ID -> "StateName"
+
+// Number of rows of the transition table (STATE_NULL + generated states).
+constexpr std::size_t kStateCount = {{ length(states) }} + 1;
+
+// Enum of the events (input names) the automaton reacts to. Inputs come first, so an input's
+// event id equals its symbol id; event names without a declared input follow.
+enum class Event : std::uint16_t {
+{% for ev in events %}
+    {{ ev.enum_id }} = {{ ev.id }}, // "{{ ev.name }}"
+{% endfor %}
+};
+constexpr std::size_t kEventCount = {{ length(events) }};
+
+// Wire names of the events, indexed by event id.
+constexpr std::array<std::string_view, kEventCount> kEventNames = {
+{% for ev in events %}
+    std::string_view("{{ ev.name }}"),
+{% endfor %}
+};
+
+// --- Perfect Hash of Event Names ---
+// The seed and the table size were chosen by the code generator so that every event name
+// gets its own slot; static_asserts in the core part re-check this at compile time.
+constexpr std::uint32_t kEventHashSeed = {{ event_hash_seed }}u;
+constexpr std::size_t kEventHashSize = {{ event_hash_size }}; // Power of two
+
+// FNV-1a over the name from a seeded basis (must match event_hash() in the code generator).
+constexpr std::uint32_t eventHash(std::string_view name) {
+    std::uint32_t h = 2166136261u ^ kEventHashSeed;
+    for (char c : name) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+// Event id stored in each hash slot, -1 for an empty slot.
+constexpr std::array<std::int16_t, kEventHashSize> kEventHashSlots = { {{ join(event_hash_slots, ", ") }} };
+
+
+// Maps a wire name to its event id with one hash and one length-checked compare (needed to
+// reject names that are not events). Returns -1 for an unknown name.
+constexpr int lookupEvent(std::string_view name) {
+    int id = kEventHashSlots[eventHash(name) & (kEventHashSize - 1)];
+    return (id >= 0 && kEventNames[id] == name) ? id : -1;
+}
+
+
+// --- Input / Output Slots ---
+// The inputs and outputs are known at generation time, so each has a fixed slot; the slot
+// index is its position in the model, which is also its symbol id in the binary protocol.
+constexpr std::size_t kInputCount = {{ length(inputs) }};
+constexpr std::size_t kOutputCount = {{ length(outputs) }};
+// Inputs are the first events, so kEventNames[slot] is the name of input slot.
+static_assert(kInputCount <= kEventCount, "Every input must be an event");
+
+// Names of the outputs, indexed by slot.
+constexpr std::array<std::string_view, kOutputCount> kOutputNames = {
+{% for output in outputs %}
+    std::string_view("{{ output }}"),
+{% endfor %}
+};
+
+// Returns the slot of an input, -1 if the name is not a declared input.
+constexpr int inputIndex(std::string_view name) {
+    int id = lookupEvent(name);
+    return id < static_cast<int>(kInputCount) ? id : -1;
+}
+
+// Returns the slot of an output, -1 if the name is not a declared output.
+constexpr int outputIndex(std::string_view name) {
+    for (std::size_t i = 0; i < kOutputCount; ++i) {
+        if (kOutputNames[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// --- Time ---
+#ifdef IFA_AUTOMATON_FLEET
+// Simulated time of a fleet simulation (see automaton_fleet.tpl), advanced tick by tick.
+extern std::chrono::steady_clock::time_point fleetNow;
+#endif
+
+// The runtime engine instance managing communication and timers, shared by all instances.
+extern ifa_runtime::Engine engine;
+
+// Current time as seen by the automaton: the engine's clock (real or virtual time, see
+// --virtual-time), or the simulated time of a fleet.
+inline std::chrono::steady_clock::time_point automatonNow() {
+#ifdef IFA_AUTOMATON_FLEET
+    return fleetNow;
+#else
+    return engine.now();
+#endif
+}
+
+// --- Runtime State ---
+// Last value received for each input; defined stays false until the first INPUT arrives.
+struct InputSlot {
+    std::string value;
+    bool defined = false;
+};
+
+// Last value sent for each output; sent stays false until the output is first written.
+struct OutputSlot {
+    std::string value;
+    bool sent = false;
+};
+
+// A delayed transition scheduled by an instance: the engine's timer handle and the target state.
+struct PendingTimer {
+    std::uint64_t handle;
+    State target;
+};
+
+// Delayed transitions of an instance restored from a checkpoint: the time left (ms) and the target.
+using RestoredTimers = std::vector<std::pair<long long, State>>;
+
+// One instance of the automaton. A process runs one or more instances (--instances N) on a
+// single engine: they share the socket, the timer wheel and the tables above, while all state
+// lives here. The state actions, guards and delays are members, so the user-defined code
+// refers to the variables and calls valueof(), output() etc. of its own instance.
+struct AutomatonInstance {
+    // Creates the instance with the initial values of the variables (defined in the core part).
+    explicit AutomatonInstance(std::uint32_t id);
+
+    // Instance id, the "@id" suffix of the inputs addressed to this instance.
+    std::uint32_t instanceId;
+
+    // --- Automaton Variables ---
+    // Variables use the type and name specified in the JSON/model.
+{% for var in variables %}
+    {{ var.type }} {{ var.name }}{};
+{% endfor %}
+
+    // --- Input / Output Values ---
+    std::array<InputSlot, kInputCount> inputSlots;
+    std::array<OutputSlot, kOutputCount> outputSlots;
+    // Values of names that are not declared inputs/outputs of the model (only reachable through
+    // names built at run time). std::less<> allows lookups by string_view.
+    std::map<std::string, std::string, std::less<>> undeclaredInputValues;
+    std::map<std::string, std::string> undeclaredOutputValues;
+
+    // The currently active state of the instance.
+    State currentState = State::STATE_NULL;
+    // Timestamp recorded when the current state was entered.
+    std::chrono::steady_clock::time_point stateEntryTime;
+    // The delayed transitions scheduled since the current state was entered.
+    std::vector<PendingTimer> pendingTimers;
+
+    // --- Helper Functions ---
+    // Inline, so every part of a split build can call them.
+
+    // Returns the time elapsed (in milliseconds) since entering the current state.
+    long long elapsed() const {
+        // Calculate duration between now and the state entry time.
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            automatonNow() - stateEntryTime
+        ).count();
+    }
+
+    // Returns the last value of the input in the given slot, "" before the first INPUT.
+    // Literal valueof("name") calls in actions and guards are generated as calls of this function.
+    const char* inputValueAt(std::size_t slot) const {
+        const InputSlot& input = inputSlots[slot];
+        if (!input.defined) {
+            IFA_LOG_DEBUG("[INPUT] valueof: Input '" << kEventNames[slot] << "' has no value yet.");
+        }
+        return input.value.c_str();
+    }
+
+    // Checks whether the input in the given slot has received a value.
+    // Literal defined("name") calls in actions and guards are generated as calls of this function.
+    bool inputDefinedAt(std::size_t slot) const {
+        return inputSlots[slot].defined;
+    }
+
+    // Retrieves the last known value of a specified input channel as a C-style string.
+    // Returns an empty string "" if the input name is not found.
+    const char* valueof(std::string_view name) const {
+        int slot = inputIndex(name);
+        if (slot >= 0) {
+            return inputValueAt(static_cast<std::size_t>(slot));
+        }
+        auto it_input = undeclaredInputValues.find(name);
+        if (it_input != undeclaredInputValues.end()) {
+            return it_input->second.c_str();
+        }
+        IFA_LOG_WARN("[WARNING] valueof: Name '" << name << "' not found.");
+        return "";
+    }
+
+    // Checks if an input event for the given input name has been received previously.
+    bool defined(std::string_view input_name) const {
+        int slot = inputIndex(input_name);
+        if (slot >= 0) {
+            return inputDefinedAt(static_cast<std::size_t>(slot));
+        }
+        return undeclaredInputValues.find(input_name) != undeclaredInputValues.end();
+    }
+
+    // Sends a value of the output in the given slot through the runtime engine.
+    // Literal output("name", value) calls in actions are generated as calls of this function.
+    template<typename T>
+    void outputAt(std::size_t slot, const T& value);
+
+    // Sends an output value through the runtime engine.
+    // Converts the provided value to a string before sending.
+    template<typename T>
+    void output(const std::string& output_name, const T& value);
+
+    // --- Generated Functions ---
+    // State actions, guards and delays; defined in automaton_state.tpl (one part per state in a split build).
+{% for state in states %}
+    void {{ state.func_id }}();
+{% endfor %}
+{% for trans in transitions %}
+  {% if trans.guard %}
+    bool check_guard_{{ trans.template_index0 }}();
+  {% endif %}
+  {% if trans.delay or trans.delay_var_original %}
+    long long transition_delay_{{ trans.template_index0 }}();
+  {% endif %}
+{% endfor %}
+
+    // --- Core Logic ---
+    // Defined in automaton_core.tpl.
+
+    // Enters the initial state and processes the transitions leaving it.
+    void start();
+    // Executes the action associated with the current state and updates status.
+    void executeCurrentStateAction();
+    // Performs the transition to the next state.
+    void performStateTransition(State nextState);
+    // Schedules a delayed transition of this instance.
+    void scheduleTransition(long long delayMs, State target);
+    // Cancels the delayed transitions scheduled since the current state was entered.
+    void cancelTransitions();
+    // Processes transitions based on current state and optional event. Returns true if a state change occurred.
+    // The event is passed as its event id (-1 for a name that is not an event of the automaton).
+    bool processTransitions(std::optional<int> event = std::nullopt);
+    // Handles an INPUT addressed to this instance (storeInput() followed by processEvent()).
+    void handleEvent(std::string_view inputName, std::string_view value);
+    // Records the value of an INPUT; eventId is lookupEvent(inputName).
+    void storeInput(int eventId, std::string_view inputName, std::string_view value);
+    // Processes the transitions triggered by an event (-1 for a name that is not an event).
+    void processEvent(int eventId);
+    // Handles the expiry of a timer scheduled by this instance.
+    void handleTimeout(const std::string& targetStateName);
+    // Takes a delayed transition whose timer expired.
+    void fireTransition(State target);
+    // Sends the state, variables and outputs of this instance (reply to GET_STATUS).
+    void sendStatus();
+    // Appends the state, variables, input/output values and pending timers to a checkpoint.
+    void saveSnapshot(ifa_runtime::SnapshotWriter& out) const;
+    // Loads what saveSnapshot() wrote after the instance id; the delayed transitions are returned
+    // for resume(). Returns false if the snapshot is corrupt.
+    bool restoreSnapshot(ifa_runtime::SnapshotReader& in, RestoredTimers& timers);
+    // Continues a restored instance: re-schedules its delayed transitions and sends its status.
+    void resume(const RestoredTimers& timers);
+};
+
+// The instances of the automaton, indexed by instance id.
+extern std::vector<AutomatonInstance> instances;
+
+template<typename T>
+void AutomatonInstance::outputAt(std::size_t slot, const T& value) {
+    OutputSlot& out = outputSlots[slot];
+    // Strings are assigned directly (reusing the slot's capacity); integers are formatted with
+    // std::to_chars (same text as operator<<), other types through a stringstream.
+    if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        out.value.assign(std::string_view(value));
+    } else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) > 1) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.value.assign(digits, result.ptr);
+    } else {
+        std::stringstream ss;
+        ss << value;
+        out.value = ss.str();
+    }
+    out.sent = true;
+
+    IFA_LOG_DEBUG("[OUTPUT] Sending output: " << kOutputNames[slot] << " = " << out.value);
+    engine.sendOutputById(static_cast<std::uint16_t>(slot), out.value);
+}
+
+template<typename T>
+void AutomatonInstance::output(const std::string& output_name, const T& value) {
+    int slot = outputIndex(output_name);
+    if (slot >= 0) {
+        outputAt(static_cast<std::size_t>(slot), value);
+        return;
+    }
+    // Output not declared in the model: sent by name
+    std::stringstream ss;
+    ss << value;
+    std::string value_str = ss.str();
+    IFA_LOG_DEBUG("[OUTPUT] Sending output: " << output_name << " = " << value_str);
+    engine.sendOutputUpdate(output_name, value_str);
+    undeclaredOutputValues[output_name] = value_str;
+}
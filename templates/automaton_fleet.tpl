@@ -0,0 +1,284 @@
+{#
+  automaton_fleet.tpl - Fleet simulation: main() of an automaton built with -DIFA_AUTOMATON_FLEET.
+
+  Included by automaton_core.tpl in place of the standalone main(). Instead of talking to the
+  GUI, the executable steps many instances of the automaton through recorded inputs in
+  simulated time and reports the throughput.
+#}
+// --- Fleet Simulation ---
+// Built with -DIFA_AUTOMATON_FLEET (and optimization, e.g. -O2), the automaton is a simulator
+// which advances N instances in lockstep, one tick of simulated time at a time, and reports
+// the steps executed per second (inputs processed plus timers fired). Usage:
+//   ./automaton [--instances N] [--ticks T] [--tick-ms MS] [--log-level LEVEL] [inputs.txt]
+// Each line of the input file is "<time_ms> <instance|*> <input> [value]", where "*" addresses
+// every instance; lines starting with '#' are ignored.
+//
+// The data scanned every tick lives in struct-of-arrays layout: the state and the earliest
+// timer deadline of all instances, each in an array of its own. The scans over these arrays
+// are branch-free, so the compiler can vectorize them, and only the instances they select are
+// touched. The variables and input values stay in the AutomatonInstance objects, because the
+// actions and guards are arbitrary C++ code working on them.
+
+std::chrono::steady_clock::time_point fleetNow;
+
+namespace {
+
+// Deadline of an instance without pending timers.
+constexpr std::int64_t kNoDeadline = std::numeric_limits<std::int64_t>::max();
+
+// One delayed transition of an instance.
+struct FleetTimer {
+    std::int64_t deadline; // Simulated time in ms
+    State target;
+};
+
+// One line of the input file.
+struct FleetInput {
+    std::int64_t time;     // Simulated time in ms
+    std::int64_t instance; // Instance id, -1 for all instances
+    std::string name;
+    std::string value;
+    int eventId;           // lookupEvent(name)
+};
+
+// State of the simulation.
+struct Fleet {
+    // Simulated time in ms.
+    std::int64_t nowMs = 0;
+
+    // --- Struct of arrays, indexed by instance id ---
+    // Current state (copy of AutomatonInstance::currentState, refreshed by syncState()).
+    std::vector<std::uint16_t> state;
+    // Earliest deadline of the instance's timers, kNoDeadline if it has none.
+    std::vector<std::int64_t> nextDeadline;
+    // Pending timers in order of scheduling; only read for instances with a due deadline.
+    std::vector<std::vector<FleetTimer>> timers;
+    // Scratch list of the instances selected by a scan.
+    std::vector<std::uint32_t> selected;
+
+    // --- Statistics ---
+    // Inputs delivered to an instance.
+    std::uint64_t events = 0;
+    // Inputs an instance processed (delivered to it alone, or with transitions in its state).
+    std::uint64_t processed = 0;
+    // Delayed transitions taken.
+    std::uint64_t timerFirings = 0;
+};
+
+Fleet fleet;
+
+// Refreshes the state copy of an instance after the simulation called into it.
+inline void syncState(std::uint32_t id) {
+    fleet.state[id] = static_cast<std::uint16_t>(instances[id].currentState);
+}
+
+// Delivers one recorded input to its instance, or to all instances.
+void deliverInput(const FleetInput& input) {
+    std::uint32_t count = static_cast<std::uint32_t>(instances.size());
+    if (input.instance >= 0) {
+        if (input.instance >= static_cast<std::int64_t>(count)) {
+            IFA_LOG_WARN("[Fleet] Input for unknown instance " << input.instance << " ignored.");
+            return;
+        }
+        std::uint32_t id = static_cast<std::uint32_t>(input.instance);
+        instances[id].storeInput(input.eventId, input.name, input.value);
+        instances[id].processEvent(input.eventId);
+        syncState(id);
+        ++fleet.events;
+        ++fleet.processed;
+        return;
+    }
+
+    // Every instance records the value, but only those whose current state has transitions for
+    // the event process it; they are selected with a branch-free lookup in the transition table.
+    for (AutomatonInstance& instance : instances) {
+        instance.storeInput(input.eventId, input.name, input.value);
+    }
+    fleet.events += count;
+    if (input.eventId < 0) {
+        return; // Not an event of the automaton, no transitions
+    }
+    const std::uint16_t* state = fleet.state.data();
+    std::uint32_t* selected = fleet.selected.data();
+    std::size_t event = static_cast<std::size_t>(input.eventId);
+    std::uint32_t found = 0;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        selected[found] = i;
+        found += kTransitionTable[state[i]][event].count != 0;
+    }
+    for (std::uint32_t k = 0; k < found; ++k) {
+        std::uint32_t id = selected[k];
+        instances[id].processEvent(input.eventId);
+        syncState(id);
+    }
+    fleet.processed += found;
+}
+
+// Takes the delayed transitions due at the current tick.
+void fireDueTimers() {
+    std::uint32_t count = static_cast<std::uint32_t>(instances.size());
+    const std::int64_t now = fleet.nowMs;
+    const std::int64_t* deadline = fleet.nextDeadline.data();
+    std::uint32_t* selected = fleet.selected.data();
+    std::uint32_t found = 0;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        selected[found] = i;
+        found += deadline[i] <= now;
+    }
+    for (std::uint32_t k = 0; k < found; ++k) {
+        std::uint32_t id = selected[k];
+        // The earliest timer fires (the first scheduled among equal deadlines); the transition
+        // cancels the others, as with the engine's timers.
+        const std::vector<FleetTimer>& timers = fleet.timers[id];
+        State target = std::min_element(timers.begin(), timers.end(), [](const FleetTimer& a, const FleetTimer& b) {
+            return a.deadline < b.deadline;
+        })->target;
+        ++fleet.timerFirings;
+        instances[id].fireTransition(target);
+        syncState(id);
+    }
+}
+
+// Reads the recorded inputs; returns false if the file cannot be read.
+bool loadFleetInputs(const std::string& path, std::vector<FleetInput>& inputs) {
+    std::ifstream file(path);
+    if (!file) {
+        IFA_LOG_ERROR("[Fleet] ERROR: Cannot open input file '" << path << "'.");
+        return false;
+    }
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        FleetInput input;
+        std::string instance;
+        input.instance = -1;
+        if (!(fields >> input.time >> instance >> input.name) ||
+            (instance != "*" && (!(std::istringstream(instance) >> input.instance) || input.instance < 0))) {
+            IFA_LOG_WARN("[Fleet] WARNING: Malformed line " << lineNumber << " ignored.");
+            continue;
+        }
+        std::getline(fields >> std::ws, input.value);
+        input.eventId = lookupEvent(input.name);
+        inputs.push_back(std::move(input));
+    }
+    // Inputs of the same time keep the order of the file.
+    std::stable_sort(inputs.begin(), inputs.end(), [](const FleetInput& a, const FleetInput& b) {
+        return a.time < b.time;
+    });
+    return true;
+}
+
+} // namespace
+
+void fleetSchedule(std::uint32_t instanceId, long long delayMs, State target) {
+    if (delayMs <= 0) {
+        // As with Engine::scheduleTimer(), timers are only for positive delays.
+        IFA_LOG_ERROR("[Fleet] Instance " << instanceId << ": attempted to schedule timer with non-positive delay.");
+        return;
+    }
+    std::int64_t deadline = fleet.nowMs + delayMs;
+    fleet.timers[instanceId].push_back(FleetTimer{deadline, target});
+    fleet.nextDeadline[instanceId] = std::min(fleet.nextDeadline[instanceId], deadline);
+}
+
+void fleetCancel(std::uint32_t instanceId) {
+    fleet.timers[instanceId].clear(); // Keeps the capacity for the next state
+    fleet.nextDeadline[instanceId] = kNoDeadline;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long instanceCount = 1000;
+    std::int64_t ticks = 10000;
+    std::int64_t tickMs = 1;
+    std::string inputPath;
+    // Per-transition log lines would dominate the run time; --log-level overrides this.
+    ifa_runtime::Logger::instance().setLevel(ifa_runtime::LogLevel::Warn);
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "--instances" || arg == "--ticks" || arg == "--tick-ms") && i + 1 < argc) {
+            try {
+                long long value = std::stoll(argv[++i]);
+                if (arg == "--instances") instanceCount = static_cast<unsigned long>(std::clamp<long long>(value, 1, std::numeric_limits<std::uint32_t>::max()));
+                else if (arg == "--ticks") ticks = std::max<long long>(value, 0);
+                else tickMs = std::max<long long>(value, 1);
+            } catch (const std::exception& e) {
+                IFA_LOG_WARN("[Config] WARNING: Invalid value '" << argv[i] << "' for option '" << arg << "' ignored.");
+            }
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            ifa_runtime::LogLevel logLevel;
+            if (ifa_runtime::parseLogLevel(argv[++i], logLevel)) {
+                ifa_runtime::Logger::instance().setLevel(logLevel);
+            } else {
+                IFA_LOG_WARN("[Config] WARNING: Unknown log level '" << argv[i] << "' ignored.");
+            }
+        } else if (arg.rfind("--", 0) == 0) {
+            IFA_LOG_WARN("[Config] WARNING: Unknown option '" << arg << "' ignored.");
+        } else {
+            inputPath = arg;
+        }
+    }
+
+    std::vector<FleetInput> inputs;
+    if (!inputPath.empty() && !loadFleetInputs(inputPath, inputs)) {
+        return 1;
+    }
+    // The engine is never run, so it must not keep Ctrl+C from ending the simulation.
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+
+    initStateMaps();
+    instances.reserve(instanceCount);
+    fleet.state.resize(instanceCount);
+    fleet.nextDeadline.assign(instanceCount, kNoDeadline);
+    fleet.timers.resize(instanceCount);
+    fleet.selected.resize(instanceCount);
+
+    auto wallStart = std::chrono::steady_clock::now();
+    fleetNow = std::chrono::steady_clock::time_point{};
+    for (unsigned long id = 0; id < instanceCount; ++id) {
+        instances.emplace_back(static_cast<std::uint32_t>(id));
+        instances.back().start();
+        syncState(static_cast<std::uint32_t>(id));
+    }
+
+    // Each tick delivers the inputs recorded up to its time, then takes the due delayed transitions.
+    std::size_t nextInput = 0;
+    for (std::int64_t tick = 0; tick < ticks; ++tick) {
+        fleet.nowMs = tick * tickMs;
+        fleetNow = std::chrono::steady_clock::time_point{} + std::chrono::milliseconds(fleet.nowMs);
+        while (nextInput < inputs.size() && inputs[nextInput].time <= fleet.nowMs) {
+            deliverInput(inputs[nextInput++]);
+        }
+        fireDueTimers();
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    // --- Report ---
+    // A step is an input processed by an instance or a timer fired; an instance-tick is one
+    // instance advanced by one tick, whether or not it had anything to do.
+    double steps = static_cast<double>(fleet.processed + fleet.timerFirings);
+    double instanceTicks = static_cast<double>(instanceCount) * static_cast<double>(ticks);
+    double simulatedSeconds = static_cast<double>(ticks * tickMs) / 1000.0;
+    std::cout << std::fixed << std::setprecision(3)
+              << "Fleet " << AUTOMATON_NAME << ": " << instanceCount << " instances, " << ticks << " ticks of "
+              << tickMs << " ms (" << simulatedSeconds << " s simulated)\n"
+              << "Inputs: " << fleet.events << " delivered, " << fleet.processed << " processed, timers: "
+              << fleet.timerFirings << " fired\n"
+              << "Wall time: " << wallSeconds * 1000.0 << " ms, "
+              << std::setprecision(0) << (wallSeconds > 0 ? steps / wallSeconds : 0.0) << " steps/s, "
+              << (wallSeconds > 0 ? instanceTicks / wallSeconds : 0.0) << " instance-ticks/s, "
+              << std::setprecision(1) << (wallSeconds > 0 ? simulatedSeconds / wallSeconds : 0.0) << "x real time\n";
+    std::array<std::uint64_t, kStateCount> histogram{};
+    for (std::uint16_t state : fleet.state) {
+        ++histogram[state];
+    }
+    std::cout << "Final states:";
+    for (std::size_t state = 1; state < kStateCount; ++state) {
+        std::cout << " " << stateEnumToName[static_cast<State>(state)] << "=" << histogram[state];
+    }
+    std::cout << std::endl;
+    return 0;
+}
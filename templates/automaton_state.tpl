@@ -0,0 +1,47 @@
+{#
+  automaton_state.tpl - Generated functions of one state: its action and the guards and delays
+  of its outgoing transitions, members of AutomatonInstance. Expects "state" in the data.
+
+  Included once per state by automation_template.tpl; a split build renders it into one source
+  file per state, so editing one state's code recompiles only that file.
+#}
+// --- State {{ state.name }} ---
+
+// Action function for state: {{ state.name }}
+void AutomatonInstance::{{ state.func_id }}() {
+    IFA_LOG_DEBUG("[ACTION] Executing action for state {{ state.name }}");
+    // User-defined action code:
+    {{ state.action_cpp }}
+}
+{% for trans in state.outgoing_transitions %}
+  {% if trans.guard %}
+
+// Guard function for transition #{{ trans.template_index0 }} (Source: {{trans.source}}, Target: {{trans.target}})
+bool AutomatonInstance::check_guard_{{ trans.template_index0 }}() {
+    try {
+         // User-defined guard condition code:
+         // Uses original variable names and calls valueof("input_name") for inputs.
+        return ({{ trans.guard_cpp }});
+    } catch (const std::exception& e) {
+        // Basic error handling for exceptions during guard evaluation.
+        IFA_LOG_ERROR("[ERROR] Exception in guard_{{ trans.template_index0 }}: " << e.what());
+        return false;
+    } catch (...) {
+        IFA_LOG_ERROR("[ERROR] Unknown exception in guard_{{ trans.template_index0 }}");
+        return false;
+    }
+}
+  {% endif %}
+  {% if trans.delay or trans.delay_var_original %}
+
+// Delay of transition #{{ trans.template_index0 }} in milliseconds; -1 if the delay variable cannot be used.
+long long AutomatonInstance::transition_delay_{{ trans.template_index0 }}() {
+    {% if trans.delay and trans.delay > 0 %}
+    return {{ trans.delay }};
+    {% else %}
+    try { return static_cast<long long>({{ trans.delay_var_original }}); }
+    catch (...) { IFA_LOG_ERROR("[ERROR] Delay variable '{{ trans.delay_var_original }}' invalid!"); return -1; }
+    {% endif %}
+}
+  {% endif %}
+{% endfor %}
@@ -0,0 +1,22 @@
+# tests/expression_vm/expression_vm.pro
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+TARGET = ifa_test_expression_vm
+
+INCLUDEPATH += \
+    $$PWD/.. \
+    $$PWD/../../src
+
+SOURCES += \
+    test_expression_vm.cpp \
+    ../../src/core/Expression.cpp \
+    ../../src/core/ExpressionBytecode.cpp
+
+HEADERS += \
+    ../../src/core/Expression.h \
+    ../../src/core/ExpressionBytecode.h
+
+QMAKE_CXXFLAGS += -w
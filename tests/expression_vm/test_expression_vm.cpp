@@ -0,0 +1,170 @@
+/**
+ * @file test_expression_vm.cpp
+ * @brief Unit tests of the bytecode virtual machine running the interpreter's guards and actions.
+ * @details Covers the jumps of the short-circuit operators and of ?:, and the constant-operand
+ *          (*K) forms the compiler emits when the right operand of an operator is a literal.
+ *          Division by zero is used as a side effect showing which operands were evaluated.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_test.h"
+#include "core/Expression.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+/** @brief Slots of the variables of the tests. */
+enum Slot { kInt, kZero, kFloat, kText, kFlag };
+
+/**
+ * @brief An environment with one variable of each type and a log of the outputs.
+ */
+struct TestEnvironment : ExpressionEnvironment {
+    std::vector<Value> variables{7LL, 0LL, 2.5, std::string("abc"), false};
+    std::vector<std::string> outputs;
+
+    Value& variable(int slot) override { return variables[slot]; }
+    const std::string* inputValue(int, const std::string&) const override { return nullptr; }
+    long long elapsedMs() const override { return 0; }
+    void output(int, const std::string& name, const Value& value) override {
+        outputs.push_back(name + "=" + valueToString(value));
+    }
+};
+
+/** @brief The names of the variables of TestEnvironment. */
+ExpressionSymbols symbols() {
+    ExpressionSymbols result;
+    result.variables = {{"i", kInt}, {"zero", kZero}, {"d", kFloat}, {"s", kText}, {"flag", kFlag}};
+    result.outputs = {{"out", 0}};
+    return result;
+}
+
+/** @brief Evaluates an expression in a fresh environment. */
+Value evaluate(const std::string& source) {
+    TestEnvironment environment;
+    return Expression::parse(source, symbols()).evaluate(environment);
+}
+
+/** @brief Checks whether evaluating an expression throws (in a fresh environment). */
+bool throws(const std::string& source) {
+    try {
+        evaluate(source);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+/** @brief Executes an action on an environment. */
+void execute(const std::string& source, TestEnvironment& environment) {
+    ActionProgram::parse(source, symbols()).execute(environment);
+}
+
+// && and || skip their right operand once the left one decides the result.
+void testShortCircuit() {
+    IFA_CHECK(evaluate("zero != 0 && i / zero > 1") == Value(false));
+    IFA_CHECK(evaluate("zero == 0 || i / zero > 1") == Value(true));
+    IFA_CHECK(throws("zero == 0 && i / zero > 1"));
+    IFA_CHECK(throws("zero != 0 || i / zero > 1"));
+
+    // Operands that are not booleans are converted, whichever operand decides the result.
+    IFA_CHECK(evaluate("zero && i / zero") == Value(false));
+    IFA_CHECK(evaluate("i || i / zero") == Value(true));
+    IFA_CHECK(evaluate("i && s") == Value(true));
+    IFA_CHECK(evaluate("zero || d") == Value(true));
+    IFA_CHECK(evaluate("zero || zero") == Value(false));
+
+    // Nested operators jump past the right end of the enclosing expression.
+    IFA_CHECK(evaluate("zero != 0 && i / zero > 1 || i == 7") == Value(true));
+    IFA_CHECK(evaluate("i == 7 || (i / zero > 1 && zero != 0)") == Value(true));
+    IFA_CHECK(evaluate("(zero == 0 || i / zero > 1) && (i > 100 || d < 3)") == Value(true));
+    IFA_CHECK(evaluate("!(zero != 0 && i / zero > 1)") == Value(true));
+
+    // In an action, the skipped operand has no side effect.
+    TestEnvironment environment;
+    execute("flag && ++i; zero == 0 || i++; flag || (i += 10);", environment);
+    IFA_CHECK(environment.variables[kInt] == Value(17LL));
+}
+
+// ?: evaluates the condition and exactly one of its branches.
+void testConditional() {
+    IFA_CHECK(evaluate("i > 5 ? 1 : 2") == Value(1LL));
+    IFA_CHECK(evaluate("i > 50 ? 1 : 2") == Value(2LL));
+    IFA_CHECK(evaluate("zero ? i / zero : i") == Value(7LL));
+    IFA_CHECK(evaluate("i ? i : i / zero") == Value(7LL));
+    IFA_CHECK(evaluate("flag ? \"yes\" : \"no\"") == Value(std::string("no")));
+
+    // Right associative: a ? b : c ? d : e is a ? b : (c ? d : e).
+    IFA_CHECK(evaluate("i < 0 ? 1 : i < 10 ? 2 : 3") == Value(2LL));
+    IFA_CHECK(evaluate("i < 0 ? 1 : i < 5 ? 2 : 3") == Value(3LL));
+
+    // As an operand, and with operators in its branches.
+    IFA_CHECK(evaluate("(zero ? 10 : 20) + 1") == Value(21LL));
+    IFA_CHECK(evaluate("i > 5 && d > 2 ? i * 2 : i / zero") == Value(14LL));
+
+    TestEnvironment environment;
+    execute("i = zero ? i / zero : i - 1; output(\"out\", flag ? 1 : i);", environment);
+    IFA_CHECK(environment.variables[kInt] == Value(6LL));
+    IFA_CHECK((environment.outputs == std::vector<std::string>{"out=6"}));
+}
+
+// A literal right operand is read from the constants (AddK ... NotEqualK), with the same
+// conversions as the register forms.
+void testConstantOperands() {
+    IFA_CHECK(evaluate("i + 3") == Value(10LL));
+    IFA_CHECK(evaluate("i - 10") == Value(-3LL));
+    IFA_CHECK(evaluate("i * 6") == Value(42LL));
+    IFA_CHECK(evaluate("i / 2") == Value(3LL));
+    IFA_CHECK(evaluate("i % 4") == Value(3LL));
+    IFA_CHECK(evaluate("i + 0.5") == Value(7.5));
+    IFA_CHECK(evaluate("d * 2") == Value(5.0));
+    IFA_CHECK(evaluate("d / 2") == Value(1.25));
+    IFA_CHECK(evaluate("flag + 1") == Value(1LL));
+    IFA_CHECK(evaluate("s + \"def\"") == Value(std::string("abcdef")));
+
+    IFA_CHECK(evaluate("i < 8") == Value(true));
+    IFA_CHECK(evaluate("i <= 6") == Value(false));
+    IFA_CHECK(evaluate("i > 6.5") == Value(true));
+    IFA_CHECK(evaluate("i >= 7") == Value(true));
+    IFA_CHECK(evaluate("i == 7") == Value(true));
+    IFA_CHECK(evaluate("i != 7") == Value(false));
+    IFA_CHECK(evaluate("d == 2.5") == Value(true));
+    IFA_CHECK(evaluate("flag == false") == Value(true));
+    IFA_CHECK(evaluate("s == \"abc\"") == Value(true));
+    IFA_CHECK(evaluate("s < \"abd\"") == Value(true));
+
+    // Invalid operations are reported as by the register forms.
+    IFA_CHECK(throws("i / 0"));
+    IFA_CHECK(throws("i % 0"));
+    IFA_CHECK(throws("d % 2"));
+    IFA_CHECK(throws("s + 1"));
+    IFA_CHECK(throws("s == 1"));
+    IFA_CHECK(throws("i + \"x\""));
+
+    // A compound assignment with a literal uses the constant form and converts to the variable's type.
+    TestEnvironment environment;
+    execute("i += 5; i -= 2; i *= 3; i /= 4; d *= 2; s += \"!\"; i += 0.9;", environment);
+    IFA_CHECK(environment.variables[kInt] == Value(7LL));
+    IFA_CHECK(environment.variables[kFloat] == Value(5.0));
+    IFA_CHECK(environment.variables[kText] == Value(std::string("abc!")));
+    bool divisionByZero = false;
+    try {
+        execute("i %= 0;", environment);
+    } catch (const std::runtime_error&) {
+        divisionByZero = true;
+    }
+    IFA_CHECK(divisionByZero);
+    IFA_CHECK(environment.variables[kInt] == Value(7LL));
+}
+
+} // namespace
+
+int main() {
+    testShortCircuit();
+    testConditional();
+    testConstantOperands();
+    return ifa_test::finish("ifa_test_expression_vm");
+}
@@ -0,0 +1,55 @@
+/**
+ * @file ifa_test.h
+ * @brief Minimal checking helpers shared by the unit test programs in tests/.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#ifndef IFA_TEST_H
+#define IFA_TEST_H
+
+#include <iostream>
+
+namespace ifa_test {
+
+/**
+ * @brief Gets the number of failed checks of the running test program.
+ * @return int& The counter.
+ */
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+/**
+ * @brief Records the result of one check and reports a failure on stderr.
+ * @param ok The checked condition.
+ * @param expression The source text of the condition.
+ * @param file The source file of the check.
+ * @param line The source line of the check.
+ */
+inline void check(bool ok, const char* expression, const char* file, int line) {
+    if (!ok) {
+        std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+        ++failures();
+    }
+}
+
+/**
+ * @brief Prints the summary of a test program.
+ * @param name Name of the test program.
+ * @return int Exit code of the program (0 if all checks passed).
+ */
+inline int finish(const char* name) {
+    std::cout << name << ": " << (failures() == 0 ? "passed" : "FAILED") << " (" << failures() << " failed checks)" << std::endl;
+    return failures() == 0 ? 0 : 1;
+}
+
+} // namespace ifa_test
+
+/**
+ * @brief Checks a condition; the test program continues after a failed check.
+ */
+#define IFA_CHECK(condition) ::ifa_test::check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+#endif // IFA_TEST_H
@@ -0,0 +1,20 @@
+# tests/io_calls/io_calls.pro
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+TARGET = ifa_test_io_calls
+
+INCLUDEPATH += \
+    $$PWD/.. \
+    $$PWD/../../src
+
+SOURCES += \
+    test_io_calls.cpp \
+    ../../src/persistence/io_call_rewriter.cpp
+
+HEADERS += \
+    ../../src/persistence/io_call_rewriter.h
+
+QMAKE_CXXFLAGS += -w
@@ -0,0 +1,109 @@
+/**
+ * @file test_io_calls.cpp
+ * @brief Unit tests of the scanner rewriting input/output calls in action and guard code.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_test.h"
+#include "persistence/io_call_rewriter.h"
+#include <iostream>
+#include <string>
+
+namespace {
+
+const std::map<std::string, size_t> kInputs{{"ped_button", 0}, {"timeout", 1}};
+const std::map<std::string, size_t> kOutputs{{"lamp", 0}, {"beeper", 1}};
+
+/**
+ * @brief Checks that rewriting code gives the expected result and reports the difference.
+ * @param code The action or guard code.
+ * @param expected The expected rewritten code.
+ * @param line The line of the calling check.
+ */
+void expectRewrite(const std::string& code, const std::string& expected, int line) {
+    const std::string actual = rewrite_io_calls(code, kInputs, kOutputs);
+    ifa_test::check(actual == expected, "rewrite_io_calls(code) == expected", __FILE__, line);
+    if (actual != expected) {
+        std::cerr << "  code:     " << code << "\n  expected: " << expected << "\n  actual:   " << actual << std::endl;
+    }
+}
+
+/** @brief Checks that the code is copied unchanged. */
+void expectUnchanged(const std::string& code, int line) {
+    expectRewrite(code, code, line);
+}
+
+// Calls with a literal name of a declared input/output become slot accesses.
+void testRewrittenCalls() {
+    expectRewrite("if (valueof(\"ped_button\") == \"1\") output(\"lamp\", 1);",
+                  "if (inputValueAt(0) == \"1\") outputAt(0, 1);", __LINE__);
+    expectRewrite("defined( \"timeout\" ) && valueof (\"timeout\")",
+                  "inputDefinedAt(1) && inputValueAt(1)", __LINE__);
+    expectRewrite("output(\"beeper\",\n       valueof(\"ped_button\"));",
+                  "outputAt(1,\n       inputValueAt(0));", __LINE__);
+}
+
+// Comments are copied as they are, code after them is still rewritten.
+void testComments() {
+    expectUnchanged("// output(\"lamp\", 1);", __LINE__);
+    expectUnchanged("/* valueof(\"ped_button\") */", __LINE__);
+    expectRewrite("/* output(\"lamp\", 0); */ output(\"lamp\", 1); // valueof(\"timeout\")\ndefined(\"timeout\");",
+                  "/* output(\"lamp\", 0); */ outputAt(0, 1); // valueof(\"timeout\")\ninputDefinedAt(1);", __LINE__);
+    // An unterminated block comment runs to the end of the code.
+    expectUnchanged("x = 1; /* output(\"lamp\", 1);", __LINE__);
+}
+
+// String, character and raw string literals are copied as they are.
+void testLiterals() {
+    expectUnchanged("log(\"valueof(\\\"ped_button\\\")\");", __LINE__);
+    expectUnchanged("char q = '\"'; char r = '\\'';", __LINE__);
+    expectRewrite("char q = '\"'; output(\"lamp\", q);", "char q = '\"'; outputAt(0, q);", __LINE__);
+    expectUnchanged("auto s = R\"(output(\"lamp\", 1))\";", __LINE__);
+    expectRewrite("auto s = R\"x(valueof(\"timeout\") )\" )x\"; output(\"lamp\", s);",
+                  "auto s = R\"x(valueof(\"timeout\") )\" )x\"; outputAt(0, s);", __LINE__);
+    expectUnchanged("auto s = u8R\"(defined(\"timeout\"))\";", __LINE__);
+    // R not followed by a quote is an ordinary identifier.
+    expectRewrite("R = valueof(\"timeout\");", "R = inputValueAt(1);", __LINE__);
+}
+
+// Member and qualified calls belong to other objects and are not rewritten.
+void testMemberCalls() {
+    expectUnchanged("a.output(\"lamp\", 1);", __LINE__);
+    expectUnchanged("a . output(\"lamp\", 1);", __LINE__);
+    expectUnchanged("p->valueof(\"ped_button\");", __LINE__);
+    expectUnchanged("ns::output(\"lamp\", 1);", __LINE__);
+    expectUnchanged("ns :: defined(\"timeout\");", __LINE__);
+    expectRewrite("a.output(\"lamp\", 1); output(\"lamp\", 2);", "a.output(\"lamp\", 1); outputAt(0, 2);", __LINE__);
+}
+
+// Digit separators are part of the number, not the start of a character literal.
+void testDigitSeparators() {
+    expectRewrite("long n = 1'000'000; output(\"lamp\", n);", "long n = 1'000'000; outputAt(0, n);", __LINE__);
+    expectRewrite("x = 0x7f'ff + 0b1010'0101 + valueof(\"timeout\");", "x = 0x7f'ff + 0b1010'0101 + inputValueAt(1);", __LINE__);
+    expectRewrite("x = 1'0; c = 'a'; defined(\"timeout\");", "x = 1'0; c = 'a'; inputDefinedAt(1);", __LINE__);
+}
+
+// Calls that do not match the expected form or name no declared input/output stay as they are.
+void testUnmatchedCalls() {
+    expectUnchanged("valueof(\"unknown\"); output(\"unknown\", 1);", __LINE__);
+    expectUnchanged("valueof(name); output(name, 1);", __LINE__);
+    expectUnchanged("valueof(\"ped\\\"button\");", __LINE__);
+    expectUnchanged("output(\"lamp\");", __LINE__);
+    expectUnchanged("valueof(\"ped_button\", 1);", __LINE__);
+    expectUnchanged("my_output(\"lamp\", 1); outputs(\"lamp\", 1); valueof2(\"timeout\");", __LINE__);
+    expectUnchanged("output", __LINE__);
+    expectUnchanged("", __LINE__);
+}
+
+} // namespace
+
+int main() {
+    testRewrittenCalls();
+    testComments();
+    testLiterals();
+    testMemberCalls();
+    testDigitSeparators();
+    testUnmatchedCalls();
+    return ifa_test::finish("ifa_test_io_calls");
+}
@@ -0,0 +1,159 @@
+/**
+ * @file test_protocol.cpp
+ * @brief Unit tests of the binary wire protocol codec (encoding and RecordReader).
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_test.h"
+#include "runtime/ifa_runtime_protocol.h"
+#include <string>
+#include <vector>
+
+using namespace ifa_runtime::protocol;
+
+namespace {
+
+/**
+ * @brief Decodes all records of a datagram.
+ * @param datagram The datagram.
+ * @param malformed Receives RecordReader::malformed() after the last record.
+ * @return std::vector<Record> The records (views into the datagram).
+ */
+std::vector<Record> readAll(const std::string& datagram, bool& malformed) {
+    RecordReader reader(datagram.data(), datagram.size());
+    std::vector<Record> records;
+    Record record;
+    while (reader.next(record)) {
+        records.push_back(record);
+    }
+    malformed = reader.malformed();
+    return records;
+}
+
+// Every record kind survives an encode/decode round trip, values are carried as raw bytes.
+void testRoundTrip() {
+    const std::string rawValue("a|b=\"c\"\n\0d", 11);
+    std::string datagram;
+    appendHeader(datagram);
+    appendRecord(datagram, RecordType::Name, "TrafficLight");
+    appendSymbolRecord(datagram, SymbolKind::Output, 513, "lamp");
+    appendInstanceRecord(datagram, 0x01020304u);
+    appendIdRecord(datagram, RecordType::State, 7);
+    appendIdRecord(datagram, RecordType::Output, 513, rawValue);
+    appendRecord(datagram, RecordType::Terminating, {});
+
+    IFA_CHECK(isBinaryDatagram(datagram.data(), datagram.size()));
+    bool malformed = true;
+    std::vector<Record> records = readAll(datagram, malformed);
+    IFA_CHECK(!malformed);
+    IFA_CHECK(records.size() == 6);
+    if (records.size() != 6) {
+        return;
+    }
+
+    IFA_CHECK(records[0].type == RecordType::Name && records[0].payload == "TrafficLight");
+
+    IFA_CHECK(records[1].type == RecordType::Symbol);
+    IFA_CHECK(records[1].payload.size() == 3 + 4 && records[1].payload[0] == static_cast<char>(SymbolKind::Output));
+    std::uint16_t id = 0;
+    std::string_view value;
+    IFA_CHECK(splitIdPayload(records[1].payload.substr(1), id, value) && id == 513 && value == "lamp");
+
+    std::uint32_t instance = 0;
+    IFA_CHECK(records[2].type == RecordType::Instance);
+    IFA_CHECK(readInstancePayload(records[2].payload, instance) && instance == 0x01020304u);
+
+    IFA_CHECK(records[3].type == RecordType::State);
+    IFA_CHECK(splitIdPayload(records[3].payload, id, value) && id == 7 && value.empty());
+
+    IFA_CHECK(records[4].type == RecordType::Output);
+    IFA_CHECK(splitIdPayload(records[4].payload, id, value) && id == 513 && value == rawValue);
+
+    IFA_CHECK(records[5].type == RecordType::Terminating && records[5].payload.empty());
+}
+
+// Payloads longer than a record can hold are cut at kMaxRecordPayload.
+void testOversizedPayload() {
+    std::string datagram;
+    appendHeader(datagram);
+    appendIdRecord(datagram, RecordType::Variable, 1, std::string(kMaxRecordPayload + 10, 'x'));
+    bool malformed = true;
+    std::vector<Record> records = readAll(datagram, malformed);
+    IFA_CHECK(!malformed);
+    IFA_CHECK(records.size() == 1 && records[0].payload.size() == kMaxRecordPayload);
+}
+
+// Datagrams that are not binary protocol, or of another version, are rejected as a whole.
+void testForeignDatagrams() {
+    const std::string text = "INPUT|ped_button|1";
+    IFA_CHECK(!isBinaryDatagram(text.data(), text.size()));
+    IFA_CHECK(!RecordReader(text.data(), text.size()).valid());
+
+    std::string shortHeader(kMagic, sizeof(kMagic));
+    IFA_CHECK(!isBinaryDatagram(shortHeader.data(), shortHeader.size()));
+
+    std::string otherVersion(kMagic, sizeof(kMagic));
+    otherVersion.push_back(static_cast<char>(kVersion + 1));
+    appendRecord(otherVersion, RecordType::Log, "hello");
+    RecordReader reader(otherVersion.data(), otherVersion.size());
+    Record record;
+    IFA_CHECK(!reader.valid());
+    IFA_CHECK(!reader.next(record));
+    IFA_CHECK(!reader.malformed());
+}
+
+// A truncated record ends the datagram: the records before it are returned, then malformed() is set.
+void testTruncatedRecords() {
+    std::string datagram;
+    appendHeader(datagram);
+    appendRecord(datagram, RecordType::Log, "first");
+    const std::size_t complete = datagram.size();
+    appendRecord(datagram, RecordType::Log, "second");
+
+    // Cut inside the second record's payload, then inside its header.
+    for (std::size_t cut : {datagram.size() - 1, complete + 2, complete + 1}) {
+        const std::string truncated = datagram.substr(0, cut);
+        bool malformed = false;
+        std::vector<Record> records = readAll(truncated, malformed);
+        IFA_CHECK(records.size() == 1 && records[0].payload == "first");
+        IFA_CHECK(malformed);
+    }
+
+    // Only the header: no records and nothing malformed.
+    bool malformed = true;
+    IFA_CHECK(readAll(datagram.substr(0, kHeaderSize), malformed).empty());
+    IFA_CHECK(!malformed);
+
+    // Once malformed, the reader stays at the end.
+    std::string cut = datagram.substr(0, complete + 1);
+    RecordReader reader(cut.data(), cut.size());
+    Record record;
+    IFA_CHECK(reader.next(record));
+    IFA_CHECK(!reader.next(record));
+    IFA_CHECK(!reader.next(record));
+    IFA_CHECK(reader.malformed());
+}
+
+// Payload helpers reject payloads of the wrong size.
+void testMalformedPayloads() {
+    std::uint16_t id = 0;
+    std::string_view value;
+    IFA_CHECK(!splitIdPayload(std::string_view("\x01", 1), id, value));
+    IFA_CHECK(splitIdPayload(std::string_view("\x01\x00", 2), id, value) && id == 1 && value.empty());
+
+    std::uint32_t instance = 0;
+    IFA_CHECK(!readInstancePayload(std::string_view("\x01\x02\x03", 3), instance));
+    IFA_CHECK(!readInstancePayload(std::string_view("\x01\x02\x03\x04\x05", 5), instance));
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip();
+    testOversizedPayload();
+    testForeignDatagrams();
+    testTruncatedRecords();
+    testMalformedPayloads();
+    return ifa_test::finish("ifa_test_protocol");
+}
@@ -0,0 +1,117 @@
+/**
+ * @file test_scheduler.cpp
+ * @brief Tests the start-up of engines sharing a Scheduler.
+ * @details An engine between initialize() and run() must not occupy a worker thread, and none
+ *          of its handlers may run before run(). With a single worker thread, a second engine
+ *          has to start, run and stop while the first one is still starting up.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_test.h"
+#include "runtime/ifa_runtime_engine.h"
+#include "runtime/ifa_runtime_scheduler.h"
+#include <asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
+using namespace ifa_runtime;
+
+namespace {
+
+/** @brief Ports of the two engines and of the socket standing in for the GUI. */
+constexpr int kPortA = 47541;
+constexpr int kPortB = 47542;
+constexpr int kGuiPort = 47543;
+
+/**
+ * @brief Sets handlers that record the timeouts and stop the engine on the first one.
+ */
+void setStoppingHandlers(Engine& engine, std::atomic<int>& timeouts) {
+    engine.setEventHandlers(
+        [](std::string_view, std::string_view) {},
+        [&engine, &timeouts](const std::string&) {
+            ++timeouts;
+            engine.stop();
+        },
+        [&engine]() { engine.stop(); },
+        [](const std::string&) {},
+        []() {});
+}
+
+/**
+ * @brief Receives datagrams on the GUI port until none arrives for a while.
+ * @return int Number of datagrams received.
+ */
+int drainGui(asio::ip::udp::socket& gui) {
+    int received = 0;
+    char buffer[2048];
+    for (auto quiet = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+         std::chrono::steady_clock::now() < quiet;) {
+        asio::error_code error;
+        if (gui.available(error) > 0) {
+            gui.receive(asio::buffer(buffer), 0, error);
+            ++received;
+            quiet = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    return received;
+}
+
+} // namespace
+
+int main() {
+    asio::io_context io;
+    asio::ip::udp::socket gui(io, asio::ip::udp::endpoint(asio::ip::make_address("127.0.0.1"), kGuiPort));
+
+    Scheduler scheduler(1);
+    Engine a(scheduler);
+    Engine b(scheduler);
+    std::atomic<int> timeoutsA{0};
+    std::atomic<int> timeoutsB{0};
+
+    // A starts up: its timer is due almost at once and its messages are queued, but nothing of A may
+    // run on the worker thread before A's run().
+    IFA_CHECK(a.initialize("A", kPortA, "127.0.0.1", kGuiPort));
+    setStoppingHandlers(a, timeoutsA);
+    a.scheduleTimer(1, "NEXT");
+    a.sendStateUpdate("START");
+
+    // B starts, runs and stops on the single worker thread meanwhile.
+    auto runB = std::async(std::launch::async, [&]() {
+        if (!b.initialize("B", kPortB, "127.0.0.1", kGuiPort)) {
+            return false;
+        }
+        setStoppingHandlers(b, timeoutsB);
+        b.scheduleTimer(10, "NEXT");
+        b.run();
+        return true;
+    });
+    bool finishedB = runB.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+    IFA_CHECK(finishedB);
+    if (!finishedB) {
+        std::cerr << "engine B did not finish while engine A was starting up" << std::endl;
+        std::_Exit(1); // The blocked engine cannot be destroyed
+    }
+    IFA_CHECK(runB.get());
+    IFA_CHECK(timeoutsB == 1);
+    IFA_CHECK(timeoutsA == 0);
+
+    // B's READY, STATE-less stop: READY and TERMINATING; A's queued messages are still held.
+    int beforeRunA = drainGui(gui);
+    IFA_CHECK(beforeRunA == 2);
+
+    // A's run() releases its handlers: the queued messages go out and the due timer fires.
+    std::thread runA([&]() { a.run(); });
+    runA.join();
+    IFA_CHECK(timeoutsA == 1);
+    // READY, STATE START and TERMINATING of A.
+    IFA_CHECK(drainGui(gui) == 3);
+
+    return ifa_test::finish("ifa_test_scheduler");
+}
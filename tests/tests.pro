@@ -0,0 +1,11 @@
+# tests/tests.pro
+
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    expression_vm \
+    io_calls \
+    protocol \
+    scheduler \
+    timers \
+    udp_alloc
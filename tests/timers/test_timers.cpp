@@ -0,0 +1,154 @@
+/**
+ * @file test_timers.cpp
+ * @brief Unit tests of the timing wheel in TimerManager, driven by a virtual clock.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_test.h"
+#include "runtime/ifa_runtime_timers.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace ifa_runtime;
+
+namespace {
+
+/**
+ * @brief A TimerManager on a virtual clock recording the timers it fires.
+ */
+struct WheelFixture {
+    asio::io_context io;
+    HandlerTracker tracker;
+    VirtualClock clock;
+    std::vector<std::string> fired;
+    /** @brief Called after a fired timer has been recorded (may cancel or schedule timers). */
+    std::function<void(const std::string&)> onFire;
+    TimerManager timers{io.get_executor(), tracker, clock, [this](std::uint32_t, const std::string& target) {
+        fired.push_back(target);
+        if (onFire) {
+            onFire(target);
+        }
+    }};
+
+    /** @brief Fires every scheduled timer in order of expiry. */
+    void runAll() {
+        while (timers.advanceToNextTimer()) {
+        }
+    }
+};
+
+// A handler cancelling another timer due in the same tick must not see it fire afterwards.
+void testCancelSiblingFromHandler() {
+    WheelFixture f;
+    TimerHandle a = f.timers.scheduleTimer(50, "a");
+    TimerHandle b = f.timers.scheduleTimer(50, "b");
+    bool cancelled = false;
+    f.onFire = [&](const std::string& target) {
+        cancelled = f.timers.cancelTimer(target == "a" ? b : a);
+    };
+    f.runAll();
+    IFA_CHECK(f.fired.size() == 1);
+    IFA_CHECK(cancelled);
+    IFA_CHECK(f.timers.activeTimerCount() == 0);
+}
+
+// A handler cancelling its own (already fired) timer gets false and changes nothing.
+void testCancelSelfFromHandler() {
+    WheelFixture f;
+    TimerHandle self = f.timers.scheduleTimer(10, "self");
+    f.timers.scheduleTimer(20, "later");
+    bool cancelled = true;
+    f.onFire = [&](const std::string& target) {
+        if (target == "self") {
+            cancelled = f.timers.cancelTimer(self);
+        }
+    };
+    f.runAll();
+    IFA_CHECK(!cancelled);
+    IFA_CHECK((f.fired == std::vector<std::string>{"self", "later"}));
+    IFA_CHECK(f.timers.activeTimerCount() == 0);
+}
+
+// cancelAllTimers() from a handler drops the rest of the expiring slot and the later levels.
+void testCancelAllDuringExpiry() {
+    WheelFixture f;
+    f.timers.scheduleTimer(30, "x");
+    f.timers.scheduleTimer(30, "y");
+    f.timers.scheduleTimer(30, "z");
+    f.timers.scheduleTimer(5000, "far");
+    f.onFire = [&](const std::string&) {
+        f.timers.cancelAllTimers();
+    };
+    f.runAll();
+    IFA_CHECK(f.fired.size() == 1);
+    IFA_CHECK(f.timers.activeTimerCount() == 0);
+    IFA_CHECK(!f.timers.advanceToNextTimer());
+
+    // The wheel is usable again after being emptied from a handler.
+    f.onFire = nullptr;
+    f.timers.scheduleTimer(1, "again");
+    f.runAll();
+    IFA_CHECK(f.fired.size() == 2 && f.fired.back() == "again");
+}
+
+// A timer scheduled by a handler expires on a later tick, never in the slot being expired.
+void testScheduleFromHandler() {
+    WheelFixture f;
+    f.timers.scheduleTimer(0, "first");
+    f.onFire = [&](const std::string& target) {
+        if (target == "first") {
+            f.timers.scheduleTimer(0, "second");
+        }
+    };
+    IFA_CHECK(f.timers.advanceToNextTimer());
+    IFA_CHECK((f.fired == std::vector<std::string>{"first"}));
+    IFA_CHECK(f.timers.activeTimerCount() == 1);
+    f.runAll();
+    IFA_CHECK((f.fired == std::vector<std::string>{"first", "second"}));
+}
+
+// Delays on every wheel level (and beyond its range) fire in order after cascading.
+void testExpiryOrderAcrossLevels() {
+    WheelFixture f;
+    const std::vector<long long> delays{20000000, 300000, 5000, 70, 5};
+    for (long long delay : delays) {
+        f.timers.scheduleTimer(delay, std::to_string(delay));
+    }
+    auto start = f.clock.now();
+    std::vector<long long> firedAfter;
+    f.onFire = [&](const std::string&) {
+        firedAfter.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(f.clock.now() - start).count());
+    };
+    f.runAll();
+    IFA_CHECK((f.fired == std::vector<std::string>{"5", "70", "5000", "300000", "20000000"}));
+    IFA_CHECK((firedAfter == std::vector<long long>{5, 70, 5000, 300000, 20000000}));
+}
+
+// A handle of a cancelled timer does not cancel the timer that reuses its pool node.
+void testStaleHandle() {
+    WheelFixture f;
+    TimerHandle old = f.timers.scheduleTimer(10, "old");
+    IFA_CHECK(f.timers.cancelTimer(old));
+    IFA_CHECK(!f.timers.cancelTimer(old));
+    TimerHandle reused = f.timers.scheduleTimer(10, "new");
+    IFA_CHECK(reused != old);
+    IFA_CHECK(!f.timers.cancelTimer(old));
+    IFA_CHECK(f.timers.remainingMs(reused) == 10);
+    f.runAll();
+    IFA_CHECK((f.fired == std::vector<std::string>{"new"}));
+    IFA_CHECK(f.timers.remainingMs(reused) == -1);
+}
+
+} // namespace
+
+int main() {
+    testCancelSiblingFromHandler();
+    testCancelSelfFromHandler();
+    testCancelAllDuringExpiry();
+    testScheduleFromHandler();
+    testExpiryOrderAcrossLevels();
+    testStaleHandle();
+    return ifa_test::finish("ifa_test_timers");
+}
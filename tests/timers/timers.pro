@@ -0,0 +1,25 @@
+# tests/timers/timers.pro
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+TARGET = ifa_test_timers
+
+DEFINES += ASIO_STANDALONE
+DEFINES += ASIO_SEPARATE_COMPILATION
+
+INCLUDEPATH += \
+    $$PWD/.. \
+    $$PWD/../../src \
+    $$PWD/../../third_party/asio/include
+
+SOURCES += \
+    test_timers.cpp
+
+QMAKE_CXXFLAGS += -w
+
+unix {
+    LIBS += -L$$OUT_PWD/../../src/runtime -lifa_runtime -lpthread
+    PRE_TARGETDEPS += $$OUT_PWD/../../src/runtime/libifa_runtime.a
+}
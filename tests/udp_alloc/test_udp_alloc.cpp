@@ -0,0 +1,99 @@
+/**
+ * @file test_udp_alloc.cpp
+ * @brief Checks that receiving, parsing and dispatching text messages in UdpCommunicator
+ *        (down to UdpCommunicator::parseAndDelegate) does not allocate once it is warmed up.
+ * @details Replaces the global operator new with a counting one. Datagrams are sent over the
+ *          loopback interface while counting is off, then received with counting on.
+ * @authors Your Authors (xsiaket00, xsimonl00)
+ * @date 2025-05-05 // Date of last modification
+ */
+
+#include "ifa_test.h"
+#include "runtime/ifa_runtime_udp.h"
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+
+/** @brief Whether allocations are being counted. */
+bool countingAllocations = false;
+/** @brief Number of allocations made while counting. */
+std::size_t allocationCount = 0;
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (countingAllocations) {
+        ++allocationCount;
+    }
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+/** @brief Port the communicator under test listens on. */
+constexpr int kListenPort = 47531;
+/** @brief Datagrams sent per batch, small enough for the default socket receive buffer. */
+constexpr int kBatch = 64;
+/** @brief Batches received with counting on (after one warm-up batch). */
+constexpr int kBatches = 20;
+
+} // namespace
+
+int main() {
+    using namespace ifa_runtime;
+    asio::io_context io;
+    HandlerTracker tracker;
+    std::size_t received = 0;
+    std::size_t errors = 0;
+    std::size_t valueLength = 0;
+
+    UdpCommunicator udp(io.get_executor(), tracker,
+        [&](std::string_view type, std::string_view name, std::string_view value) {
+            received += (type == "INPUT" && name == "ped_button") ? 1 : 0;
+            valueLength += value.size();
+        },
+        [&](const std::string&) { ++errors; });
+    IFA_CHECK(udp.initialize(kListenPort, "127.0.0.1", kListenPort + 1));
+    udp.startReceive();
+
+    asio::ip::udp::socket sender(io, asio::ip::udp::endpoint(asio::ip::udp::v4(), 0));
+    asio::ip::udp::endpoint target(asio::ip::make_address("127.0.0.1"), kListenPort);
+    const std::string message = "INPUT|ped_button|1";
+
+    std::size_t expected = 0;
+    for (int batch = 0; batch <= kBatches; ++batch) {
+        for (int i = 0; i < kBatch; ++i) {
+            sender.send_to(asio::buffer(message), target);
+        }
+        expected += kBatch;
+        // Batch 0 warms up Asio's handler memory and the receive buffers.
+        countingAllocations = batch > 0;
+        while (received < expected && errors == 0) {
+            io.run_one();
+        }
+        countingAllocations = false;
+    }
+
+    IFA_CHECK(errors == 0);
+    IFA_CHECK(received == expected);
+    IFA_CHECK(valueLength == expected);
+    IFA_CHECK(allocationCount == 0);
+    if (allocationCount != 0) {
+        std::cerr << allocationCount << " allocations while receiving " << kBatch * kBatches << " messages" << std::endl;
+    }
+    udp.shutdown();
+    return ifa_test::finish("ifa_test_udp_alloc");
+}